@@ -84,6 +84,11 @@ ATOMIC_INLINE uint64_t atomic_cas_uint64(uint64_t *v, uint64_t old, uint64_t _ne
 	return __sync_val_compare_and_swap(v, old, _new);
 }
 
+ATOMIC_INLINE uint64_t atomic_load_uint64(const uint64_t *v)
+{
+	return __atomic_load_n(v, __ATOMIC_SEQ_CST);
+}
+
 /* Signed */
 ATOMIC_INLINE int64_t atomic_add_and_fetch_int64(int64_t *p, int64_t x)
 {
@@ -154,6 +159,14 @@ ATOMIC_INLINE uint64_t atomic_cas_uint64(uint64_t *v, uint64_t old, uint64_t _ne
 	return ret;
 }
 
+/* Aligned loads are atomic on x86, only keep the compiler from reordering them. */
+ATOMIC_INLINE uint64_t atomic_load_uint64(const uint64_t *v)
+{
+	uint64_t ret = *(volatile const uint64_t *)v;
+	asm volatile ("" : : : "memory");
+	return ret;
+}
+
 /* Signed */
 ATOMIC_INLINE int64_t atomic_fetch_and_add_int64(int64_t *p, int64_t x)
 {
@@ -220,6 +233,11 @@ ATOMIC_INLINE uint32_t atomic_cas_uint32(uint32_t *v, uint32_t old, uint32_t _ne
    return __sync_val_compare_and_swap(v, old, _new);
 }
 
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+	return __atomic_load_n(v, __ATOMIC_SEQ_CST);
+}
+
 /* Signed */
 ATOMIC_INLINE int32_t atomic_add_and_fetch_int32(int32_t *p, int32_t x)
 {
@@ -271,6 +289,14 @@ ATOMIC_INLINE uint32_t atomic_cas_uint32(uint32_t *v, uint32_t old, uint32_t _ne
 	return ret;
 }
 
+/* Aligned loads are atomic on x86, only keep the compiler from reordering them. */
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+	uint32_t ret = *(volatile const uint32_t *)v;
+	asm volatile ("" : : : "memory");
+	return ret;
+}
+
 /* Signed */
 ATOMIC_INLINE int32_t atomic_add_and_fetch_int32(int32_t *p, int32_t x)
 {
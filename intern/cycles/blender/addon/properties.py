@@ -290,6 +290,28 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 default=0.01,
                 )
 
+        cls.use_adaptive_sampling = BoolProperty(
+                name="Adaptive Sampling",
+                description="Stop sampling the pixels which converged, to spend the samples on the noisy areas "
+                            "(not used with denoising)",
+                default=False,
+                )
+        cls.adaptive_threshold = FloatProperty(
+                name="Adaptive Threshold",
+                description="Noise level at which a pixel stops being sampled, lower values reduce more noise. "
+                            "Zero derives it from the number of samples",
+                min=0.0, max=1.0,
+                default=0.0,
+                precision=4,
+                )
+        cls.adaptive_min_samples = IntProperty(
+                name="Adaptive Min Samples",
+                description="Minimum number of samples of every pixel before testing its convergence. "
+                            "Zero derives it from the number of samples",
+                min=0, max=4096,
+                default=0,
+                )
+
         cls.caustics_reflective = BoolProperty(
                 name="Reflective Caustics",
                 description="Use reflective caustics, resulting in a brighter image (more noise but added realism)",
@@ -533,6 +555,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 description="Use special type BVH optimized for hair (uses more ram but renders faster)",
                 default=True,
                 )
+        cls.debug_use_two_level_bvh = BoolProperty(
+                name="Two-Level BVH",
+                description="Keep the BVH of unchanged objects between animation frames when "
+                            "using persistent images, only rebuilding the BVH over the objects "
+                            "(faster updates, slightly slower render)",
+                default=False,
+                )
         cls.debug_bvh_time_steps = IntProperty(
                 name="BVH Time Steps",
                 description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
@@ -643,6 +672,21 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
             items=enum_texture_limit
             )
 
+        cls.use_texture_cache = BoolProperty(
+            name="Texture Cache",
+            description="Read image files on demand through a texture cache of limited size instead of loading "
+                        "them fully in memory, for CPU rendering. Tiled and mip-mapped files (.tx) are read fastest",
+            default=False,
+            )
+
+        cls.texture_cache_size = IntProperty(
+            name="Cache Size",
+            description="Maximum memory used by the texture cache, in megabytes",
+            default=1024,
+            min=16, max=1048576,
+            subtype='UNSIGNED',
+            )
+
         cls.ao_bounces = IntProperty(
             name="AO Bounces",
             default=0,
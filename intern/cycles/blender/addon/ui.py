@@ -173,6 +173,13 @@ class CYCLES_RENDER_PT_sampling(CyclesButtonsPanel, Panel):
         sub.prop(cscene, "sample_clamp_indirect")
         sub.prop(cscene, "light_sampling_threshold")
 
+        sub = col.column(align=True)
+        sub.prop(cscene, "use_adaptive_sampling")
+        subsub = sub.column(align=True)
+        subsub.active = cscene.use_adaptive_sampling
+        subsub.prop(cscene, "adaptive_threshold", text="Threshold")
+        subsub.prop(cscene, "adaptive_min_samples", text="Min Samples")
+
         if cscene.progressive == 'PATH' or use_branched_path(context) is False:
             col = split.column()
             sub = col.column(align=True)
@@ -421,10 +428,21 @@ class CYCLES_RENDER_PT_performance(CyclesButtonsPanel, Panel):
 
         col.separator()
 
+        col.prop(cscene, "use_texture_cache")
+        sub = col.column()
+        sub.active = cscene.use_texture_cache
+        sub.prop(cscene, "texture_cache_size")
+
+        col.separator()
+
         col.label(text="Acceleration structure:")
         col.prop(cscene, "debug_use_spatial_splits")
         col.prop(cscene, "debug_use_hair_bvh")
 
+        sub = col.column()
+        sub.active = rd.use_persistent_data
+        sub.prop(cscene, "debug_use_two_level_bvh")
+
         row = col.row()
         row.active = not cscene.debug_use_spatial_splits
         row.prop(cscene, "debug_bvh_time_steps")
@@ -59,6 +59,28 @@ bool BlenderSync::BKE_object_is_modified(BL::Object& b_ob)
 	return false;
 }
 
+bool BlenderSync::object_geometry_is_animated(BL::Object& b_ob)
+{
+	/* modifiers can depend on time or on other objects */
+	if(BKE_object_is_modified(b_ob)) {
+		return true;
+	}
+
+	BL::ID b_ob_data = b_ob.data();
+
+	if(!b_ob_data.is_a(&RNA_Mesh)) {
+		/* curves, surfaces, texts and metaballs are converted to a mesh from
+		 * data which can be animated */
+		return true;
+	}
+
+	/* shape keys and drivers */
+	BL::Mesh b_mesh(b_ob_data);
+	BL::Key b_key(b_mesh.shape_keys());
+
+	return (b_mesh.animation_data() || (b_key && b_key.animation_data()));
+}
+
 bool BlenderSync::object_is_mesh(BL::Object& b_ob)
 {
 	BL::ID b_ob_data = b_ob.data();
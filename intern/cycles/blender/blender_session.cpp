@@ -22,6 +22,7 @@
 #include "device/device.h"
 #include "render/integrator.h"
 #include "render/film.h"
+#include "render/image.h"
 #include "render/light.h"
 #include "render/mesh.h"
 #include "render/object.h"
@@ -129,6 +130,7 @@ void BlenderSession::create_session()
 	last_error = "";
 	last_progress = -1.0f;
 	start_resize_time = 0.0;
+	last_frame = b_scene.frame_current();
 
 	/* create session */
 	session = new Session(session_params);
@@ -207,7 +209,6 @@ void BlenderSession::reset_session(BL::BlendData& b_data_, BL::Scene& b_scene_)
 	}
 
 	session->progress.reset();
-	scene->reset();
 
 	session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -216,8 +217,23 @@ void BlenderSession::reset_session(BL::BlendData& b_data_, BL::Scene& b_scene_)
 	 */
 	session->stats.mem_peak = session->stats.mem_used;
 
-	/* sync object should be re-created */
-	sync = new BlenderSync(b_engine, b_data, b_depsgraph, b_scene, scene, !background, session->progress);
+	/* The next frame of an animation keeps the synchronized data, only the data
+	 * which can change with time is synchronized again, so the unchanged meshes
+	 * keep their BVH. Other renders can follow any edit of the scene, the recalc
+	 * flags of which are already cleared, so the sync object is re-created. */
+	const int frame = b_scene.frame_current();
+
+	if(b_engine.is_animation() && frame == last_frame + b_scene.frame_step()) {
+		sync->reset(b_data, b_scene);
+	}
+	else {
+		scene->reset();
+
+		delete sync;
+		sync = new BlenderSync(b_engine, b_data, b_depsgraph, b_scene, scene, !background, session->progress);
+	}
+
+	last_frame = frame;
 
 	/* for final render we will do full data sync per render layer, only
 	 * do some basic syncing here, no objects or materials for speed */
@@ -942,6 +958,19 @@ void BlenderSession::update_status_progress()
 
 	timestatus += string_printf("Mem:%.2fM, Peak:%.2fM", (double)mem_used, (double)mem_peak);
 
+	float cache_hit_rate;
+	size_t cache_mem_used, cache_mem_peak;
+	if(session->scene &&
+	   session->scene->image_manager->get_texture_cache_stats(cache_hit_rate,
+	                                                          cache_mem_used,
+	                                                          cache_mem_peak))
+	{
+		timestatus += string_printf(" | Tex Cache:%.1f%% hits, Mem:%.2fM, Peak:%.2fM",
+		                            (double)cache_hit_rate * 100.0,
+		                            (double)cache_mem_used / 1024.0 / 1024.0,
+		                            (double)cache_mem_peak / 1024.0 / 1024.0);
+	}
+
 	if(status.size() > 0)
 		status = " | " + status;
 	if(substatus.size() > 0)
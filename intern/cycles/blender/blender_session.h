@@ -122,6 +122,10 @@ public:
 	int width, height;
 	double start_resize_time;
 
+	/* Frame of the last final render, to keep the synchronized data between
+	 * the frames of an animation. */
+	int last_frame;
+
 	void *python_thread_state;
 
 	/* Global state which is common for all render sessions created from Blender.
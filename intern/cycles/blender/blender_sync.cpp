@@ -79,6 +79,43 @@ BlenderSync::~BlenderSync()
 
 /* Sync */
 
+void BlenderSync::reset(BL::BlendData& b_data, BL::Scene& b_scene)
+{
+	/* Data and scene pointers can change between renders. */
+	this->b_data = b_data;
+	this->b_scene = b_scene;
+
+	/* Tag the data for the next frame of an animation. The recalc flags of the
+	 * frame change are cleared before rendering, so everything which can change
+	 * with time is tagged. Shaders, lights and object transforms are cheap to
+	 * synchronize, only the animated geometry is synchronized again, other
+	 * meshes keep their BVH. */
+	BL::BlendData::materials_iterator b_mat;
+	for(b_data.materials.begin(b_mat); b_mat != b_data.materials.end(); ++b_mat)
+		shader_map.set_recalc(*b_mat);
+
+	BL::BlendData::lamps_iterator b_lamp;
+	for(b_data.lamps.begin(b_lamp); b_lamp != b_data.lamps.end(); ++b_lamp)
+		shader_map.set_recalc(*b_lamp);
+
+	world_recalc = true;
+
+	BL::BlendData::objects_iterator b_ob;
+	for(b_data.objects.begin(b_ob); b_ob != b_data.objects.end(); ++b_ob) {
+		object_map.set_recalc(*b_ob);
+		light_map.set_recalc(*b_ob);
+
+		if(object_is_mesh(*b_ob) && object_geometry_is_animated(*b_ob)) {
+			BL::ID key = BKE_object_is_modified(*b_ob)? *b_ob: b_ob->data();
+			mesh_map.set_recalc(key);
+		}
+
+		BL::Object::particle_systems_iterator b_psys;
+		for(b_ob->particle_systems.begin(b_psys); b_psys != b_ob->particle_systems.end(); ++b_psys)
+			particle_system_map.set_recalc(*b_ob);
+	}
+}
+
 bool BlenderSync::sync_recalc()
 {
 	/* sync recalc flags from blender to cycles. actual update is done separate,
@@ -288,6 +325,10 @@ void BlenderSync::sync_integrator()
 	integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
 	integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
 
+	integrator->use_adaptive_sampling = get_boolean(cscene, "use_adaptive_sampling");
+	integrator->adaptive_threshold = get_float(cscene, "adaptive_threshold");
+	integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
+
 	int diffuse_samples = get_int(cscene, "diffuse_samples");
 	int glossy_samples = get_int(cscene, "glossy_samples");
 	int transmission_samples = get_int(cscene, "transmission_samples");
@@ -609,7 +650,18 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 	else if(shadingsystem == 1)
 		params.shadingsystem = SHADINGSYSTEM_OSL;
 	
-	if(background || DebugFlags().viewport_static_bvh)
+	if(background && params.shadingsystem != SHADINGSYSTEM_OSL)
+		params.persistent_data = r.use_persistent_data();
+	else
+		params.persistent_data = false;
+
+	/* With persistent data the scene is kept between animation frames, a two
+	 * level BVH keeps the BVH of unchanged objects and only rebuilds the top
+	 * level BVH over the objects, instead of flattening the whole scene. */
+	const bool two_level_bvh = params.persistent_data &&
+	                           RNA_boolean_get(&cscene, "debug_use_two_level_bvh");
+
+	if((background && !two_level_bvh) || DebugFlags().viewport_static_bvh)
 		params.bvh_type = SceneParams::BVH_STATIC;
 	else
 		params.bvh_type = SceneParams::BVH_DYNAMIC;
@@ -618,11 +670,6 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 	params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
 	params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
-	if(background && params.shadingsystem != SHADINGSYSTEM_OSL)
-		params.persistent_data = r.use_persistent_data();
-	else
-		params.persistent_data = false;
-
 	int texture_limit;
 	if(background) {
 		texture_limit = RNA_enum_get(&cscene, "texture_limit_render");
@@ -637,6 +684,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 		params.texture_limit = 0;
 	}
 
+	if(get_boolean(cscene, "use_texture_cache")) {
+		params.texture_cache_size = get_int(cscene, "texture_cache_size");
+	}
+	else {
+		params.texture_cache_size = 0;
+	}
+
 	params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
 	return params;
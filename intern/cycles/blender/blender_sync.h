@@ -60,6 +60,7 @@ public:
 	~BlenderSync();
 
 	/* sync */
+	void reset(BL::BlendData& b_data, BL::Scene& b_scene);
 	bool sync_recalc();
 	void sync_data(BL::RenderSettings& b_render,
 	               BL::SpaceView3D& b_v3d,
@@ -158,6 +159,7 @@ private:
 	void find_shader(BL::ID& id, vector<Shader*>& used_shaders, Shader *default_shader);
 	bool BKE_object_is_modified(BL::Object& b_ob);
 	bool object_is_mesh(BL::Object& b_ob);
+	bool object_geometry_is_animated(BL::Object& b_ob);
 	bool object_is_light(BL::Object& b_ob);
 
 	/* variables */
@@ -34,6 +34,7 @@
 #include "kernel/kernel_types.h"
 #include "kernel/split/kernel_split_data.h"
 #include "kernel/kernel_globals.h"
+#include "kernel/kernels/cpu/kernel_cpu_texture_cache.h"
 
 #include "kernel/filter/filter.h"
 
@@ -166,6 +167,8 @@ public:
 	device_vector<TextureInfo> texture_info;
 	bool need_texture_info;
 
+	TextureCacheGlobals texture_cache_globals;
+
 #ifdef WITH_OSL
 	OSLGlobals osl_globals;
 #endif
@@ -175,6 +178,10 @@ public:
 	DeviceRequestedFeatures requested_features;
 
 	KernelFunctions<void(*)(KernelGlobals *, float *, int, int, int, int, int)>             path_trace_kernel;
+	KernelFunctions<void(*)(KernelGlobals *, float *, int, int, int, int)>                  adaptive_stopping_kernel;
+	KernelFunctions<bool(*)(KernelGlobals *, float *, int, int, int, int, int)>             adaptive_filter_x_kernel;
+	KernelFunctions<bool(*)(KernelGlobals *, float *, int, int, int, int, int)>             adaptive_filter_y_kernel;
+	KernelFunctions<void(*)(KernelGlobals *, float *, int, int, int, int, int)>             adaptive_adjust_samples_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)> convert_to_half_float_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)> convert_to_byte_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uint4 *, float4 *, int, int, int, int, int)>   shader_kernel;
@@ -212,6 +219,10 @@ public:
 	  texture_info(this, "__texture_info", MEM_TEXTURE),
 #define REGISTER_KERNEL(name) name ## _kernel(KERNEL_FUNCTIONS(name))
 	  REGISTER_KERNEL(path_trace),
+	  REGISTER_KERNEL(adaptive_stopping),
+	  REGISTER_KERNEL(adaptive_filter_x),
+	  REGISTER_KERNEL(adaptive_filter_y),
+	  REGISTER_KERNEL(adaptive_adjust_samples),
 	  REGISTER_KERNEL(convert_to_half_float),
 	  REGISTER_KERNEL(convert_to_byte),
 	  REGISTER_KERNEL(shader),
@@ -237,6 +248,7 @@ public:
 #ifdef WITH_OSL
 		kernel_globals.osl = &osl_globals;
 #endif
+		kernel_globals.texture_cache = NULL;
 		use_split_kernel = DebugFlags().cpu.split_kernel;
 		if(use_split_kernel) {
 			VLOG(1) << "Will be using split kernel.";
@@ -283,6 +295,9 @@ public:
 			texture_info.copy_to_device();
 			need_texture_info = false;
 		}
+
+		/* Images are only looked up in the texture cache when it is in use. */
+		kernel_globals.texture_cache = (texture_cache_globals.ts)? &texture_cache_globals: NULL;
 	}
 
 	void mem_alloc(device_memory& mem)
@@ -439,6 +454,11 @@ public:
 #endif
 	}
 
+	void *texture_cache_memory()
+	{
+		return &texture_cache_globals;
+	}
+
 	void thread_run(DeviceTask *task)
 	{
 		if(task->type == DeviceTask::RENDER) {
@@ -684,6 +704,40 @@ public:
 		return true;
 	}
 
+	/* Mark the converged pixels of the tile, returns false when all of them converged. */
+	bool adaptive_sampling_filter(RenderTile &tile, KernelGlobals *kg)
+	{
+		float *render_buffer = (float*)tile.buffer;
+
+		for(int y = tile.y; y < tile.y + tile.h; y++) {
+			for(int x = tile.x; x < tile.x + tile.w; x++) {
+				adaptive_stopping_kernel()(kg, render_buffer, x, y, tile.offset, tile.stride);
+			}
+		}
+
+		bool any = false;
+		for(int y = tile.y; y < tile.y + tile.h; y++) {
+			any |= adaptive_filter_x_kernel()(kg, render_buffer, y, tile.x, tile.w, tile.offset, tile.stride);
+		}
+		for(int x = tile.x; x < tile.x + tile.w; x++) {
+			any |= adaptive_filter_y_kernel()(kg, render_buffer, x, tile.y, tile.h, tile.offset, tile.stride);
+		}
+
+		return any;
+	}
+
+	void adaptive_sampling_adjust(RenderTile &tile, KernelGlobals *kg)
+	{
+		float *render_buffer = (float*)tile.buffer;
+
+		for(int y = tile.y; y < tile.y + tile.h; y++) {
+			for(int x = tile.x; x < tile.x + tile.w; x++) {
+				adaptive_adjust_samples_kernel()(kg, render_buffer, tile.sample,
+				                                 x, y, tile.offset, tile.stride);
+			}
+		}
+	}
+
 	void path_trace(DeviceTask &task, RenderTile &tile, KernelGlobals *kg)
 	{
 		scoped_timer timer(&tile.buffers->render_time);
@@ -707,8 +761,25 @@ public:
 
 			tile.sample = sample + 1;
 
+			if(task.adaptive_sampling &&
+			   tile.sample >= task.adaptive_min_samples &&
+			   (tile.sample % task.adaptive_step) == 0)
+			{
+				if(!adaptive_sampling_filter(tile, kg)) {
+					/* All pixels converged, the thread can take the next tile. Report
+					 * the skipped samples so the progress still ends at 100%. */
+					tile.sample = end_sample;
+					task.update_progress(&tile, tile.w*tile.h*(end_sample - sample));
+					break;
+				}
+			}
+
 			task.update_progress(&tile, tile.w*tile.h);
 		}
+
+		if(task.adaptive_sampling) {
+			adaptive_sampling_adjust(tile, kg);
+		}
 	}
 
 	void denoise(DeviceTask &task, DenoisingTask& denoising, RenderTile &tile)
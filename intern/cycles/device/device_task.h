@@ -76,6 +76,12 @@ public:
 	int pass_denoising_data;
 	int pass_denoising_clean;
 
+	/* Stop sampling the converged pixels, tested every adaptive_step samples
+	 * once adaptive_min_samples are rendered. */
+	bool adaptive_sampling;
+	int adaptive_min_samples;
+	int adaptive_step;
+
 	bool need_finish_queue;
 	bool integrator_branched;
 	int2 requested_tile_size;
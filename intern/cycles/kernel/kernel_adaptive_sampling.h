@@ -0,0 +1,172 @@
+/*
+ * Copyright 2011-2018 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __KERNEL_ADAPTIVE_SAMPLING_H__
+#define __KERNEL_ADAPTIVE_SAMPLING_H__
+
+CCL_NAMESPACE_BEGIN
+
+/* Adaptive sampling
+ *
+ * The combined pass holds the sum of all samples of a pixel and the auxiliary
+ * buffer the sum of every other sample with twice the weight. Both estimate the
+ * same value, their difference is used as the per pixel error estimate.
+ *
+ * The w component of the auxiliary buffer is set when the pixel converged,
+ * kernel_adaptive_sample_pixel() then skips it for the next samples. */
+
+ccl_device_inline ccl_global float *kernel_adaptive_pixel_buffer(KernelGlobals *kg,
+                                                                 ccl_global float *buffer,
+                                                                 int x, int y,
+                                                                 int offset, int stride)
+{
+	int index = offset + x + y*stride;
+	return buffer + index*kernel_data.film.pass_stride;
+}
+
+/* Test the convergence of a pixel, the error is the difference of the two
+ * estimates relative to the square root of the pixel intensity, see
+ * "A hierarchical automatic stopping condition for Monte Carlo global illumination"
+ * by Dammertz et al. */
+ccl_device void kernel_adaptive_stopping(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int x, int y,
+                                         int offset, int stride)
+{
+	buffer = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+	ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux_buffer;
+
+	if(aux[3] != 0.0f) {
+		return;
+	}
+
+	const float sample = buffer[kernel_data.film.pass_sample_count];
+	const float3 I = make_float3(buffer[0], buffer[1], buffer[2]);
+	const float3 A = make_float3(aux[0], aux[1], aux[2]);
+
+	/* A small epsilon avoids the division by zero for black pixels. */
+	const float error = (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) /
+	                    (sample*0.0001f + sqrtf(max(I.x + I.y + I.z, 0.0f)));
+
+	if(error < kernel_data.integrator.adaptive_threshold*sample) {
+		aux[3] = 1.0f;
+	}
+}
+
+/* Mark the horizontal neighbors of the pixels which didn't converge as not converged,
+ * so the noisy areas keep being sampled up to their border.
+ * Returns true when any pixel of the row still needs samples. */
+ccl_device bool kernel_adaptive_filter_x(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int y, int x_start, int width,
+                                         int offset, int stride)
+{
+	bool any = false;
+	bool prev = false;
+
+	for(int x = x_start; x < x_start + width; x++) {
+		ccl_global float *aux = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride) +
+		                        kernel_data.film.pass_adaptive_aux_buffer;
+
+		if(aux[3] == 0.0f) {
+			any = true;
+			if(x > x_start && !prev) {
+				ccl_global float *prev_aux = kernel_adaptive_pixel_buffer(kg, buffer, x - 1, y, offset, stride) +
+				                             kernel_data.film.pass_adaptive_aux_buffer;
+				prev_aux[3] = 0.0f;
+			}
+			prev = true;
+		}
+		else {
+			if(prev) {
+				aux[3] = 0.0f;
+			}
+			prev = false;
+		}
+	}
+
+	return any;
+}
+
+/* Same as kernel_adaptive_filter_x() for the vertical neighbors. */
+ccl_device bool kernel_adaptive_filter_y(KernelGlobals *kg,
+                                         ccl_global float *buffer,
+                                         int x, int y_start, int height,
+                                         int offset, int stride)
+{
+	bool any = false;
+	bool prev = false;
+
+	for(int y = y_start; y < y_start + height; y++) {
+		ccl_global float *aux = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride) +
+		                        kernel_data.film.pass_adaptive_aux_buffer;
+
+		if(aux[3] == 0.0f) {
+			any = true;
+			if(y > y_start && !prev) {
+				ccl_global float *prev_aux = kernel_adaptive_pixel_buffer(kg, buffer, x, y - 1, offset, stride) +
+				                             kernel_data.film.pass_adaptive_aux_buffer;
+				prev_aux[3] = 0.0f;
+			}
+			prev = true;
+		}
+		else {
+			if(prev) {
+				aux[3] = 0.0f;
+			}
+			prev = false;
+		}
+	}
+
+	return any;
+}
+
+/* Scale the passes of a pixel which stopped early as if it was rendered with all
+ * the samples, so the buffer can be read like a buffer rendered without adaptive
+ * sampling. Passes only written by the first sample are left untouched. */
+ccl_device void kernel_adaptive_adjust_samples(KernelGlobals *kg,
+                                               ccl_global float *buffer,
+                                               int sample,
+                                               int x, int y,
+                                               int offset, int stride)
+{
+	buffer = kernel_adaptive_pixel_buffer(kg, buffer, x, y, offset, stride);
+
+	const float sample_count = buffer[kernel_data.film.pass_sample_count];
+	if(sample_count == 0.0f || sample_count >= (float)sample) {
+		return;
+	}
+
+	const float scale = (float)sample/sample_count;
+	const int flag = kernel_data.film.pass_flag;
+
+	for(int i = 0; i < kernel_data.film.pass_adaptive_aux_buffer; i++) {
+		if(((flag & PASSMASK(DEPTH)) && i == kernel_data.film.pass_depth) ||
+		   ((flag & PASSMASK(OBJECT_ID)) && i == kernel_data.film.pass_object_id) ||
+		   ((flag & PASSMASK(MATERIAL_ID)) && i == kernel_data.film.pass_material_id))
+		{
+			continue;
+		}
+
+		buffer[i] *= scale;
+	}
+
+	buffer[kernel_data.film.pass_sample_count] = (float)sample;
+}
+
+CCL_NAMESPACE_END
+
+#endif /* __KERNEL_ADAPTIVE_SAMPLING_H__ */
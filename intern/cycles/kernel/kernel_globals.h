@@ -42,6 +42,8 @@ struct OSLThreadData;
 struct OSLShadingSystem;
 #  endif
 
+struct TextureCacheGlobals;
+
 struct Intersection;
 struct VolumeStep;
 
@@ -60,6 +62,9 @@ typedef struct KernelGlobals {
 	OSLThreadData *osl_tdata;
 #  endif
 
+	/* Images read on demand, NULL when all images are loaded in memory. */
+	TextureCacheGlobals *texture_cache;
+
 	/* **** Run-time data ****  */
 
 	/* Heap-allocated storage for transparent shadows intersections. */
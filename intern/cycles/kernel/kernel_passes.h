@@ -332,6 +332,23 @@ ccl_device_inline void kernel_write_light_passes(KernelGlobals *kg, ccl_global f
 #endif
 }
 
+/* Adaptive sampling: returns false when the pixel has converged and must not be
+ * sampled anymore, otherwise counts the sample in the pixel sample count pass. */
+ccl_device_inline bool kernel_adaptive_sample_pixel(KernelGlobals *kg,
+                                                    ccl_global float *buffer)
+{
+	if(kernel_data.film.pass_sample_count == 0) {
+		return true;
+	}
+
+	if(buffer[kernel_data.film.pass_adaptive_aux_buffer + 3] != 0.0f) {
+		return false;
+	}
+
+	kernel_write_pass_float(buffer + kernel_data.film.pass_sample_count, 1.0f);
+	return true;
+}
+
 ccl_device_inline void kernel_write_result(KernelGlobals *kg,
                                            ccl_global float *buffer,
                                            int sample,
@@ -342,6 +359,13 @@ ccl_device_inline void kernel_write_result(KernelGlobals *kg,
 
 	kernel_write_pass_float4(buffer, make_float4(L_sum.x, L_sum.y, L_sum.z, alpha));
 
+	/* The auxiliary buffer accumulates every other sample with twice the weight,
+	 * the difference with the combined pass estimates the pixel error. */
+	if(kernel_data.film.pass_adaptive_aux_buffer && (sample & 1)) {
+		kernel_write_pass_float4(buffer + kernel_data.film.pass_adaptive_aux_buffer,
+		                         make_float4(L_sum.x*2.0f, L_sum.y*2.0f, L_sum.z*2.0f, 0.0f));
+	}
+
 	kernel_write_light_passes(kg, buffer, L);
 
 #ifdef __DENOISING_FEATURES__
@@ -59,6 +59,7 @@
 #include "kernel/kernel.h"
 #define KERNEL_ARCH cpu
 #include "kernel/kernels/cpu/kernel_cpu_impl.h"
+#include "kernel/kernels/cpu/kernel_cpu_texture_cache.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -92,4 +93,44 @@ void kernel_tex_copy(KernelGlobals *kg,
 	}
 }
 
+/* Texture Cache */
+
+bool kernel_tex_image_cache_lookup(KernelGlobals *kg,
+                                   int id,
+                                   float x, float y,
+                                   float2 dx, float2 dy,
+                                   float4 *result)
+{
+	TextureCacheGlobals *tc = kg->texture_cache;
+
+	if(id < 0 || id >= (int)tc->images.size() || !tc->images[id].handle) {
+		return false;
+	}
+
+	const TextureCacheGlobals::Image& image = tc->images[id];
+	OIIO::TextureOpt options = image.options;
+	OIIO::TextureSystem::Perthread *thread_info = tc->ts->get_perthread_info();
+	float rgba[4];
+
+	/* Image rows are stored bottom to top in Cycles, OIIO starts at the top. */
+	if(tc->ts->texture(image.handle, thread_info, options,
+	                   x, 1.0f - y,
+	                   dx.x, -dx.y,
+	                   dy.x, -dy.y,
+	                   4, rgba))
+	{
+		*result = make_float4(rgba[0], rgba[1], rgba[2], rgba[3]);
+	}
+	else {
+		/* Clear the error, the image was valid when the handle was created. */
+		tc->ts->geterror();
+		*result = make_float4(TEX_IMAGE_MISSING_R,
+		                      TEX_IMAGE_MISSING_G,
+		                      TEX_IMAGE_MISSING_B,
+		                      TEX_IMAGE_MISSING_A);
+	}
+
+	return true;
+}
+
 CCL_NAMESPACE_END
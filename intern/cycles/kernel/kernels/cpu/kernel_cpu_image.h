@@ -472,8 +472,29 @@ template<typename T> struct TextureInterpolator  {
 #undef SET_CUBIC_SPLINE_WEIGHTS
 };
 
-ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
+/* Lookup of the images read through the texture cache, returns false for images
+ * loaded in memory. Defined in kernel.cpp, outside of the per architecture
+ * kernels, since it calls into OIIO. */
+bool kernel_tex_image_cache_lookup(KernelGlobals *kg,
+                                   int id,
+                                   float x, float y,
+                                   float2 dx, float2 dy,
+                                   float4 *result);
+
+/* Image lookup with the differentials of the coordinates, they select the mip
+ * level and filter size of the images read through the texture cache. */
+ccl_device float4 kernel_tex_image_interp_diff(KernelGlobals *kg,
+                                               int id,
+                                               float x, float y,
+                                               float2 dx, float2 dy)
 {
+	if(kg->texture_cache) {
+		float4 r;
+		if(kernel_tex_image_cache_lookup(kg, id, x, y, dx, dy, &r)) {
+			return r;
+		}
+	}
+
 	const TextureInfo& info = kernel_tex_fetch(__texture_info, id);
 
 	switch(kernel_tex_type(id)) {
@@ -493,6 +514,13 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, fl
 	}
 }
 
+ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, float y)
+{
+	return kernel_tex_image_interp_diff(kg, id, x, y,
+	                                    make_float2(0.0f, 0.0f),
+	                                    make_float2(0.0f, 0.0f));
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals *kg, int id, float x, float y, float z, InterpolationType interp)
 {
 	const TextureInfo& info = kernel_tex_fetch(__texture_info, id);
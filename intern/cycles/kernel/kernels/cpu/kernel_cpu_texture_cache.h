@@ -0,0 +1,51 @@
+/*
+ * Copyright 2011-2018 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __KERNEL_CPU_TEXTURE_CACHE_H__
+#define __KERNEL_CPU_TEXTURE_CACHE_H__
+
+#include <OpenImageIO/texture.h>
+
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Texture Cache
+ *
+ * On the CPU, image files can be read on demand instead of being fully loaded
+ * in memory. The image manager opens them in an OIIO texture system, which
+ * keeps the tiles of the mip levels in a cache of bounded size, and the kernel
+ * looks them up with kernel_tex_image_cache_lookup().
+ *
+ * Images are indexed by flat slot, images loaded in memory have no handle. */
+
+struct TextureCacheGlobals {
+	struct Image {
+		Image() : handle(NULL) {}
+
+		OIIO::TextureSystem::TextureHandle *handle;
+		OIIO::TextureOpt options;
+	};
+
+	TextureCacheGlobals() : ts(NULL) {}
+
+	OIIO::TextureSystem *ts;
+	vector<Image> images;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __KERNEL_CPU_TEXTURE_CACHE_H__ */
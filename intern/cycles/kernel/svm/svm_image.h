@@ -16,9 +16,14 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint srgb, uint use_alpha)
+ccl_device float4 svm_image_texture_diff(KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy, uint srgb, uint use_alpha)
 {
+#ifdef __KERNEL_CPU__
+	/* Only images read through the texture cache are filtered with the differentials. */
+	float4 r = kernel_tex_image_interp_diff(kg, id, x, y, dx, dy);
+#else
 	float4 r = kernel_tex_image_interp(kg, id, x, y);
+#endif
 	const float alpha = r.w;
 
 	if(use_alpha && alpha != 1.0f && alpha != 0.0f) {
@@ -39,6 +44,32 @@ ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y,
 	return r;
 }
 
+ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint srgb, uint use_alpha)
+{
+	return svm_image_texture_diff(kg, id, x, y, make_float2(0.0f, 0.0f), make_float2(0.0f, 0.0f), srgb, use_alpha);
+}
+
+/* Differentials of the default UV map, for image coordinates read unmodified from it. */
+ccl_device void svm_image_uv_differentials(KernelGlobals *kg, ShaderData *sd, float2 *dx, float2 *dy)
+{
+	*dx = make_float2(0.0f, 0.0f);
+	*dy = make_float2(0.0f, 0.0f);
+
+#ifdef __KERNEL_CPU__
+	if(kg->texture_cache == NULL) {
+		return;
+	}
+
+	const AttributeDescriptor desc = find_attribute(kg, sd, ATTR_STD_UV);
+	if(desc.offset != ATTR_STD_NOT_FOUND) {
+		float3 uv_dx, uv_dy;
+		primitive_attribute_float3(kg, sd, desc, &uv_dx, &uv_dy);
+		*dx = make_float2(uv_dx.x, uv_dx.y);
+		*dy = make_float2(uv_dy.x, uv_dy.y);
+	}
+#endif
+}
+
 /* Remap coordnate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -49,24 +80,36 @@ ccl_device void svm_node_tex_image(KernelGlobals *kg, ShaderData *sd, float *sta
 {
 	uint id = node.y;
 	uint co_offset, out_offset, alpha_offset, srgb;
+	uint projection, flags;
 
 	decode_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &srgb);
+	decode_node_uchar4(node.w, &projection, &flags, NULL, NULL);
 
 	float3 co = stack_load_float3(stack, co_offset);
 	float2 tex_co;
+	float2 dx, dy;
 	uint use_alpha = stack_valid(alpha_offset);
-	if(node.w == NODE_IMAGE_PROJ_SPHERE) {
+	if(projection == NODE_IMAGE_PROJ_SPHERE) {
 		co = texco_remap_square(co);
 		tex_co = map_to_sphere(co);
 	}
-	else if(node.w == NODE_IMAGE_PROJ_TUBE) {
+	else if(projection == NODE_IMAGE_PROJ_TUBE) {
 		co = texco_remap_square(co);
 		tex_co = map_to_tube(co);
 	}
 	else {
 		tex_co = make_float2(co.x, co.y);
 	}
-	float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, srgb, use_alpha);
+
+	if(projection == NODE_IMAGE_PROJ_FLAT && (flags & NODE_IMAGE_UV_DIFFERENTIALS)) {
+		svm_image_uv_differentials(kg, sd, &dx, &dy);
+	}
+	else {
+		dx = make_float2(0.0f, 0.0f);
+		dy = make_float2(0.0f, 0.0f);
+	}
+
+	float4 f = svm_image_texture_diff(kg, id, tex_co.x, tex_co.y, dx, dy, srgb, use_alpha);
 
 	if(stack_valid(out_offset))
 		stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -365,6 +365,12 @@ typedef enum NodeImageProjection {
 	NODE_IMAGE_PROJ_TUBE   = 3,
 } NodeImageProjection;
 
+typedef enum NodeImageFlags {
+	/* Image coordinates are the default UV map, its differentials can be used
+	 * to filter the image. */
+	NODE_IMAGE_UV_DIFFERENTIALS = 1,
+} NodeImageFlags;
+
 typedef enum NodeEnvironmentProjection {
 	NODE_ENVIRONMENT_EQUIRECTANGULAR = 0,
 	NODE_ENVIRONMENT_MIRROR_BALL = 1,
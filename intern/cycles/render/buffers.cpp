@@ -43,6 +43,7 @@ BufferParams::BufferParams()
 
 	denoising_data_pass = false;
 	denoising_clean_pass = false;
+	adaptive_sampling_pass = false;
 
 	Pass::add(PASS_COMBINED, passes);
 }
@@ -61,6 +62,7 @@ bool BufferParams::modified(const BufferParams& params)
 		&& height == params.height
 		&& full_width == params.full_width
 		&& full_height == params.full_height
+		&& adaptive_sampling_pass == params.adaptive_sampling_pass
 		&& Pass::equals(passes, params.passes));
 }
 
@@ -76,7 +78,14 @@ int BufferParams::get_passes_size()
 		if(denoising_clean_pass) size += DENOISING_PASS_SIZE_CLEAN;
 	}
 
-	return align_up(size, 4);
+	size = align_up(size, 4);
+
+	if(adaptive_sampling_pass && !denoising_data_pass) {
+		/* float4 auxiliary buffer and sample count. */
+		size = align_up(size + 4 + 1, 4);
+	}
+
+	return size;
 }
 
 int BufferParams::get_denoising_offset()
@@ -54,6 +54,8 @@ public:
 	bool denoising_data_pass;
 	/* If only some light path types should be denoised, an additional pass is needed. */
 	bool denoising_clean_pass;
+	/* Auxiliary buffer and sample count of adaptive sampling, not used with the denoising data. */
+	bool adaptive_sampling_pass;
 
 	/* functions */
 	BufferParams();
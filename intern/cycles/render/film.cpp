@@ -289,6 +289,9 @@ Film::Film()
 	Pass::add(PASS_COMBINED, passes);
 
 	use_light_visibility = false;
+	use_adaptive_sampling = false;
+	adaptive_aux_offset = 0;
+	sample_count_offset = 0;
 	filter_table_offset = TABLE_OFFSET_INVALID;
 
 	need_update = true;
@@ -458,6 +461,19 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 	}
 
 	kfilm->pass_stride = align_up(kfilm->pass_stride, 4);
+
+	/* Adaptive sampling passes, the auxiliary buffer is a float4 aligned like the
+	 * combined pass. Keep in sync with BufferParams::get_passes_size(). */
+	kfilm->pass_adaptive_aux_buffer = 0;
+	kfilm->pass_sample_count = 0;
+	if(use_adaptive_sampling && !denoising_data_pass) {
+		kfilm->pass_adaptive_aux_buffer = kfilm->pass_stride;
+		kfilm->pass_stride += 4;
+		kfilm->pass_sample_count = kfilm->pass_stride;
+		kfilm->pass_stride += 1;
+		kfilm->pass_stride = align_up(kfilm->pass_stride, 4);
+	}
+
 	kfilm->pass_alpha_threshold = pass_alpha_threshold;
 
 	/* update filter table */
@@ -474,6 +490,8 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 	pass_stride = kfilm->pass_stride;
 	denoising_data_offset = kfilm->pass_denoising_data;
 	denoising_clean_offset = kfilm->pass_denoising_clean;
+	adaptive_aux_offset = kfilm->pass_adaptive_aux_buffer;
+	sample_count_offset = kfilm->pass_sample_count;
 
 	need_update = false;
 }
@@ -65,6 +65,8 @@ public:
 	int pass_stride;
 	int denoising_data_offset;
 	int denoising_clean_offset;
+	int adaptive_aux_offset;
+	int sample_count_offset;
 
 	FilterType filter_type;
 	float filter_width;
@@ -76,6 +78,8 @@ public:
 
 	bool use_light_visibility;
 	bool use_sample_clamp;
+	/* Set from the integrator, ignored with the denoising data pass. */
+	bool use_adaptive_sampling;
 
 	bool need_update;
 
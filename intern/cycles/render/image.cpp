@@ -18,6 +18,8 @@
 #include "render/image.h"
 #include "render/scene.h"
 
+#include "kernel/kernels/cpu/kernel_cpu_texture_cache.h"
+
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_path.h"
@@ -44,6 +46,8 @@ ImageManager::ImageManager(const DeviceInfo& info)
 {
 	need_update = true;
 	osl_texture_system = NULL;
+	texture_cache = NULL;
+	texture_cache_mem_peak = 0;
 	animation_frame = 0;
 
 	/* Set image limits */
@@ -85,6 +89,41 @@ bool ImageManager::set_animation_frame_update(int frame)
 	return false;
 }
 
+/* Statistics are 32 or 64 bit integers depending on the OIIO version. */
+static long long texture_cache_stat(OIIO::TextureSystem *ts, const char *name)
+{
+	long long value = 0;
+	if(!ts->getattribute(name, TypeDesc::INT64, &value)) {
+		int int_value = 0;
+		if(ts->getattribute(name, TypeDesc::INT, &int_value)) {
+			value = int_value;
+		}
+	}
+	return value;
+}
+
+bool ImageManager::get_texture_cache_stats(float& hit_rate,
+                                           size_t& mem_used,
+                                           size_t& mem_peak)
+{
+	thread_scoped_lock device_lock(device_mutex);
+
+	if(!texture_cache) {
+		return false;
+	}
+
+	OIIO::TextureSystem *ts = texture_cache->ts;
+	const long long tile_calls = texture_cache_stat(ts, "stat:find_tile_calls");
+	const long long tile_misses = texture_cache_stat(ts, "stat:find_tile_cache_misses");
+
+	hit_rate = (tile_calls > 0)? 1.0f - (float)tile_misses/(float)tile_calls: 1.0f;
+	mem_used = (size_t)texture_cache_stat(ts, "stat:cache_memory_used");
+	texture_cache_mem_peak = max(texture_cache_mem_peak, mem_used);
+	mem_peak = texture_cache_mem_peak;
+
+	return true;
+}
+
 ImageDataType ImageManager::get_image_metadata(const string& filename,
                                                void *builtin_data,
                                                bool& is_linear,
@@ -682,6 +721,142 @@ bool ImageManager::file_load_image(Image *img,
 	return true;
 }
 
+static OIIO::TextureOpt texture_cache_options(InterpolationType interpolation,
+                                              ExtensionType extension)
+{
+	OIIO::TextureOpt options;
+
+	switch(interpolation) {
+		case INTERPOLATION_CLOSEST:
+			options.interpmode = OIIO::TextureOpt::InterpClosest;
+			options.mipmode = OIIO::TextureOpt::MipModeNoMIP;
+			break;
+		case INTERPOLATION_LINEAR:
+			options.interpmode = OIIO::TextureOpt::InterpBilinear;
+			break;
+		case INTERPOLATION_CUBIC:
+			options.interpmode = OIIO::TextureOpt::InterpBicubic;
+			break;
+		default:
+			options.interpmode = OIIO::TextureOpt::InterpSmartBicubic;
+			break;
+	}
+
+	switch(extension) {
+		case EXTENSION_EXTEND:
+			options.swrap = options.twrap = OIIO::TextureOpt::WrapClamp;
+			break;
+		case EXTENSION_CLIP:
+			options.swrap = options.twrap = OIIO::TextureOpt::WrapBlack;
+			break;
+		default:
+			options.swrap = options.twrap = OIIO::TextureOpt::WrapPeriodic;
+			break;
+	}
+
+	/* Opaque alpha for images without alpha channel. */
+	options.fill = 1.0f;
+
+	return options;
+}
+
+void ImageManager::device_update_texture_cache(Device *device, Scene *scene)
+{
+	if(!texture_cache) {
+		/* OSL reads image files through its own texture system. */
+		if(scene->params.texture_cache_size <= 0 || osl_texture_system) {
+			return;
+		}
+
+		texture_cache = (TextureCacheGlobals*)device->texture_cache_memory();
+		if(!texture_cache) {
+			VLOG(1) << "Texture cache is not supported by the device, loading images in memory.";
+			return;
+		}
+
+		OIIO::TextureSystem *ts = OIIO::TextureSystem::create(false);
+		ts->attribute("max_memory_MB", (float)scene->params.texture_cache_size);
+		/* Files which are not tiled or mip-mapped are split in tiles and mip-mapped
+		 * when they are opened, files converted with maketx are read faster. */
+		ts->attribute("autotile", 64);
+		ts->attribute("automip", 1);
+		/* Single channel images are expanded to gray like the images in memory. */
+		ts->attribute("gray_to_rgb", 1);
+
+		texture_cache->ts = ts;
+		texture_cache_mem_peak = 0;
+
+		VLOG(1) << "Using texture cache of " << scene->params.texture_cache_size << " MB.";
+	}
+
+	/* Entries are written from the image loading threads, allocate them first. */
+	size_t num_slots = 0;
+	for(int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
+		num_slots = max(num_slots,
+		                (size_t)type_index_to_flattened_slot(images[type].size(),
+		                                                     (ImageDataType)type));
+	}
+	if(texture_cache->images.size() < num_slots) {
+		texture_cache->images.resize(num_slots);
+	}
+}
+
+void ImageManager::device_free_texture_cache()
+{
+	thread_scoped_lock device_lock(device_mutex);
+
+	if(texture_cache) {
+		VLOG(1) << "Texture cache statistics:\n" << texture_cache->ts->getstats();
+
+		OIIO::TextureSystem::destroy(texture_cache->ts);
+		texture_cache->ts = NULL;
+		texture_cache->images.clear();
+		texture_cache = NULL;
+	}
+}
+
+bool ImageManager::texture_cache_add_image(Image *img, int flat_slot)
+{
+	/* Builtin images only exist in memory, images without alpha are read with
+	 * unassociated alpha which the texture system does not support. */
+	if(img->builtin_data || !img->use_alpha) {
+		return false;
+	}
+
+	OIIO::TextureSystem *ts = texture_cache->ts;
+	ustring filename(img->filename);
+
+	OIIO::TextureSystem::TextureHandle *handle = ts->get_texture_handle(filename);
+	const ImageSpec *spec = (handle)? ts->imagespec(filename): NULL;
+	if(!spec) {
+		/* Let the regular loading report the missing image. */
+		ts->geterror();
+		return false;
+	}
+	else if(spec->depth > 1) {
+		/* Volumes are only supported in memory. */
+		return false;
+	}
+
+	TextureCacheGlobals::Image& image = texture_cache->images[flat_slot];
+	image.handle = handle;
+	image.options = texture_cache_options(img->interpolation, img->extension);
+
+	VLOG(1) << "Reading image " << img->filename << " through the texture cache.";
+
+	return true;
+}
+
+void ImageManager::texture_cache_remove_image(Image *img, int flat_slot)
+{
+	if(flat_slot < (int)texture_cache->images.size() &&
+	   texture_cache->images[flat_slot].handle)
+	{
+		texture_cache->ts->invalidate(ustring(img->filename));
+		texture_cache->images[flat_slot] = TextureCacheGlobals::Image();
+	}
+}
+
 void ImageManager::device_load_image(Device *device,
                                      Scene *scene,
                                      ImageDataType type,
@@ -712,6 +887,16 @@ void ImageManager::device_load_image(Device *device,
 		img->mem = NULL;
 	}
 
+	/* Read image files on demand through the texture cache. */
+	if(texture_cache) {
+		texture_cache_remove_image(img, flat_slot);
+
+		if(texture_cache_add_image(img, flat_slot)) {
+			img->need_load = false;
+			return;
+		}
+	}
+
 	/* Create new texture. */
 	if(type == IMAGE_DATA_TYPE_FLOAT4) {
 		device_vector<float4> *tex_img
@@ -873,6 +1058,10 @@ void ImageManager::device_free_image(Device *, ImageDataType type, int slot)
 #endif
 		}
 
+		if(texture_cache) {
+			texture_cache_remove_image(img, type_index_to_flattened_slot(slot, type));
+		}
+
 		if(img->mem) {
 			thread_scoped_lock device_lock(device_mutex);
 			delete img->mem;
@@ -892,6 +1081,8 @@ void ImageManager::device_update(Device *device,
 		return;
 	}
 
+	device_update_texture_cache(device, scene);
+
 	TaskPool pool;
 	for(int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
 		for(size_t slot = 0; slot < images[type].size(); slot++) {
@@ -934,6 +1125,8 @@ void ImageManager::device_update_slot(Device *device,
 		device_free_image(device, type, slot);
 	}
 	else if(image->need_load) {
+		device_update_texture_cache(device, scene);
+
 		if(!osl_texture_system || image->builtin_data)
 			device_load_image(device,
 			                  scene,
@@ -961,6 +1154,8 @@ void ImageManager::device_free(Device *device)
 		}
 		images[type].clear();
 	}
+
+	device_free_texture_cache();
 }
 
 CCL_NAMESPACE_END
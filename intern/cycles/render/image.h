@@ -30,6 +30,7 @@ CCL_NAMESPACE_BEGIN
 class Device;
 class Progress;
 class Scene;
+struct TextureCacheGlobals;
 
 class ImageManager {
 public:
@@ -74,6 +75,12 @@ public:
 	void set_osl_texture_system(void *texture_system);
 	bool set_animation_frame_update(int frame);
 
+	/* Statistics of the texture cache, returns false when it is not used.
+	 * The peak memory is the highest usage seen by this function. */
+	bool get_texture_cache_stats(float& hit_rate,
+	                             size_t& mem_used,
+	                             size_t& mem_peak);
+
 	bool need_update;
 
 	/* NOTE: Here pixels_size is a size of storage, which equals to
@@ -129,6 +136,10 @@ private:
 	vector<Image*> images[IMAGE_DATA_NUM_TYPES];
 	void *osl_texture_system;
 
+	/* Owned by the device, NULL when image files are loaded in memory. */
+	TextureCacheGlobals *texture_cache;
+	size_t texture_cache_mem_peak;
+
 	bool file_load_image_generic(Image *img,
 	                             ImageInput **in,
 	                             int &width,
@@ -157,6 +168,11 @@ private:
 	void device_free_image(Device *device,
 	                       ImageDataType type,
 	                       int slot);
+
+	void device_update_texture_cache(Device *device, Scene *scene);
+	void device_free_texture_cache();
+	bool texture_cache_add_image(Image *img, int flat_slot);
+	void texture_cache_remove_image(Image *img, int flat_slot);
 };
 
 CCL_NAMESPACE_END
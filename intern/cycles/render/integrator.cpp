@@ -68,6 +68,10 @@ NODE_DEFINE(Integrator)
 	SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
 	SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
 
+	SOCKET_BOOLEAN(use_adaptive_sampling, "Use Adaptive Sampling", false);
+	SOCKET_FLOAT(adaptive_threshold, "Adaptive Threshold", 0.0f);
+	SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 0);
+
 	static NodeEnum method_enum;
 	method_enum.insert("path", PATH);
 	method_enum.insert("branched_path", BRANCHED_PATH);
@@ -175,6 +179,17 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 		kintegrator->light_inv_rr_threshold = 0.0f;
 	}
 
+	/* Adaptive sampling, zero threshold and minimum samples are derived from the
+	 * number of samples. The convergence is tested every adaptive_step samples,
+	 * the minimum is rounded to a multiple of the step. */
+	kintegrator->adaptive_step = 4;
+	kintegrator->adaptive_min_samples = (adaptive_min_samples > 0)?
+		adaptive_min_samples: max(4, (int)sqrtf((float)aa_samples));
+	kintegrator->adaptive_min_samples = align_up(kintegrator->adaptive_min_samples,
+	                                             kintegrator->adaptive_step);
+	kintegrator->adaptive_threshold = (adaptive_threshold > 0.0f)?
+		adaptive_threshold: max(0.001f, 1.0f/(float)max(aa_samples, 1));
+
 	/* sobol directions table */
 	int max_samples = 1;
 
@@ -206,6 +221,12 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 		scene->film->tag_update(scene);
 	}
 
+	/* Adaptive sampling passes. */
+	if(use_adaptive_sampling != scene->film->use_adaptive_sampling) {
+		scene->film->use_adaptive_sampling = use_adaptive_sampling;
+		scene->film->tag_update(scene);
+	}
+
 	need_update = false;
 }
 
@@ -69,6 +69,10 @@ public:
 	bool sample_all_lights_indirect;
 	float light_sampling_threshold;
 
+	bool use_adaptive_sampling;
+	float adaptive_threshold;
+	int adaptive_min_samples;
+
 	enum Method {
 		BRANCHED_PATH = 0,
 		PATH = 1,
@@ -37,6 +37,7 @@
 #include "util/util_logging.h"
 #include "util/util_progress.h"
 #include "util/util_set.h"
+#include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -2073,12 +2074,28 @@ void MeshManager::device_update(Device *device, DeviceScene *dscene, Scene *scen
 
 	/* Update bvh. */
 	size_t num_bvh = 0;
+	size_t num_bvh_refit = 0;
+	size_t num_bvh_reused = 0;
 	foreach(Mesh *mesh, scene->meshes) {
-		if(mesh->need_update && mesh->need_build_bvh()) {
+		if(!mesh->need_build_bvh()) {
+			continue;
+		}
+
+		if(!mesh->need_update) {
+			/* Unchanged meshes keep their BVH, only the top level BVH
+			 * over the objects is rebuilt. */
+			num_bvh_reused++;
+		}
+		else {
 			num_bvh++;
+			if(mesh->bvh && !mesh->need_update_rebuild) {
+				num_bvh_refit++;
+			}
 		}
 	}
 
+	double bvh_start_time = time_dt();
+
 	TaskPool pool;
 
 	i = 0;
@@ -2102,6 +2119,10 @@ void MeshManager::device_update(Device *device, DeviceScene *dscene, Scene *scen
 	pool.wait_work(&summary);
 	VLOG(2) << "Objects BVH build pool statistics:\n"
 	        << summary.full_report();
+	VLOG(1) << "Object BVHs: " << num_bvh - num_bvh_refit << " built, "
+	        << num_bvh_refit << " refitted, "
+	        << num_bvh_reused << " reused in "
+	        << time_dt() - bvh_start_time << " seconds.";
 
 	foreach(Shader *shader, scene->shaders) {
 		shader->need_update_mesh = false;
@@ -2118,8 +2139,11 @@ void MeshManager::device_update(Device *device, DeviceScene *dscene, Scene *scen
 
 	if(progress.get_cancel()) return;
 
+	bvh_start_time = time_dt();
 	device_update_bvh(device, dscene, scene, progress);
 	if(progress.get_cancel()) return;
+	VLOG(1) << "Scene BVH over " << scene->objects.size() << " objects built in "
+	        << time_dt() - bvh_start_time << " seconds.";
 
 	device_update_mesh(device, dscene, scene, false, progress);
 	if(progress.get_cancel()) return;
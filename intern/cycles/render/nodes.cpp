@@ -294,6 +294,26 @@ void ImageTextureNode::attributes(Shader *shader, AttributeRequestSet *attribute
 	ShaderNode::attributes(shader, attributes);
 }
 
+/* Image coordinates read unmodified from the default UV map, the kernel can
+ * then use the UV differentials to filter images read through the texture cache. */
+static bool image_vector_is_default_uv(ShaderInput *vector_in, TextureMapping& tex_mapping)
+{
+	if(!vector_in->link || !tex_mapping.skip() || vector_in->link->name() != "UV") {
+		return false;
+	}
+
+	ShaderNode *node = vector_in->link->parent;
+	if(node->type == TextureCoordinateNode::node_type) {
+		return !((TextureCoordinateNode*)node)->from_dupli;
+	}
+	else if(node->type == UVMapNode::node_type) {
+		UVMapNode *uv_node = (UVMapNode*)node;
+		return !uv_node->from_dupli && uv_node->attribute.empty();
+	}
+
+	return false;
+}
+
 void ImageTextureNode::compile(SVMCompiler& compiler)
 {
 	ShaderInput *vector_in = input("Vector");
@@ -320,6 +340,11 @@ void ImageTextureNode::compile(SVMCompiler& compiler)
 		int vector_offset = tex_mapping.compile_begin(compiler, vector_in);
 
 		if(projection != NODE_IMAGE_PROJ_BOX) {
+			int flags = 0;
+			if(image_vector_is_default_uv(vector_in, tex_mapping)) {
+				flags |= NODE_IMAGE_UV_DIFFERENTIALS;
+			}
+
 			compiler.add_node(NODE_TEX_IMAGE,
 				slot,
 				compiler.encode_uchar4(
@@ -327,7 +352,7 @@ void ImageTextureNode::compile(SVMCompiler& compiler)
 					compiler.stack_assign_if_linked(color_out),
 					compiler.stack_assign_if_linked(alpha_out),
 					srgb),
-				projection);
+				compiler.encode_uchar4(projection, flags));
 		}
 		else {
 			compiler.add_node(NODE_TEX_IMAGE_BOX,
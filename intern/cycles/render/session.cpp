@@ -773,6 +773,10 @@ void Session::reset_(BufferParams& buffer_params, int samples)
 
 void Session::reset(BufferParams& buffer_params, int samples)
 {
+	/* The film adds the adaptive sampling passes from the integrator settings. */
+	buffer_params.adaptive_sampling_pass = scene->integrator->use_adaptive_sampling;
+	tile_manager.adaptive_sampling = scene->integrator->use_adaptive_sampling;
+
 	if(device_use_gl)
 		reset_gpu(buffer_params, samples);
 	else
@@ -837,11 +841,12 @@ void Session::update_scene()
 	}
 
 	/* number of samples is needed by multi jittered
-	 * sampling pattern and by baking */
+	 * sampling pattern, adaptive sampling and by baking */
 	Integrator *integrator = scene->integrator;
 	BakeManager *bake_manager = scene->bake_manager;
 
 	if(integrator->sampling_pattern == SAMPLING_PATTERN_CMJ ||
+	   integrator->use_adaptive_sampling ||
 	   bake_manager->get_baking())
 	{
 		int aa_samples = tile_manager.num_samples;
@@ -961,6 +966,14 @@ void Session::render()
 		task.pass_denoising_clean = scene->film->denoising_clean_offset;
 	}
 
+	if(scene->film->sample_count_offset) {
+		assert(!scene->film->need_update);
+		assert(scene->film->pass_stride == task.passes_size);
+		task.adaptive_sampling = true;
+		task.adaptive_min_samples = scene->dscene.data.integrator.adaptive_min_samples;
+		task.adaptive_step = scene->dscene.data.integrator.adaptive_step;
+	}
+
 	device->task_add(task);
 }
 
@@ -94,6 +94,7 @@ TileManager::TileManager(bool progressive_, int num_samples_, int2 tile_size_, i
 {
 	progressive = progressive_;
 	tile_size = tile_size_;
+	requested_tile_size = tile_size_;
 	tile_order = tile_order_;
 	start_resolution = start_resolution_;
 	pixel_size = pixel_size_;
@@ -102,6 +103,7 @@ TileManager::TileManager(bool progressive_, int num_samples_, int2 tile_size_, i
 	preserve_tile_device = preserve_tile_device_;
 	background = background_;
 	schedule_denoising = false;
+	adaptive_sampling = false;
 
 	range_start_sample = 0;
 	range_num_samples = -1;
@@ -152,6 +154,17 @@ void TileManager::reset(BufferParams& params_, int num_samples_)
 	state.num_samples = 0;
 	state.resolution_divider = get_divider(params.width, params.height, start_resolution);
 	state.render_tiles.clear();
+
+	/* With adaptive sampling the tiles of the converged areas finish early, smaller
+	 * tiles let the threads which are done share the remaining noisy areas instead of
+	 * waiting for the last big tiles. Denoising relies on the requested tile size to
+	 * find the neighbor tiles. */
+	tile_size = requested_tile_size;
+	if(adaptive_sampling && background && !progressive && !schedule_denoising) {
+		tile_size.x = min(tile_size.x, max(tile_size.x/2, 16));
+		tile_size.y = min(tile_size.y, max(tile_size.y/2, 16));
+	}
+
 	state.denoising_tiles.clear();
 	device_free();
 }
@@ -114,12 +114,17 @@ public:
 
 	/* Schedule tiles for denoising after they've been rendered. */
 	bool schedule_denoising;
+
+	/* Converged pixels stop sampling early, use smaller tiles to balance the work
+	 * between the threads. Applied on the next reset. */
+	bool adaptive_sampling;
 protected:
 
 	void set_tiles();
 
 	bool progressive;
 	int2 tile_size;
+	int2 requested_tile_size;
 	TileOrder tile_order;
 	int start_resolution;
 	int pixel_size;
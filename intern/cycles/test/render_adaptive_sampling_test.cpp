@@ -0,0 +1,313 @@
+/*
+ * Copyright 2011-2018 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include <stdio.h>
+
+#include "device/device.h"
+#include "render/background.h"
+#include "render/buffers.h"
+#include "render/camera.h"
+#include "render/film.h"
+#include "render/graph.h"
+#include "render/integrator.h"
+#include "render/light.h"
+#include "render/mesh.h"
+#include "render/nodes.h"
+#include "render/object.h"
+#include "render/scene.h"
+#include "render/session.h"
+#include "render/shader.h"
+#include "util/util_foreach.h"
+#include "util/util_function.h"
+#include "util/util_thread.h"
+#include "util/util_time.h"
+#include "util/util_transform.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Renders a test scene with fixed and adaptive sampling and compares the noise
+ * level against a high sample count reference and the render times.
+ *
+ * The left half of the image only sees a constant background which converges
+ * after the minimum number of samples, the right half is a diffuse plane lit by
+ * a soft point light and the background, which stays noisy. */
+
+namespace {
+
+const int image_size = 48;
+
+struct RenderResult {
+	/* RGBA pixels of the combined pass. */
+	vector<float> pixels;
+	/* Adaptive sampling converged flag of each pixel. */
+	vector<bool> converged;
+	double time;
+
+	RenderResult()
+	  : pixels(image_size*image_size*4, 0.0f),
+	    converged(image_size*image_size, false),
+	    time(0.0)
+	{
+	}
+};
+
+class TileWriter {
+public:
+	TileWriter(Session *session, RenderResult *result)
+	  : session_(session),
+	    result_(result)
+	{
+	}
+
+	void write_tile(RenderTile& rtile)
+	{
+		RenderBuffers *buffers = rtile.buffers;
+		if(buffers == NULL || !buffers->copy_from_device()) {
+			return;
+		}
+
+		BufferParams params = buffers->params;
+		vector<float> pixels(params.width*params.height*4);
+		if(!buffers->get_pass_rect(PASS_COMBINED, 1.0f, rtile.sample, 4, &pixels[0])) {
+			return;
+		}
+
+		const Film *film = session_->scene->film;
+		const int pass_stride = params.get_passes_size();
+
+		thread_scoped_lock lock(mutex_);
+
+		for(int y = 0; y < params.height; y++) {
+			for(int x = 0; x < params.width; x++) {
+				const int src = x + y*params.width;
+				const int dst = (params.full_x + x) + (params.full_y + y)*image_size;
+
+				for(int i = 0; i < 4; i++) {
+					result_->pixels[dst*4 + i] = pixels[src*4 + i];
+				}
+
+				if(film->adaptive_aux_offset) {
+					const float *aux = buffers->buffer.data() + src*pass_stride + film->adaptive_aux_offset;
+					result_->converged[dst] = (aux[3] != 0.0f);
+				}
+			}
+		}
+	}
+
+protected:
+	Session *session_;
+	RenderResult *result_;
+	thread_mutex mutex_;
+};
+
+Shader *add_shader(Scene *scene, const string& name, ShaderGraph *graph)
+{
+	Shader *shader = new Shader();
+	shader->name = name;
+	shader->graph = graph;
+	scene->shaders.push_back(shader);
+	shader->tag_update(scene);
+	return shader;
+}
+
+void scene_build(Scene *scene)
+{
+	/* Camera at the origin looking along +Z. */
+	Camera *camera = scene->camera;
+	camera->width = image_size;
+	camera->height = image_size;
+	camera->matrix = transform_identity();
+	camera->compute_auto_viewplane();
+	camera->need_update = true;
+
+	/* Constant background. */
+	{
+		ShaderGraph *graph = new ShaderGraph();
+		BackgroundNode *background = new BackgroundNode();
+		background->color = make_float3(0.2f, 0.3f, 0.4f);
+		background->strength = 1.0f;
+		graph->add(background);
+		graph->connect(background->output("Background"), graph->output()->input("Surface"));
+
+		scene->background->shader = add_shader(scene, "background", graph);
+		scene->background->tag_update(scene);
+	}
+
+	/* Diffuse plane covering the right half of the view. */
+	{
+		ShaderGraph *graph = new ShaderGraph();
+		DiffuseBsdfNode *diffuse = new DiffuseBsdfNode();
+		diffuse->color = make_float3(0.8f, 0.8f, 0.8f);
+		graph->add(diffuse);
+		graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+		Mesh *mesh = new Mesh();
+		mesh->used_shaders.push_back(add_shader(scene, "diffuse", graph));
+		mesh->reserve_mesh(4, 2);
+		mesh->add_vertex(make_float3(0.0f, -4.0f, 4.0f));
+		mesh->add_vertex(make_float3(4.0f, -4.0f, 4.0f));
+		mesh->add_vertex(make_float3(4.0f, 4.0f, 4.0f));
+		mesh->add_vertex(make_float3(0.0f, 4.0f, 4.0f));
+		mesh->add_triangle(0, 1, 2, 0, false);
+		mesh->add_triangle(0, 2, 3, 0, false);
+		scene->meshes.push_back(mesh);
+
+		Object *object = new Object();
+		object->mesh = mesh;
+		object->tfm = transform_identity();
+		scene->objects.push_back(object);
+	}
+
+	/* Soft point light in front of the plane. */
+	{
+		ShaderGraph *graph = new ShaderGraph();
+		EmissionNode *emission = new EmissionNode();
+		emission->color = make_float3(1.0f, 1.0f, 1.0f);
+		emission->strength = 200.0f;
+		graph->add(emission);
+		graph->connect(emission->output("Emission"), graph->output()->input("Surface"));
+
+		Light *light = new Light();
+		light->type = LIGHT_POINT;
+		light->co = make_float3(2.0f, 1.0f, 2.5f);
+		light->size = 0.5f;
+		light->shader = add_shader(scene, "light", graph);
+		scene->lights.push_back(light);
+	}
+
+	scene->mesh_manager->tag_update(scene);
+	scene->object_manager->tag_update(scene);
+	scene->light_manager->tag_update(scene);
+}
+
+bool render(int samples, bool adaptive, RenderResult *result)
+{
+	DeviceInfo device_info;
+	bool found = false;
+	foreach(DeviceInfo& info, Device::available_devices()) {
+		if(info.type == DEVICE_CPU) {
+			device_info = info;
+			found = true;
+			break;
+		}
+	}
+	if(!found) {
+		return false;
+	}
+
+	SessionParams session_params;
+	session_params.device = device_info;
+	session_params.background = true;
+	session_params.samples = samples;
+	session_params.tile_size = make_int2(16, 16);
+
+	Session *session = new Session(session_params);
+	session->scene = new Scene(SceneParams(), session->device);
+	scene_build(session->scene);
+
+	Integrator *integrator = session->scene->integrator;
+	integrator->use_adaptive_sampling = adaptive;
+	integrator->tag_update(session->scene);
+
+	TileWriter writer(session, result);
+	session->write_render_tile_cb = function_bind(&TileWriter::write_tile, &writer, _1);
+
+	BufferParams buffer_params;
+	buffer_params.width = image_size;
+	buffer_params.height = image_size;
+	buffer_params.full_width = image_size;
+	buffer_params.full_height = image_size;
+
+	double start_time = time_dt();
+	session->reset(buffer_params, samples);
+	session->start();
+	session->wait();
+	result->time = time_dt() - start_time;
+
+	delete session;
+	return true;
+}
+
+/* Root mean square error of the color against the reference, over one half of the image. */
+float half_rmse(const RenderResult& result, const RenderResult& reference, bool right)
+{
+	double error = 0.0;
+	int num = 0;
+	for(int y = 0; y < image_size; y++) {
+		for(int x = right? image_size/2: 0; x < (right? image_size: image_size/2); x++) {
+			for(int i = 0; i < 3; i++) {
+				int index = (x + y*image_size)*4 + i;
+				double d = result.pixels[index] - reference.pixels[index];
+				error += d*d;
+				num++;
+			}
+		}
+	}
+	return (float)sqrt(error/num);
+}
+
+int count_converged(const RenderResult& result, bool right)
+{
+	int num = 0;
+	for(int y = 0; y < image_size; y++) {
+		for(int x = right? image_size/2: 0; x < (right? image_size: image_size/2); x++) {
+			num += result.converged[x + y*image_size];
+		}
+	}
+	return num;
+}
+
+}  // namespace
+
+TEST(render_adaptive_sampling, noise_and_time)
+{
+	const int samples = 128;
+
+	RenderResult reference, fixed, adaptive;
+	if(!render(samples*8, false, &reference)) {
+		/* No CPU device available. */
+		return;
+	}
+	ASSERT_TRUE(render(samples, false, &fixed));
+	ASSERT_TRUE(render(samples, true, &adaptive));
+
+	const float fixed_left = half_rmse(fixed, reference, false);
+	const float fixed_right = half_rmse(fixed, reference, true);
+	const float adaptive_left = half_rmse(adaptive, reference, false);
+	const float adaptive_right = half_rmse(adaptive, reference, true);
+
+	printf("fixed:    %.3fs, background error %f, plane error %f\n",
+	       fixed.time, fixed_left, fixed_right);
+	printf("adaptive: %.3fs, background error %f, plane error %f, %d/%d converged pixels\n",
+	       adaptive.time, adaptive_left, adaptive_right,
+	       count_converged(adaptive, false) + count_converged(adaptive, true),
+	       image_size*image_size);
+
+	/* The constant background converges, the pixels stop after the minimum samples
+	 * except along the plane border where the noisy pixels are dilated. */
+	EXPECT_GT(count_converged(adaptive, false), image_size*image_size/2*9/10);
+	EXPECT_LT(adaptive_left, fixed_left*1.5f + 1e-4f);
+
+	/* The noisy plane keeps most of its samples, the error stays close to the
+	 * fixed sampling error. */
+	EXPECT_LT(count_converged(adaptive, true), image_size*image_size/2);
+	EXPECT_LT(adaptive_right, fixed_right*1.5f + 1e-4f);
+}
+
+CCL_NAMESPACE_END
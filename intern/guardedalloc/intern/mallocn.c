@@ -132,3 +132,21 @@ void MEM_use_guarded_allocator(void)
 	MEM_name_ptr = MEM_guarded_name_ptr;
 #endif
 }
+
+void MEM_use_pool_allocator(void)
+{
+	MEM_pool_init();
+
+	MEM_freeN = MEM_pool_freeN;
+	MEM_dupallocN = MEM_pool_dupallocN;
+	MEM_reallocN_id = MEM_pool_reallocN_id;
+	MEM_recallocN_id = MEM_pool_recallocN_id;
+	MEM_callocN = MEM_pool_callocN;
+	MEM_calloc_arrayN = MEM_pool_calloc_arrayN;
+	MEM_mallocN = MEM_pool_mallocN;
+	MEM_malloc_arrayN = MEM_pool_malloc_arrayN;
+	MEM_mapallocN = MEM_pool_mapallocN;
+	MEM_printmemlist_stats = MEM_pool_printmemlist_stats;
+	MEM_set_error_callback = MEM_pool_set_error_callback;
+	MEM_set_memory_debug = MEM_pool_set_memory_debug;
+}
@@ -485,6 +485,20 @@ void MEM_lockfree_set_memory_debug(void)
 	malloc_debug_memset = true;
 }
 
+/* Used by the pool allocator, which shares the counters for the blocks it allocates itself. */
+void MEM_lockfree_count_alloc(size_t len)
+{
+	atomic_add_and_fetch_u(&totblock, 1);
+	atomic_add_and_fetch_z(&mem_in_use, len);
+	update_maximum(&peak_mem, mem_in_use);
+}
+
+void MEM_lockfree_count_free(size_t len)
+{
+	atomic_sub_and_fetch_u(&totblock, 1);
+	atomic_sub_and_fetch_z(&mem_in_use, len);
+}
+
 size_t MEM_lockfree_get_memory_in_use(void)
 {
 	return mem_in_use;
@@ -0,0 +1,660 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file guardedalloc/intern/mallocn_pool_impl.c
+ *  \ingroup MEM
+ *
+ * Memory allocation with per-thread caches of small blocks.
+ *
+ * Small blocks are rounded up to a size class and, when freed, kept in a
+ * free list of the thread that allocated them instead of being returned to
+ * the system, so the next allocation of the same class is a pointer pop
+ * without any locking. This helps code allocating many small short-lived
+ * blocks, like the game engine logic and the depsgraph.
+ *
+ * Blocks freed by another thread are pushed on an atomic list of the owning
+ * cache, which the owner takes back when its own free list runs empty. That
+ * list is bounded too, so threads only allocating don't keep blocks freed by
+ * others forever.
+ *
+ * Large, aligned and mapped blocks are handled by the lock-free allocator,
+ * whose counters are shared so #MEM_get_memory_in_use and friends keep
+ * reporting the memory used by Blender, not counting the cached blocks.
+ *
+ * When the MEM_POOL_TRACE environment variable is set to a file path, the
+ * allocations and frees of this allocator are written there, with one "m <id> <len>" or "f <id>" line,
+ * the id being the hexadecimal address of the block. Such traces can be replayed
+ * by the guardedalloc_pool_performance test.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h> /* memcpy */
+#include <stdarg.h>
+#include <sys/types.h>
+
+#if defined(WIN32)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+#include "MEM_guardedalloc.h"
+
+/* to ensure strict conversions */
+#include "../../source/blender/blenlib/BLI_strict_flags.h"
+
+#include "atomic_ops.h"
+#include "mallocn_intern.h"
+
+/* Must match the MemHead of the lock-free allocator, so #MEM_lockfree_allocN_len
+ * and the flag checks work on pool blocks too. */
+typedef struct PoolHead {
+	union {
+		/* Cache the block belongs to, while allocated. */
+		struct PoolCache *cache;
+		/* Next free block, while in a free list. */
+		struct PoolHead *next;
+	} u;
+	/* Length of allocated memory block, never has flags set. */
+	size_t len;
+} PoolHead;
+
+#define POOLHEAD_FROM_PTR(ptr) (((PoolHead *) ptr) - 1)
+#define PTR_FROM_POOLHEAD(poolhead) (poolhead + 1)
+
+/* Lengths are rounded up to a multiple of the class size. */
+#define POOL_CLASS_SHIFT 4
+#define POOL_CLASS_SIZE (1 << POOL_CLASS_SHIFT)
+/* Largest block length kept in the caches, larger blocks go to the system directly. */
+#define POOL_LEN_MAX 512
+#define POOL_NUM_CLASSES ((POOL_LEN_MAX >> POOL_CLASS_SHIFT) + 1)
+/* Memory kept in each free list and in the list of remotely freed blocks of a cache,
+ * the rest is returned to the system. */
+#define POOL_CACHE_BYTES (64 * 1024)
+
+#define POOL_CLASS_FROM_LEN(len) (((len) + (POOL_CLASS_SIZE - 1)) >> POOL_CLASS_SHIFT)
+#define POOL_BLOCK_SIZE(cls) (sizeof(PoolHead) + ((size_t)(cls) << POOL_CLASS_SHIFT))
+
+/* The flags of the lock-free allocator, see #MemHead. */
+#define POOL_LEN_ALIGN_FLAG ((size_t) 2)
+#define POOL_LEN_FLAGS ((size_t) 3)
+
+typedef struct PoolCache {
+	PoolHead *free_list[POOL_NUM_CLASSES];
+	unsigned int num_free[POOL_NUM_CLASSES];
+
+	/* Blocks freed by other threads and their size, only accessed atomically. */
+	PoolHead *remote_free;
+	size_t remote_bytes;
+
+	/* All caches, caches are never freed. */
+	struct PoolCache *next;
+	/* Caches of finished threads, waiting to be adopted by a new thread. */
+	struct PoolCache *next_orphan;
+
+	/* Statistics, only written by the owning thread. */
+	size_t num_hits, num_misses, num_remote;
+} PoolCache;
+
+#if defined(_MSC_VER)
+#  define POOL_THREAD_LOCAL __declspec(thread)
+#else
+#  define POOL_THREAD_LOCAL __thread
+#endif
+
+static POOL_THREAD_LOCAL PoolCache *thread_cache = NULL;
+
+#if defined(WIN32)
+static DWORD thread_exit_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t thread_exit_key;
+#endif
+static bool thread_exit_key_valid = false;
+
+static PoolCache *all_caches = NULL;
+static PoolCache *orphan_caches = NULL;
+static unsigned int caches_lock = 0;
+
+static bool malloc_debug_memset = false;
+
+/* Allocation trace, see MEM_POOL_TRACE. */
+static FILE *trace_file = NULL;
+
+static void (*error_callback)(const char *) = NULL;
+
+#ifdef __GNUC__
+__attribute__ ((format(printf, 1, 2)))
+#endif
+static void print_error(const char *str, ...)
+{
+	char buf[512];
+	va_list ap;
+
+	va_start(ap, str);
+	vsnprintf(buf, sizeof(buf), str, ap);
+	va_end(ap);
+	buf[sizeof(buf) - 1] = '\0';
+
+	if (error_callback) {
+		error_callback(buf);
+	}
+}
+
+/* Creating and retiring caches is rare, a spin lock is enough. */
+static void caches_lock_acquire(void)
+{
+	while (atomic_cas_u(&caches_lock, 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+static void caches_lock_release(void)
+{
+	atomic_cas_u(&caches_lock, 1, 0);
+}
+
+/* Stdio writes are locked, lines of different threads are not mixed.
+ * A free is written before the block can be reused, an allocation after. */
+MEM_INLINE void pool_trace_alloc(const void *vmemh, size_t len)
+{
+	if (UNLIKELY(trace_file && vmemh)) {
+		fprintf(trace_file, "m %llx " SIZET_FORMAT "\n", (unsigned long long)(uintptr_t)vmemh, SIZET_ARG(len));
+	}
+}
+
+MEM_INLINE void pool_trace_free(const void *vmemh)
+{
+	if (UNLIKELY(trace_file)) {
+		fprintf(trace_file, "f %llx\n", (unsigned long long)(uintptr_t)vmemh);
+	}
+}
+
+/* Take all blocks freed by other threads, the caller subtracts their size from remote_bytes. */
+static PoolHead *pool_cache_take_remote(PoolCache *cache)
+{
+	PoolHead *list;
+	do {
+		list = atomic_load_ptr((void *const *)&cache->remote_free);
+	} while (atomic_cas_ptr((void **)&cache->remote_free, list, NULL) != list);
+	return list;
+}
+
+static void pool_cache_push_remote(PoolCache *cache, PoolHead *poolh)
+{
+	const size_t size = POOL_BLOCK_SIZE(POOL_CLASS_FROM_LEN(poolh->len));
+	PoolHead *list;
+
+	/* The owner may not allocate anymore, don't keep more than a free list. */
+	if (atomic_add_and_fetch_z(&cache->remote_bytes, size) > POOL_CACHE_BYTES) {
+		atomic_sub_and_fetch_z(&cache->remote_bytes, size);
+		free(poolh);
+		return;
+	}
+
+	do {
+		list = atomic_load_ptr((void *const *)&cache->remote_free);
+		poolh->u.next = list;
+	} while (atomic_cas_ptr((void **)&cache->remote_free, list, poolh) != list);
+}
+
+static void pool_cache_flush(PoolCache *cache)
+{
+	PoolHead *poolh, *poolh_next;
+	unsigned int cls;
+
+	for (cls = 0; cls < POOL_NUM_CLASSES; cls++) {
+		for (poolh = cache->free_list[cls]; poolh; poolh = poolh_next) {
+			poolh_next = poolh->u.next;
+			free(poolh);
+		}
+		cache->free_list[cls] = NULL;
+		cache->num_free[cls] = 0;
+	}
+
+	for (poolh = pool_cache_take_remote(cache); poolh; poolh = poolh_next) {
+		poolh_next = poolh->u.next;
+		atomic_sub_and_fetch_z(&cache->remote_bytes, POOL_BLOCK_SIZE(POOL_CLASS_FROM_LEN(poolh->len)));
+		free(poolh);
+	}
+}
+
+/* Called when a thread exits, blocks of the cache which are still in use
+ * may be freed later on by other threads, so the cache itself is kept
+ * for the next new thread. */
+#if defined(WIN32)
+static void WINAPI pool_thread_exit(void *data)
+#else
+static void pool_thread_exit(void *data)
+#endif
+{
+	PoolCache *cache = data;
+
+	if (cache == NULL) {
+		return;
+	}
+
+	thread_cache = NULL;
+	pool_cache_flush(cache);
+
+	caches_lock_acquire();
+	cache->next_orphan = orphan_caches;
+	orphan_caches = cache;
+	caches_lock_release();
+}
+
+static PoolCache *pool_thread_cache_init(void)
+{
+	PoolCache *cache;
+
+	caches_lock_acquire();
+	cache = orphan_caches;
+	if (cache) {
+		orphan_caches = cache->next_orphan;
+		cache->next_orphan = NULL;
+	}
+	caches_lock_release();
+
+	if (cache == NULL) {
+		cache = calloc(1, sizeof(PoolCache));
+		if (UNLIKELY(cache == NULL)) {
+			return NULL;
+		}
+
+		caches_lock_acquire();
+		cache->next = all_caches;
+		all_caches = cache;
+		caches_lock_release();
+	}
+
+	if (thread_exit_key_valid) {
+#if defined(WIN32)
+		FlsSetValue(thread_exit_key, cache);
+#else
+		pthread_setspecific(thread_exit_key, cache);
+#endif
+	}
+
+	thread_cache = cache;
+	return cache;
+}
+
+MEM_INLINE PoolCache *pool_thread_cache_get(void)
+{
+	PoolCache *cache = thread_cache;
+	if (UNLIKELY(cache == NULL)) {
+		cache = pool_thread_cache_init();
+	}
+	return cache;
+}
+
+MEM_INLINE bool pool_cache_is_full(const PoolCache *cache, unsigned int cls)
+{
+	return cache->num_free[cls] * POOL_BLOCK_SIZE(cls) >= POOL_CACHE_BYTES;
+}
+
+MEM_INLINE bool pool_len_is_pooled(size_t len)
+{
+	/* Also rejects the flags of the lock-free allocator. */
+	return (len <= POOL_LEN_MAX) && ((len & POOL_LEN_FLAGS) == 0);
+}
+
+static void *pool_block_alloc(size_t len, bool zero, const char *str)
+{
+	PoolCache *cache = pool_thread_cache_get();
+	const unsigned int cls = (unsigned int)POOL_CLASS_FROM_LEN(len);
+	PoolHead *poolh = NULL;
+
+	if (LIKELY(cache)) {
+		poolh = cache->free_list[cls];
+		if (poolh == NULL && atomic_load_ptr((void *const *)&cache->remote_free)) {
+			PoolHead *poolh_next;
+			size_t remote_bytes = 0;
+
+			/* Blocks of all classes are in the remote list, sort them into the free lists. */
+			for (poolh = pool_cache_take_remote(cache); poolh; poolh = poolh_next) {
+				const unsigned int poolh_cls = (unsigned int)POOL_CLASS_FROM_LEN(poolh->len);
+				poolh_next = poolh->u.next;
+				remote_bytes += POOL_BLOCK_SIZE(poolh_cls);
+				cache->num_remote++;
+				if (pool_cache_is_full(cache, poolh_cls)) {
+					free(poolh);
+					continue;
+				}
+				poolh->u.next = cache->free_list[poolh_cls];
+				cache->free_list[poolh_cls] = poolh;
+				cache->num_free[poolh_cls]++;
+			}
+			atomic_sub_and_fetch_z(&cache->remote_bytes, remote_bytes);
+			poolh = cache->free_list[cls];
+		}
+
+		if (poolh) {
+			cache->free_list[cls] = poolh->u.next;
+			cache->num_free[cls]--;
+			cache->num_hits++;
+			if (zero) {
+				memset(PTR_FROM_POOLHEAD(poolh), 0, len);
+			}
+		}
+		else {
+			cache->num_misses++;
+		}
+	}
+
+	if (poolh == NULL) {
+		const size_t size = POOL_BLOCK_SIZE(cls);
+		poolh = zero ? calloc(1, size) : malloc(size);
+
+		if (UNLIKELY(poolh == NULL)) {
+			print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+			            SIZET_ARG(len), str, (unsigned int) MEM_lockfree_get_memory_in_use());
+			return NULL;
+		}
+	}
+
+	if (UNLIKELY(malloc_debug_memset && !zero && len)) {
+		memset(PTR_FROM_POOLHEAD(poolh), 255, len);
+	}
+
+	poolh->u.cache = cache;
+	poolh->len = len;
+	MEM_lockfree_count_alloc(len);
+
+	return PTR_FROM_POOLHEAD(poolh);
+}
+
+static void pool_block_free(PoolHead *poolh)
+{
+	PoolCache *owner = poolh->u.cache;
+	const size_t len = poolh->len;
+
+	MEM_lockfree_count_free(len);
+
+	if (UNLIKELY(malloc_debug_memset && len)) {
+		memset(PTR_FROM_POOLHEAD(poolh), 255, len);
+	}
+
+	if (LIKELY(owner && owner == thread_cache)) {
+		const unsigned int cls = (unsigned int)POOL_CLASS_FROM_LEN(len);
+
+		if (!pool_cache_is_full(owner, cls)) {
+			poolh->u.next = owner->free_list[cls];
+			owner->free_list[cls] = poolh;
+			owner->num_free[cls]++;
+			return;
+		}
+	}
+	else if (owner) {
+		pool_cache_push_remote(owner, poolh);
+		return;
+	}
+
+	free(poolh);
+}
+
+void MEM_pool_init(void)
+{
+	const char *trace_path;
+
+	if (thread_exit_key_valid) {
+		return;
+	}
+
+	trace_path = getenv("MEM_POOL_TRACE");
+	if (trace_path && trace_path[0]) {
+		/* Left open, it's flushed and closed when exiting. */
+		trace_file = fopen(trace_path, "w");
+		if (trace_file == NULL) {
+			print_error("Can't open the allocation trace file %s\n", trace_path);
+		}
+	}
+
+#if defined(WIN32)
+	thread_exit_key = FlsAlloc(pool_thread_exit);
+	thread_exit_key_valid = (thread_exit_key != FLS_OUT_OF_INDEXES);
+#else
+	thread_exit_key_valid = (pthread_key_create(&thread_exit_key, pool_thread_exit) == 0);
+#endif
+}
+
+void MEM_pool_freeN(void *vmemh)
+{
+	PoolHead *poolh;
+
+	if (vmemh == NULL) {
+		print_error("Attempt to free NULL pointer\n");
+#ifdef WITH_ASSERT_ABORT
+		abort();
+#endif
+		return;
+	}
+
+	pool_trace_free(vmemh);
+
+	poolh = POOLHEAD_FROM_PTR(vmemh);
+	if (pool_len_is_pooled(poolh->len)) {
+		pool_block_free(poolh);
+	}
+	else {
+		MEM_lockfree_freeN(vmemh);
+	}
+}
+
+void *MEM_pool_dupallocN(const void *vmemh)
+{
+	void *newp = NULL;
+	if (vmemh) {
+		const PoolHead *poolh = POOLHEAD_FROM_PTR(vmemh);
+		if (!pool_len_is_pooled(poolh->len)) {
+			newp = MEM_lockfree_dupallocN(vmemh);
+			pool_trace_alloc(newp, MEM_lockfree_allocN_len(vmemh));
+			return newp;
+		}
+		newp = MEM_pool_mallocN(poolh->len, "dupli_malloc");
+		if (newp) {
+			memcpy(newp, vmemh, poolh->len);
+		}
+	}
+	return newp;
+}
+
+void *MEM_pool_reallocN_id(void *vmemh, size_t len, const char *str)
+{
+	void *newp = NULL;
+
+	if (vmemh) {
+		const size_t old_len = MEM_lockfree_allocN_len(vmemh);
+
+		if (UNLIKELY(POOLHEAD_FROM_PTR(vmemh)->len & POOL_LEN_ALIGN_FLAG)) {
+			pool_trace_free(vmemh);
+			newp = MEM_lockfree_reallocN_id(vmemh, len, str);
+			pool_trace_alloc(newp, len);
+			return newp;
+		}
+
+		newp = MEM_pool_mallocN(len, "realloc");
+		if (newp) {
+			memcpy(newp, vmemh, (len < old_len) ? len : old_len);
+		}
+
+		MEM_pool_freeN(vmemh);
+	}
+	else {
+		newp = MEM_pool_mallocN(len, str);
+	}
+
+	return newp;
+}
+
+void *MEM_pool_recallocN_id(void *vmemh, size_t len, const char *str)
+{
+	void *newp = NULL;
+
+	if (vmemh) {
+		const size_t old_len = MEM_lockfree_allocN_len(vmemh);
+
+		if (UNLIKELY(POOLHEAD_FROM_PTR(vmemh)->len & POOL_LEN_ALIGN_FLAG)) {
+			pool_trace_free(vmemh);
+			newp = MEM_lockfree_recallocN_id(vmemh, len, str);
+			pool_trace_alloc(newp, len);
+			return newp;
+		}
+
+		newp = MEM_pool_mallocN(len, "recalloc");
+		if (newp) {
+			if (len < old_len) {
+				/* shrink */
+				memcpy(newp, vmemh, len);
+			}
+			else {
+				memcpy(newp, vmemh, old_len);
+
+				if (len > old_len) {
+					/* grow */
+					/* zero new bytes */
+					memset(((char *)newp) + old_len, 0, len - old_len);
+				}
+			}
+		}
+
+		MEM_pool_freeN(vmemh);
+	}
+	else {
+		newp = MEM_pool_callocN(len, str);
+	}
+
+	return newp;
+}
+
+void *MEM_pool_callocN(size_t len, const char *str)
+{
+	void *vmemh;
+
+	len = SIZET_ALIGN_4(len);
+
+	if (LIKELY(len <= POOL_LEN_MAX)) {
+		vmemh = pool_block_alloc(len, true, str);
+	}
+	else {
+		vmemh = MEM_lockfree_callocN(len, str);
+	}
+	pool_trace_alloc(vmemh, len);
+	return vmemh;
+}
+
+void *MEM_pool_calloc_arrayN(size_t len, size_t size, const char *str)
+{
+	size_t total_size;
+	if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+		print_error("Calloc array aborted due to integer overflow: "
+		            "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+		            SIZET_ARG(len), SIZET_ARG(size), str,
+		            (unsigned int) MEM_lockfree_get_memory_in_use());
+		abort();
+		return NULL;
+	}
+
+	return MEM_pool_callocN(total_size, str);
+}
+
+void *MEM_pool_mallocN(size_t len, const char *str)
+{
+	void *vmemh;
+
+	len = SIZET_ALIGN_4(len);
+
+	if (LIKELY(len <= POOL_LEN_MAX)) {
+		vmemh = pool_block_alloc(len, false, str);
+	}
+	else {
+		vmemh = MEM_lockfree_mallocN(len, str);
+	}
+	pool_trace_alloc(vmemh, len);
+	return vmemh;
+}
+
+void *MEM_pool_malloc_arrayN(size_t len, size_t size, const char *str)
+{
+	size_t total_size;
+	if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+		print_error("Malloc array aborted due to integer overflow: "
+		            "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+		            SIZET_ARG(len), SIZET_ARG(size), str,
+		            (unsigned int) MEM_lockfree_get_memory_in_use());
+		abort();
+		return NULL;
+	}
+
+	return MEM_pool_mallocN(total_size, str);
+}
+
+void *MEM_pool_mapallocN(size_t len, const char *str)
+{
+	void *vmemh;
+
+	/* Small blocks are never worth a mapping, larger ones are handled by
+	 * the lock-free allocator which only maps them on 32 bit. */
+	if (SIZET_ALIGN_4(len) <= POOL_LEN_MAX) {
+		return MEM_pool_callocN(len, str);
+	}
+	vmemh = MEM_lockfree_mapallocN(len, str);
+	pool_trace_alloc(vmemh, len);
+	return vmemh;
+}
+
+void MEM_pool_printmemlist_stats(void)
+{
+	const PoolCache *cache;
+	size_t num_hits = 0, num_misses = 0, num_remote = 0, cached = 0;
+	unsigned int num_caches = 0, cls;
+
+	MEM_lockfree_printmemlist_stats();
+
+	/* Only approximate, other threads keep on using their caches. */
+	caches_lock_acquire();
+	for (cache = all_caches; cache; cache = cache->next) {
+		num_hits += cache->num_hits;
+		num_misses += cache->num_misses;
+		num_remote += cache->num_remote;
+		for (cls = 0; cls < POOL_NUM_CLASSES; cls++) {
+			cached += cache->num_free[cls] * POOL_BLOCK_SIZE(cls);
+		}
+		num_caches++;
+	}
+	caches_lock_release();
+
+	printf("\nthread caches: %u, cached memory len: %.3f MB\n",
+	       num_caches, (double)cached / (double)(1024 * 1024));
+	printf("cache hits: " SIZET_FORMAT ", misses: " SIZET_FORMAT ", freed by other threads: " SIZET_FORMAT "\n",
+	       SIZET_ARG(num_hits), SIZET_ARG(num_misses), SIZET_ARG(num_remote));
+}
+
+void MEM_pool_set_error_callback(void (*func)(const char *))
+{
+	error_callback = func;
+	MEM_lockfree_set_error_callback(func);
+}
+
+void MEM_pool_set_memory_debug(void)
+{
+	malloc_debug_memset = true;
+	MEM_lockfree_set_memory_debug();
+}
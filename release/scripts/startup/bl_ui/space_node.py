@@ -426,6 +426,7 @@ class NODE_PT_quality(bpy.types.Panel):
         col = layout.column()
         col.prop(tree, "use_opencl")
         col.prop(tree, "use_groupnode_buffer")
+        col.prop(tree, "use_buffer_cache")
         col.prop(tree, "use_two_pass")
         col.prop(tree, "use_viewer_border")
 
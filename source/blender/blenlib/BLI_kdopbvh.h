@@ -155,6 +155,16 @@ void BLI_bvhtree_ray_cast_all(
         BVHTree *tree, const float co[3], const float dir[3], float radius, float hit_dist,
         BVHTree_RayCastCallback callback, void *userdata);
 
+/* batched queries, callbacks must be thread-safe */
+void BLI_bvhtree_ray_cast_batch(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], int rays_num, float radius,
+        BVHTreeRayHit *hits,
+        BVHTree_RayCastCallback callback, void *userdata,
+        int flag);
+void BLI_bvhtree_find_nearest_batch(
+        BVHTree *tree, const float (*co)[3], int co_num, BVHTreeNearest *nearest,
+        BVHTree_NearestPointCallback callback, void *userdata);
+
 float BLI_bvhtree_bb_raycast(const float bv[6], const float light_start[3], const float light_end[3], float pos[3]);
 
 /* range query */
@@ -44,6 +44,8 @@
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
  * - Range Query:
  *   #BLI_bvhtree_range_query
+ * - Batched ray-cast and nearest point, with packets of rays or points:
+ *   #BLI_bvhtree_ray_cast_batch, #BLI_bvhtree_find_nearest_batch
  */
 
 #include <assert.h>
@@ -55,6 +57,7 @@
 #include "BLI_stack.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_math.h"
+#include "BLI_math_bits.h"
 #include "BLI_task.h"
 
 #include "BLI_strict_flags.h"
@@ -76,8 +79,10 @@
  */
 #ifdef DEBUG
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 0
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 0
 #else
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 256
 #endif
 
 
@@ -1924,6 +1929,524 @@ void BLI_bvhtree_ray_cast_all(
 	BLI_bvhtree_ray_cast_all_ex(tree, co, dir, radius, hit_dist, callback, userdata, BVH_RAYCAST_DEFAULT);
 }
 
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+
+/** \name BLI_bvhtree_ray_cast_batch / BLI_bvhtree_find_nearest_batch
+ *
+ * Batched queries traverse the tree with packets of #BVH_PACKET_SIZE rays or points,
+ * so the nodes are fetched once per packet and their bounds are tested against all
+ * the packet lanes at once, using SSE when available. Packets are distributed over
+ * threads.
+ *
+ * The bounds tests do the same floating point operations per lane as the single
+ * queries, and a lane only enters a node when the single query would, so results
+ * are the same (up to hits at exactly the same distance), only the order of the
+ * callback calls differs.
+ *
+ * \{ */
+
+#define BVH_PACKET_SIZE 4
+
+typedef struct BVHPacketStackItem {
+	BVHNode *node;
+	/* Lanes entering the node. */
+	int mask;
+} BVHPacketStackItem;
+
+typedef struct BVHRayPacket {
+	BVHRayCastData data[BVH_PACKET_SIZE];
+	float hit_dist[BVH_PACKET_SIZE];
+	int mask;
+#ifdef __SSE2__
+	/* Structure of arrays copy of the rays, for the SIMD tests. */
+	__m128 origin[3];
+	__m128 ray_dot_axis[3];
+	__m128 idot_axis[3];
+	__m128 idot_neg[3];
+	__m128 radius;
+#endif
+} BVHRayPacket;
+
+typedef struct BVHNearestPacket {
+	BVHNearestData data[BVH_PACKET_SIZE];
+	float dist_sq[BVH_PACKET_SIZE];
+	int mask;
+#ifdef __SSE2__
+	__m128 proj[3];
+#endif
+} BVHNearestPacket;
+
+typedef struct BVHBatchData {
+	BVHTree *tree;
+	const float (*co)[3];
+	const float (*dir)[3];
+	int num;
+	float radius;
+	int flag;
+
+	BVHTreeRayHit *hits;
+	BVHTree_RayCastCallback raycast_callback;
+
+	BVHTreeNearest *nearest;
+	BVHTree_NearestPointCallback nearest_callback;
+
+	void *userdata;
+} BVHBatchData;
+
+/* Enough for the depth first traversal of the (balanced) tree, without recursion. */
+static int bvhtree_packet_stack_size(const BVHTree *tree)
+{
+	int depth = 1, num = tree->totleaf;
+	while (num > 1) {
+		num = (num + tree->tree_type - 1) / tree->tree_type;
+		depth++;
+	}
+	return (depth + 1) * tree->tree_type;
+}
+
+#ifdef __SSE2__
+MINLINE __m128 sse_select(const __m128 mask, const __m128 a, const __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+MINLINE __m128 sse_get_lanes(const float lanes[BVH_PACKET_SIZE])
+{
+	return _mm_loadu_ps(lanes);
+}
+#endif
+
+/* Packet version of #fast_ray_nearest_hit and #ray_nearest_hit,
+ * returns the lanes of \a mask entering the node. */
+static int ray_packet_nearest_hit(const BVHRayPacket *packet, const BVHNode *node, int mask, float r_dist[BVH_PACKET_SIZE])
+{
+#ifdef __SSE2__
+	const float *bv = node->bv;
+	const __m128 hit_dist = sse_get_lanes(packet->hit_dist);
+	const __m128 zero = _mm_setzero_ps();
+	__m128 dist;
+	int i;
+
+	if (packet->data[0].ray.radius == 0.0f) {
+		__m128 t1[3], t2[3], cull;
+
+		for (i = 0; i != 3; i++) {
+			const __m128 lo = _mm_set1_ps(bv[2 * i]);
+			const __m128 hi = _mm_set1_ps(bv[2 * i + 1]);
+			t1[i] = _mm_mul_ps(_mm_sub_ps(sse_select(packet->idot_neg[i], hi, lo), packet->origin[i]), packet->idot_axis[i]);
+			t2[i] = _mm_mul_ps(_mm_sub_ps(sse_select(packet->idot_neg[i], lo, hi), packet->origin[i]), packet->idot_axis[i]);
+		}
+
+		cull = _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(t1[0], t2[1]), _mm_cmplt_ps(t2[0], t1[1])),
+		                 _mm_or_ps(_mm_cmpgt_ps(t1[0], t2[2]), _mm_cmplt_ps(t2[0], t1[2])));
+		cull = _mm_or_ps(cull, _mm_or_ps(_mm_cmpgt_ps(t1[1], t2[2]), _mm_cmplt_ps(t2[1], t1[2])));
+		cull = _mm_or_ps(cull, _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(t2[0], zero), _mm_cmplt_ps(t2[1], zero)),
+		                                 _mm_cmplt_ps(t2[2], zero)));
+		cull = _mm_or_ps(cull, _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(t1[0], hit_dist), _mm_cmpgt_ps(t1[1], hit_dist)),
+		                                 _mm_cmpgt_ps(t1[2], hit_dist)));
+
+		/* Same as max_fff(). */
+		dist = _mm_max_ps(_mm_max_ps(t1[0], t1[1]), t1[2]);
+		dist = sse_select(cull, _mm_set1_ps(FLT_MAX), dist);
+	}
+	else {
+		__m128 low = zero, upper = hit_dist, cull = zero;
+
+		for (i = 0; i != 3; i++) {
+			const __m128 lo = _mm_sub_ps(_mm_set1_ps(bv[2 * i]), packet->radius);
+			const __m128 hi = _mm_add_ps(_mm_set1_ps(bv[2 * i + 1]), packet->radius);
+			const __m128 axis_aligned = _mm_cmpeq_ps(packet->ray_dot_axis[i], zero);
+			const __m128 positive = _mm_cmpgt_ps(packet->ray_dot_axis[i], zero);
+			/* Avoid dividing by zero for axis aligned lanes, their result isn't used. */
+			const __m128 dot = sse_select(axis_aligned, _mm_set1_ps(1.0f), packet->ray_dot_axis[i]);
+			const __m128 ll = _mm_div_ps(_mm_sub_ps(lo, packet->origin[i]), dot);
+			const __m128 lu = _mm_div_ps(_mm_sub_ps(hi, packet->origin[i]), dot);
+			const __m128 low_axis = sse_select(positive, _mm_max_ps(ll, low), _mm_max_ps(lu, low));
+			const __m128 upper_axis = sse_select(positive, _mm_min_ps(lu, upper), _mm_min_ps(ll, upper));
+			const __m128 outside = _mm_or_ps(_mm_cmplt_ps(packet->origin[i], lo), _mm_cmpgt_ps(packet->origin[i], hi));
+
+			low = sse_select(axis_aligned, low, low_axis);
+			upper = sse_select(axis_aligned, upper, upper_axis);
+			cull = _mm_or_ps(cull, sse_select(axis_aligned, outside, _mm_cmpgt_ps(low, upper)));
+		}
+
+		dist = sse_select(cull, _mm_set1_ps(FLT_MAX), low);
+	}
+
+	_mm_storeu_ps(r_dist, dist);
+	/* Not '<' so NaN distances enter the node, like with the single ray cast. */
+	return mask & _mm_movemask_ps(_mm_cmpnge_ps(dist, hit_dist));
+#else
+	int lane;
+
+	for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+		if (mask & (1 << lane)) {
+			const BVHRayCastData *data = &packet->data[lane];
+			r_dist[lane] = (data->ray.radius == 0.0f) ? fast_ray_nearest_hit(data, node) : ray_nearest_hit(data, node->bv);
+			if (r_dist[lane] >= packet->hit_dist[lane]) {
+				mask &= ~(1 << lane);
+			}
+		}
+	}
+	return mask;
+#endif
+}
+
+static void ray_packet_traverse(BVHRayPacket *packet, BVHNode *root, BVHPacketStackItem *stack)
+{
+	int stack_size = 0;
+
+	stack[stack_size].node = root;
+	stack[stack_size].mask = packet->mask;
+	stack_size++;
+
+	while (stack_size) {
+		float dist[BVH_PACKET_SIZE];
+		BVHNode *node;
+		int mask, lane, i;
+
+		stack_size--;
+		node = stack[stack_size].node;
+		mask = ray_packet_nearest_hit(packet, node, stack[stack_size].mask, dist);
+		if (mask == 0) {
+			continue;
+		}
+
+		if (node->totnode == 0) {
+			for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+				if (mask & (1 << lane)) {
+					BVHRayCastData *data = &packet->data[lane];
+					if (data->callback) {
+						data->callback(data->userdata, node->index, &data->ray, &data->hit);
+					}
+					else {
+						data->hit.index = node->index;
+						data->hit.dist  = dist[lane];
+						madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist[lane]);
+					}
+					packet->hit_dist[lane] = data->hit.dist;
+				}
+			}
+		}
+		else {
+			/* Pick the order like #dfs_raycast does for the first lane,
+			 * pushing the children to visit first last. */
+			const BVHRayCastData *data = &packet->data[bitscan_forward_i(mask)];
+			if (data->ray_dot_axis[node->main_axis] > 0.0f) {
+				for (i = node->totnode - 1; i >= 0; i--) {
+					stack[stack_size].node = node->children[i];
+					stack[stack_size].mask = mask;
+					stack_size++;
+				}
+			}
+			else {
+				for (i = 0; i != node->totnode; i++) {
+					stack[stack_size].node = node->children[i];
+					stack[stack_size].mask = mask;
+					stack_size++;
+				}
+			}
+		}
+	}
+}
+
+static void bvhtree_ray_cast_batch_task_cb(
+        void *__restrict userdata,
+        const int packet_index,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const BVHBatchData *batch = userdata;
+	BVHTree *tree = batch->tree;
+	BVHRayPacket packet;
+	BVHPacketStackItem *stack = BLI_array_alloca(stack, (size_t)bvhtree_packet_stack_size(tree));
+	const int start = packet_index * BVH_PACKET_SIZE;
+	const int lanes = min_ii(BVH_PACKET_SIZE, batch->num - start);
+	int lane, i;
+
+	packet.mask = 0;
+	for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+		/* Unused lanes copy the first ray, their results are ignored. */
+		const int ray_index = start + ((lane < lanes) ? lane : 0);
+		BVHRayCastData *data = &packet.data[lane];
+
+		BLI_ASSERT_UNIT_V3(batch->dir[ray_index]);
+
+		data->tree = tree;
+		data->callback = batch->raycast_callback;
+		data->userdata = batch->userdata;
+
+		copy_v3_v3(data->ray.origin,    batch->co[ray_index]);
+		copy_v3_v3(data->ray.direction, batch->dir[ray_index]);
+		data->ray.radius = batch->radius;
+
+		bvhtree_ray_cast_data_precalc(data, batch->flag);
+
+		memcpy(&data->hit, &batch->hits[ray_index], sizeof(data->hit));
+		packet.hit_dist[lane] = data->hit.dist;
+
+		if (lane < lanes) {
+			packet.mask |= 1 << lane;
+		}
+	}
+
+#ifdef __SSE2__
+	for (i = 0; i < 3; i++) {
+		packet.origin[i] = _mm_setr_ps(
+		        packet.data[0].ray.origin[i], packet.data[1].ray.origin[i],
+		        packet.data[2].ray.origin[i], packet.data[3].ray.origin[i]);
+		packet.ray_dot_axis[i] = _mm_setr_ps(
+		        packet.data[0].ray_dot_axis[i], packet.data[1].ray_dot_axis[i],
+		        packet.data[2].ray_dot_axis[i], packet.data[3].ray_dot_axis[i]);
+		packet.idot_axis[i] = _mm_setr_ps(
+		        packet.data[0].idot_axis[i], packet.data[1].idot_axis[i],
+		        packet.data[2].idot_axis[i], packet.data[3].idot_axis[i]);
+		packet.idot_neg[i] = _mm_cmplt_ps(packet.idot_axis[i], _mm_setzero_ps());
+	}
+	packet.radius = _mm_set1_ps(batch->radius);
+#else
+	UNUSED_VARS(i);
+#endif
+
+	ray_packet_traverse(&packet, tree->nodes[tree->totleaf], stack);
+
+	for (lane = 0; lane < lanes; lane++) {
+		memcpy(&batch->hits[start + lane], &packet.data[lane].hit, sizeof(packet.data[lane].hit));
+	}
+}
+
+/**
+ * Cast many rays at once, gives the same results as calling #BLI_bvhtree_ray_cast_ex for each ray.
+ *
+ * Consecutive rays are traversed together, so it's fastest when they are coherent
+ * (close origins and similar directions, as for neighbor pixels or vertices).
+ *
+ * \param hits: Input and output for each ray, initialized like the \a hit of the single ray cast
+ * (index -1 and the maximum distance, usually #BVH_RAYCAST_DIST_MAX).
+ * \param callback: Called from multiple threads, must be thread-safe.
+ */
+void BLI_bvhtree_ray_cast_batch(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], int rays_num, float radius,
+        BVHTreeRayHit *hits,
+        BVHTree_RayCastCallback callback, void *userdata,
+        int flag)
+{
+	BVHBatchData batch = {NULL};
+	const int packets_num = (rays_num + BVH_PACKET_SIZE - 1) / BVH_PACKET_SIZE;
+
+	if (tree->nodes[tree->totleaf] == NULL || rays_num == 0) {
+		return;
+	}
+
+	batch.tree = tree;
+	batch.co = co;
+	batch.dir = dir;
+	batch.num = rays_num;
+	batch.radius = radius;
+	batch.flag = flag;
+	batch.hits = hits;
+	batch.raycast_callback = callback;
+	batch.userdata = userdata;
+
+	ParallelRangeSettings settings;
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.use_threading = (rays_num > KDOPBVH_THREAD_QUERY_THRESHOLD);
+	settings.scheduling_mode = TASK_SCHEDULING_DYNAMIC;
+	BLI_task_parallel_range(
+	            0, packets_num,
+	            &batch,
+	            bvhtree_ray_cast_batch_task_cb,
+	            &settings);
+}
+
+/* Packet version of #calc_nearest_point_squared,
+ * returns the lanes of \a mask which may have a point nearer than their current nearest. */
+static int nearest_packet_test(const BVHNearestPacket *packet, BVHNode *node, int mask)
+{
+#ifdef __SSE2__
+	const float *bv = node->bv;
+	__m128 d[3], dist_sq;
+	int i;
+
+	for (i = 0; i != 3; i++) {
+		const __m128 lo = _mm_set1_ps(bv[2 * i]);
+		const __m128 hi = _mm_set1_ps(bv[2 * i + 1]);
+		const __m128 nearest = sse_select(_mm_cmpgt_ps(lo, packet->proj[i]), lo, _mm_min_ps(hi, packet->proj[i]));
+		d[i] = _mm_sub_ps(packet->proj[i], nearest);
+	}
+	dist_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], d[0]), _mm_mul_ps(d[1], d[1])), _mm_mul_ps(d[2], d[2]));
+
+	return mask & _mm_movemask_ps(_mm_cmpnge_ps(dist_sq, sse_get_lanes(packet->dist_sq)));
+#else
+	int lane;
+
+	for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+		if (mask & (1 << lane)) {
+			float nearest[3];
+			if (calc_nearest_point_squared(packet->data[lane].proj, node, nearest) >= packet->dist_sq[lane]) {
+				mask &= ~(1 << lane);
+			}
+		}
+	}
+	return mask;
+#endif
+}
+
+static void nearest_packet_traverse(BVHNearestPacket *packet, BVHNode *root, BVHPacketStackItem *stack)
+{
+	int stack_size = 0;
+
+	stack[stack_size].node = root;
+	stack[stack_size].mask = packet->mask;
+	stack_size++;
+
+	while (stack_size) {
+		BVHNode *node;
+		int mask, lane, i;
+
+		stack_size--;
+		node = stack[stack_size].node;
+		mask = nearest_packet_test(packet, node, stack[stack_size].mask);
+		if (mask == 0) {
+			continue;
+		}
+
+		if (node->totnode == 0) {
+			for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+				if (mask & (1 << lane)) {
+					BVHNearestData *data = &packet->data[lane];
+					if (data->callback) {
+						data->callback(data->userdata, node->index, data->co, &data->nearest);
+					}
+					else {
+						data->nearest.index = node->index;
+						data->nearest.dist_sq = calc_nearest_point_squared(data->proj, node, data->nearest.co);
+					}
+					packet->dist_sq[lane] = data->nearest.dist_sq;
+				}
+			}
+		}
+		else {
+			/* Pick the order like #dfs_find_nearest_dfs does for the first lane,
+			 * pushing the children to visit first last. */
+			const BVHNearestData *data = &packet->data[bitscan_forward_i(mask)];
+			if (data->proj[node->main_axis] <= node->children[0]->bv[node->main_axis * 2 + 1]) {
+				for (i = node->totnode - 1; i >= 0; i--) {
+					stack[stack_size].node = node->children[i];
+					stack[stack_size].mask = mask;
+					stack_size++;
+				}
+			}
+			else {
+				for (i = 0; i != node->totnode; i++) {
+					stack[stack_size].node = node->children[i];
+					stack[stack_size].mask = mask;
+					stack_size++;
+				}
+			}
+		}
+	}
+}
+
+static void bvhtree_find_nearest_batch_task_cb(
+        void *__restrict userdata,
+        const int packet_index,
+        const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	const BVHBatchData *batch = userdata;
+	BVHTree *tree = batch->tree;
+	BVHNearestPacket packet;
+	BVHPacketStackItem *stack = BLI_array_alloca(stack, (size_t)bvhtree_packet_stack_size(tree));
+	const int start = packet_index * BVH_PACKET_SIZE;
+	const int lanes = min_ii(BVH_PACKET_SIZE, batch->num - start);
+	int lane, i;
+
+	packet.mask = 0;
+	for (lane = 0; lane < BVH_PACKET_SIZE; lane++) {
+		/* Unused lanes copy the first point, their results are ignored. */
+		const int co_index = start + ((lane < lanes) ? lane : 0);
+		BVHNearestData *data = &packet.data[lane];
+		axis_t axis_iter;
+
+		data->tree = tree;
+		data->co = batch->co[co_index];
+		data->callback = batch->nearest_callback;
+		data->userdata = batch->userdata;
+
+		/* The first 3 axes are always used by the bounds tests. */
+		copy_v3_v3(data->proj, data->co);
+		for (axis_iter = tree->start_axis; axis_iter != tree->stop_axis; axis_iter++) {
+			data->proj[axis_iter] = dot_v3v3(data->co, bvhtree_kdop_axes[axis_iter]);
+		}
+
+		memcpy(&data->nearest, &batch->nearest[co_index], sizeof(data->nearest));
+		packet.dist_sq[lane] = data->nearest.dist_sq;
+
+		if (lane < lanes) {
+			packet.mask |= 1 << lane;
+		}
+	}
+
+#ifdef __SSE2__
+	for (i = 0; i < 3; i++) {
+		packet.proj[i] = _mm_setr_ps(
+		        packet.data[0].proj[i], packet.data[1].proj[i],
+		        packet.data[2].proj[i], packet.data[3].proj[i]);
+	}
+#else
+	UNUSED_VARS(i);
+#endif
+
+	nearest_packet_traverse(&packet, tree->nodes[tree->totleaf], stack);
+
+	for (lane = 0; lane < lanes; lane++) {
+		memcpy(&batch->nearest[start + lane], &packet.data[lane].nearest, sizeof(packet.data[lane].nearest));
+	}
+}
+
+/**
+ * Find the nearest node to many coordinates at once, gives the same results as calling
+ * #BLI_bvhtree_find_nearest for each coordinate.
+ *
+ * Consecutive coordinates are traversed together, so it's fastest when they are close to each other.
+ *
+ * \param nearest: Input and output for each coordinate, initialized like the \a nearest of the
+ * single query (index -1 and the squared distance to search around, FLT_MAX for no limit).
+ * \param callback: Called from multiple threads, must be thread-safe.
+ */
+void BLI_bvhtree_find_nearest_batch(
+        BVHTree *tree, const float (*co)[3], int co_num, BVHTreeNearest *nearest,
+        BVHTree_NearestPointCallback callback, void *userdata)
+{
+	BVHBatchData batch = {NULL};
+	const int packets_num = (co_num + BVH_PACKET_SIZE - 1) / BVH_PACKET_SIZE;
+
+	if (tree->nodes[tree->totleaf] == NULL || co_num == 0) {
+		return;
+	}
+
+	batch.tree = tree;
+	batch.co = co;
+	batch.num = co_num;
+	batch.nearest = nearest;
+	batch.nearest_callback = callback;
+	batch.userdata = userdata;
+
+	ParallelRangeSettings settings;
+	BLI_parallel_range_settings_defaults(&settings);
+	settings.use_threading = (co_num > KDOPBVH_THREAD_QUERY_THRESHOLD);
+	settings.scheduling_mode = TASK_SCHEDULING_DYNAMIC;
+	BLI_task_parallel_range(
+	            0, packets_num,
+	            &batch,
+	            bvhtree_find_nearest_batch_task_cb,
+	            &settings);
+}
+
+/** \} */
+
 
 /* -------------------------------------------------------------------- */
 
@@ -0,0 +1,654 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/ohash.c
+ *  \ingroup bli
+ *
+ * An open addressing (pointer -> pointer) hash table,
+ * using linear probing with Robin Hood insertion.
+ *
+ * Entries are stored inline in the buckets array together with their hash,
+ * so resizing never calls the hash callback and the comparison callback is only
+ * called for keys with an equal hash.
+ *
+ * #OHashEntry.dist
+ * - ``0`` means the bucket is empty.
+ * - Otherwise it is one more than the distance from the bucket the hash maps to.
+ *
+ * Robin Hood insertion moves entries that are closer to their ideal bucket out of the way,
+ * which keeps probe sequences short and lets lookups stop as soon as they reach an entry
+ * closer to its ideal bucket than the key being searched.
+ * Removal shifts the following entries back, so no tombstones are needed.
+ *
+ * See: https://en.wikipedia.org/wiki/Hash_table#Robin_Hood_hashing
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"
+#include "BLI_utildefines.h"
+
+#define GHASH_INTERNAL_API
+#include "BLI_ohash.h"
+#include "BLI_strict_flags.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Structs & Constants
+ * \{ */
+
+#define OHASH_BUCKET_BIT_MIN 4
+#define OHASH_BUCKET_BIT_MAX 30
+
+/**
+ * Max load, same as #GHash.
+ * Robin Hood probing keeps lookups fast at higher loads too,
+ * but this keeps the memory usage comparable.
+ */
+#define OHASH_LIMIT_GROW(_nbkt)   ((uint)(((size_t)(_nbkt) * 3) / 4))
+
+/* WARNING! Keep in sync with _oh_Entry in header!!! */
+typedef struct OHashEntry {
+	void *key;
+	void *val;
+	uint hash;
+	uint dist;
+} OHashEntry;
+
+struct OHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	OHashEntry *buckets;
+	uint nbuckets;
+	uint bucket_mask, bucket_bit;
+	uint limit_grow;
+
+	uint nentries;
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Utility API
+ * \{ */
+
+/**
+ * Fibonacci hashing, takes the top bits so weak hashes (aligned pointers, sequential integers)
+ * are spread over the buckets.
+ */
+BLI_INLINE uint ohash_bucket_index(const OHash *oh, const uint hash)
+{
+	return (hash * 2654435769u) >> (32 - oh->bucket_bit);
+}
+
+BLI_INLINE uint ohash_bucket_bit_for_size(const uint nentries)
+{
+	uint bucket_bit = OHASH_BUCKET_BIT_MIN;
+
+	while ((bucket_bit < OHASH_BUCKET_BIT_MAX) &&
+	       (nentries > OHASH_LIMIT_GROW((size_t)1 << bucket_bit)))
+	{
+		bucket_bit++;
+	}
+
+	return bucket_bit;
+}
+
+/**
+ * Insert an entry known not to be in \a oh.
+ *
+ * \return the bucket where the new entry has been placed.
+ */
+BLI_INLINE OHashEntry *ohash_insert_entry(OHash *oh, void *key, void *val, const uint hash)
+{
+	OHashEntry *buckets = oh->buckets;
+	OHashEntry entry = {key, val, hash, 1};
+	OHashEntry *r_entry = NULL;
+	uint i = ohash_bucket_index(oh, hash);
+
+	for (;; i = (i + 1) & oh->bucket_mask, entry.dist++) {
+		OHashEntry *e = &buckets[i];
+
+		if (e->dist == 0) {
+			*e = entry;
+			return r_entry ? r_entry : e;
+		}
+		else if (e->dist < entry.dist) {
+			/* Take the place of the entry closer to its ideal bucket, and carry on inserting that one. */
+			SWAP(OHashEntry, *e, entry);
+			if (r_entry == NULL) {
+				r_entry = e;
+			}
+		}
+	}
+}
+
+static void ohash_buckets_resize(OHash *oh, const uint bucket_bit)
+{
+	OHashEntry *buckets_old = oh->buckets;
+	const uint nbuckets_old = oh->nbuckets;
+	uint i;
+
+	BLI_assert(bucket_bit <= OHASH_BUCKET_BIT_MAX);
+
+	oh->bucket_bit = bucket_bit;
+	oh->nbuckets = 1u << bucket_bit;
+	oh->bucket_mask = oh->nbuckets - 1;
+	oh->limit_grow = OHASH_LIMIT_GROW(oh->nbuckets);
+	oh->buckets = MEM_callocN(sizeof(*oh->buckets) * oh->nbuckets, __func__);
+
+	if (buckets_old) {
+		for (i = 0; i < nbuckets_old; i++) {
+			OHashEntry *e = &buckets_old[i];
+			if (e->dist != 0) {
+				ohash_insert_entry(oh, e->key, e->val, e->hash);
+			}
+		}
+		MEM_freeN(buckets_old);
+	}
+}
+
+/**
+ * Expand buckets so that \a nentries fit.
+ */
+BLI_INLINE void ohash_buckets_expand(OHash *oh, const uint nentries)
+{
+	if (LIKELY(nentries <= oh->limit_grow)) {
+		return;
+	}
+	ohash_buckets_resize(oh, ohash_bucket_bit_for_size(nentries));
+}
+
+BLI_INLINE OHashEntry *ohash_lookup_entry_ex(const OHash *oh, const void *key, const uint hash)
+{
+	const OHashEntry *buckets = oh->buckets;
+	uint i = ohash_bucket_index(oh, hash);
+	uint dist;
+
+	for (dist = 1; ; i = (i + 1) & oh->bucket_mask, dist++) {
+		const OHashEntry *e = &buckets[i];
+
+		/* Also stops on empty buckets. */
+		if (e->dist < dist) {
+			return NULL;
+		}
+		if ((e->hash == hash) && (oh->cmpfp(key, e->key) == false)) {
+			return (OHashEntry *)e;
+		}
+	}
+}
+
+BLI_INLINE OHashEntry *ohash_lookup_entry(const OHash *oh, const void *key)
+{
+	return ohash_lookup_entry_ex(oh, key, oh->hashfp(key));
+}
+
+/**
+ * Remove the entry, shifting back the following entries of the same probe sequence.
+ */
+BLI_INLINE void ohash_remove_entry(OHash *oh, OHashEntry *e)
+{
+	OHashEntry *buckets = oh->buckets;
+	uint i = (uint)(e - buckets);
+
+	for (;;) {
+		const uint i_next = (i + 1) & oh->bucket_mask;
+		OHashEntry *e_next = &buckets[i_next];
+
+		if (e_next->dist <= 1) {
+			buckets[i].dist = 0;
+			break;
+		}
+		buckets[i] = *e_next;
+		buckets[i].dist--;
+		i = i_next;
+	}
+
+	oh->nentries--;
+}
+
+static void ohash_free_cb(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	uint i;
+
+	BLI_assert(keyfreefp || valfreefp);
+
+	for (i = 0; i < oh->nbuckets; i++) {
+		OHashEntry *e = &oh->buckets[i];
+		if (e->dist != 0) {
+			if (keyfreefp) {
+				keyfreefp(e->key);
+			}
+			if (valfreefp) {
+				valfreefp(e->val);
+			}
+		}
+	}
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name OHash Public API
+ * \{ */
+
+/**
+ * Creates a new, empty OHash.
+ *
+ * \param hashfp  Hash callback.
+ * \param cmpfp  Comparison callback.
+ * \param info  Identifier string for the OHash.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ * Use this to avoid resizing buckets if the size is known or can be closely approximated.
+ * \return  An empty OHash.
+ */
+OHash *BLI_ohash_new_ex(
+        GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+        const uint nentries_reserve)
+{
+	OHash *oh = MEM_mallocN(sizeof(*oh), info);
+
+	oh->hashfp = hashfp;
+	oh->cmpfp = cmpfp;
+	oh->buckets = NULL;
+	oh->nbuckets = 0;
+	oh->nentries = 0;
+
+	ohash_buckets_resize(oh, ohash_bucket_bit_for_size(nentries_reserve));
+
+	return oh;
+}
+
+/**
+ * Wraps #BLI_ohash_new_ex with zero entries reserved.
+ */
+OHash *BLI_ohash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_ohash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Frees the OHash and its members.
+ *
+ * \param oh  The OHash to free.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_ohash_free(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+	}
+
+	MEM_freeN(oh->buckets);
+	MEM_freeN(oh);
+}
+
+/**
+ * Reserve given amount of entries (resize \a oh accordingly if needed).
+ */
+void BLI_ohash_reserve(OHash *oh, const uint nentries_reserve)
+{
+	ohash_buckets_expand(oh, nentries_reserve);
+}
+
+/**
+ * \return size of the OHash.
+ */
+uint BLI_ohash_size(const OHash *oh)
+{
+	return oh->nentries;
+}
+
+/**
+ * Insert a key/value pair into the \a oh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique.
+ */
+void BLI_ohash_insert(OHash *oh, void *key, void *val)
+{
+	BLI_assert(BLI_ohash_haskey(oh, key) == false);
+
+	ohash_buckets_expand(oh, ++oh->nentries);
+	ohash_insert_entry(oh, key, val, oh->hashfp(key));
+}
+
+/**
+ * Inserts a new value to a key that may already be in ohash.
+ *
+ * Avoids #BLI_ohash_remove, #BLI_ohash_insert calls (double lookups)
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_ohash_reinsert(OHash *oh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const uint hash = oh->hashfp(key);
+	OHashEntry *e = ohash_lookup_entry_ex(oh, key, hash);
+
+	if (e) {
+		if (keyfreefp) {
+			keyfreefp(e->key);
+		}
+		if (valfreefp) {
+			valfreefp(e->val);
+		}
+		e->key = key;
+		e->val = val;
+		return false;
+	}
+
+	ohash_buckets_expand(oh, ++oh->nentries);
+	ohash_insert_entry(oh, key, val, hash);
+	return true;
+}
+
+/**
+ * Lookup the value of \a key in \a oh.
+ *
+ * \param key  The key to lookup.
+ * \returns the value for \a key or NULL.
+ *
+ * \note When NULL is a valid value, use #BLI_ohash_lookup_p to differentiate a missing key
+ * from a key with a NULL value. (Avoids calling #BLI_ohash_haskey before #BLI_ohash_lookup)
+ */
+void *BLI_ohash_lookup(const OHash *oh, const void *key)
+{
+	OHashEntry *e = ohash_lookup_entry(oh, key);
+
+	return e ? e->val : NULL;
+}
+
+/**
+ * A version of #BLI_ohash_lookup which accepts a fallback argument.
+ */
+void *BLI_ohash_lookup_default(const OHash *oh, const void *key, void *val_default)
+{
+	OHashEntry *e = ohash_lookup_entry(oh, key);
+
+	return e ? e->val : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a oh.
+ *
+ * \param key  The key to lookup.
+ * \returns the pointer to value for \a key or NULL.
+ *
+ * \warning The pointer is invalidated by the next insertion or removal.
+ */
+void **BLI_ohash_lookup_p(OHash *oh, const void *key)
+{
+	OHashEntry *e = ohash_lookup_entry(oh, key);
+
+	return e ? &e->val : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a oh.
+ *
+ * This handles the common situation where the caller needs ensure a key is added to \a oh,
+ * constructing a new value in the case the key isn't found.
+ * Otherwise use the existing value.
+ *
+ * Such situations typically incur multiple lookups, however this function
+ * avoids them by ensuring the key is added,
+ * returning a pointer to the value so it can be used or initialized by the caller.
+ *
+ * \returns true when the value didn't need to be added.
+ * (when false, the caller _must_ initialize the value).
+ *
+ * \warning The pointer is invalidated by the next insertion or removal.
+ */
+bool BLI_ohash_ensure_p(OHash *oh, void *key, void ***r_val)
+{
+	const uint hash = oh->hashfp(key);
+	OHashEntry *e = ohash_lookup_entry_ex(oh, key, hash);
+	const bool haskey = (e != NULL);
+
+	if (!haskey) {
+		ohash_buckets_expand(oh, ++oh->nentries);
+		e = ohash_insert_entry(oh, key, NULL, hash);
+	}
+
+	*r_val = &e->val;
+	return haskey;
+}
+
+/**
+ * Remove \a key from \a oh, or return false if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \return true if \a key was removed from \a oh.
+ */
+bool BLI_ohash_remove(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	OHashEntry *e = ohash_lookup_entry(oh, key);
+
+	if (e) {
+		if (keyfreefp) {
+			keyfreefp(e->key);
+		}
+		if (valfreefp) {
+			valfreefp(e->val);
+		}
+		ohash_remove_entry(oh, e);
+		return true;
+	}
+	else {
+		return false;
+	}
+}
+
+/**
+ * Remove \a key from \a oh, returning the value or NULL if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \return the value of \a key int \a oh or NULL.
+ */
+void *BLI_ohash_popkey(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp)
+{
+	OHashEntry *e = ohash_lookup_entry(oh, key);
+
+	if (e) {
+		void *val = e->val;
+		if (keyfreefp) {
+			keyfreefp(e->key);
+		}
+		ohash_remove_entry(oh, e);
+		return val;
+	}
+	else {
+		return NULL;
+	}
+}
+
+/**
+ * \return true if the \a key is in \a oh.
+ */
+bool BLI_ohash_haskey(const OHash *oh, const void *key)
+{
+	return (ohash_lookup_entry(oh, key) != NULL);
+}
+
+/**
+ * Reset \a oh clearing all entries.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ */
+void BLI_ohash_clear_ex(
+        OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+        const uint nentries_reserve)
+{
+	const uint bucket_bit = ohash_bucket_bit_for_size(nentries_reserve);
+
+	if (keyfreefp || valfreefp) {
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+	}
+
+	oh->nentries = 0;
+	if (bucket_bit != oh->bucket_bit) {
+		MEM_freeN(oh->buckets);
+		oh->buckets = NULL;
+		ohash_buckets_resize(oh, bucket_bit);
+	}
+	else {
+		memset(oh->buckets, 0, sizeof(*oh->buckets) * oh->nbuckets);
+	}
+}
+
+/**
+ * Wraps #BLI_ohash_clear_ex with zero entries reserved.
+ */
+void BLI_ohash_clear(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	BLI_ohash_clear_ex(oh, keyfreefp, valfreefp, 0);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name OHash Iterator API
+ * \{ */
+
+/**
+ * Init an already allocated OHashIterator. The hash table must not be mutated
+ * until the iterator is done, the order of the entries is undefined.
+ *
+ * \param ohi  The OHashIterator to initialize.
+ * \param oh  The OHash to iterate over.
+ */
+void BLI_ohashIterator_init(OHashIterator *ohi, OHash *oh)
+{
+	ohi->oh = oh;
+	ohi->curr_entry = NULL;
+	ohi->curr_bucket = UINT_MAX;  /* wraps to zero */
+	BLI_ohashIterator_step(ohi);
+}
+
+/**
+ * Steps the iterator to the next index.
+ *
+ * \param ohi  The iterator.
+ */
+void BLI_ohashIterator_step(OHashIterator *ohi)
+{
+	const OHash *oh = ohi->oh;
+
+	for (ohi->curr_bucket++; ohi->curr_bucket < oh->nbuckets; ohi->curr_bucket++) {
+		OHashEntry *e = &oh->buckets[ohi->curr_bucket];
+		if (e->dist != 0) {
+			ohi->curr_entry = e;
+			return;
+		}
+	}
+
+	ohi->curr_entry = NULL;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Convenience OHash Creation Functions
+ * \{ */
+
+OHash *BLI_ohash_ptr_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_ptr_new(const char *info)
+{
+	return BLI_ohash_ptr_new_ex(info, 0);
+}
+
+OHash *BLI_ohash_str_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_str_new(const char *info)
+{
+	return BLI_ohash_str_new_ex(info, 0);
+}
+
+OHash *BLI_ohash_int_new_ex(const char *info, const uint nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_int_new(const char *info)
+{
+	return BLI_ohash_int_new_ex(info, 0);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Debugging & Introspection
+ * \{ */
+
+/**
+ * \return number of buckets in the OHash.
+ */
+int BLI_ohash_buckets_size(const OHash *oh)
+{
+	return (int)oh->nbuckets;
+}
+
+/**
+ * Measure how well the hash function performs (1.0 is perfect, every key in its ideal bucket).
+ *
+ * \return the average number of buckets visited to find a key.
+ *
+ * \param r_load  The load factor (entries / buckets).
+ * \param r_probe_max  The longest probe sequence.
+ */
+double BLI_ohash_calc_quality_ex(const OHash *oh, double *r_load, int *r_probe_max)
+{
+	uint64_t probe_sum = 0;
+	uint probe_max = 0;
+	uint i;
+
+	for (i = 0; i < oh->nbuckets; i++) {
+		const OHashEntry *e = &oh->buckets[i];
+		probe_sum += e->dist;
+		if (e->dist > probe_max) {
+			probe_max = e->dist;
+		}
+	}
+
+	if (r_load) {
+		*r_load = (double)oh->nentries / (double)oh->nbuckets;
+	}
+	if (r_probe_max) {
+		*r_probe_max = (int)probe_max;
+	}
+
+	return oh->nentries ? (double)probe_sum / (double)oh->nentries : 0.0;
+}
+
+/** \} */
@@ -204,15 +204,39 @@ struct TaskPool {
 #endif
 };
 
+/* Queue of tasks owned by a worker thread.
+ *
+ * Workers pop tasks from their own queue first and steal from the queues of
+ * other workers once it runs dry. The lock is only held to link or unlink a
+ * task, so contention is limited to threads touching the same queue at the
+ * same time instead of every push and pop going through one global mutex.
+ */
+typedef struct TaskQueue {
+	ListBase tasks;
+	SpinLock lock;
+	/* Keep queues of different workers on separate cache lines. */
+	char _pad[64];
+} TaskQueue;
+
 struct TaskScheduler {
 	pthread_t *threads;
 	struct TaskThread *task_threads;
 	int num_threads;
 	bool background_thread_only;
 
-	ListBase queue;
-	ThreadMutex queue_mutex;
-	ThreadCondition queue_cond;
+	/* One queue per worker thread, indexed by thread id - 1. */
+	TaskQueue *queues;
+	/* Round-robin queue for pushes from threads which are not workers. */
+	uint32_t next_queue;
+
+	/* Number of queued tasks workers are allowed to run, and number of workers
+	 * sleeping because there is none. Sleeping workers are woken up from the
+	 * condition when new tasks are pushed.
+	 */
+	int32_t num_queued;
+	uint32_t num_sleeping;
+	ThreadMutex sleep_mutex;
+	ThreadCondition sleep_cond;
 
 	volatile bool do_exit;
 
@@ -330,13 +354,27 @@ static void task_free(TaskPool *pool, Task *task, const int thread_id)
 
 static void task_pool_num_decrease(TaskPool *pool, size_t done)
 {
+	size_t num = pool->num;
+
+	/* Only the last tasks need to wake up threads waiting for the pool, other
+	 * ones decrease the counter without locking.
+	 */
+	while (num > done) {
+		const size_t old_num = atomic_cas_z((size_t *)&pool->num, num, num - done);
+		if (old_num == num) {
+			return;
+		}
+		num = old_num;
+	}
+
+	/* Pool becomes empty, which must happen with the mutex held: waiter might
+	 * free the pool as soon as it sees zero tasks.
+	 */
 	BLI_mutex_lock(&pool->num_mutex);
 
 	BLI_assert(pool->num >= done);
 
-	pool->num -= done;
-
-	if (pool->num == 0)
+	if (atomic_sub_and_fetch_z((size_t *)&pool->num, done) == 0)
 		BLI_condition_notify_all(&pool->num_cond);
 
 	BLI_mutex_unlock(&pool->num_mutex);
@@ -344,62 +382,147 @@ static void task_pool_num_decrease(TaskPool *pool, size_t done)
 
 static void task_pool_num_increase(TaskPool *pool, size_t new)
 {
-	BLI_mutex_lock(&pool->num_mutex);
+	atomic_add_and_fetch_z((size_t *)&pool->num, new);
 
-	pool->num += new;
-	BLI_condition_notify_all(&pool->num_cond);
+	/* Wake up thread doing work_and_wait() on the pool so it picks up new
+	 * tasks. Nobody waits for pools which are not being worked on.
+	 */
+	if (pool->do_work) {
+		BLI_mutex_lock(&pool->num_mutex);
+		BLI_condition_notify_all(&pool->num_cond);
+		BLI_mutex_unlock(&pool->num_mutex);
+	}
+}
 
-	BLI_mutex_unlock(&pool->num_mutex);
+/* Whether task is allowed to be run by worker threads. In the background only
+ * mode the worker only handles pools which are never work_and_wait'ed.
+ */
+BLI_INLINE bool task_pool_is_worker_runnable(TaskScheduler *scheduler, TaskPool *pool)
+{
+	return !scheduler->background_thread_only || pool->run_in_background;
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+BLI_INLINE bool task_is_worker_runnable(TaskScheduler *scheduler, Task *task)
 {
-	bool found_task = false;
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	return task_pool_is_worker_runnable(scheduler, task->pool);
+}
 
-	while (!scheduler->queue.first && !scheduler->do_exit)
-		BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+static TaskQueue *task_scheduler_queue_for_thread(TaskScheduler *scheduler, int thread_id)
+{
+	if (thread_id <= 0) {
+		/* Pushes from a worker without explicit thread id still go to its own queue. */
+		TaskThread *thread = pthread_getspecific(scheduler->tls_id_key);
+		if (thread != NULL) {
+			thread_id = thread->id;
+		}
+	}
+	if (thread_id <= 0) {
+		/* Spread tasks from the main and other threads over all workers. */
+		thread_id = atomic_fetch_and_add_uint32(&scheduler->next_queue, 1) % scheduler->num_threads + 1;
+	}
+	return &scheduler->queues[thread_id - 1];
+}
 
-	do {
-		Task *current_task;
+static void task_scheduler_wake_workers(TaskScheduler *scheduler, bool all)
+{
+	/* Paired with the sleep in task_scheduler_thread_wait_pop(): num_queued is
+	 * increased before the check and workers increase num_sleeping before they
+	 * check num_queued, so either the worker sees the task or we see the worker.
+	 */
+	if (atomic_add_and_fetch_uint32(&scheduler->num_sleeping, 0) == 0) {
+		return;
+	}
 
-		/* Assuming we can only have a void queue in 'exit' case here seems logical (we should only be here after
-		 * our worker thread has been woken up from a condition_wait(), which only happens after a new task was
-		 * added to the queue), but it is wrong.
-		 * Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups), and some
-		 * race condition may also empty the queue **after** condition has been signaled, but **before** awoken thread
-		 * reaches this point...
-		 * See http://stackoverflow.com/questions/8594591
-		 *
-		 * So we only abort here if do_exit is set.
-		 */
-		if (scheduler->do_exit) {
-			BLI_mutex_unlock(&scheduler->queue_mutex);
-			return false;
-		}
+	BLI_mutex_lock(&scheduler->sleep_mutex);
+	if (all)
+		BLI_condition_notify_all(&scheduler->sleep_cond);
+	else
+		BLI_condition_notify_one(&scheduler->sleep_cond);
+	BLI_mutex_unlock(&scheduler->sleep_mutex);
+}
 
-		for (current_task = scheduler->queue.first;
-		     current_task != NULL;
-		     current_task = current_task->next)
-		{
-			TaskPool *pool = current_task->pool;
+/* Pop task from the queue, either of the given pool or any task workers are
+ * allowed to run when pool is NULL.
+ */
+static Task *task_queue_pop(TaskScheduler *scheduler, TaskQueue *queue, TaskPool *pool)
+{
+	Task *task;
 
-			if (scheduler->background_thread_only && !pool->run_in_background) {
-				continue;
-			}
+	/* Unlocked peek, avoids locking queues which are empty anyway. */
+	if (queue->tasks.first == NULL) {
+		return NULL;
+	}
 
-			*task = current_task;
-			found_task = true;
-			BLI_remlink(&scheduler->queue, *task);
+	BLI_spin_lock(&queue->lock);
+	for (task = queue->tasks.first; task; task = task->next) {
+		if (pool ? task->pool == pool : task_is_worker_runnable(scheduler, task)) {
+			BLI_remlink(&queue->tasks, task);
 			break;
 		}
-		if (!found_task)
-			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
-	} while (!found_task);
+	}
+	BLI_spin_unlock(&queue->lock);
 
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+	if (task && task_is_worker_runnable(scheduler, task)) {
+		atomic_sub_and_fetch_int32(&scheduler->num_queued, 1);
+	}
 
-	return true;
+	return task;
+}
+
+/* Pop task from worker's own queue, or steal one from other workers. */
+static Task *task_scheduler_pop(TaskScheduler *scheduler, int thread_id)
+{
+	const int num_queues = scheduler->num_threads;
+
+	for (int i = 0; i < num_queues; i++) {
+		TaskQueue *queue = &scheduler->queues[(thread_id - 1 + i) % num_queues];
+		Task *task = task_queue_pop(scheduler, queue, NULL);
+		if (task) {
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+/* Pop task of the given pool from any of the queues. */
+static Task *task_scheduler_pop_pool(TaskScheduler *scheduler, TaskPool *pool)
+{
+	for (int i = 0; i < scheduler->num_threads; i++) {
+		Task *task = task_queue_pop(scheduler, &scheduler->queues[i], pool);
+		if (task) {
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, TaskThread *thread, Task **task)
+{
+	while (!scheduler->do_exit) {
+		*task = task_scheduler_pop(scheduler, thread->id);
+		if (*task) {
+			return true;
+		}
+
+		/* No task found in any queue, sleep until something is pushed.
+		 *
+		 * Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups), and
+		 * other workers may steal the task **after** condition has been signaled, but **before** awoken thread
+		 * reaches the queues. So we only abort when do_exit is set and otherwise try popping again.
+		 * See http://stackoverflow.com/questions/8594591
+		 */
+		BLI_mutex_lock(&scheduler->sleep_mutex);
+		atomic_add_and_fetch_uint32(&scheduler->num_sleeping, 1);
+		while (atomic_add_and_fetch_int32(&scheduler->num_queued, 0) <= 0 && !scheduler->do_exit) {
+			BLI_condition_wait(&scheduler->sleep_cond, &scheduler->sleep_mutex);
+		}
+		atomic_sub_and_fetch_uint32(&scheduler->num_sleeping, 1);
+		BLI_mutex_unlock(&scheduler->sleep_mutex);
+	}
+
+	return false;
 }
 
 BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls,
@@ -433,7 +556,7 @@ static void *task_scheduler_thread_run(void *thread_p)
 	pthread_setspecific(scheduler->tls_id_key, thread);
 
 	/* keep popping off tasks */
-	while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+	while (task_scheduler_thread_wait_pop(scheduler, thread, &task)) {
 		TaskPool *pool = task->pool;
 
 		/* run task */
@@ -462,9 +585,8 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 	 * threads, so we keep track of the number of users. */
 	scheduler->do_exit = false;
 
-	BLI_listbase_clear(&scheduler->queue);
-	BLI_mutex_init(&scheduler->queue_mutex);
-	BLI_condition_init(&scheduler->queue_cond);
+	BLI_mutex_init(&scheduler->sleep_mutex);
+	BLI_condition_init(&scheduler->sleep_cond);
 
 	if (num_threads == 0) {
 		/* automatic number of threads will be main thread + num cores */
@@ -486,6 +608,11 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 	/* Initialize TLS for main thread. */
 	initialize_task_tls(&scheduler->task_threads[0].tls);
 
+	scheduler->queues = MEM_callocN(sizeof(TaskQueue) * num_threads, "TaskScheduler queues");
+	for (int i = 0; i < num_threads; i++) {
+		BLI_spin_init(&scheduler->queues[i].lock);
+	}
+
 	pthread_key_create(&scheduler->tls_id_key, NULL);
 
 	/* launch threads that will be waiting for work */
@@ -515,10 +642,10 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
 	Task *task;
 
 	/* stop all waiting threads */
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	BLI_mutex_lock(&scheduler->sleep_mutex);
 	scheduler->do_exit = true;
-	BLI_condition_notify_all(&scheduler->queue_cond);
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+	BLI_condition_notify_all(&scheduler->sleep_cond);
+	BLI_mutex_unlock(&scheduler->sleep_mutex);
 
 	pthread_key_delete(scheduler->tls_id_key);
 
@@ -545,14 +672,19 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
 	}
 
 	/* delete leftover tasks */
-	for (task = scheduler->queue.first; task; task = task->next) {
-		task_data_free(task, 0);
+	for (int i = 0; i < scheduler->num_threads; i++) {
+		TaskQueue *queue = &scheduler->queues[i];
+		for (task = queue->tasks.first; task; task = task->next) {
+			task_data_free(task, 0);
+		}
+		BLI_freelistN(&queue->tasks);
+		BLI_spin_end(&queue->lock);
 	}
-	BLI_freelistN(&scheduler->queue);
+	MEM_freeN(scheduler->queues);
 
 	/* delete mutex/condition */
-	BLI_mutex_end(&scheduler->queue_mutex);
-	BLI_condition_end(&scheduler->queue_cond);
+	BLI_mutex_end(&scheduler->sleep_mutex);
+	BLI_condition_end(&scheduler->sleep_cond);
 
 	MEM_freeN(scheduler);
 }
@@ -562,41 +694,59 @@ int BLI_task_scheduler_num_threads(TaskScheduler *scheduler)
 	return scheduler->num_threads + 1;
 }
 
-static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriority priority)
+static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriority priority, int thread_id)
 {
+	TaskQueue *queue = task_scheduler_queue_for_thread(scheduler, thread_id);
+	/* Task might be run and freed by a worker as soon as it is queued. */
+	const bool is_worker_runnable = task_is_worker_runnable(scheduler, task);
+
 	task_pool_num_increase(task->pool, 1);
 
 	/* add task to queue */
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	BLI_spin_lock(&queue->lock);
 
 	if (priority == TASK_PRIORITY_HIGH)
-		BLI_addhead(&scheduler->queue, task);
+		BLI_addhead(&queue->tasks, task);
 	else
-		BLI_addtail(&scheduler->queue, task);
+		BLI_addtail(&queue->tasks, task);
+
+	BLI_spin_unlock(&queue->lock);
 
-	BLI_condition_notify_one(&scheduler->queue_cond);
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+	if (is_worker_runnable) {
+		atomic_add_and_fetch_int32(&scheduler->num_queued, 1);
+		task_scheduler_wake_workers(scheduler, false);
+	}
 }
 
 static void task_scheduler_push_all(TaskScheduler *scheduler,
                                     TaskPool *pool,
                                     Task **tasks,
-                                    int num_tasks)
+                                    int num_tasks,
+                                    int thread_id)
 {
 	if (num_tasks == 0) {
 		return;
 	}
 
+	TaskQueue *queue = task_scheduler_queue_for_thread(scheduler, thread_id);
+	/* Pool might be done and freed as soon as its tasks are queued. */
+	const bool is_worker_runnable = task_pool_is_worker_runnable(scheduler, pool);
+
 	task_pool_num_increase(pool, num_tasks);
 
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	BLI_spin_lock(&queue->lock);
 
 	for (int i = 0; i < num_tasks; i++) {
-		BLI_addhead(&scheduler->queue, tasks[i]);
+		BLI_addhead(&queue->tasks, tasks[i]);
+	}
+
+	BLI_spin_unlock(&queue->lock);
+
+	if (is_worker_runnable) {
+		atomic_add_and_fetch_int32(&scheduler->num_queued, num_tasks);
+		task_scheduler_wake_workers(scheduler, true);
 	}
 
-	BLI_condition_notify_all(&scheduler->queue_cond);
-	BLI_mutex_unlock(&scheduler->queue_mutex);
 }
 
 static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
@@ -604,21 +754,29 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
 	Task *task, *nexttask;
 	size_t done = 0;
 
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	/* free all tasks from this pool from the queues */
+	for (int i = 0; i < scheduler->num_threads; i++) {
+		TaskQueue *queue = &scheduler->queues[i];
+
+		BLI_spin_lock(&queue->lock);
 
-	/* free all tasks from this pool from the queue */
-	for (task = scheduler->queue.first; task; task = nexttask) {
-		nexttask = task->next;
+		for (task = queue->tasks.first; task; task = nexttask) {
+			nexttask = task->next;
 
-		if (task->pool == pool) {
-			task_data_free(task, pool->thread_id);
-			BLI_freelinkN(&scheduler->queue, task);
+			if (task->pool == pool) {
+				task_data_free(task, pool->thread_id);
+				BLI_freelinkN(&queue->tasks, task);
 
-			done++;
+				done++;
+			}
 		}
+
+		BLI_spin_unlock(&queue->lock);
 	}
 
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+	if (done && task_pool_is_worker_runnable(scheduler, pool)) {
+		atomic_sub_and_fetch_int32(&scheduler->num_queued, (int32_t)done);
+	}
 
 	/* notify done */
 	task_pool_num_decrease(pool, done);
@@ -819,7 +977,7 @@ static void task_pool_push(
 	/* Do push to a global execution ppol, slowest possible method,
 	 * causes quite reasonable amount of threading overhead.
 	 */
-	task_scheduler_push(pool->scheduler, task, priority);
+	task_scheduler_push(pool->scheduler, task, priority, thread_id);
 }
 
 void BLI_task_pool_push_ex(
@@ -848,43 +1006,48 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
 	if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
 		if (pool->num_suspended) {
+			Task *task, *nexttask;
+			int i = 0;
+
 			task_pool_num_increase(pool, pool->num_suspended);
-			BLI_mutex_lock(&scheduler->queue_mutex);
 
-			BLI_movelisttolist(&scheduler->queue, &pool->suspended_queue);
+			/* Deal tasks out over all worker queues. */
+			for (task = pool->suspended_queue.first; task; task = nexttask, i++) {
+				TaskQueue *queue = &scheduler->queues[i % scheduler->num_threads];
+				nexttask = task->next;
+
+				BLI_spin_lock(&queue->lock);
+				BLI_addtail(&queue->tasks, task);
+				BLI_spin_unlock(&queue->lock);
+			}
+			BLI_listbase_clear(&pool->suspended_queue);
 
-			BLI_condition_notify_all(&scheduler->queue_cond);
-			BLI_mutex_unlock(&scheduler->queue_mutex);
+			if (task_pool_is_worker_runnable(scheduler, pool)) {
+				atomic_add_and_fetch_int32(&scheduler->num_queued, (int32_t)pool->num_suspended);
+				task_scheduler_wake_workers(scheduler, true);
+			}
 		}
 	}
 
-	pool->do_work = true;
+	/* Full barrier, so pushes from other threads either see the flag and
+	 * notify us, or their tasks are seen by the loop below.
+	 */
+	atomic_fetch_and_or_uint8((uint8_t *)&pool->do_work, true);
 
 	ASSERT_THREAD_ID(pool->scheduler, pool->thread_id);
 
 	BLI_mutex_lock(&pool->num_mutex);
 
 	while (pool->num != 0) {
-		Task *task, *work_task = NULL;
+		Task *work_task = NULL;
 		bool found_task = false;
 
 		BLI_mutex_unlock(&pool->num_mutex);
 
-		BLI_mutex_lock(&scheduler->queue_mutex);
-
 		/* find task from this pool. if we get a task from another pool,
 		 * we can get into deadlock */
-
-		for (task = scheduler->queue.first; task; task = task->next) {
-			if (task->pool == pool) {
-				work_task = task;
-				found_task = true;
-				BLI_remlink(&scheduler->queue, task);
-				break;
-			}
-		}
-
-		BLI_mutex_unlock(&scheduler->queue_mutex);
+		work_task = task_scheduler_pop_pool(scheduler, pool);
+		found_task = (work_task != NULL);
 
 		/* if found task, do it, otherwise wait until other tasks are done */
 		if (found_task) {
@@ -894,7 +1057,7 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 			BLI_assert(!tls->do_delayed_push);
 
 			/* delete task */
-			task_free(pool, task, pool->thread_id);
+			task_free(pool, work_task, pool->thread_id);
 
 			/* Handle all tasks from local queue. */
 			handle_local_queue(tls, pool->thread_id);
@@ -964,7 +1127,8 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
 		task_scheduler_push_all(pool->scheduler,
 		                        pool,
 		                        tls->delayed_queue,
-		                        tls->num_delayed_queue);
+		                        tls->num_delayed_queue,
+		                        thread_id);
 		tls->do_delayed_push = false;
 		tls->num_delayed_queue = 0;
 	}
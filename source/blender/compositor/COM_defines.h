@@ -111,4 +111,11 @@ typedef enum OrderOfChunks {
 
 #define COM_BLUR_BOKEH_PIXELS 512
 
+/**
+ * @brief maximum number of pixels calculated at once by SocketReader.readRow
+ * operations keep a row of each input on the stack, so keep this small.
+ * @ingroup Execution
+ */
+#define COM_ROW_SIZE 64
+
 #endif  /* __COM_DEFINES_H__ */
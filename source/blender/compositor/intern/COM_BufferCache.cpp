@@ -0,0 +1,159 @@
+/*
+ * Copyright 2018, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <map>
+#include <stdio.h>
+
+#include "COM_BufferCache.h"
+#include "COM_MemoryBuffer.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#  include "DNA_userdef_types.h"
+}
+
+typedef struct BufferCacheEntry {
+	float *buffer;
+	size_t size;
+	rcti rect;
+	unsigned int num_channels;
+	unsigned int last_used;
+} BufferCacheEntry;
+
+typedef std::map<uint64_t, BufferCacheEntry> BufferCacheMap;
+
+static BufferCacheMap g_entries;
+static unsigned int g_execution = 0;
+static size_t g_mem_in_use = 0;
+static size_t g_mem_peak = 0;
+static unsigned int g_hits = 0;
+static unsigned int g_misses = 0;
+
+static size_t buffer_cache_limit()
+{
+	return ((size_t)U.memcachelimit) * 1024 * 1024;
+}
+
+static void buffer_cache_free_entry(BufferCacheMap::iterator it)
+{
+	g_mem_in_use -= it->second.size;
+	MEM_freeN(it->second.buffer);
+	g_entries.erase(it);
+}
+
+/* Free least recently used buffers until the new buffer fits in the limit,
+ * buffers used by the current execution are kept. */
+static bool buffer_cache_make_room(size_t size)
+{
+	const size_t limit = buffer_cache_limit();
+
+	if (size > limit) {
+		return false;
+	}
+
+	while (g_mem_in_use + size > limit) {
+		BufferCacheMap::iterator oldest = g_entries.end();
+		for (BufferCacheMap::iterator it = g_entries.begin(); it != g_entries.end(); ++it) {
+			if (oldest == g_entries.end() || it->second.last_used < oldest->second.last_used) {
+				oldest = it;
+			}
+		}
+
+		if (oldest == g_entries.end() || oldest->second.last_used == g_execution) {
+			return false;
+		}
+		buffer_cache_free_entry(oldest);
+	}
+
+	return true;
+}
+
+bool BufferCache::lookup(const OperationHash &hash, MemoryBuffer *buffer)
+{
+	BufferCacheMap::iterator it = g_entries.find(hash.get());
+	if (it == g_entries.end()) {
+		g_misses++;
+		return false;
+	}
+
+	BufferCacheEntry &entry = it->second;
+	if (!BLI_rcti_compare(&entry.rect, buffer->getRect()) ||
+	    entry.num_channels != buffer->get_num_channels())
+	{
+		g_misses++;
+		return false;
+	}
+
+	memcpy(buffer->getBuffer(), entry.buffer, entry.size);
+	entry.last_used = g_execution;
+	g_hits++;
+	return true;
+}
+
+void BufferCache::store(const OperationHash &hash, MemoryBuffer *buffer)
+{
+	const rcti *rect = buffer->getRect();
+	const size_t size = sizeof(float) * BLI_rcti_size_x(rect) * BLI_rcti_size_y(rect) *
+	                    buffer->get_num_channels();
+
+	BufferCacheMap::iterator it = g_entries.find(hash.get());
+	if (it != g_entries.end()) {
+		buffer_cache_free_entry(it);
+	}
+
+	if (size == 0 || !buffer_cache_make_room(size)) {
+		return;
+	}
+
+	BufferCacheEntry entry;
+	entry.buffer = (float *)MEM_mallocN_aligned(size, 16, "COM_BufferCache");
+	entry.size = size;
+	entry.rect = *rect;
+	entry.num_channels = buffer->get_num_channels();
+	entry.last_used = g_execution;
+	memcpy(entry.buffer, buffer->getBuffer(), size);
+
+	g_entries[hash.get()] = entry;
+	g_mem_in_use += size;
+	if (g_mem_in_use > g_mem_peak) {
+		g_mem_peak = g_mem_in_use;
+	}
+}
+
+void BufferCache::beginExecution()
+{
+	g_execution++;
+}
+
+void BufferCache::free()
+{
+	while (!g_entries.empty()) {
+		buffer_cache_free_entry(g_entries.begin());
+	}
+	g_hits = 0;
+	g_misses = 0;
+	g_mem_peak = 0;
+}
+
+void BufferCache::printStatistics()
+{
+	printf("Compositor buffer cache: %u hits, %u misses, %u buffers, %.2fM in use, %.2fM peak\n",
+	       g_hits, g_misses, (unsigned int)g_entries.size(),
+	       (double)g_mem_in_use / (1024.0 * 1024.0), (double)g_mem_peak / (1024.0 * 1024.0));
+}
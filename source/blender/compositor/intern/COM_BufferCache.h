@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _COM_BufferCache_h_
+#define _COM_BufferCache_h_
+
+#include <stdint.h>
+#include <string.h>
+
+class MemoryBuffer;
+
+/**
+ * @brief hash identifying the result of an operation
+ *
+ * The hash is built from the type and the parameters of the operation and the
+ * hashes of the operations connected to its inputs.
+ * @see NodeOperation.hashParameters
+ * @ingroup Memory
+ */
+class OperationHash {
+private:
+	uint64_t m_hash;
+
+public:
+	OperationHash() : m_hash(14695981039346656037ULL) {}
+
+	void add(const void *data, size_t size)
+	{
+		const unsigned char *bytes = (const unsigned char *)data;
+		for (size_t i = 0; i < size; i++) {
+			m_hash = (m_hash ^ bytes[i]) * 1099511628211ULL;
+		}
+	}
+
+	template<typename T> void add(const T &value) { add(&value, sizeof(value)); }
+
+	/**
+	 * @brief add large data like image pixels, hashed by words for speed
+	 */
+	void addBuffer(const void *data, size_t size)
+	{
+		const unsigned char *bytes = (const unsigned char *)data;
+		const size_t words = size / sizeof(uint64_t);
+		for (size_t i = 0; i < words; i++) {
+			uint64_t word;
+			memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+			m_hash = (m_hash ^ word) * 1099511628211ULL;
+		}
+		add(bytes + words * sizeof(uint64_t), size - words * sizeof(uint64_t));
+		add(size);
+	}
+
+	void addString(const char *str)
+	{
+		if (str) {
+			add(str, strlen(str));
+		}
+		add((unsigned char)0);
+	}
+
+	uint64_t get() const { return m_hash; }
+};
+
+/**
+ * @brief cache of the buffers written by execution groups, kept between executions
+ *
+ * When an execution group has the same hash as in a previous execution, its
+ * buffer is copied from the cache instead of executing its chunks, and the
+ * groups it depends on are not scheduled at all. This avoids recalculating
+ * static parts of the tree, like blurred background plates, when tweaking
+ * other nodes or rendering an animation.
+ *
+ * The cache shares the memory cache limit of the user preferences, least
+ * recently used buffers are freed first. It is disabled per node tree with
+ * the "Buffer Cache" option (NTREE_COM_NO_BUFFER_CACHE).
+ * @ingroup Memory
+ */
+class BufferCache {
+public:
+	/**
+	 * @brief copy the cached buffer into the given buffer
+	 * @return false when there is no cached buffer with this hash and size
+	 */
+	static bool lookup(const OperationHash &hash, MemoryBuffer *buffer);
+
+	/**
+	 * @brief store a copy of the buffer in the cache
+	 */
+	static void store(const OperationHash &hash, MemoryBuffer *buffer);
+
+	/**
+	 * @brief start a new execution, used to find the least recently used buffers
+	 */
+	static void beginExecution();
+
+	/**
+	 * @brief free all cached buffers
+	 */
+	static void free();
+
+	/**
+	 * @brief print hits and memory usage of the cache
+	 */
+	static void printStatistics();
+};
+
+#endif /* _COM_BufferCache_h_ */
@@ -375,6 +375,16 @@ public:
 	 * @param system
 	 */
 	void execute(ExecutionSystem *system);
+
+	/**
+	 * @brief mark all chunks as executed, used when the output buffer was restored from the BufferCache
+	 */
+	void setExecuted();
+
+	/**
+	 * @brief have all chunks of this ExecutionGroup been executed
+	 */
+	bool isExecuted() const;
 	
 	/**
 	 * @brief this method determines the MemoryProxy's where this execution group depends on.
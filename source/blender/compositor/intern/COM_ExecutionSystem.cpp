@@ -22,9 +22,13 @@
 
 #include "COM_ExecutionSystem.h"
 
+#include <map>
+#include <typeinfo>
+
 #include "PIL_time.h"
 #include "BLI_utildefines.h"
 extern "C" {
+#include "BKE_global.h"
 #include "BKE_node.h"
 }
 
@@ -36,6 +40,7 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
 #include "COM_Debug.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -174,6 +179,8 @@ void ExecutionSystem::execute()
 		executionGroup->initExecution();
 	}
 
+	restoreCachedBuffers();
+
 	WorkScheduler::start(this->m_context);
 
 	executeGroups(COM_PRIORITY_HIGH);
@@ -185,6 +192,8 @@ void ExecutionSystem::execute()
 	WorkScheduler::finish();
 	WorkScheduler::stop();
 
+	storeCachedBuffers();
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | De-initializing execution"));
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -229,3 +238,124 @@ void ExecutionSystem::findOutputExecutionGroup(vector<ExecutionGroup *> *result)
 		}
 	}
 }
+
+typedef std::map<NodeOperation *, std::pair<bool, OperationHash> > OperationHashMap;
+
+/* Hash of the result of an operation, built from the operations it depends on.
+ * Returns false when one of these can't be hashed. */
+static bool determine_operation_hash(NodeOperation *operation, const OperationHash &seed,
+                                     OperationHashMap &hashes, OperationHash *r_hash)
+{
+	OperationHashMap::iterator it = hashes.find(operation);
+	if (it != hashes.end()) {
+		*r_hash = it->second.second;
+		return it->second.first;
+	}
+
+	OperationHash hash = seed;
+	OperationHash input_hash;
+	bool valid = true;
+
+	if (operation->isReadBufferOperation()) {
+		/* continue with the operations of the group writing the buffer */
+		ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+		NodeOperation *writeOperation = readOperation->getMemoryProxy()->getWriteBufferOperation();
+		valid = determine_operation_hash(writeOperation, seed, hashes, &input_hash);
+		hash.add(input_hash.get());
+	}
+	else {
+		hash.addString(typeid(*operation).name());
+		valid = operation->hashParameters(hash);
+
+		for (unsigned int index = 0; valid && index < operation->getNumberOfInputSockets(); index++) {
+			NodeOperationInput *input = operation->getInputSocket(index);
+			if (!input->isConnected()) {
+				hash.add(index);
+				continue;
+			}
+
+			NodeOperationOutput *output = input->getLink();
+			NodeOperation *inputOperation = &output->getOperation();
+			valid = determine_operation_hash(inputOperation, seed, hashes, &input_hash);
+			hash.add(input_hash.get());
+			for (unsigned int output_index = 0; output_index < inputOperation->getNumberOfOutputSockets(); output_index++) {
+				if (inputOperation->getOutputSocket(output_index) == output) {
+					hash.add(output_index);
+				}
+			}
+		}
+	}
+
+	hash.add(operation->getWidth());
+	hash.add(operation->getHeight());
+
+	hashes[operation] = std::make_pair(valid, hash);
+	*r_hash = hash;
+	return valid;
+}
+
+void ExecutionSystem::restoreCachedBuffers()
+{
+	const RenderData *rd = this->m_context.getRenderData();
+	OperationHashMap hashes;
+	OperationHash seed;
+
+	/* settings used by nodes when converting to operations */
+	seed.add(this->m_context.getQuality());
+	seed.add(this->m_context.isFastCalculation());
+	seed.add(rd->xsch);
+	seed.add(rd->ysch);
+	seed.add(rd->xasp);
+	seed.add(rd->yasp);
+	seed.add(rd->size);
+	seed.add(rd->scemode & R_FULL_SAMPLE);
+
+	BufferCache::beginExecution();
+	this->m_cacheableGroups.clear();
+
+	if (this->m_context.getbNodeTree()->flag & NTREE_COM_NO_BUFFER_CACHE) {
+		return;
+	}
+
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *group = this->m_groups[index];
+		NodeOperation *operation = group->getOutputOperation();
+		if (!operation->isWriteBufferOperation() || group->getWidth() == 0 || group->getHeight() == 0) {
+			continue;
+		}
+
+		OperationHash hash;
+		if (!determine_operation_hash(operation, seed, hashes, &hash)) {
+			continue;
+		}
+
+		MemoryBuffer *buffer = ((WriteBufferOperation *)operation)->getMemoryProxy()->getBuffer();
+		if (BufferCache::lookup(hash, buffer)) {
+			group->setExecuted();
+		}
+		else {
+			this->m_cacheableGroups.push_back(std::make_pair(group, hash));
+		}
+	}
+}
+
+void ExecutionSystem::storeCachedBuffers()
+{
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
+
+	/* chunks are finalized without being calculated when breaking */
+	if (!(editingtree->test_break && editingtree->test_break(editingtree->tbh))) {
+		for (GroupHashes::iterator it = this->m_cacheableGroups.begin(); it != this->m_cacheableGroups.end(); ++it) {
+			ExecutionGroup *group = it->first;
+			if (group->isExecuted()) {
+				WriteBufferOperation *operation = (WriteBufferOperation *)group->getOutputOperation();
+				BufferCache::store(it->second, operation->getMemoryProxy()->getBuffer());
+			}
+		}
+	}
+	this->m_cacheableGroups.clear();
+
+	if (G.debug & G_DEBUG) {
+		BufferCache::printStatistics();
+	}
+}
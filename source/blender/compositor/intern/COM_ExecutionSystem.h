@@ -29,6 +29,7 @@ class ExecutionGroup;
 #include "DNA_node_types.h"
 #include "COM_Node.h"
 #include "BKE_text.h"
+#include "COM_BufferCache.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_NodeOperation.h"
 
@@ -114,6 +115,7 @@ class ExecutionSystem {
 public:
 	typedef std::vector<NodeOperation*> Operations;
 	typedef std::vector<ExecutionGroup*> Groups;
+	typedef std::vector<std::pair<ExecutionGroup*, OperationHash> > GroupHashes;
 	
 private:
 	/**
@@ -131,6 +133,11 @@ private:
 	 */
 	Groups m_groups;
 
+	/**
+	 * @brief groups whose buffer is stored in the BufferCache after execution
+	 */
+	GroupHashes m_cacheableGroups;
+
 private: //methods
 	/**
 	 * find all execution group with output nodes
@@ -177,6 +184,17 @@ public:
 private:
 	void executeGroups(CompositorPriority priority);
 
+	/**
+	 * @brief restore the buffers of unchanged groups from the BufferCache
+	 * and remember the other groups that can be cached
+	 */
+	void restoreCachedBuffers();
+
+	/**
+	 * @brief store the buffers of the fully executed groups in the BufferCache
+	 */
+	void storeCachedBuffers();
+
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
 
@@ -24,8 +24,16 @@
 #include <stdio.h>
 
 #include "COM_defines.h"
+#include "COM_BufferCache.h"
 #include "COM_ExecutionSystem.h"
 
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#  include "BKE_node.h"
+#  include "DNA_color_types.h"
+}
+
 #include "COM_NodeOperation.h" /* own include */
 
 /*******************
@@ -41,6 +49,7 @@ NodeOperation::NodeOperation()
 	this->m_isResolutionSet = false;
 	this->m_openCL = false;
 	this->m_btree = NULL;
+	this->m_bnode = NULL;
 }
 
 NodeOperation::~NodeOperation()
@@ -192,6 +201,73 @@ bool NodeOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOper
 	}
 }
 
+bool NodeOperation::hashParameters(OperationHash &hash) const
+{
+	/* input operations read their data from outside of the node tree */
+	if (isInputOperation()) {
+		return false;
+	}
+	return hashNode(hash);
+}
+
+/* the curves are copied for each execution, hash the points and not the arrays */
+static void hash_curve_mapping(OperationHash &hash, const CurveMapping *cumap)
+{
+	hash.add(cumap->flag);
+	hash.add(cumap->preset);
+	hash.add(cumap->curr);
+	hash.add(cumap->clipr);
+	hash.add(cumap->black);
+	hash.add(cumap->white);
+	for (int i = 0; i < CM_TOT; i++) {
+		const CurveMap *cuma = &cumap->cm[i];
+		hash.add(cuma->totpoint);
+		hash.add(cuma->flag);
+		hash.add(cuma->ext_in);
+		hash.add(cuma->ext_out);
+		if (cuma->curve) {
+			hash.add(cuma->curve, sizeof(CurveMapPoint) * cuma->totpoint);
+		}
+	}
+}
+
+bool NodeOperation::hashNode(OperationHash &hash) const
+{
+	const bNode *node = this->m_bnode;
+	if (node == NULL) {
+		return true;
+	}
+	if (node->id) {
+		return false;
+	}
+
+	hash.add(node->type);
+	hash.add(node->custom1);
+	hash.add(node->custom2);
+	hash.add(node->custom3);
+	hash.add(node->custom4);
+	if (node->storage) {
+		/* storage with pointers needs its own hash, the pointed data is copied for each execution */
+		switch (node->type) {
+			case CMP_NODE_CURVE_RGB:
+			case CMP_NODE_CURVE_VEC:
+			case CMP_NODE_HUECORRECT:
+			case CMP_NODE_TIME:
+				hash_curve_mapping(hash, (const CurveMapping *)node->storage);
+				break;
+			default:
+				hash.add(node->storage, MEM_allocN_len(node->storage));
+				break;
+		}
+	}
+	for (bNodeSocket *sock = (bNodeSocket *)node->inputs.first; sock; sock = sock->next) {
+		if (sock->default_value) {
+			hash.add(sock->default_value, MEM_allocN_len(sock->default_value));
+		}
+	}
+	return true;
+}
+
 
 /*****************
  **** OpInput ****
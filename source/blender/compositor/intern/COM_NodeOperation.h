@@ -45,6 +45,7 @@ using std::min;
 using std::max;
 
 class OpenCLDevice;
+class OperationHash;
 class ReadBufferOperation;
 class WriteBufferOperation;
 
@@ -121,6 +122,11 @@ private:
 	 */
 	const bNodeTree *m_btree;
 
+	/**
+	 * @brief reference to the bNode this operation was converted from, NULL for conversions
+	 */
+	const bNode *m_bnode;
+
 	/**
 	 * @brief set to truth when resolution for this operation is set
 	 */
@@ -166,6 +172,7 @@ public:
 	virtual int isSingleThreaded() { return false; }
 
 	void setbNodeTree(const bNodeTree *tree) { this->m_btree = tree; }
+	void setbNode(const bNode *node) { this->m_bnode = node; }
 	virtual void initExecution();
 	
 	/**
@@ -295,6 +302,17 @@ public:
 	virtual bool isProxyOperation() const { return false; }
 	
 	virtual bool useDatatypeConversion() const { return true; }
+
+	/**
+	 * @brief add the parameters of this operation to the hash identifying its result
+	 * @note called after initExecution, the inputs are hashed by the caller
+	 * @see BufferCache
+	 * @return false when the result depends on data outside of the node tree
+	 * (render results, movie clips, the scene camera), it can't be cached then.
+	 * By default the settings of the bNode are hashed, input operations have to
+	 * hash their data themselves.
+	 */
+	virtual bool hashParameters(OperationHash &hash) const;
 	
 	inline bool isBreaked() const {
 		return this->m_btree->test_break(this->m_btree->tbh);
@@ -315,6 +333,14 @@ protected:
 	SocketReader *getInputSocketReader(unsigned int inputSocketindex);
 	NodeOperation *getInputOperation(unsigned int inputSocketindex);
 
+	/**
+	 * @brief hash the settings and unconnected input values of the bNode
+	 * @note node storage is hashed byte by byte, storage pointing to other
+	 * data (like curve mappings) must be hashed by node type
+	 * @return false when the node uses an ID data-block
+	 */
+	bool hashNode(OperationHash &hash) const;
+
 	void deinitMutex();
 	void initMutex();
 	void lockMutex();
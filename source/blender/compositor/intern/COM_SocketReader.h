@@ -95,6 +95,22 @@ protected:
 	                                  float /*x*/, float /*y*/,
 	                                  float /*dx*/[2], float /*dy*/[2]) {}
 
+	/**
+	 * @brief calculate a row of pixels with the nearest sampler
+	 * @note operations can override this to process whole rows of their inputs at once,
+	 * instead of reading them pixel by pixel. By default executePixelSampled is called
+	 * for every pixel.
+	 * @param output array of width float[4] pixels to store the result
+	 * @param x the x-coordinate of the first pixel to calculate in image space
+	 * @param y the y-coordinate of the row to calculate in image space
+	 * @param width the number of pixels to calculate, at most COM_ROW_SIZE
+	 */
+	virtual void executeRow(float *output, int x, int y, int width) {
+		for (int i = 0; i < width; i++) {
+			executePixelSampled(&output[i * 4], x + i, y, COM_PS_NEAREST);
+		}
+	}
+
 public:
 	inline void readSampled(float result[4], float x, float y, PixelSampler sampler) {
 		executePixelSampled(result, x, y, sampler);
@@ -105,6 +121,9 @@ public:
 	inline void readFiltered(float result[4], float x, float y, float dx[2], float dy[2]) {
 		executePixelFiltered(result, x, y, dx, dy);
 	}
+	inline void readRow(float *result, int x, int y, int width) {
+		executeRow(result, x, y, width);
+	}
 
 	virtual void *initializeTileData(rcti * /*rect*/) { return 0; }
 	virtual void deinitializeTileData(rcti * /*rect*/, void * /*data*/) {}
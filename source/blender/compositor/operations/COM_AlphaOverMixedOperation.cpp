@@ -55,3 +55,33 @@ void AlphaOverMixedOperation::executePixelSampled(float output[4], float x, floa
 	}
 }
 
+void AlphaOverMixedOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float inputColor1[COM_ROW_SIZE * 4];
+	float inputOverColor[COM_ROW_SIZE * 4];
+
+	readInputRows(value, inputColor1, inputOverColor, x, y, width);
+	for (int i = 0; i < width; i++) {
+		const float *color1 = &inputColor1[i * 4];
+		const float *over = &inputOverColor[i * 4];
+		float *out = &output[i * 4];
+
+		if (over[3] <= 0.0f) {
+			copy_v4_v4(out, color1);
+		}
+		else if (value[i] == 1.0f && over[3] >= 1.0f) {
+			copy_v4_v4(out, over);
+		}
+		else {
+			float addfac = 1.0f - this->m_x + over[3] * this->m_x;
+			float premul = value[i] * addfac;
+			float mul = 1.0f - value[i] * over[3];
+
+			out[0] = (mul * color1[0]) + premul * over[0];
+			out[1] = (mul * color1[1]) + premul * over[1];
+			out[2] = (mul * color1[2]) + premul * over[2];
+			out[3] = (mul * color1[3]) + value[i] * over[3];
+		}
+	}
+}
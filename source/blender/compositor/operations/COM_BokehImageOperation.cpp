@@ -21,6 +21,7 @@
  */
 
 #include "COM_BokehImageOperation.h"
+#include "COM_BufferCache.h"
 #include "BLI_math.h"
 
 BokehImageOperation::BokehImageOperation() : NodeOperation()
@@ -121,3 +122,9 @@ void BokehImageOperation::determineResolution(unsigned int resolution[2], unsign
 	resolution[0] = COM_BLUR_BOKEH_PIXELS;
 	resolution[1] = COM_BLUR_BOKEH_PIXELS;
 }
+
+bool BokehImageOperation::hashParameters(OperationHash &hash) const
+{
+	hash.add(*this->m_data);
+	return true;
+}
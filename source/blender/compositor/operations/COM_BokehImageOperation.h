@@ -130,6 +130,8 @@ public:
 	 */
 	void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
 
+	bool hashParameters(OperationHash &hash) const;
+
 	/**
 	 * @brief set the node data
 	 * @param data
@@ -68,6 +68,27 @@ void ColorBalanceASCCDLOperation::executePixelSampled(float output[4], float x,
 
 }
 
+void ColorBalanceASCCDLOperation::executeRow(float *output, int x, int y, int width)
+{
+	float inputColor[COM_ROW_SIZE * 4];
+	float value[COM_ROW_SIZE * 4];
+
+	this->m_inputValueOperation->readRow(value, x, y, width);
+	this->m_inputColorOperation->readRow(inputColor, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float *color = &inputColor[i * 4];
+		const float fac = min(1.0f, value[i * 4]);
+		const float mfac = 1.0f - fac;
+		float *out = &output[i * 4];
+
+		for (int c = 0; c < 3; c++) {
+			out[c] = mfac * color[c] + fac * colorbalance_cdl(color[c], this->m_offset[c], this->m_power[c], this->m_slope[c]);
+		}
+		out[3] = color[3];
+	}
+}
+
 void ColorBalanceASCCDLOperation::deinitExecution()
 {
 	this->m_inputValueOperation = NULL;
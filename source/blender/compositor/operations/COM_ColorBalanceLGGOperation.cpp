@@ -73,6 +73,27 @@ void ColorBalanceLGGOperation::executePixelSampled(float output[4], float x, flo
 
 }
 
+void ColorBalanceLGGOperation::executeRow(float *output, int x, int y, int width)
+{
+	float inputColor[COM_ROW_SIZE * 4];
+	float value[COM_ROW_SIZE * 4];
+
+	this->m_inputValueOperation->readRow(value, x, y, width);
+	this->m_inputColorOperation->readRow(inputColor, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float *color = &inputColor[i * 4];
+		const float fac = min(1.0f, value[i * 4]);
+		const float mfac = 1.0f - fac;
+		float *out = &output[i * 4];
+
+		for (int c = 0; c < 3; c++) {
+			out[c] = mfac * color[c] + fac * colorbalance_lgg(color[c], this->m_lift[c], this->m_gamma_inv[c], this->m_gain[c]);
+		}
+		out[3] = color[3];
+	}
+}
+
 void ColorBalanceLGGOperation::deinitExecution()
 {
 	this->m_inputValueOperation = NULL;
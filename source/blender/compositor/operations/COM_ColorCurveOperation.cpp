@@ -152,6 +152,34 @@ void ConstantLevelColorCurveOperation::executePixelSampled(float output[4], floa
 	output[3] = image[3];
 }
 
+void ConstantLevelColorCurveOperation::executeRow(float *output, int x, int y, int width)
+{
+	float fac[COM_ROW_SIZE * 4];
+	float image[COM_ROW_SIZE * 4];
+
+	this->m_inputFacProgram->readRow(fac, x, y, width);
+	this->m_inputImageProgram->readRow(image, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float f = fac[i * 4];
+		const float *col_in = &image[i * 4];
+		float *out = &output[i * 4];
+
+		if (f >= 1.0f) {
+			curvemapping_evaluate_premulRGBF(this->m_curveMapping, out, col_in);
+		}
+		else if (f <= 0.0f) {
+			copy_v3_v3(out, col_in);
+		}
+		else {
+			float col[4];
+			curvemapping_evaluate_premulRGBF(this->m_curveMapping, col, col_in);
+			interp_v3_v3v3(out, col_in, col, f);
+		}
+		out[3] = col_in[3];
+	}
+}
+
 void ConstantLevelColorCurveOperation::deinitExecution()
 {
 	CurveBaseOperation::deinitExecution();
@@ -71,6 +71,9 @@ public:
 	void setCameraObject(Object *camera) { this->m_cameraObject = camera; }
 	float determineFocalDistance();
 	void setPostBlur(FastGaussianBlurValueOperation *operation) {this->m_blurPostOperation = operation;}
+
+	/* the radius depends on the scene camera */
+	bool hashParameters(OperationHash & /*hash*/) const { return false; }
 	
 };
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "COM_ImageOperation.h"
+#include "COM_BufferCache.h"
 
 #include "BLI_listbase.h"
 #include "DNA_image_types.h"
@@ -107,6 +108,39 @@ void BaseImageOperation::deinitExecution()
 	BKE_image_release_ibuf(this->m_image, this->m_buffer, NULL);
 }
 
+bool BaseImageOperation::hashParameters(OperationHash &hash) const
+{
+	if (this->m_image == NULL || this->m_buffer == NULL) {
+		return true;
+	}
+
+	/* render results and viewers are written during the compositing */
+	if (!ELEM(this->m_image->source, IMA_SRC_FILE, IMA_SRC_SEQUENCE, IMA_SRC_MOVIE, IMA_SRC_GENERATED)) {
+		return false;
+	}
+
+	/* Image buffers are painted in place, and reloaded, regenerated or loaded
+	 * for another frame at the same address: the pixels are hashed, not the buffer. */
+	const ImBuf *ibuf = this->m_buffer;
+	const size_t num_pixels = (size_t)ibuf->x * (size_t)ibuf->y;
+	const int channels = (ibuf->channels) ? ibuf->channels : 4;
+
+	hash.add(ibuf->x);
+	hash.add(ibuf->y);
+	hash.add(channels);
+	hash.add(ibuf->rect_colorspace);
+	if (ibuf->rect_float) {
+		hash.addBuffer(ibuf->rect_float, sizeof(float) * channels * num_pixels);
+	}
+	if (ibuf->rect) {
+		hash.addBuffer(ibuf->rect, sizeof(unsigned int) * num_pixels);
+	}
+	if (ibuf->zbuf_float) {
+		hash.addBuffer(ibuf->zbuf_float, sizeof(float) * num_pixels);
+	}
+	return true;
+}
+
 void BaseImageOperation::determineResolution(unsigned int resolution[2], unsigned int /*preferredResolution*/[2])
 {
 	ImBuf *stackbuf = getImBuf();
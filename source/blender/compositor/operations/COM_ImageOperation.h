@@ -69,6 +69,8 @@ public:
 	void setRenderData(const RenderData *rd) { this->m_rd = rd; }
 	void setViewName(const char *viewName) { this->m_viewName = viewName; }
 	void setFramenumber(int framenumber) { this->m_framenumber = framenumber; }
+
+	bool hashParameters(OperationHash &hash) const;
 };
 class ImageOperation : public BaseImageOperation {
 public:
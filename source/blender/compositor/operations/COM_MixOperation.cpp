@@ -26,6 +26,17 @@ extern "C" {
 #  include "BLI_math.h"
 }
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+
+/* color with the alpha of another one, mix operations keep the alpha of their first color */
+static inline __m128 sse_with_alpha(__m128 color, __m128 alpha_color)
+{
+	const __m128 mask_rgb = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+	return _mm_or_ps(_mm_and_ps(mask_rgb, color), _mm_andnot_ps(mask_rgb, alpha_color));
+}
+#endif
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation() : NodeOperation()
@@ -69,6 +80,39 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
 	output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::readInputRows(float *value, float *color1, float *color2, int x, int y, int width)
+{
+	this->m_inputValueOperation->readRow(value, x, y, width);
+	this->m_inputColor1Operation->readRow(color1, x, y, width);
+	this->m_inputColor2Operation->readRow(color2, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		value[i] = value[i * 4];
+	}
+	if (this->useValueAlphaMultiply()) {
+		for (int i = 0; i < width; i++) {
+			value[i] *= color2[i * 4 + 3];
+		}
+	}
+}
+
+void MixBaseOperation::clampRowIfNeeded(float *output, int width)
+{
+	if (m_useClamp) {
+#ifdef __SSE2__
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (int i = 0; i < width; i++) {
+			_mm_storeu_ps(&output[i * 4], _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&output[i * 4]), zero), one));
+		}
+#else
+		for (int i = 0; i < width * 4; i++) {
+			CLAMP(output[i], 0.0f, 1.0f);
+		}
+#endif
+	}
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	NodeOperationInput *socket;
@@ -129,6 +173,31 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
 	clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float color1[COM_ROW_SIZE * 4];
+	float color2[COM_ROW_SIZE * 4];
+
+	readInputRows(value, color1, color2, x, y, width);
+#ifdef __SSE2__
+	for (int i = 0; i < width; i++) {
+		const __m128 fac = _mm_set1_ps(value[i]);
+		const __m128 c1 = _mm_loadu_ps(&color1[i * 4]);
+		const __m128 c2 = _mm_loadu_ps(&color2[i * 4]);
+		_mm_storeu_ps(&output[i * 4], sse_with_alpha(_mm_add_ps(c1, _mm_mul_ps(fac, c2)), c1));
+	}
+#else
+	for (int i = 0; i < width; i++) {
+		output[i * 4 + 0] = color1[i * 4 + 0] + value[i] * color2[i * 4 + 0];
+		output[i * 4 + 1] = color1[i * 4 + 1] + value[i] * color2[i * 4 + 1];
+		output[i * 4 + 2] = color1[i * 4 + 2] + value[i] * color2[i * 4 + 2];
+		output[i * 4 + 3] = color1[i * 4 + 3];
+	}
+#endif
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -160,6 +229,34 @@ void MixBlendOperation::executePixelSampled(float output[4], float x, float y, P
 	clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float color1[COM_ROW_SIZE * 4];
+	float color2[COM_ROW_SIZE * 4];
+
+	readInputRows(value, color1, color2, x, y, width);
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (int i = 0; i < width; i++) {
+		const __m128 fac = _mm_set1_ps(value[i]);
+		const __m128 facm = _mm_sub_ps(one, fac);
+		const __m128 c1 = _mm_loadu_ps(&color1[i * 4]);
+		const __m128 c2 = _mm_loadu_ps(&color2[i * 4]);
+		_mm_storeu_ps(&output[i * 4], sse_with_alpha(_mm_add_ps(_mm_mul_ps(facm, c1), _mm_mul_ps(fac, c2)), c1));
+	}
+#else
+	for (int i = 0; i < width; i++) {
+		const float valuem = 1.0f - value[i];
+		output[i * 4 + 0] = valuem * color1[i * 4 + 0] + value[i] * color2[i * 4 + 0];
+		output[i * 4 + 1] = valuem * color1[i * 4 + 1] + value[i] * color2[i * 4 + 1];
+		output[i * 4 + 2] = valuem * color1[i * 4 + 2] + value[i] * color2[i * 4 + 2];
+		output[i * 4 + 3] = color1[i * 4 + 3];
+	}
+#endif
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixBurnOperation::MixBurnOperation() : MixBaseOperation()
@@ -623,6 +720,34 @@ void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float color1[COM_ROW_SIZE * 4];
+	float color2[COM_ROW_SIZE * 4];
+
+	readInputRows(value, color1, color2, x, y, width);
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (int i = 0; i < width; i++) {
+		const __m128 fac = _mm_set1_ps(value[i]);
+		const __m128 facm = _mm_sub_ps(one, fac);
+		const __m128 c1 = _mm_loadu_ps(&color1[i * 4]);
+		const __m128 c2 = _mm_loadu_ps(&color2[i * 4]);
+		_mm_storeu_ps(&output[i * 4], sse_with_alpha(_mm_mul_ps(c1, _mm_add_ps(facm, _mm_mul_ps(fac, c2))), c1));
+	}
+#else
+	for (int i = 0; i < width; i++) {
+		const float valuem = 1.0f - value[i];
+		output[i * 4 + 0] = color1[i * 4 + 0] * (valuem + value[i] * color2[i * 4 + 0]);
+		output[i * 4 + 1] = color1[i * 4 + 1] * (valuem + value[i] * color2[i * 4 + 1]);
+		output[i * 4 + 2] = color1[i * 4 + 2] * (valuem + value[i] * color2[i * 4 + 2]);
+		output[i * 4 + 3] = color1[i * 4 + 3];
+	}
+#endif
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -740,6 +865,35 @@ void MixScreenOperation::executePixelSampled(float output[4], float x, float y,
 	clampIfNeeded(output);
 }
 
+void MixScreenOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float color1[COM_ROW_SIZE * 4];
+	float color2[COM_ROW_SIZE * 4];
+
+	readInputRows(value, color1, color2, x, y, width);
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (int i = 0; i < width; i++) {
+		const __m128 fac = _mm_set1_ps(value[i]);
+		const __m128 facm = _mm_sub_ps(one, fac);
+		const __m128 c1 = _mm_loadu_ps(&color1[i * 4]);
+		const __m128 c2 = _mm_loadu_ps(&color2[i * 4]);
+		const __m128 screen = _mm_mul_ps(_mm_add_ps(facm, _mm_mul_ps(fac, _mm_sub_ps(one, c2))), _mm_sub_ps(one, c1));
+		_mm_storeu_ps(&output[i * 4], sse_with_alpha(_mm_sub_ps(one, screen), c1));
+	}
+#else
+	for (int i = 0; i < width; i++) {
+		const float valuem = 1.0f - value[i];
+		output[i * 4 + 0] = 1.0f - (valuem + value[i] * (1.0f - color2[i * 4 + 0])) * (1.0f - color1[i * 4 + 0]);
+		output[i * 4 + 1] = 1.0f - (valuem + value[i] * (1.0f - color2[i * 4 + 1])) * (1.0f - color1[i * 4 + 1]);
+		output[i * 4 + 2] = 1.0f - (valuem + value[i] * (1.0f - color2[i * 4 + 2])) * (1.0f - color1[i * 4 + 2]);
+		output[i * 4 + 3] = color1[i * 4 + 3];
+	}
+#endif
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -806,6 +960,31 @@ void MixSubtractOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRow(float *output, int x, int y, int width)
+{
+	float value[COM_ROW_SIZE * 4];
+	float color1[COM_ROW_SIZE * 4];
+	float color2[COM_ROW_SIZE * 4];
+
+	readInputRows(value, color1, color2, x, y, width);
+#ifdef __SSE2__
+	for (int i = 0; i < width; i++) {
+		const __m128 fac = _mm_set1_ps(value[i]);
+		const __m128 c1 = _mm_loadu_ps(&color1[i * 4]);
+		const __m128 c2 = _mm_loadu_ps(&color2[i * 4]);
+		_mm_storeu_ps(&output[i * 4], sse_with_alpha(_mm_sub_ps(c1, _mm_mul_ps(fac, c2)), c1));
+	}
+#else
+	for (int i = 0; i < width; i++) {
+		output[i * 4 + 0] = color1[i * 4 + 0] - value[i] * color2[i * 4 + 0];
+		output[i * 4 + 1] = color1[i * 4 + 1] - value[i] * color2[i * 4 + 1];
+		output[i * 4 + 2] = color1[i * 4 + 2] - value[i] * color2[i * 4 + 2];
+		output[i * 4 + 3] = color1[i * 4 + 3];
+	}
+#endif
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
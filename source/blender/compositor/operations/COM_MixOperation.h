@@ -50,6 +50,13 @@ protected:
 			CLAMP(color[3], 0.0f, 1.0f);
 		}
 	}
+
+	/**
+	 * Read a row of the inputs for executeRow, value contains a single
+	 * float per pixel, already multiplied by the alpha of color2 when needed.
+	 */
+	void readInputRows(float *value, float *color1, float *color2, int x, int y, int width);
+	void clampRowIfNeeded(float *output, int width);
 	
 public:
 	/**
@@ -84,12 +91,14 @@ class MixAddOperation : public MixBaseOperation {
 public:
 	MixAddOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 };
 
 class MixBlendOperation : public MixBaseOperation {
 public:
 	MixBlendOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 };
 
 class MixBurnOperation : public MixBaseOperation {
@@ -156,6 +165,7 @@ class MixMultiplyOperation : public MixBaseOperation {
 public:
 	MixMultiplyOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -174,6 +184,7 @@ class MixScreenOperation : public MixBaseOperation {
 public:
 	MixScreenOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -186,6 +197,7 @@ class MixSubtractOperation : public MixBaseOperation {
 public:
 	MixSubtractOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 };
 
 class MixValueOperation : public MixBaseOperation {
@@ -61,6 +61,9 @@ public:
 	                                      ReadBufferOperation *readOperation,
 	                                      rcti *output);
 
+	/* the distortion depends on the movie clip camera */
+	bool hashParameters(OperationHash & /*hash*/) const { return false; }
+
 };
 
 #endif
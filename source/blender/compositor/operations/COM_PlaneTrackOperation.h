@@ -84,6 +84,9 @@ public:
 
 	void initExecution();
 
+	/* the corners depend on the movie clip tracking */
+	bool hashParameters(OperationHash & /*hash*/) const { return false; }
+
 	void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 	{
 		PlaneTrackCommon::determineResolution(resolution, preferredResolution);
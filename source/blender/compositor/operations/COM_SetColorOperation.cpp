@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_BufferCache.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
@@ -34,8 +35,21 @@ void SetColorOperation::executePixelSampled(float output[4],
 	copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeRow(float *output, int /*x*/, int /*y*/, int width)
+{
+	for (int i = 0; i < width; i++) {
+		copy_v4_v4(&output[i * 4], this->m_color);
+	}
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+bool SetColorOperation::hashParameters(OperationHash &hash) const
+{
+	hash.add(this->m_color);
+	return true;
+}
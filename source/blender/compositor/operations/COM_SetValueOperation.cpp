@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_BufferCache.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
@@ -34,8 +35,21 @@ void SetValueOperation::executePixelSampled(float output[4],
 	output[0] = this->m_value;
 }
 
+void SetValueOperation::executeRow(float *output, int /*x*/, int /*y*/, int width)
+{
+	for (int i = 0; i < width; i++) {
+		output[i * 4] = this->m_value;
+	}
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+bool SetValueOperation::hashParameters(OperationHash &hash) const
+{
+	hash.add(this->m_value);
+	return true;
+}
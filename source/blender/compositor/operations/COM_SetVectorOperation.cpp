@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_BufferCache.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
@@ -37,8 +38,26 @@ void SetVectorOperation::executePixelSampled(float output[4],
 	output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeRow(float *output, int /*x*/, int /*y*/, int width)
+{
+	for (int i = 0; i < width; i++) {
+		output[i * 4 + 0] = this->m_x;
+		output[i * 4 + 1] = this->m_y;
+		output[i * 4 + 2] = this->m_z;
+	}
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+bool SetVectorOperation::hashParameters(OperationHash &hash) const
+{
+	hash.add(this->m_x);
+	hash.add(this->m_y);
+	hash.add(this->m_z);
+	hash.add(this->m_w);
+	return true;
+}
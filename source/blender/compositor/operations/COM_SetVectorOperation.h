@@ -55,9 +55,11 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int width);
 
 	void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
 	bool isSetOperation() const { return true; }
+	bool hashParameters(OperationHash &hash) const;
 
 	void setVector(const float vector[3]) {
 		setX(vector[0]);
@@ -67,6 +67,9 @@ public:
 	void deinitExecution();
 	void setRenderData(const RenderData *rd) { this->m_rd = rd; }
 	void setSceneColorManage(bool sceneColorManage) { this->m_sceneColorManage = sceneColorManage; }
+
+	/* the texture settings are not part of the node */
+	bool hashParameters(OperationHash & /*hash*/) const { return false; }
 };
 
 class TextureOperation : public TextureBaseOperation {
@@ -32,6 +32,8 @@ public:
 	WrapOperation(DataType datetype);
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	/* wrapped pixels can't be read as a row of the buffer */
+	void executeRow(float *output, int x, int y, int width) { SocketReader::executeRow(output, x, y, width); }
 
 	void setWrapping(int wrapping_type);
 	float getWrappedOriginalXPos(float x);
@@ -96,11 +96,21 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int x;
 		int y;
 		bool breaked = false;
+		float row[COM_ROW_SIZE * 4];
 		for (y = y1; y < y2 && (!breaked); y++) {
-			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-				offset4 += num_channels;
+			/* calculate the row in parts, color buffers are written directly */
+			for (x = x1; x < x2; x += COM_ROW_SIZE) {
+				const int width = min(x2 - x, COM_ROW_SIZE);
+				float *output = &buffer[(y * memoryBuffer->getWidth() + x) * num_channels];
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					this->m_input->readRow(output, x, y, width);
+				}
+				else {
+					this->m_input->readRow(row, x, y, width);
+					for (int i = 0; i < width; i++) {
+						memcpy(&output[i * num_channels], &row[i * 4], sizeof(float) * num_channels);
+					}
+				}
 			}
 			if (isBreaked()) {
 				breaked = true;
@@ -37,6 +37,7 @@
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
+#include "BLI_ohash.h"
 
 extern "C" {
 #include "DNA_action_types.h"
@@ -97,14 +98,14 @@ Depsgraph::Depsgraph()
     view_layer(NULL)
 {
 	BLI_spin_init(&lock);
-	id_hash = BLI_ghash_ptr_new("Depsgraph id hash");
+	id_hash = BLI_ohash_ptr_new("Depsgraph id hash");
 	entry_tags = BLI_gset_ptr_new("Depsgraph entry_tags");
 }
 
 Depsgraph::~Depsgraph()
 {
 	clear_id_nodes();
-	BLI_ghash_free(id_hash, NULL, NULL);
+	BLI_ohash_free(id_hash, NULL, NULL);
 	BLI_gset_free(entry_tags, NULL);
 	if (time_source != NULL) {
 		OBJECT_GUARDED_DELETE(time_source, TimeSourceDepsNode);
@@ -287,7 +288,7 @@ TimeSourceDepsNode *Depsgraph::find_time_source() const
 
 IDDepsNode *Depsgraph::find_id_node(const ID *id) const
 {
-	return reinterpret_cast<IDDepsNode *>(BLI_ghash_lookup(id_hash, id));
+	return reinterpret_cast<IDDepsNode *>(BLI_ohash_lookup(id_hash, id));
 }
 
 IDDepsNode *Depsgraph::add_id_node(ID *id, bool do_tag, ID *id_cow_hint)
@@ -306,7 +307,7 @@ IDDepsNode *Depsgraph::add_id_node(ID *id, bool do_tag, ID *id_cow_hint)
 		 * NOTE: We address ID nodes by the original ID pointer they are
 		 * referencing to.
 		 */
-		BLI_ghash_insert(id_hash, id, id_node);
+		BLI_ohash_insert(id_hash, id, id_node);
 		id_nodes.push_back(id_node);
 	}
 	else if (do_tag) {
@@ -340,7 +341,7 @@ void Depsgraph::clear_id_nodes()
 		OBJECT_GUARDED_DELETE(id_node, IDDepsNode);
 	}
 	/* Clear containers. */
-	BLI_ghash_clear(id_hash, NULL, NULL);
+	BLI_ohash_clear(id_hash, NULL, NULL);
 	id_nodes.clear();
 }
 
@@ -44,6 +44,7 @@ struct ID;
 struct GHash;
 struct Main;
 struct GSet;
+struct OHash;
 struct PointerRNA;
 struct PropertyRNA;
 struct Scene;
@@ -157,7 +158,7 @@ struct Depsgraph {
 	/* <ID : IDDepsNode> mapping from ID blocks to nodes representing these
 	 * blocks, used for quick lookups.
 	 */
-	GHash *id_hash;
+	OHash *id_hash;
 
 	/* Ordered list of ID nodes, order matches ID allocation order.
 	 * Used for faster iteration, especially for areas which are critical to
@@ -420,6 +420,7 @@ typedef struct bNodeTree {
 #define NTREE_COM_GROUPNODE_BUFFER	8	/* use groupnode buffers */
 #define NTREE_VIEWER_BORDER			16	/* use a border for viewer nodes */
 #define NTREE_IS_LOCALIZED			32	/* tree is localized copy, free when deleting node groups */
+#define NTREE_COM_NO_BUFFER_CACHE	64	/* don't keep the compositor buffers between executions */
 
 /* XXX not nice, but needed as a temporary flags
  * for group updates after library linking.
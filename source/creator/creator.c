@@ -267,8 +267,10 @@ int main(
 	/* NOTE: Special exception for guarded allocator type switch:
 	 *       we need to perform switch from lock-free to fully
 	 *       guarded allocator before any allocation happened.
+	 *       The same goes for the pool allocator, debugging wins.
 	 */
 	{
+		bool use_memory_pool = false;
 		int i;
 		for (i = 0; i < argc; i++) {
 			if (STREQ(argv[i], "--debug") || STREQ(argv[i], "-d") ||
@@ -276,12 +278,21 @@ int main(
 			{
 				printf("Switching to fully guarded memory allocator.\n");
 				MEM_use_guarded_allocator();
+				use_memory_pool = false;
 				break;
 			}
+			else if (STREQ(argv[i], "--enable-memory-pool")) {
+				use_memory_pool = true;
+			}
 			else if (STREQ(argv[i], "--")) {
 				break;
 			}
 		}
+
+		if (use_memory_pool) {
+			printf("Switching to pooled memory allocator.\n");
+			MEM_use_pool_allocator();
+		}
 	}
 
 #ifdef BUILD_DATE
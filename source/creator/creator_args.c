@@ -609,6 +609,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
 	printf("\n");
 	printf("Experimental Features:\n");
 	BLI_argsPrintArgDoc(ba, "--enable-copy-on-write");
+	BLI_argsPrintArgDoc(ba, "--enable-memory-pool");
 
 	/* Other options _must_ be last (anything not handled will show here) */
 	printf("\n");
@@ -1210,6 +1211,15 @@ static int arg_handle_use_copy_on_write(int UNUSED(argc), const char **UNUSED(ar
 	return 0;
 }
 
+static const char arg_handle_use_memory_pool_doc[] =
+"\n\tKeep freed small memory blocks in per-thread caches, for faster allocation"
+;
+static int arg_handle_use_memory_pool(int UNUSED(argc), const char **UNUSED(argv), void *UNUSED(data))
+{
+	/* Handled in main() since the allocator needs to be switched before any allocation happened. */
+	return 0;
+}
+
 static const char arg_handle_verbosity_set_doc[] =
 "<verbose>\n"
 "\tSet logging verbosity level."
@@ -1863,6 +1873,7 @@ void main_args_setup(bContext *C, bArgs *ba, SYS_SystemHandle *syshandle)
 	            CB_EX(arg_handle_debug_mode_generic_set, gpumem), (void *)G_DEBUG_GPU_SHADERS);
 
 	BLI_argsAdd(ba, 1, NULL, "--enable-copy-on-write", CB(arg_handle_use_copy_on_write), NULL);
+	BLI_argsAdd(ba, 1, NULL, "--enable-memory-pool", CB(arg_handle_use_memory_pool), NULL);
 
 	BLI_argsAdd(ba, 1, NULL, "--verbose", CB(arg_handle_verbosity_set), NULL);
 
@@ -0,0 +1,167 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file gameengine/Common/CM_JobSystem.cpp
+ *  \ingroup common
+ */
+
+#include "CM_JobSystem.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_mempool.h"
+
+struct CM_Job
+{
+	CM_JobPool *m_pool;
+	CM_JobSystem *m_jobSystem;
+	TaskRunFunction m_run;
+	void *m_taskdata;
+	bool m_freeTaskData;
+};
+
+static void job_run_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	CM_Job *job = (CM_Job *)taskdata;
+
+	const CM_JobSystem::Clock::time_point start = CM_JobSystem::Clock::now();
+	job->m_run(pool, job->m_taskdata, threadid);
+	job->m_jobSystem->AddJobTime(job->m_pool->GetQueue(), CM_JobSystem::Clock::now() - start);
+}
+
+/// Called by the task pool after the job ran and for cancelled jobs.
+static void job_free_func(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	CM_Job *job = (CM_Job *)taskdata;
+
+	if (job->m_freeTaskData) {
+		MEM_freeN(job->m_taskdata);
+	}
+	job->m_pool->FreeJob(job);
+}
+
+CM_JobSystem::CM_JobSystem(int numThreads)
+	:m_scheduler(BLI_task_scheduler_create(numThreads))
+{
+	ResetStats();
+}
+
+CM_JobSystem::~CM_JobSystem()
+{
+	BLI_task_scheduler_free(m_scheduler);
+}
+
+TaskScheduler *CM_JobSystem::GetScheduler() const
+{
+	return m_scheduler;
+}
+
+int CM_JobSystem::GetNumThreads() const
+{
+	return BLI_task_scheduler_num_threads(m_scheduler);
+}
+
+const char *CM_JobSystem::GetQueueName(Queue queue)
+{
+	static const char *names[QUEUE_MAX] = {"frame", "background", "streaming"};
+	return names[queue];
+}
+
+CM_JobSystem::QueueStats CM_JobSystem::GetQueueStats(Queue queue) const
+{
+	const Counters& counters = m_counters[queue];
+	const double busyTime = std::chrono::duration<double>(Clock::duration(counters.m_busyTime.load())).count();
+	const double elapsed = std::chrono::duration<double>(Clock::now() - m_statsStart).count();
+
+	QueueStats stats;
+	stats.m_jobs = counters.m_jobs;
+	stats.m_busyTime = busyTime;
+	stats.m_utilisation = (elapsed > 0.0) ? busyTime / (elapsed * GetNumThreads()) : 0.0;
+
+	return stats;
+}
+
+void CM_JobSystem::ResetStats()
+{
+	for (Counters& counters : m_counters) {
+		counters.m_jobs = 0;
+		counters.m_busyTime = 0;
+	}
+	m_statsStart = Clock::now();
+}
+
+CM_JobPool::CM_JobPool(CM_JobSystem *jobSystem, CM_JobSystem::Queue queue, void *userdata)
+	:m_jobSystem(jobSystem),
+	m_queue(queue)
+{
+	// Only frame jobs are waited for by the main thread every frame.
+	if (m_queue == CM_JobSystem::QUEUE_FRAME) {
+		m_pool = BLI_task_pool_create(m_jobSystem->GetScheduler(), userdata);
+	}
+	else {
+		m_pool = BLI_task_pool_create_background(m_jobSystem->GetScheduler(), userdata);
+	}
+
+	m_jobs = BLI_mempool_create(sizeof(CM_Job), 64, 64, BLI_MEMPOOL_NOP);
+}
+
+CM_JobPool::~CM_JobPool()
+{
+	// Cancels the remaining jobs, which releases their wrappers.
+	BLI_task_pool_free(m_pool);
+	BLI_mempool_destroy(m_jobs);
+}
+
+CM_JobSystem::Queue CM_JobPool::GetQueue() const
+{
+	return m_queue;
+}
+
+void CM_JobPool::FreeJob(CM_Job *job)
+{
+	m_jobsLock.Lock();
+	BLI_mempool_free(m_jobs, job);
+	m_jobsLock.Unlock();
+}
+
+void CM_JobPool::Push(TaskRunFunction run, void *taskdata, bool freeTaskData)
+{
+	m_jobsLock.Lock();
+	CM_Job *job = (CM_Job *)BLI_mempool_alloc(m_jobs);
+	m_jobsLock.Unlock();
+
+	job->m_pool = this;
+	job->m_jobSystem = m_jobSystem;
+	job->m_run = run;
+	job->m_taskdata = taskdata;
+	job->m_freeTaskData = freeTaskData;
+
+	const TaskPriority priority = (m_queue == CM_JobSystem::QUEUE_FRAME) ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW;
+	BLI_task_pool_push_ex(m_pool, job_run_func, job, true, job_free_func, priority);
+}
+
+void CM_JobPool::WorkAndWait()
+{
+	BLI_task_pool_work_and_wait(m_pool);
+}
@@ -0,0 +1,134 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file CM_JobSystem.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_JOBSYSTEM_H__
+#define __CM_JOBSYSTEM_H__
+
+#include "CM_Thread.h"
+
+#include "BLI_task.h"
+
+#include <atomic>
+#include <chrono>
+
+/** Engine wide worker threads shared by all the subsystems running jobs.
+ * Jobs are accounted to named queues to report how much of the threads each subsystem uses.
+ */
+class CM_JobSystem
+{
+public:
+	enum Queue {
+		/// Jobs the current frame waits for: sensors, animations, levels of detail.
+		QUEUE_FRAME = 0,
+		/// Jobs completing in the background: screenshot saving.
+		QUEUE_BACKGROUND,
+		/// Asset streaming: asynchronous library loading.
+		QUEUE_STREAMING,
+		QUEUE_MAX
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct QueueStats {
+		/// Number of jobs run.
+		unsigned int m_jobs;
+		/// Time spent running the jobs in seconds.
+		double m_busyTime;
+		/// Busy time divided by the time of all threads since the last reset.
+		double m_utilisation;
+	};
+
+private:
+	TaskScheduler *m_scheduler;
+
+	struct Counters {
+		std::atomic<unsigned int> m_jobs;
+		/// Busy time in clock ticks.
+		std::atomic<Clock::rep> m_busyTime;
+	} m_counters[QUEUE_MAX];
+
+	Clock::time_point m_statsStart;
+
+public:
+	/** Create the worker threads.
+	 * \param numThreads The number of threads including the main thread, 0 to use all the cores.
+	 */
+	CM_JobSystem(int numThreads);
+	~CM_JobSystem();
+
+	TaskScheduler *GetScheduler() const;
+	/// Return the number of threads including the main thread.
+	int GetNumThreads() const;
+
+	static const char *GetQueueName(Queue queue);
+	QueueStats GetQueueStats(Queue queue) const;
+	void ResetStats();
+
+	/// Account a job run of the queue, called from the worker threads.
+	void AddJobTime(Queue queue, Clock::duration time)
+	{
+		Counters& counters = m_counters[queue];
+		++counters.m_jobs;
+		counters.m_busyTime += time.count();
+	}
+};
+
+struct BLI_mempool;
+struct CM_Job;
+
+/** Pool of jobs pushed to one queue of the job system.
+ * The pool user data is still accessible from the jobs with BLI_task_pool_userdata.
+ */
+class CM_JobPool
+{
+private:
+	CM_JobSystem *m_jobSystem;
+	CM_JobSystem::Queue m_queue;
+	TaskPool *m_pool;
+
+	/// Job wrappers reused between pushes, released from the worker threads.
+	BLI_mempool *m_jobs;
+	CM_ThreadSpinLock m_jobsLock;
+
+public:
+	CM_JobPool(CM_JobSystem *jobSystem, CM_JobSystem::Queue queue, void *userdata = nullptr);
+	~CM_JobPool();
+
+	CM_JobSystem::Queue GetQueue() const;
+
+	/// Release a job wrapper, called from the worker threads.
+	void FreeJob(CM_Job *job);
+
+	/** Push a job, frame jobs are scheduled before the others.
+	 * \param freeTaskData Free taskdata with MEM_freeN after the job ran or when it is cancelled.
+	 */
+	void Push(TaskRunFunction run, void *taskdata, bool freeTaskData = false);
+	/// Run the pool jobs from the calling thread too and wait until all of them are done.
+	void WorkAndWait();
+};
+
+#endif  // __CM_JOBSYSTEM_H__
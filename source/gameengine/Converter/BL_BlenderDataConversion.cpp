@@ -51,6 +51,7 @@
 
 #include <math.h>
 #include <vector>
+#include <memory>
 #include <algorithm>
 
 #include "BL_BlenderDataConversion.h"
@@ -111,6 +112,7 @@
 
 #include "KX_KetsjiEngine.h"
 #include "KX_BlenderSceneConverter.h"
+#include "BL_MeshCache.h"
 
 #include "KX_Globals.h"
 #include "KX_PyConstraintBinding.h"
@@ -152,6 +154,7 @@
 #include "BKE_mesh.h"
 
 #include "BLI_math.h"
+#include "PIL_time.h"
 
 extern "C" {
 #include "BKE_scene.h"
@@ -437,17 +440,6 @@ static KX_BlenderMaterial *ConvertMaterial(
 	return kx_blmat;
 }
 
-/// Convert uv and color layers for a given vertex and material.
-static void uvsRgbFromMesh(Material *ma, MFace *mface, MTFace *tface, const RAS_MeshObject::LayerList& layers,
-	unsigned int rgb[4][RAS_IVertex::MAX_UNIT], MT_Vector2 uvs[4][RAS_Texture::MaxUnits])
-{
-	if (mface) {
-		GetRGB(mface, layers, rgb);
-
-		GetUVs(layers, mface, tface, uvs);
-	}
-}
-
 static RAS_MaterialBucket *material_from_mesh(Material *ma, int lightlayer, KX_Scene *scene, RAS_Rasterizer *rasty, KX_BlenderSceneConverter& converter)
 {
 	KX_BlenderMaterial* mat = converter.FindMaterial(ma);
@@ -466,22 +458,20 @@ static RAS_MaterialBucket *material_from_mesh(Material *ma, int lightlayer, KX_S
 	return bucket;
 }
 
-/* blenderobj can be nullptr, make sure its checked for */
-RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene, RAS_Rasterizer *rasty, KX_BlenderSceneConverter& converter, bool libloading)
+/// Return for each material index of the mesh if its material uses wire lines.
+static std::vector<bool> BL_GetWireMaterials(Mesh *mesh)
 {
-	RAS_MeshObject *meshobj;
-	int lightlayer = blenderobj ? blenderobj->lay:(1<<20)-1; // all layers if no object.
-
-	// Without checking names, we get some reuse we don't want that can cause
-	// problems with material LoDs.
-	if (blenderobj && ((meshobj = converter.FindGameMesh(mesh/*, ob->lay*/)) != nullptr)) {
-		const std::string bge_name = meshobj->GetName();
-		const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
-		if (bge_name == blender_name) {
-			return meshobj;
-		}
+	std::vector<bool> wireMaterials(max_ii(mesh->totcol, 1), false);
+	for (unsigned short i = 0, size = wireMaterials.size(); i < size; ++i) {
+		Material *ma = mesh->mat ? mesh->mat[i] : nullptr;
+		wireMaterials[i] = (ma && ma->material_type == MA_TYPE_WIRE);
 	}
+	return wireMaterials;
+}
 
+/// Compute the tessellated faces of a mesh with their corners data.
+static std::shared_ptr<BL_MeshCache::MeshData> BL_ComputeMeshData(Mesh *mesh, const std::vector<bool>& wireMaterials, uint64_t key)
+{
 	// Get DerivedMesh data
 	DerivedMesh *dm = CDDM_from_mesh(mesh);
 	DM_ensure_tessface(dm);
@@ -506,15 +496,19 @@ RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene,
 		}
 	}
 
+	std::shared_ptr<BL_MeshCache::MeshData> data = std::make_shared<BL_MeshCache::MeshData>();
+	data->m_key = key;
+	data->m_totvert = totvert;
+
 	// Extract avaiable layers
-	RAS_MeshObject::LayersInfo layersInfo;
+	RAS_MeshObject::LayerList layers;
 
 	// Get the active color and uv layer.
 	const short activeUv = CustomData_get_active_layer(&dm->faceData, CD_MTFACE);
 	const short activeColor = CustomData_get_active_layer(&dm->faceData, CD_MCOL);
 
-	layersInfo.activeUv = (activeUv == -1) ? 0 : activeUv;
-	layersInfo.activeColor = (activeColor == -1) ? 0 : activeColor;
+	data->m_activeUv = (activeUv == -1) ? 0 : activeUv;
+	data->m_activeColor = (activeColor == -1) ? 0 : activeColor;
 
 	unsigned short uvLayers = 0;
 	unsigned short colorLayers = 0;
@@ -545,75 +539,49 @@ RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene,
 				++uvLayers;
 			}
 
-			layersInfo.layers.push_back(layer);
+			layers.push_back(layer);
+			data->m_layers.push_back({layer.name, layer.index, (layer.color != nullptr)});
 		}
 	}
 
-	meshobj = new RAS_MeshObject(blenderobj, mesh, layersInfo);
+	data->m_uvSize = max_ii(1, uvLayers);
+	data->m_colorSize = max_ii(1, colorLayers);
+	data->Resize(totface);
 
-	meshobj->m_sharedvertex_map.resize(totvert);
-
-	RAS_VertexFormat vertformat;
-	vertformat.uvSize = max_ii(1, uvLayers);
-	vertformat.colorSize = max_ii(1, colorLayers);
-
-	Material* ma = 0;
 	MT_Vector2 uvs[4][RAS_Texture::MaxUnits];
 	unsigned int rgb[4][RAS_IVertex::MAX_UNIT];
 
-	MT_Vector3 pt[4];
-	MT_Vector3 no[4];
-	MT_Vector4 tan[4];
-
-	/* ugh, if there is a less annoying way to do this please use that.
-	 * since these are converted from floats to floats, theres no real
-	 * advantage to use MT_ types - campbell */
-	for (unsigned int i = 0; i < 4; i++) {
-		const float zero_vec[4] = {0.0f};
-		pt[i].setValue(zero_vec);
-		no[i].setValue(zero_vec);
-		tan[i].setValue(zero_vec);
-	}
-
 	/* we need to manually initialize the uvs (MoTo doesn't do that) [#34550] */
 	for (unsigned int i = 0; i < RAS_IVertex::MAX_UNIT; i++) {
 		uvs[0][i] = uvs[1][i] = uvs[2][i] = uvs[3][i] = MT_Vector2(0.f, 0.f);
 		rgb[0][i] = rgb[1][i] = rgb[2][i] = rgb[3][i] = 0xffffffffL;
 	}
 
-	// Convert all the materials contained in the mesh.
-	for (unsigned short i = 0, size = max_ii(mesh->totcol, 1); i < size; ++i) {
-		ma = mesh->mat ? mesh->mat[i] : nullptr;
-		// Check for blender material
-		if (!ma) {
-			ma = &defmaterial;
-		}
-
-		RAS_MaterialBucket *bucket = material_from_mesh(ma, lightlayer, scene, rasty, converter);
-		meshobj->AddMaterial(bucket, i, vertformat);
-	}
-
 	for (int f=0;f<totface;f++,mface++)
 	{
+		BL_MeshCache::Face& face = data->m_faces[f];
+		const unsigned int nverts = (mface->v4) ? 4 : 3;
+		const unsigned int mfaceindices[4] = {mface->v1, mface->v2, mface->v3, mface->v4};
+
+		face.m_matNr = mface->mat_nr;
+		face.m_numVerts = nverts;
+		/* mark face as flat, so vertices are split */
+		face.m_flat = (mface->flag & ME_SMOOTH) == 0;
+
+		const unsigned int corner = f * 4;
+		float (*positions)[3] = (float (*)[3])&data->m_positions[corner * 3];
+		float (*normals)[3] = (float (*)[3])&data->m_normals[corner * 3];
+		float (*tangents)[4] = (float (*)[4])&data->m_tangents[corner * 4];
+
 		/* get coordinates, normals and tangents */
-		pt[0].setValue(mvert[mface->v1].co);
-		pt[1].setValue(mvert[mface->v2].co);
-		pt[2].setValue(mvert[mface->v3].co);
-		if (mface->v4) pt[3].setValue(mvert[mface->v4].co);
+		for (unsigned int i = 0; i < nverts; ++i) {
+			face.m_origIndex[i] = mfaceindices[i];
+			copy_v3_v3(positions[i], mvert[mfaceindices[i]].co);
+		}
 
 		if (mface->flag & ME_SMOOTH) {
-			float n0[3], n1[3], n2[3], n3[3];
-
-			normal_short_to_float_v3(n0, mvert[mface->v1].no);
-			normal_short_to_float_v3(n1, mvert[mface->v2].no);
-			normal_short_to_float_v3(n2, mvert[mface->v3].no);
-			no[0] = MT_Vector3(n0);
-			no[1] = MT_Vector3(n1);
-			no[2] = MT_Vector3(n2);
-
-			if (mface->v4) {
-				normal_short_to_float_v3(n3, mvert[mface->v4].no);
-				no[3] = MT_Vector3(n3);
+			for (unsigned int i = 0; i < nverts; ++i) {
+				normal_short_to_float_v3(normals[i], mvert[mfaceindices[i]].no);
 			}
 		}
 		else {
@@ -624,81 +592,55 @@ RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene,
 			else
 				normal_tri_v3(fno,mvert[mface->v1].co, mvert[mface->v2].co, mvert[mface->v3].co);
 
-			no[0] = no[1] = no[2] = no[3] = MT_Vector3(fno);
+			for (unsigned int i = 0; i < nverts; ++i) {
+				copy_v3_v3(normals[i], fno);
+			}
 		}
 
 		if (tangent) {
-			tan[0] = MT_Vector4(tangent[f*4 + 0]);
-			tan[1] = MT_Vector4(tangent[f*4 + 1]);
-			tan[2] = MT_Vector4(tangent[f*4 + 2]);
-
-			if (mface->v4)
-				tan[3] = MT_Vector4(tangent[f*4 + 3]);
-		}
-		if (blenderobj)
-			ma = give_current_material(blenderobj, mface->mat_nr+1);
-		else
-			ma = mesh->mat ? mesh->mat[mface->mat_nr]:nullptr;
-
-		// Check for blender material
-		if (ma == nullptr) {
-			ma= &defmaterial;
+			for (unsigned int i = 0; i < nverts; ++i) {
+				copy_v4_v4(tangents[i], tangent[f*4 + i]);
+			}
 		}
 
-		{
-
-			uvsRgbFromMesh(ma, mface, tface, layersInfo.layers, rgb, uvs);
-			RAS_MeshMaterial *meshmat = meshobj->GetMeshMaterialBlenderIndex(mface->mat_nr);
-
-			// set render flags
-			bool visible = ((ma->game.flag & GEMAT_INVISIBLE)==0);
-			bool twoside = ((ma->game.flag  & GEMAT_BACKCULL)==0);
-			bool collider = ((ma->game.flag & GEMAT_NOPHYSICS)==0);
-
-			/* mark face as flat, so vertices are split */
-			bool flat = (mface->flag & ME_SMOOTH) == 0;
-				
-			int nverts = (mface->v4)? 4: 3;
-
-			unsigned int indices[4]; // all indices of the poly, can be a tri or quad.
-
-			indices[0] = meshobj->AddVertex(meshmat, pt[0], uvs[0], tan[0], rgb[0], no[0], flat, mface->v1);
-			indices[1] = meshobj->AddVertex(meshmat, pt[1], uvs[1], tan[1], rgb[1], no[1], flat, mface->v2);
-			indices[2] = meshobj->AddVertex(meshmat, pt[2], uvs[2], tan[2], rgb[2], no[2], flat, mface->v3);
+		GetRGB(mface, layers, rgb);
+		GetUVs(layers, mface, tface, uvs);
 
-			if (nverts == 4) {
-				indices[3] = meshobj->AddVertex(meshmat, pt[3], uvs[3], tan[3], rgb[3], no[3], flat, mface->v4);
+		for (unsigned int i = 0; i < nverts; ++i) {
+			float *cornerUvs = &data->m_uvs[(corner + i) * data->m_uvSize * 2];
+			for (unsigned short j = 0; j < data->m_uvSize; ++j) {
+				uvs[i][j].getValue(&cornerUvs[j * 2]);
 			}
+			memcpy(&data->m_colors[(corner + i) * data->m_colorSize], rgb[i], sizeof(unsigned int) * data->m_colorSize);
+		}
 
-			if (meshmat->GetBucket()->IsWire() && visible) {
-				// The fourth value can be uninitialized.
-				unsigned int mfaceindices[4] = {mface->v1, mface->v2, mface->v3, mface->v4};
-				MPoly *mpoly = mpolyarray + mfaceTompoly[f];
-				unsigned int lpstart = mpoly->loopstart;
-				unsigned int totlp = mpoly->totloop;
-				// Iterate on all edges (=loops) of the MPoly which contains the current MFace.
-				for (unsigned int i = lpstart; i < lpstart + totlp; ++i) {
-					MLoop *mloop = mlooparray + i;
-					// Get the edge.
-					MEdge *medge = medgearray + mloop->e;
-					// Iterate on all MFace vertices index.
-					for (unsigned short j = (nverts - 1), k = 0; k < nverts; j = k++) {
-						// If 2 vertices are the same as an edge, we add a line in the mesh.
-						if (ELEM(medge->v1, mfaceindices[j], mfaceindices[k]) &&
-							ELEM(medge->v2, mfaceindices[j], mfaceindices[k])) {
-							meshobj->AddLine(meshmat, indices[j], indices[k]);
-							break;
-						}
+		// Store the edges of the MPoly which are edges of the current MFace, used for wire materials only.
+		if (mfaceTompoly && mface->mat_nr < wireMaterials.size() && wireMaterials[mface->mat_nr]) {
+			MPoly *mpoly = mpolyarray + mfaceTompoly[f];
+			unsigned int lpstart = mpoly->loopstart;
+			unsigned int totlp = mpoly->totloop;
+			// Iterate on all edges (=loops) of the MPoly which contains the current MFace.
+			for (unsigned int i = lpstart; i < lpstart + totlp && face.m_numLines < 4; ++i) {
+				MLoop *mloop = mlooparray + i;
+				// Get the edge.
+				MEdge *medge = medgearray + mloop->e;
+				// Iterate on all MFace vertices index.
+				for (unsigned short j = (nverts - 1), k = 0; k < nverts; j = k++) {
+					// If 2 vertices are the same as an edge, we add a line in the mesh.
+					if (ELEM(medge->v1, mfaceindices[j], mfaceindices[k]) &&
+						ELEM(medge->v2, mfaceindices[j], mfaceindices[k])) {
+						face.m_lines[face.m_numLines][0] = j;
+						face.m_lines[face.m_numLines][1] = k;
+						++face.m_numLines;
+						break;
 					}
 				}
 			}
-			meshobj->AddPolygon(meshmat, nverts, indices, visible, collider, twoside);
 		}
 
 		if (tface) 
 			tface++;
-
-		for (RAS_MeshObject::LayerList::iterator it = layersInfo.layers.begin(), end = layersInfo.layers.end(); it != end; ++it) {
+		for (RAS_MeshObject::LayerList::iterator it = layers.begin(), end = layers.end(); it != end; ++it) {
 			RAS_MeshObject::Layer &layer = *it;
 
 			if (layer.face) {
@@ -709,6 +651,93 @@ RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene,
 			}
 		}
 	}
+
+	dm->release(dm);
+
+	return data;
+}
+
+/// Create the mesh object and its polygons in the material buckets of the scene from the computed mesh data.
+static RAS_MeshObject *BL_CreateMeshObject(const BL_MeshCache::MeshData& data, Mesh *mesh, Object *blenderobj, KX_Scene *scene,
+                                           RAS_Rasterizer *rasty, KX_BlenderSceneConverter& converter, bool libloading)
+{
+	int lightlayer = blenderobj ? blenderobj->lay:(1<<20)-1; // all layers if no object.
+
+	RAS_MeshObject::LayersInfo layersInfo;
+	layersInfo.activeUv = data.m_activeUv;
+	layersInfo.activeColor = data.m_activeColor;
+	for (const BL_MeshCache::Layer& cacheLayer : data.m_layers) {
+		// The layer data are only used during the conversion.
+		RAS_MeshObject::Layer layer = {nullptr, nullptr, cacheLayer.m_index, cacheLayer.m_name};
+		layersInfo.layers.push_back(layer);
+	}
+
+	RAS_MeshObject *meshobj = new RAS_MeshObject(blenderobj, mesh, layersInfo);
+
+	meshobj->m_sharedvertex_map.resize(data.m_totvert);
+
+	RAS_VertexFormat vertformat;
+	vertformat.uvSize = data.m_uvSize;
+	vertformat.colorSize = data.m_colorSize;
+
+	Material* ma = 0;
+
+	// Convert all the materials contained in the mesh.
+	for (unsigned short i = 0, size = max_ii(mesh->totcol, 1); i < size; ++i) {
+		ma = mesh->mat ? mesh->mat[i] : nullptr;
+		// Check for blender material
+		if (!ma) {
+			ma = &defmaterial;
+		}
+
+		RAS_MaterialBucket *bucket = material_from_mesh(ma, lightlayer, scene, rasty, converter);
+		meshobj->AddMaterial(bucket, i, vertformat);
+	}
+
+	MT_Vector2 uvs[4][RAS_Texture::MaxUnits];
+
+	for (unsigned int f = 0, totface = data.m_faces.size(); f < totface; ++f) {
+		const BL_MeshCache::Face& face = data.m_faces[f];
+
+		if (blenderobj)
+			ma = give_current_material(blenderobj, face.m_matNr+1);
+		else
+			ma = mesh->mat ? mesh->mat[face.m_matNr]:nullptr;
+
+		// Check for blender material
+		if (ma == nullptr) {
+			ma= &defmaterial;
+		}
+
+		RAS_MeshMaterial *meshmat = meshobj->GetMeshMaterialBlenderIndex(face.m_matNr);
+
+		// set render flags
+		bool visible = ((ma->game.flag & GEMAT_INVISIBLE)==0);
+		bool twoside = ((ma->game.flag  & GEMAT_BACKCULL)==0);
+		bool collider = ((ma->game.flag & GEMAT_NOPHYSICS)==0);
+
+		unsigned int indices[4]; // all indices of the poly, can be a tri or quad.
+
+		for (unsigned int i = 0; i < face.m_numVerts; ++i) {
+			const unsigned int corner = f * 4 + i;
+			const float *cornerUvs = &data.m_uvs[corner * data.m_uvSize * 2];
+			for (unsigned short j = 0; j < data.m_uvSize; ++j) {
+				uvs[i][j].setValue(&cornerUvs[j * 2]);
+			}
+
+			indices[i] = meshobj->AddVertex(meshmat, MT_Vector3(&data.m_positions[corner * 3]), uvs[i],
+			                                MT_Vector4(&data.m_tangents[corner * 4]), &data.m_colors[corner * data.m_colorSize],
+			                                MT_Vector3(&data.m_normals[corner * 3]), face.m_flat, face.m_origIndex[i]);
+		}
+
+		if (meshmat->GetBucket()->IsWire() && visible) {
+			for (unsigned short i = 0; i < face.m_numLines; ++i) {
+				meshobj->AddLine(meshmat, indices[face.m_lines[i][0]], indices[face.m_lines[i][1]]);
+			}
+		}
+		meshobj->AddPolygon(meshmat, face.m_numVerts, indices, visible, collider, twoside);
+	}
+
 	// keep meshobj->m_sharedvertex_map for reinstance phys mesh.
 	// 2.49a and before it did: meshobj->m_sharedvertex_map.clear();
 	// but this didnt save much ram. - Campbell
@@ -723,7 +752,52 @@ RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene,
 		}
 	}
 
-	dm->release(dm);
+	return meshobj;
+}
+
+/* blenderobj can be nullptr, make sure its checked for */
+RAS_MeshObject* BL_ConvertMesh(Mesh* mesh, Object* blenderobj, KX_Scene* scene, RAS_Rasterizer *rasty, KX_BlenderSceneConverter& converter, bool libloading)
+{
+	RAS_MeshObject *meshobj;
+
+	// Without checking names, we get some reuse we don't want that can cause
+	// problems with material LoDs.
+	if (blenderobj && ((meshobj = converter.FindGameMesh(mesh/*, ob->lay*/)) != nullptr)) {
+		const std::string bge_name = meshobj->GetName();
+		const std::string blender_name = ((ID *)blenderobj->data)->name + 2;
+		if (bge_name == blender_name) {
+			return meshobj;
+		}
+	}
+
+	const double starttime = PIL_check_seconds_timer();
+
+	/* The tessellated faces don't depend on the scene, they are reused from
+	 * the mesh cache when the same mesh content was already converted. */
+	BL_MeshCache *cache = converter.GetMeshCache();
+	const bool usecache = (cache && cache->GetEnabled());
+	BL_MeshCache::Source source = BL_MeshCache::SOURCE_CONVERTED;
+	std::shared_ptr<const BL_MeshCache::MeshData> data;
+	const std::vector<bool> wireMaterials = BL_GetWireMaterials(mesh);
+	uint64_t key = 0;
+
+	if (usecache) {
+		key = BL_MeshCache::ComputeKey(mesh, wireMaterials);
+		data = cache->Find(key, mesh, scene, source);
+	}
+
+	if (!data) {
+		data = BL_ComputeMeshData(mesh, wireMaterials, key);
+		if (usecache) {
+			cache->Add(data, mesh, scene);
+		}
+	}
+
+	meshobj = BL_CreateMeshObject(*data, mesh, blenderobj, scene, rasty, converter, libloading);
+
+	if (cache) {
+		cache->AddStat(mesh->id.name + 2, source, data->m_faces.size(), PIL_check_seconds_timer() - starttime);
+	}
 
 	converter.RegisterGameMesh(meshobj, mesh);
 	return meshobj;
@@ -0,0 +1,491 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_MeshCache.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_MeshCache.h"
+
+#include "CM_Message.h"
+
+extern "C" {
+#  include "DNA_mesh_types.h"
+#  include "DNA_meshdata_types.h"
+#  include "BKE_customdata.h"
+#  include "BLI_utildefines.h"
+#  include "BLI_hash_mm2a.h"
+#  include "BLI_fileops.h"
+#  include "BLI_path_util.h"
+}
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+/// Header of a saved mesh file, the layers, faces and corner arrays follow it.
+struct MeshFileHeader
+{
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_totvert;
+	uint64_t m_key;
+	uint16_t m_activeUv;
+	uint16_t m_activeColor;
+	uint16_t m_uvSize;
+	uint16_t m_colorSize;
+	uint32_t m_numLayers;
+	uint32_t m_numFaces;
+};
+
+static const char meshFileMagic[8] = {'B', 'G', 'E', 'M', 'E', 'S', 'H', '\0'};
+/// Increase when the conversion or the file layout change to invalidate the saved files.
+static const uint32_t meshFileVersion = 2;
+
+void BL_MeshCache::MeshData::Resize(unsigned int numFaces)
+{
+	const unsigned int numCorners = numFaces * 4;
+	m_faces.resize(numFaces);
+	m_positions.resize(numCorners * 3, 0.0f);
+	m_normals.resize(numCorners * 3, 0.0f);
+	m_tangents.resize(numCorners * 4, 0.0f);
+	m_uvs.resize(numCorners * m_uvSize * 2, 0.0f);
+	m_colors.resize(numCorners * m_colorSize, 0xffffffff);
+}
+
+size_t BL_MeshCache::MeshData::GetMemorySize() const
+{
+	size_t size = sizeof(MeshData) + sizeof(Layer) * m_layers.capacity() + sizeof(Face) * m_faces.capacity() +
+	              sizeof(float) * (m_positions.capacity() + m_normals.capacity() + m_tangents.capacity() + m_uvs.capacity()) +
+	              sizeof(unsigned int) * m_colors.capacity();
+	for (const Layer& layer : m_layers) {
+		size += layer.m_name.capacity();
+	}
+	return size;
+}
+
+BL_MeshCache::BL_MeshCache()
+	:m_enabled(true),
+	m_memorySize(0),
+	m_memoryBudget(256 * 1024 * 1024),
+	m_statIndex(0),
+	m_numConversions(0),
+	m_totalTime(0.0)
+{
+}
+
+BL_MeshCache::~BL_MeshCache()
+{
+}
+
+bool BL_MeshCache::GetEnabled() const
+{
+	return m_enabled;
+}
+
+void BL_MeshCache::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+void BL_MeshCache::SetDirectory(const std::string& directory)
+{
+	m_directory = directory;
+	if (!m_directory.empty() && !BLI_is_dir(m_directory.c_str()) && !BLI_dir_create_recursive(m_directory.c_str())) {
+		CM_Error("failed to create the mesh cache directory " << m_directory);
+		m_directory.clear();
+	}
+}
+
+void BL_MeshCache::SetMemoryBudget(size_t budget)
+{
+	m_mutex.Lock();
+	m_memoryBudget = budget;
+	Evict(0);
+	m_mutex.Unlock();
+}
+
+/// Hash the data in two murmur hashes with different seeds to make a 64 bits key.
+struct KeyHash
+{
+	BLI_HashMurmur2A m_low;
+	BLI_HashMurmur2A m_high;
+
+	KeyHash()
+	{
+		BLI_hash_mm2a_init(&m_low, 0);
+		BLI_hash_mm2a_init(&m_high, 0x9747b28c);
+	}
+
+	void Add(const void *data, size_t len)
+	{
+		if (data && len > 0) {
+			BLI_hash_mm2a_add(&m_low, (const unsigned char *)data, len);
+			BLI_hash_mm2a_add(&m_high, (const unsigned char *)data, len);
+		}
+	}
+
+	void AddInt(int data)
+	{
+		BLI_hash_mm2a_add_int(&m_low, data);
+		BLI_hash_mm2a_add_int(&m_high, data);
+	}
+
+	uint64_t End()
+	{
+		return ((uint64_t)BLI_hash_mm2a_end(&m_high) << 32) | BLI_hash_mm2a_end(&m_low);
+	}
+};
+
+uint64_t BL_MeshCache::ComputeKey(Mesh *mesh, const std::vector<bool>& wireMaterials)
+{
+	KeyHash hash;
+
+	hash.AddInt(meshFileVersion);
+	hash.AddInt(mesh->totvert);
+	hash.AddInt(mesh->totedge);
+	hash.AddInt(mesh->totpoly);
+	hash.AddInt(mesh->totloop);
+	hash.AddInt(mesh->totcol);
+
+	// The wire lines are only computed for the faces using a wire material.
+	for (unsigned int i = 0, size = wireMaterials.size(); i < size; ++i) {
+		if (wireMaterials[i]) {
+			hash.AddInt(i);
+		}
+	}
+
+	hash.Add(mesh->mvert, sizeof(MVert) * mesh->totvert);
+	hash.Add(mesh->medge, sizeof(MEdge) * mesh->totedge);
+	hash.Add(mesh->mpoly, sizeof(MPoly) * mesh->totpoly);
+	hash.Add(mesh->mloop, sizeof(MLoop) * mesh->totloop);
+
+	// The tessellated uv and color layers are computed from the loop layers.
+	hash.AddInt(CustomData_get_active_layer(&mesh->ldata, CD_MLOOPUV));
+	hash.AddInt(CustomData_get_active_layer(&mesh->ldata, CD_MLOOPCOL));
+	for (int i = 0; i < mesh->ldata.totlayer; ++i) {
+		const CustomDataLayer& layer = mesh->ldata.layers[i];
+		if (!ELEM(layer.type, CD_MLOOPUV, CD_MLOOPCOL)) {
+			continue;
+		}
+
+		hash.AddInt(layer.type);
+		hash.Add(layer.name, strlen(layer.name));
+		hash.Add(layer.data, CustomData_sizeof(layer.type) * mesh->totloop);
+	}
+
+	return hash.End();
+}
+
+std::string BL_MeshCache::GetFilePath(uint64_t key) const
+{
+	std::stringstream name;
+	name << std::hex << std::setfill('0') << std::setw(16) << key << ".bgemesh";
+
+	char path[FILE_MAX];
+	BLI_join_dirfile(path, sizeof(path), m_directory.c_str(), name.str().c_str());
+	return path;
+}
+
+std::shared_ptr<const BL_MeshCache::MeshData> BL_MeshCache::Load(uint64_t key) const
+{
+	const std::string filepath = GetFilePath(key);
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file) {
+		return nullptr;
+	}
+
+	MeshFileHeader header;
+	if (!file.read((char *)&header, sizeof(MeshFileHeader)) || memcmp(header.m_magic, meshFileMagic, sizeof(meshFileMagic)) != 0 ||
+		header.m_version != meshFileVersion || header.m_key != key)
+	{
+		CM_Warning("ignoring invalid mesh cache file " << filepath);
+		return nullptr;
+	}
+
+	std::shared_ptr<MeshData> data = std::make_shared<MeshData>();
+	data->m_key = key;
+	data->m_totvert = header.m_totvert;
+	data->m_activeUv = header.m_activeUv;
+	data->m_activeColor = header.m_activeColor;
+	data->m_uvSize = header.m_uvSize;
+	data->m_colorSize = header.m_colorSize;
+
+	data->m_layers.resize(header.m_numLayers);
+	for (Layer& layer : data->m_layers) {
+		uint16_t index;
+		uint8_t color;
+		uint8_t length;
+		char name[256];
+		if (!file.read((char *)&index, sizeof(index)) || !file.read((char *)&color, sizeof(color)) ||
+			!file.read((char *)&length, sizeof(length)) || !file.read(name, length))
+		{
+			CM_Warning("truncated mesh cache file " << filepath);
+			return nullptr;
+		}
+
+		layer.m_name.assign(name, length);
+		layer.m_index = index;
+		layer.m_color = color;
+	}
+
+	data->Resize(header.m_numFaces);
+	file.read((char *)data->m_faces.data(), sizeof(Face) * data->m_faces.size());
+	file.read((char *)data->m_positions.data(), sizeof(float) * data->m_positions.size());
+	file.read((char *)data->m_normals.data(), sizeof(float) * data->m_normals.size());
+	file.read((char *)data->m_tangents.data(), sizeof(float) * data->m_tangents.size());
+	file.read((char *)data->m_uvs.data(), sizeof(float) * data->m_uvs.size());
+	file.read((char *)data->m_colors.data(), sizeof(unsigned int) * data->m_colors.size());
+
+	if (!file) {
+		CM_Warning("truncated mesh cache file " << filepath);
+		return nullptr;
+	}
+
+	return data;
+}
+
+bool BL_MeshCache::Save(const MeshData& data) const
+{
+	const std::string filepath = GetFilePath(data.m_key);
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file) {
+		CM_Error("failed to write the mesh cache file " << filepath);
+		return false;
+	}
+
+	MeshFileHeader header;
+	memcpy(header.m_magic, meshFileMagic, sizeof(meshFileMagic));
+	header.m_version = meshFileVersion;
+	header.m_totvert = data.m_totvert;
+	header.m_key = data.m_key;
+	header.m_activeUv = data.m_activeUv;
+	header.m_activeColor = data.m_activeColor;
+	header.m_uvSize = data.m_uvSize;
+	header.m_colorSize = data.m_colorSize;
+	header.m_numLayers = data.m_layers.size();
+	header.m_numFaces = data.m_faces.size();
+
+	file.write((const char *)&header, sizeof(MeshFileHeader));
+
+	for (const Layer& layer : data.m_layers) {
+		const uint16_t index = layer.m_index;
+		const uint8_t color = layer.m_color;
+		const uint8_t length = std::min<size_t>(layer.m_name.size(), 255);
+		file.write((const char *)&index, sizeof(index));
+		file.write((const char *)&color, sizeof(color));
+		file.write((const char *)&length, sizeof(length));
+		file.write(layer.m_name.data(), length);
+	}
+
+	file.write((const char *)data.m_faces.data(), sizeof(Face) * data.m_faces.size());
+	file.write((const char *)data.m_positions.data(), sizeof(float) * data.m_positions.size());
+	file.write((const char *)data.m_normals.data(), sizeof(float) * data.m_normals.size());
+	file.write((const char *)data.m_tangents.data(), sizeof(float) * data.m_tangents.size());
+	file.write((const char *)data.m_uvs.data(), sizeof(float) * data.m_uvs.size());
+	file.write((const char *)data.m_colors.data(), sizeof(unsigned int) * data.m_colors.size());
+
+	return (bool)file;
+}
+
+void BL_MeshCache::Use(Entry& entry, uint64_t key, const Mesh *mesh, const void *user)
+{
+	// Move to the most recently used.
+	m_lru.splice(m_lru.begin(), m_lru, entry.m_lruIt);
+
+	if (std::find(entry.m_users.begin(), entry.m_users.end(), user) == entry.m_users.end()) {
+		entry.m_users.push_back(user);
+	}
+
+	std::map<const Mesh *, uint64_t>::iterator meshIt = m_meshKeys.find(mesh);
+	if (meshIt == m_meshKeys.end()) {
+		m_meshKeys[mesh] = key;
+		++entry.m_numMeshes;
+	}
+	else if (meshIt->second != key) {
+		// The mesh content changed, the previous data is kept for the other meshes or evicted later.
+		std::map<uint64_t, Entry>::iterator it = m_entries.find(meshIt->second);
+		if (it != m_entries.end()) {
+			--it->second.m_numMeshes;
+		}
+		meshIt->second = key;
+		++entry.m_numMeshes;
+	}
+}
+
+void BL_MeshCache::Insert(const std::shared_ptr<const MeshData>& data, const Mesh *mesh, const void *user)
+{
+	const uint64_t key = data->m_key;
+	const size_t size = data->GetMemorySize();
+	if (size > m_memoryBudget) {
+		return;
+	}
+
+	std::map<uint64_t, Entry>::iterator it = m_entries.find(key);
+	if (it == m_entries.end()) {
+		m_lru.push_front(key);
+		Entry& entry = m_entries[key];
+		entry.m_data = data;
+		entry.m_size = size;
+		entry.m_numMeshes = 0;
+		entry.m_lruIt = m_lru.begin();
+		m_memorySize += size;
+		Use(entry, key, mesh, user);
+	}
+	else {
+		Use(it->second, key, mesh, user);
+	}
+
+	Evict(key);
+}
+
+void BL_MeshCache::Erase(std::map<uint64_t, Entry>::iterator it)
+{
+	for (std::map<const Mesh *, uint64_t>::iterator meshIt = m_meshKeys.begin(); meshIt != m_meshKeys.end();) {
+		if (meshIt->second == it->first) {
+			meshIt = m_meshKeys.erase(meshIt);
+		}
+		else {
+			++meshIt;
+		}
+	}
+
+	m_memorySize -= it->second.m_size;
+	m_lru.erase(it->second.m_lruIt);
+	m_entries.erase(it);
+}
+
+void BL_MeshCache::Evict(uint64_t keep)
+{
+	while (m_memorySize > m_memoryBudget && !m_lru.empty() && m_lru.back() != keep) {
+		Erase(m_entries.find(m_lru.back()));
+	}
+}
+
+std::shared_ptr<const BL_MeshCache::MeshData> BL_MeshCache::Find(uint64_t key, const Mesh *mesh, const void *user, Source& source)
+{
+	m_mutex.Lock();
+	std::map<uint64_t, Entry>::iterator it = m_entries.find(key);
+	if (it != m_entries.end()) {
+		std::shared_ptr<const MeshData> data = it->second.m_data;
+		Use(it->second, key, mesh, user);
+		m_mutex.Unlock();
+		source = SOURCE_MEMORY;
+		return data;
+	}
+	m_mutex.Unlock();
+
+	if (m_directory.empty()) {
+		return nullptr;
+	}
+
+	std::shared_ptr<const MeshData> data = Load(key);
+	if (data) {
+		m_mutex.Lock();
+		Insert(data, mesh, user);
+		m_mutex.Unlock();
+		source = SOURCE_DISK;
+	}
+
+	return data;
+}
+
+void BL_MeshCache::Add(const std::shared_ptr<const MeshData>& data, const Mesh *mesh, const void *user)
+{
+	m_mutex.Lock();
+	Insert(data, mesh, user);
+	m_mutex.Unlock();
+
+	if (!m_directory.empty()) {
+		Save(*data);
+	}
+}
+
+void BL_MeshCache::RemoveMesh(const Mesh *mesh)
+{
+	m_mutex.Lock();
+	std::map<const Mesh *, uint64_t>::iterator meshIt = m_meshKeys.find(mesh);
+	if (meshIt != m_meshKeys.end()) {
+		std::map<uint64_t, Entry>::iterator it = m_entries.find(meshIt->second);
+		m_meshKeys.erase(meshIt);
+		if (it != m_entries.end() && --it->second.m_numMeshes == 0) {
+			Erase(it);
+		}
+	}
+	m_mutex.Unlock();
+}
+
+void BL_MeshCache::RemoveUser(const void *user)
+{
+	m_mutex.Lock();
+	for (std::map<uint64_t, Entry>::value_type& pair : m_entries) {
+		Entry& entry = pair.second;
+		std::vector<const void *>::iterator userIt = std::find(entry.m_users.begin(), entry.m_users.end(), user);
+		if (userIt == entry.m_users.end()) {
+			continue;
+		}
+
+		entry.m_users.erase(userIt);
+		// Move to the least recently used to be evicted first.
+		if (entry.m_users.empty()) {
+			m_lru.splice(m_lru.end(), m_lru, entry.m_lruIt);
+		}
+	}
+	m_mutex.Unlock();
+}
+
+void BL_MeshCache::AddStat(const std::string& name, Source source, unsigned int numFaces, double time)
+{
+	m_mutex.Lock();
+	if (m_stats.size() < maxStats) {
+		m_stats.push_back({name, source, numFaces, time});
+	}
+	else {
+		m_stats[m_statIndex] = {name, source, numFaces, time};
+	}
+	m_statIndex = (m_statIndex + 1) % maxStats;
+	++m_numConversions;
+	m_totalTime += time;
+	m_mutex.Unlock();
+}
+
+void BL_MeshCache::PrintStats()
+{
+	static const char *sourceNames[] = {"converted", "memory cache", "disk cache"};
+
+	m_mutex.Lock();
+
+	// Print the stats from the oldest kept.
+	const unsigned int numStats = m_stats.size();
+	const unsigned int first = (numStats < maxStats) ? 0 : m_statIndex;
+	for (unsigned int i = 0; i < numStats; ++i) {
+		const Stat& stat = m_stats[(first + i) % numStats];
+		CM_Message("\t " << stat.m_name << ": " << stat.m_numFaces << " faces, " << sourceNames[stat.m_source]
+				   << ", " << stat.m_time * 1000.0 << " ms");
+	}
+
+	CM_Message("\t conversions: " << m_numConversions << ", cached meshes: " << m_entries.size()
+			   << ", cache memory: " << m_memorySize / 1024 << "/" << m_memoryBudget / 1024 << " KB"
+			   << ", total time: " << m_totalTime * 1000.0 << " ms");
+
+	m_mutex.Unlock();
+}
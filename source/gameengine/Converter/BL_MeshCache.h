@@ -0,0 +1,203 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_MeshCache.h
+ *  \ingroup bgeconv
+ */
+
+#ifndef __BL_MESHCACHE_H__
+#define __BL_MESHCACHE_H__
+
+#include "CM_Thread.h"
+
+#include <map>
+#include <list>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct Mesh;
+
+/** Cache of the mesh data computed by BL_ConvertMesh: tessellated faces with their
+ * per corner positions, normals, tangents, uvs and colors and the wire lines.
+ * The data doesn't depend on the scene, it is keyed by a hash of the blender mesh content
+ * and of its wire materials, so restarting a scene or LibLoading the same assets again
+ * only creates the mesh objects from the cached data.
+ * The memory used by the data is limited by a budget, the least recently used data not
+ * used by any scene is evicted first. The data of the meshes freed by LibFree is dropped.
+ * The data can also be saved in a directory to be reused by the next launches.
+ */
+class BL_MeshCache
+{
+public:
+	/// UV or color layer of the mesh.
+	struct Layer
+	{
+		std::string m_name;
+		unsigned short m_index;
+		bool m_color;
+	};
+
+	/// Tessellated face, a triangle or a quad.
+	struct Face
+	{
+		/// Original vertex index of each corner.
+		uint32_t m_origIndex[4];
+		uint16_t m_matNr;
+		uint8_t m_numVerts;
+		uint8_t m_flat;
+		/// Pairs of corners making an edge of the original polygon, used for wire materials.
+		uint8_t m_lines[4][2];
+		uint8_t m_numLines;
+		uint8_t m_pad[3];
+	};
+
+	/// Converted mesh data, the corner arrays use 4 corners per face.
+	struct MeshData
+	{
+		uint64_t m_key;
+		unsigned int m_totvert;
+		unsigned short m_activeUv;
+		unsigned short m_activeColor;
+		/// Number of uv and color layers, at least 1.
+		unsigned short m_uvSize;
+		unsigned short m_colorSize;
+
+		std::vector<Layer> m_layers;
+		std::vector<Face> m_faces;
+
+		/// 3 floats per corner.
+		std::vector<float> m_positions;
+		std::vector<float> m_normals;
+		/// 4 floats per corner.
+		std::vector<float> m_tangents;
+		/// 2 floats per corner and uv layer.
+		std::vector<float> m_uvs;
+		/// 1 packed color per corner and color layer.
+		std::vector<unsigned int> m_colors;
+
+		/// Allocate the corner arrays for a number of faces.
+		void Resize(unsigned int numFaces);
+		/// Return the memory used by the data in bytes.
+		size_t GetMemorySize() const;
+	};
+
+	enum Source {
+		/// The mesh was converted from its blender data.
+		SOURCE_CONVERTED = 0,
+		/// The data was found in the memory cache.
+		SOURCE_MEMORY,
+		/// The data was loaded from the cache directory.
+		SOURCE_DISK
+	};
+
+	/// Conversion time of a mesh.
+	struct Stat
+	{
+		std::string m_name;
+		Source m_source;
+		unsigned int m_numFaces;
+		/// Time in seconds.
+		double m_time;
+	};
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<const MeshData> m_data;
+		size_t m_size;
+		/// Number of blender meshes with this content.
+		unsigned int m_numMeshes;
+		/// Scenes using the data.
+		std::vector<const void *> m_users;
+		/// Position in the recently used list.
+		std::list<uint64_t>::iterator m_lruIt;
+	};
+
+	/// Maximum number of conversion stats kept, the oldest are overwritten.
+	static const unsigned int maxStats = 256;
+
+	bool m_enabled;
+	/// Directory of the saved data, empty to only use the memory cache.
+	std::string m_directory;
+	std::map<uint64_t, Entry> m_entries;
+	/// Keys of the entries, the most recently used first.
+	std::list<uint64_t> m_lru;
+	/// Key of the data converted from each blender mesh.
+	std::map<const Mesh *, uint64_t> m_meshKeys;
+	/// Memory used by the data and its maximum in bytes.
+	size_t m_memorySize;
+	size_t m_memoryBudget;
+
+	/// Last conversion stats, used as a ring buffer.
+	std::vector<Stat> m_stats;
+	unsigned int m_statIndex;
+	unsigned int m_numConversions;
+	double m_totalTime;
+
+	/// Meshes can be converted from LibLoad threads.
+	CM_ThreadMutex m_mutex;
+
+	std::string GetFilePath(uint64_t key) const;
+	std::shared_ptr<const MeshData> Load(uint64_t key) const;
+	bool Save(const MeshData& data) const;
+
+	/// Functions called with the mutex locked.
+	void Use(Entry& entry, uint64_t key, const Mesh *mesh, const void *user);
+	void Insert(const std::shared_ptr<const MeshData>& data, const Mesh *mesh, const void *user);
+	void Erase(std::map<uint64_t, Entry>::iterator it);
+	/// Evict the least recently used data until the budget is respected, except the given key.
+	void Evict(uint64_t keep);
+
+public:
+	BL_MeshCache();
+	~BL_MeshCache();
+
+	bool GetEnabled() const;
+	void SetEnabled(bool enabled);
+	/// Set the directory to load and save the mesh data, empty to disable.
+	void SetDirectory(const std::string& directory);
+	/// Set the maximum memory used by the data in bytes.
+	void SetMemoryBudget(size_t budget);
+
+	/** Return the key of the mesh content, the hash of all the data read by the conversion.
+	 * \param wireMaterials Per material index, true when the material uses wire lines.
+	 */
+	static uint64_t ComputeKey(Mesh *mesh, const std::vector<bool>& wireMaterials);
+
+	/** Find the data of a mesh in memory or in the cache directory.
+	 * \param user The scene converting the mesh.
+	 * \param source Set to where the data was found.
+	 */
+	std::shared_ptr<const MeshData> Find(uint64_t key, const Mesh *mesh, const void *user, Source& source);
+	/// Store the data of a converted mesh, and save it when a directory is set.
+	void Add(const std::shared_ptr<const MeshData>& data, const Mesh *mesh, const void *user);
+
+	/// Drop the data of a freed blender mesh when no other mesh has the same content.
+	void RemoveMesh(const Mesh *mesh);
+	/// Release the data used by a removed scene, the data not used anymore is evicted first.
+	void RemoveUser(const void *user);
+
+	void AddStat(const std::string& name, Source source, unsigned int numFaces, double time);
+	void PrintStats();
+};
+
+#endif  // __BL_MESHCACHE_H__
@@ -57,6 +57,7 @@
 
 extern "C" {
 	#include "BKE_customdata.h"
+	#include "BKE_cdderivedmesh.h"
 	#include "BKE_DerivedMesh.h"
 	#include "BKE_lattice.h"
 	#include "BKE_modifier.h"
@@ -170,6 +171,82 @@ DerivedMesh *BL_ModifierDeformer::GetPhysicsMesh()
 	return dm;
 }
 
+bool BL_ModifierDeformer::IsDeformOnlyStack(Object *ob) const
+{
+	// Same modifiers as mesh_create_derived_no_virtual.
+	ModifierData *md = (ModifierData *)ob->modifiers.first;
+	if (md && md->type == eModifierType_Armature) {
+		md = md->next;
+	}
+
+	for (; md; md = md->next) {
+		if (!modifier_isEnabled(m_scene, md, eModifierMode_Realtime) || modifier_dependsOnTime(md)) {
+			continue;
+		}
+		if (modifierType_getInfo((ModifierType)md->type)->type != eModifierTypeType_OnlyDeform) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BL_ModifierDeformer::UpdateDeformOnly(Object *blendobj)
+{
+	const int totvert = m_bmesh->totvert;
+	/* The modifiers deform the coordinates in place, m_transverts is computed again
+	 * by the shape and skin deformers before each update. */
+	float (*coords)[3] = m_transverts;
+	if (!coords) {
+		coords = (float (*)[3])MEM_mallocN(sizeof(float[3]) * totvert, __func__);
+		for (int v = 0; v < totvert; ++v) {
+			copy_v3_v3(coords[v], m_bmesh->mvert[v].co);
+		}
+	}
+
+	EvaluationContext *eval_ctx = KX_GetActiveEngine()->GetConverter()->GetMain()->eval_ctx;
+
+	/* Same flags as the deform modifiers of mesh_create_derived_no_virtual, which
+	 * computes the deformation without render settings and with the modifiers cache. */
+	const ModifierApplyFlag deform_app_flags = MOD_APPLY_USECACHE;
+
+	ModifierData *md = (ModifierData *)blendobj->modifiers.first;
+	if (md && md->type == eModifierType_Armature) {
+		md = md->next;
+	}
+
+	for (; md; md = md->next) {
+		md->scene = m_scene;
+		if (!modifier_isEnabled(m_scene, md, eModifierMode_Realtime) || modifier_dependsOnTime(md)) {
+			continue;
+		}
+		modwrap_deformVerts(md, eval_ctx, blendobj, nullptr, coords, totvert, deform_app_flags);
+	}
+
+	CDDM_apply_vert_coords(m_dm, coords);
+
+	if (m_bmesh->flag & ME_AUTOSMOOTH) {
+		CDDM_calc_loop_normals(m_dm, true, m_bmesh->smoothresh);
+	}
+	else {
+		CDDM_calc_normals_mapping_ex(m_dm, false);
+	}
+
+	// Update object's AABB.
+	if (m_gameobj->GetAutoUpdateBounds()) {
+		float min[3], max[3];
+		INIT_MINMAX(min, max);
+		for (int v = 0; v < totvert; ++v) {
+			minmax_v3v3_v3(min, max, coords[v]);
+		}
+		m_boundingBox->SetAabb(MT_Vector3(min), MT_Vector3(max));
+	}
+
+	if (coords != m_transverts) {
+		MEM_freeN(coords);
+	}
+}
+
 bool BL_ModifierDeformer::Update(void)
 {
 	/* TODO: This doesn't work currently because of eval_ctx. */
@@ -180,43 +257,54 @@ bool BL_ModifierDeformer::Update(void)
 		if (m_dm == nullptr || m_bDynamic) {
 			// Set to true if it's the first time Update() function is called.
 			const bool initialize = (m_dm == nullptr);
-			/* execute the modifiers */
 			Object *blendobj = m_gameobj->GetBlendObject();
 			/* hack: the modifiers require that the mesh is attached to the object
 			 * It may not be the case here because of replace mesh actuator */
 			Mesh *oldmesh = (Mesh *)blendobj->data;
 			blendobj->data = m_bmesh;
-			/* execute the modifiers */
-			EvaluationContext *eval_ctx = KX_GetActiveEngine()->GetConverter()->GetMain()->eval_ctx;
-			DerivedMesh *dm = mesh_create_derived_no_virtual(eval_ctx, m_scene, blendobj, m_transverts, CD_MASK_MESH);
-			/* restore object data */
-			blendobj->data = oldmesh;
-			/* free the current derived mesh and replace, (dm should never be nullptr) */
-			if (m_dm != nullptr) {
+
+			/* A deform only stack doesn't change the topology of the derived mesh,
+			 * only its coordinates and normals are updated if it isn't shared with a replica. */
+			if (m_deformOnly && m_dm && m_dm->deformedOnly == 1 && m_dm->type == DM_TYPE_CDDM &&
+				m_dm->getNumVerts(m_dm) == m_bmesh->totvert)
+			{
+				UpdateDeformOnly(blendobj);
+				blendobj->data = oldmesh;
+			}
+			else {
+				/* execute the modifiers */
+				EvaluationContext *eval_ctx = KX_GetActiveEngine()->GetConverter()->GetMain()->eval_ctx;
+				DerivedMesh *dm = mesh_create_derived_no_virtual(eval_ctx, m_scene, blendobj, m_transverts, CD_MASK_MESH);
+				m_deformOnly = IsDeformOnlyStack(blendobj);
+				/* restore object data */
+				blendobj->data = oldmesh;
+				/* free the current derived mesh and replace, (dm should never be nullptr) */
+				if (m_dm != nullptr) {
+					// HACK! use deformedOnly as a user counter
+					if (--m_dm->deformedOnly == 0) {
+						m_dm->needsFree = 1;
+						m_dm->release(m_dm);
+					}
+				}
+				m_dm = dm;
+				// get rid of temporary data
+				m_dm->needsFree = 0;
+				m_dm->release(m_dm);
 				// HACK! use deformedOnly as a user counter
-				if (--m_dm->deformedOnly == 0) {
-					m_dm->needsFree = 1;
-					m_dm->release(m_dm);
+				m_dm->deformedOnly = 1;
+				DM_update_materials(m_dm, blendobj);
+
+				// Some meshes with modifiers returns 0 polys, call DM_ensure_tessface avoid this.
+				DM_ensure_tessface(m_dm);
+
+				// Update object's AABB.
+				if (initialize || m_gameobj->GetAutoUpdateBounds()) {
+					float min[3], max[3];
+					INIT_MINMAX(min, max);
+					m_dm->getMinMax(m_dm, min, max);
+					m_boundingBox->SetAabb(MT_Vector3(min), MT_Vector3(max));
 				}
 			}
-			m_dm = dm;
-			// get rid of temporary data
-			m_dm->needsFree = 0;
-			m_dm->release(m_dm);
-			// HACK! use deformedOnly as a user counter
-			m_dm->deformedOnly = 1;
-			DM_update_materials(m_dm, blendobj);
-
-			// Some meshes with modifiers returns 0 polys, call DM_ensure_tessface avoid this.
-			DM_ensure_tessface(m_dm);
-
-			// Update object's AABB.
-			if (initialize || m_gameobj->GetAutoUpdateBounds()) {
-				float min[3], max[3];
-				INIT_MINMAX(min, max);
-				m_dm->getMinMax(m_dm, min, max);
-				m_boundingBox->SetAabb(MT_Vector3(min), MT_Vector3(max));
-			}
 		}
 		m_lastModifierUpdate = m_gameobj->GetLastFrame();
 		bShapeUpdate = true;
@@ -57,7 +57,8 @@ public:
 		:BL_ShapeDeformer(gameobj, bmeshobj, mesh),
 		m_lastModifierUpdate(-1.0),
 		m_scene(scene),
-		m_dm(nullptr)
+		m_dm(nullptr),
+		m_deformOnly(false)
 	{
 		m_recalcNormal = false;
 	}
@@ -73,7 +74,8 @@ public:
 		:BL_ShapeDeformer(gameobj, bmeshobj_old, bmeshobj_new, mesh, release_object, false, arma),
 		m_lastModifierUpdate(-1),
 		m_scene(scene),
-		m_dm(nullptr)
+		m_dm(nullptr),
+		m_deformOnly(false)
 	{
 	}
 
@@ -102,6 +104,15 @@ protected:
 	double m_lastModifierUpdate;
 	Scene *m_scene;
 	DerivedMesh *m_dm;
+	/// True when the evaluated modifiers only move the vertices, see UpdateDeformOnly().
+	bool m_deformOnly;
+
+	/// Return true if all the modifiers evaluated in game only deform the vertices.
+	bool IsDeformOnlyStack(Object *ob) const;
+	/** Apply the deform modifiers to the vertex coordinates and copy them in the
+	 * current derived mesh, its topology, tessellation and materials are kept.
+	 */
+	void UpdateDeformOnly(Object *blendobj);
 };
 
 #endif  /* __BL_MODIFIERDEFORMER_H__ */
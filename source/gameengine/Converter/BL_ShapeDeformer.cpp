@@ -63,6 +63,10 @@ extern "C" {
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #define __NLA_DEFNORMALS
 //#undef __NLA_DEFNORMALS
 
@@ -181,16 +185,13 @@ bool BL_ShapeDeformer::Update()
 		/* we will blend the key directly in m_transverts array: it is used by armature as the start position */
 		/* m_key can be nullptr in case of Modifier deformer */
 		if (m_key) {
-			WeightsArrayCache cache = {0, nullptr};
-			float **per_keyblock_weights;
-
 			/* store verts locally */
 			VerifyStorage();
 
-			per_keyblock_weights = BKE_keyblock_get_per_block_weights(blendobj, m_key, &cache);
-			BKE_key_evaluate_relative(0, m_bmesh->totvert, m_bmesh->totvert, (char *)(float *)m_transverts,
-			                          m_key, nullptr, per_keyblock_weights, 0); /* last arg is ignored */
-			BKE_keyblock_free_per_block_weights(m_key, per_keyblock_weights, &cache);
+			if (!m_shapeData || m_shapeData->m_keyBlocks.size() != (unsigned int)m_key->totkey) {
+				BuildShapeData(blendobj);
+			}
+			BlendShapes();
 
 			m_bDynamic = true;
 		}
@@ -227,6 +228,120 @@ bool BL_ShapeDeformer::Update()
 	return bSkinUpdate;
 }
 
+/** Add the weighted deltas of a key block stored for all vertices, size is the number of floats.
+ * Most of the key blocks move only a part of the mesh and use sparse deltas instead.
+ */
+static void BlendDenseDeltas(float *verts, const float *deltas, float weight, unsigned int size)
+{
+	unsigned int i = 0;
+
+#ifdef __SSE2__
+	const __m128 w = _mm_set1_ps(weight);
+	for (; (i + 4) <= size; i += 4) {
+		_mm_storeu_ps(verts + i, _mm_add_ps(_mm_loadu_ps(verts + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), w)));
+	}
+#endif
+
+	for (; i < size; ++i) {
+		verts[i] += deltas[i] * weight;
+	}
+}
+
+void BL_ShapeDeformer::BuildShapeData(Object *blendobj)
+{
+	std::shared_ptr<ShapeData> data = std::make_shared<ShapeData>();
+	const unsigned int totvert = m_bmesh->totvert;
+
+	KeyBlock *refkb = m_key->refkey;
+	if (refkb && refkb->totelem == (int)totvert) {
+		const float *refco = (float *)refkb->data;
+		data->m_basis.assign(refco, refco + totvert * 3);
+	}
+
+	data->m_keyBlocks.resize(m_key->totkey);
+
+	// The vertex group weights don't change in game, they are applied once to the deltas.
+	WeightsArrayCache cache = {0, nullptr};
+	float **per_keyblock_weights = BKE_keyblock_get_per_block_weights(blendobj, m_key, &cache);
+
+	unsigned int index = 0;
+	for (KeyBlock *kb = (KeyBlock *)m_key->block.first; kb; kb = kb->next, ++index) {
+		if (kb == refkb || kb->totelem != (int)totvert) {
+			continue;
+		}
+
+		KeyBlock *relkb = (KeyBlock *)BLI_findlink(&m_key->block, kb->relative);
+		if (!relkb || relkb->totelem != (int)totvert) {
+			continue;
+		}
+
+		const float (*co)[3] = (float (*)[3])kb->data;
+		const float (*relco)[3] = (float (*)[3])relkb->data;
+		const float *weights = per_keyblock_weights[index];
+
+		KeyBlockDeltas& keyBlockDeltas = data->m_keyBlocks[index];
+		std::vector<unsigned int>& indices = keyBlockDeltas.m_indices;
+		std::vector<float>& deltas = keyBlockDeltas.m_deltas;
+
+		for (unsigned int v = 0; v < totvert; ++v) {
+			float delta[3];
+			sub_v3_v3v3(delta, co[v], relco[v]);
+			if (weights) {
+				mul_v3_fl(delta, weights[v]);
+			}
+
+			if (!is_zero_v3(delta)) {
+				indices.push_back(v);
+				deltas.insert(deltas.end(), delta, delta + 3);
+			}
+		}
+
+		// Past half of the vertices the indices cost more than the zero deltas.
+		keyBlockDeltas.m_dense = (indices.size() > (totvert / 2));
+		if (keyBlockDeltas.m_dense) {
+			std::vector<float> denseDeltas(totvert * 3, 0.0f);
+			for (unsigned int i = 0, size = indices.size(); i < size; ++i) {
+				copy_v3_v3(&denseDeltas[indices[i] * 3], &deltas[i * 3]);
+			}
+			deltas.swap(denseDeltas);
+			indices.clear();
+		}
+	}
+
+	BKE_keyblock_free_per_block_weights(m_key, per_keyblock_weights, &cache);
+
+	m_shapeData = data;
+}
+
+void BL_ShapeDeformer::BlendShapes()
+{
+	/* Same result as BKE_key_evaluate_relative but only the key blocks with a value
+	 * are iterated, and only on the vertices they move. */
+	if (!m_shapeData->m_basis.empty()) {
+		memcpy(m_transverts, m_shapeData->m_basis.data(), sizeof(float) * m_shapeData->m_basis.size());
+	}
+
+	unsigned int index = 0;
+	for (KeyBlock *kb = (KeyBlock *)m_key->block.first; kb; kb = kb->next, ++index) {
+		const float weight = kb->curval;
+		if (weight == 0.0f || (kb->flag & KEYBLOCK_MUTE)) {
+			continue;
+		}
+
+		const KeyBlockDeltas& keyBlockDeltas = m_shapeData->m_keyBlocks[index];
+		const std::vector<float>& deltas = keyBlockDeltas.m_deltas;
+		if (keyBlockDeltas.m_dense) {
+			BlendDenseDeltas((float *)m_transverts, deltas.data(), weight, deltas.size());
+		}
+		else {
+			const std::vector<unsigned int>& indices = keyBlockDeltas.m_indices;
+			for (unsigned int i = 0, size = indices.size(); i < size; ++i) {
+				madd_v3_v3fl(m_transverts[indices[i]], &deltas[i * 3], weight);
+			}
+		}
+	}
+}
+
 Key *BL_ShapeDeformer::GetKey()
 {
 	return m_key;
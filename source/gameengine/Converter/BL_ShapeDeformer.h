@@ -39,6 +39,7 @@
 #include "BL_SkinDeformer.h"
 #include "BL_DeformableGameObject.h"
 #include <vector>
+#include <memory>
 
 struct Object;
 struct Key;
@@ -76,9 +77,34 @@ public:
 	}
 
 protected:
+	/// Difference of a key block with its relative key block, multiplied by the vertex group weights.
+	struct KeyBlockDeltas
+	{
+		/// Vertex indices of the non-zero deltas, empty when the deltas are stored for all vertices.
+		std::vector<unsigned int> m_indices;
+		/// 3 floats per vertex index, or per vertex when dense.
+		std::vector<float> m_deltas;
+		bool m_dense;
+	};
+
+	/// Shape data precomputed at the first update and shared between the replicas.
+	struct ShapeData
+	{
+		/// Coordinates of the reference key block, empty to use the mesh vertices.
+		std::vector<float> m_basis;
+		/// Deltas of each key block, in the key block list order.
+		std::vector<KeyBlockDeltas> m_keyBlocks;
+	};
+
 	bool m_useShapeDrivers;
 	double m_lastShapeUpdate;
 	Key *m_key;
+	std::shared_ptr<const ShapeData> m_shapeData;
+
+	/// Compute the key blocks deltas of the current key and object vertex groups.
+	void BuildShapeData(Object *blendobj);
+	/// Blend the key blocks with a non-zero value in m_transverts.
+	void BlendShapes();
 };
 
 #endif
@@ -84,6 +84,7 @@ extern "C" {
 }
 
 #include "BLI_task.h"
+#include "CM_JobSystem.h"
 #include "CM_Message.h"
 
 KX_BlenderConverter::SceneSlot::SceneSlot() = default;
@@ -125,7 +126,12 @@ KX_BlenderConverter::KX_BlenderConverter(Main *maggie, KX_KetsjiEngine *engine)
 	m_alwaysUseExpandFraming(false)
 {
 	BKE_main_id_tag_all(maggie, LIB_TAG_DOIT, false);  // avoid re-tagging later on
-	m_threadinfo.m_pool = BLI_task_pool_create(engine->GetTaskScheduler(), nullptr);
+	m_threadinfo.m_pool = new CM_JobPool(engine->GetJobSystem(), CM_JobSystem::QUEUE_STREAMING);
+
+	SYS_SystemHandle syshandle = SYS_GetSystem();
+	m_meshCache.SetEnabled(SYS_GetCommandLineInt(syshandle, "mesh_cache", 1) != 0);
+	m_meshCache.SetDirectory(SYS_GetCommandLineString(syshandle, "mesh_cache_dir", ""));
+	m_meshCache.SetMemoryBudget((size_t)std::max(SYS_GetCommandLineInt(syshandle, "mesh_cache_size", 256), 0) * 1024 * 1024);
 }
 
 KX_BlenderConverter::~KX_BlenderConverter()
@@ -140,7 +146,7 @@ KX_BlenderConverter::~KX_BlenderConverter()
 	/* Thread infos like mutex must be freed after FreeBlendFile function.
 	   Because it needs to lock the mutex, even if there's no active task when it's
 	   in the scene converter destructor. */
-	BLI_task_pool_free(m_threadinfo.m_pool);
+	delete m_threadinfo.m_pool;
 }
 
 Main *KX_BlenderConverter::GetMain()
@@ -221,7 +227,7 @@ void KX_BlenderConverter::ConvertScene(KX_Scene *destinationscene, RAS_Rasterize
 
 	destinationscene->SetPhysicsEnvironment(phy_env);
 
-	KX_BlenderSceneConverter sceneConverter;
+	KX_BlenderSceneConverter sceneConverter(&m_meshCache);
 
 	ViewLayer *view_layer = BKE_view_layer_from_scene_get(blenderscene);
 	Depsgraph *graph = BKE_scene_get_depsgraph(blenderscene, view_layer, false);
@@ -264,6 +270,8 @@ void KX_BlenderConverter::RemoveScene(KX_Scene *scene)
 
 	// delete the entities of this scene
 	m_sceneSlots.erase(scene);
+
+	m_meshCache.RemoveUser(scene);
 }
 
 void KX_BlenderConverter::SetAlwaysUseExpandFraming(bool to_what)
@@ -339,7 +347,7 @@ void KX_BlenderConverter::MergeAsyncLoads()
 void KX_BlenderConverter::FinalizeAsyncLoads()
 {
 	// Finish all loading libraries.
-	BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
+	m_threadinfo.m_pool->WorkAndWait();
 	// Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
 	MergeAsyncLoads();
 }
@@ -359,6 +367,7 @@ static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
 	std::vector<KX_Scene *> *merge_scenes = new std::vector<KX_Scene *>(); // Deleted in MergeAsyncLoads
 
 	for (unsigned int i = 0; i < scenes->size(); ++i) {
+		KX_TraceScope traceScope(status->GetEngine()->GetTraceRecorder(), "converter", "AsyncConvert");
 		new_scene = status->GetEngine()->CreateScene((*scenes)[i], true);
 
 		if (new_scene) {
@@ -473,7 +482,7 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 		// Convert all new meshes into BGE meshes
 		ID *mesh;
 
-		KX_BlenderSceneConverter sceneConverter;
+		KX_BlenderSceneConverter sceneConverter(&m_meshCache);
 		for (mesh = (ID *)main_newlib->mesh.first; mesh; mesh = (ID *)mesh->next) {
 			if (options & LIB_LOAD_VERBOSE) {
 				CM_Debug("mesh name: " << mesh->name + 2);
@@ -520,7 +529,7 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib, c
 
 		if (options & LIB_LOAD_ASYNC) {
 			status->SetData(scenes);
-			BLI_task_pool_push(m_threadinfo.m_pool, async_convert, (void *)status, false, TASK_PRIORITY_LOW);
+			m_threadinfo.m_pool->Push(async_convert, (void *)status);
 		}
 
 #ifdef WITH_PYTHON
@@ -727,6 +736,11 @@ bool KX_BlenderConverter::FreeBlendFile(Main *maggie)
 	delete m_status_map[maggie->name];
 	m_status_map.erase(maggie->name);
 
+	// The converted data of the freed meshes can't be used anymore.
+	for (Mesh *mesh = (Mesh *)maggie->mesh.first; mesh; mesh = (Mesh *)mesh->id.next) {
+		m_meshCache.RemoveMesh(mesh);
+	}
+
 	BKE_main_free(maggie);
 
 	return true;
@@ -828,7 +842,7 @@ RAS_MeshObject *KX_BlenderConverter::ConvertMeshSpecial(KX_Scene *kx_scene, Main
 		}
 	}
 
-	KX_BlenderSceneConverter sceneConverter;
+	KX_BlenderSceneConverter sceneConverter(&m_meshCache);
 
 	RAS_MeshObject *meshobj = BL_ConvertMesh((Mesh *)me, nullptr, kx_scene, m_ketsjiEngine->GetRasterizer(), sceneConverter, false);
 	kx_scene->GetLogicManager()->RegisterMeshName(meshobj->GetName(), meshobj);
@@ -866,4 +880,7 @@ void KX_BlenderConverter::PrintStats()
 	CM_Message("\t materials: " << nummat);
 	CM_Message("\t meshes: " << nummesh);
 	CM_Message("\t interpolators: " << numinter);
+
+	CM_Message(std::endl << "Mesh conversions:");
+	m_meshCache.PrintStats();
 }
@@ -43,6 +43,7 @@
 #endif
 
 #include "CM_Thread.h"
+#include "BL_MeshCache.h"
 
 extern "C" {
 #include "../draw/engines/eevee/eevee_private.h"
@@ -66,8 +67,8 @@ struct Material;
 struct bAction;
 struct bActuator;
 struct bController;
-struct TaskPool;
 struct Depsgraph;
+class CM_JobPool;
 
 template<class Value>
 using UniquePtrList = std::vector<std::unique_ptr<Value> >;
@@ -94,8 +95,11 @@ private:
 
 	std::map<KX_Scene *, SceneSlot> m_sceneSlots;
 
+	/// Converted meshes data reused when converting again the same meshes.
+	BL_MeshCache m_meshCache;
+
 	struct ThreadInfo {
-		TaskPool *m_pool;
+		CM_JobPool *m_pool;
 		CM_ThreadMutex m_mutex;
 	} m_threadinfo;
 
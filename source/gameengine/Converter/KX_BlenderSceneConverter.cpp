@@ -32,6 +32,11 @@
 #include "KX_BlenderSceneConverter.h"
 #include "KX_GameObject.h"
 
+KX_BlenderSceneConverter::KX_BlenderSceneConverter(BL_MeshCache *meshCache)
+	:m_meshCache(meshCache)
+{
+}
+
 void KX_BlenderSceneConverter::RegisterGameObject(KX_GameObject *gameobject, Object *for_blenderobject)
 {
 // 	CM_FunctionDebug("object name: " << gameobject->GetName());
@@ -104,3 +109,8 @@ SCA_IController *KX_BlenderSceneConverter::FindGameController(bController *for_c
 {
 	return m_map_blender_to_gamecontroller[for_controller];
 }
+
+BL_MeshCache *KX_BlenderSceneConverter::GetMeshCache() const
+{
+	return m_meshCache;
+}
@@ -45,6 +45,7 @@ class KX_BlenderConverter;
 class KX_GameObject;
 class KX_Scene;
 class KX_LibLoadStatus;
+class BL_MeshCache;
 struct Main;
 struct BlendHandle;
 struct Object;
@@ -68,8 +69,11 @@ private:
 	std::map<bActuator *, SCA_IActuator *> m_map_blender_to_gameactuator;
 	std::map<bController *, SCA_IController *> m_map_blender_to_gamecontroller;
 
+	/// Cache of the converted meshes shared by all the scene conversions, can be nullptr.
+	BL_MeshCache *m_meshCache;
+
 public:
-	KX_BlenderSceneConverter() = default;
+	KX_BlenderSceneConverter(BL_MeshCache *meshCache = nullptr);
 	~KX_BlenderSceneConverter() = default;
 
 	// Disable dangerous copy.
@@ -90,6 +94,8 @@ public:
 
 	void RegisterGameController(SCA_IController *cont, bController *for_controller);
 	SCA_IController *FindGameController(bController *for_controller);
+
+	BL_MeshCache *GetMeshCache() const;
 };
 
 #endif  // __KX_BLENDERSCENECONVERTER_H__
@@ -183,7 +183,83 @@ void DEV_InputDevice::ConvertWindowEvent(int incode)
 	ConvertEvent(m_reverseWindowTranslateTable[incode], 1, 0);
 }
 
+bool DEV_InputDevice::FilterLiveEvent(DEV_InputRecorder::EventType type, int input, int value, int data)
+{
+	switch (m_recorder.GetMode()) {
+		case DEV_InputRecorder::MODE_RECORD:
+		{
+			m_recorder.AddEvent(type, input, value, data);
+			return true;
+		}
+		case DEV_InputRecorder::MODE_REPLAY:
+		{
+			// The window closing is kept to let the user stop the replay.
+			return (type == DEV_InputRecorder::EVENT_INPUT && (input == WINCLOSE || input == WINQUIT));
+		}
+		default:
+		{
+			return true;
+		}
+	}
+}
+
 void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode)
+{
+	if (FilterLiveEvent(DEV_InputRecorder::EVENT_INPUT, type, val, unicode)) {
+		AddEvent(type, val, unicode);
+	}
+}
+
+void DEV_InputDevice::ConvertMoveEvent(int x, int y)
+{
+	if (FilterLiveEvent(DEV_InputRecorder::EVENT_MOVE, 0, x, y)) {
+		AddMoveEvent(x, y);
+	}
+}
+
+void DEV_InputDevice::ConvertWheelEvent(int z)
+{
+	if (FilterLiveEvent(DEV_InputRecorder::EVENT_WHEEL, 0, z, 0)) {
+		AddWheelEvent(z);
+	}
+}
+
+DEV_InputRecorder& DEV_InputDevice::GetRecorder()
+{
+	return m_recorder;
+}
+
+void DEV_InputDevice::NextFrame()
+{
+	if (m_recorder.GetMode() == DEV_InputRecorder::MODE_REPLAY) {
+		DEV_InputRecorder::Event event;
+		while (m_recorder.NextReplayEvent(event)) {
+			switch (event.m_type) {
+				case DEV_InputRecorder::EVENT_INPUT:
+				{
+					if (event.m_input < MAX_KEYS) {
+						AddEvent((SCA_EnumInputs)event.m_input, event.m_value, event.m_data);
+					}
+					break;
+				}
+				case DEV_InputRecorder::EVENT_MOVE:
+				{
+					AddMoveEvent(event.m_value, event.m_data);
+					break;
+				}
+				case DEV_InputRecorder::EVENT_WHEEL:
+				{
+					AddWheelEvent(event.m_value);
+					break;
+				}
+			}
+		}
+	}
+
+	m_recorder.NextFrame();
+}
+
+void DEV_InputDevice::AddEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode)
 {
 	SCA_InputEvent &event = m_inputsTable[type];
 
@@ -201,7 +277,7 @@ void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type, int va
 	}
 }
 
-void DEV_InputDevice::ConvertMoveEvent(int x, int y)
+void DEV_InputDevice::AddMoveEvent(int x, int y)
 {
 	SCA_InputEvent &xevent = m_inputsTable[MOUSEX];
 	xevent.m_values.push_back(x);
@@ -218,7 +294,7 @@ void DEV_InputDevice::ConvertMoveEvent(int x, int y)
 	}
 }
 
-void DEV_InputDevice::ConvertWheelEvent(int z)
+void DEV_InputDevice::AddWheelEvent(int z)
 {
 	SCA_InputEvent &event = m_inputsTable[(z > 0) ? WHEELUPMOUSE : WHEELDOWNMOUSE];
 	event.m_values.push_back(z);
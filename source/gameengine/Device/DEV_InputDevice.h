@@ -28,6 +28,7 @@
 #define __DEV_INPUTDEVICE_H__
 
 #include "SCA_IInputDevice.h"
+#include "DEV_InputRecorder.h"
 
 #include <map>
 
@@ -39,6 +40,16 @@ protected:
 	std::map<int, SCA_EnumInputs> m_reverseButtonTranslateTable;
 	std::map<int, SCA_EnumInputs> m_reverseWindowTranslateTable;
 
+	/// Records or replays the converted events.
+	DEV_InputRecorder m_recorder;
+
+	/// Return false if the live event must be ignored because of a replay, record it else.
+	bool FilterLiveEvent(DEV_InputRecorder::EventType type, int input, int value, int data);
+
+	void AddEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode);
+	void AddMoveEvent(int x, int y);
+	void AddWheelEvent(int z);
+
 public:
 	DEV_InputDevice();
 	virtual ~DEV_InputDevice();
@@ -49,6 +60,12 @@ public:
 	void ConvertMoveEvent(int x, int y);
 	void ConvertWheelEvent(int z);
 	void ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode);
+
+	DEV_InputRecorder& GetRecorder();
+	/** Convert the replayed events of the current frame and go to the next frame,
+	 * called once per frame after the live events were converted.
+	 */
+	void NextFrame();
 };
 
 #endif  // __DEV_INPUTDEVICE_H__
@@ -0,0 +1,265 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file gameengine/Device/DEV_InputRecorder.cpp
+ *  \ingroup device
+ */
+
+#include "DEV_InputRecorder.h"
+
+#include "CM_Message.h"
+
+#include <fstream>
+#include <cstring>
+
+/// Header of the record file, the events and then the joystick events follow it.
+struct RecordHeader
+{
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_numFrames;
+	uint32_t m_numEvents;
+	uint32_t m_numJoystickEvents;
+};
+
+static const char recordMagic[8] = {'B', 'G', 'E', 'I', 'N', 'P', 'U', 'T'};
+static const uint32_t recordVersion = 2;
+
+DEV_InputRecorder::DEV_InputRecorder()
+	:m_mode(MODE_NONE),
+	m_frame(0),
+	m_numFrames(0),
+	m_replayIndex(0),
+	m_joystickReplayIndex(0)
+{
+	ResetJoysticks();
+}
+
+DEV_InputRecorder::~DEV_InputRecorder()
+{
+}
+
+void DEV_InputRecorder::ResetJoysticks()
+{
+	memset(m_joysticks, 0, sizeof(m_joysticks));
+}
+
+DEV_InputRecorder::Mode DEV_InputRecorder::GetMode() const
+{
+	return m_mode;
+}
+
+unsigned int DEV_InputRecorder::GetFrame() const
+{
+	return m_frame;
+}
+
+void DEV_InputRecorder::StartRecording()
+{
+	m_mode = MODE_RECORD;
+	m_events.clear();
+	m_joystickEvents.clear();
+	ResetJoysticks();
+	m_frame = 0;
+}
+
+bool DEV_InputRecorder::StartReplay(const std::string& filepath)
+{
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file) {
+		CM_Error("failed to open the input record " << filepath);
+		return false;
+	}
+
+	if (!StartReplay(file)) {
+		CM_Error("invalid input record " << filepath);
+		return false;
+	}
+
+	return true;
+}
+
+bool DEV_InputRecorder::StartReplay(std::istream& stream)
+{
+	RecordHeader header;
+	if (!stream.read((char *)&header, sizeof(RecordHeader)) || memcmp(header.m_magic, recordMagic, sizeof(recordMagic)) != 0) {
+		return false;
+	}
+	if (header.m_version != recordVersion) {
+		CM_Error("unsupported input record version " << header.m_version);
+		return false;
+	}
+
+	m_events.resize(header.m_numEvents);
+	m_joystickEvents.resize(header.m_numJoystickEvents);
+	if ((header.m_numEvents > 0 && !stream.read((char *)m_events.data(), sizeof(Event) * header.m_numEvents)) ||
+	    (header.m_numJoystickEvents > 0 && !stream.read((char *)m_joystickEvents.data(), sizeof(Event) * header.m_numJoystickEvents)))
+	{
+		CM_Error("truncated input record");
+		m_events.clear();
+		m_joystickEvents.clear();
+		return false;
+	}
+
+	m_mode = MODE_REPLAY;
+	m_numFrames = header.m_numFrames;
+	m_replayIndex = 0;
+	m_joystickReplayIndex = 0;
+	m_frame = 0;
+	ResetJoysticks();
+
+	return true;
+}
+
+bool DEV_InputRecorder::WriteRecord(const std::string& filepath) const
+{
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file || !WriteRecord(file)) {
+		CM_Error("failed to write the input record in " << filepath);
+		return false;
+	}
+
+	return true;
+}
+
+bool DEV_InputRecorder::WriteRecord(std::ostream& stream) const
+{
+	RecordHeader header;
+	memcpy(header.m_magic, recordMagic, sizeof(recordMagic));
+	header.m_version = recordVersion;
+	header.m_numFrames = m_frame;
+	header.m_numEvents = m_events.size();
+	header.m_numJoystickEvents = m_joystickEvents.size();
+
+	stream.write((const char *)&header, sizeof(RecordHeader));
+	stream.write((const char *)m_events.data(), sizeof(Event) * m_events.size());
+	stream.write((const char *)m_joystickEvents.data(), sizeof(Event) * m_joystickEvents.size());
+
+	return (bool)stream;
+}
+
+void DEV_InputRecorder::AddEvent(EventType type, int input, int value, int data)
+{
+	Event event;
+	event.m_frame = m_frame;
+	event.m_value = value;
+	event.m_data = data;
+	event.m_input = input;
+	event.m_type = type;
+	event.m_pad = 0;
+
+	m_events.push_back(event);
+}
+
+bool DEV_InputRecorder::NextReplayEvent(Event& event)
+{
+	if (m_replayIndex >= m_events.size() || m_events[m_replayIndex].m_frame > m_frame) {
+		return false;
+	}
+
+	event = m_events[m_replayIndex++];
+	return true;
+}
+
+void DEV_InputRecorder::AddJoystickEvent(EventType type, int index, int value, int data)
+{
+	Event event;
+	event.m_frame = m_frame;
+	event.m_value = value;
+	event.m_data = data;
+	event.m_input = index;
+	event.m_type = type;
+	event.m_pad = 0;
+
+	m_joystickEvents.push_back(event);
+}
+
+void DEV_InputRecorder::RecordJoystick(int index, const JoystickState& state)
+{
+	JoystickState& last = m_joysticks[index];
+
+	if (state.m_connected != last.m_connected) {
+		AddJoystickEvent(EVENT_JOYSTICK_CONNECT, index, state.m_connected, 0);
+	}
+
+	// A disconnected joystick is recorded as released.
+	const JoystickState released = {false, {0}, 0};
+	const JoystickState& current = (state.m_connected) ? state : released;
+
+	for (int i = 0; i < JOYAXIS_MAX; ++i) {
+		if (current.m_axes[i] != last.m_axes[i]) {
+			AddJoystickEvent(EVENT_JOYSTICK_AXIS, index, current.m_axes[i], i);
+		}
+	}
+	if (current.m_buttons != last.m_buttons) {
+		AddJoystickEvent(EVENT_JOYSTICK_BUTTONS, index, current.m_buttons, 0);
+	}
+
+	last = current;
+}
+
+void DEV_InputRecorder::ReplayJoysticks()
+{
+	while (m_joystickReplayIndex < m_joystickEvents.size() && m_joystickEvents[m_joystickReplayIndex].m_frame <= m_frame) {
+		const Event& event = m_joystickEvents[m_joystickReplayIndex++];
+		if (event.m_input >= JOYINDEX_MAX) {
+			continue;
+		}
+
+		JoystickState& state = m_joysticks[event.m_input];
+		switch (event.m_type) {
+			case EVENT_JOYSTICK_CONNECT:
+			{
+				state.m_connected = (event.m_value != 0);
+				break;
+			}
+			case EVENT_JOYSTICK_AXIS:
+			{
+				if (event.m_data >= 0 && event.m_data < JOYAXIS_MAX) {
+					state.m_axes[event.m_data] = event.m_value;
+				}
+				break;
+			}
+			case EVENT_JOYSTICK_BUTTONS:
+			{
+				state.m_buttons = event.m_value;
+				break;
+			}
+		}
+	}
+}
+
+const DEV_InputRecorder::JoystickState& DEV_InputRecorder::GetJoystickState(int index) const
+{
+	return m_joysticks[index];
+}
+
+void DEV_InputRecorder::NextFrame()
+{
+	++m_frame;
+}
+
+bool DEV_InputRecorder::IsReplayFinished() const
+{
+	return (m_mode == MODE_REPLAY && m_frame >= m_numFrames);
+}
@@ -0,0 +1,147 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file DEV_InputRecorder.h
+ *  \ingroup device
+ */
+
+#ifndef __DEV_INPUTRECORDER_H__
+#define __DEV_INPUTRECORDER_H__
+
+#include "DEV_JoystickDefines.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdint>
+
+/** Records the converted input events with the number of the frame they were received in,
+ * and gives them back at the same frames when replaying. Combined with a fixed time step
+ * it allows to run the same session again for benchmark comparisons.
+ *
+ * The joysticks are recorded as their state at each frame, only the changes are stored.
+ */
+class DEV_InputRecorder
+{
+public:
+	enum Mode {
+		MODE_NONE = 0,
+		MODE_RECORD,
+		MODE_REPLAY
+	};
+
+	enum EventType {
+		/// Key, mouse button or window event.
+		EVENT_INPUT = 0,
+		/// Mouse move, the value and data are the x and y position.
+		EVENT_MOVE,
+		/// Mouse wheel, the value is the wheel delta.
+		EVENT_WHEEL,
+		/// Joystick connection, the input is the joystick index, the value is 1 when connected.
+		EVENT_JOYSTICK_CONNECT,
+		/// Joystick axis, the input is the joystick index, the data the axis and the value its position.
+		EVENT_JOYSTICK_AXIS,
+		/// Joystick buttons, the input is the joystick index and the value the mask of the pressed buttons.
+		EVENT_JOYSTICK_BUTTONS
+	};
+
+	/// State of a joystick during a frame.
+	struct JoystickState
+	{
+		bool m_connected;
+		int m_axes[JOYAXIS_MAX];
+		/// One bit per pressed button, the hat directions are the D-pad buttons of the game controllers.
+		unsigned int m_buttons;
+	};
+
+	/// Event as stored in the record file.
+	struct Event
+	{
+		uint32_t m_frame;
+		int32_t m_value;
+		/// Unicode character for an input event or the y position for a move event.
+		int32_t m_data;
+		uint16_t m_input;
+		uint8_t m_type;
+		uint8_t m_pad;
+	};
+
+private:
+	Mode m_mode;
+	std::vector<Event> m_events;
+	/** Joystick changes, kept apart from the other events as the joysticks are handled
+	 * during the logic frame and the other events at the frame end.
+	 */
+	std::vector<Event> m_joystickEvents;
+	/// Last recorded or replayed state of the joysticks.
+	JoystickState m_joysticks[JOYINDEX_MAX];
+	/// Current frame number.
+	unsigned int m_frame;
+	/// Number of frames of the loaded record.
+	unsigned int m_numFrames;
+	/// Index of the next event to replay.
+	unsigned int m_replayIndex;
+	/// Index of the next joystick event to replay.
+	unsigned int m_joystickReplayIndex;
+
+	void ResetJoysticks();
+	void AddJoystickEvent(EventType type, int index, int value, int data);
+
+public:
+	DEV_InputRecorder();
+	~DEV_InputRecorder();
+
+	Mode GetMode() const;
+	unsigned int GetFrame() const;
+
+	/// Start recording the events from the current frame.
+	void StartRecording();
+	/// Read a record file and start replaying it, return false if the file is invalid.
+	bool StartReplay(const std::string& filepath);
+	/// Read a record from a stream and start replaying it, return false if the record is invalid.
+	bool StartReplay(std::istream& stream);
+	/// Write the recorded events and the number of recorded frames in a file.
+	bool WriteRecord(const std::string& filepath) const;
+	bool WriteRecord(std::ostream& stream) const;
+
+	/// Record an event in the current frame.
+	void AddEvent(EventType type, int input, int value, int data);
+	/** Return the next replayed event of the current frame.
+	 * \return False when all the events of the frame were returned.
+	 */
+	bool NextReplayEvent(Event& event);
+
+	/// Record the state of a joystick in the current frame, a disconnected joystick can be passed.
+	void RecordJoystick(int index, const JoystickState& state);
+	/// Apply the joystick changes replayed until the current frame.
+	void ReplayJoysticks();
+	/// Return the last recorded or replayed state of a joystick.
+	const JoystickState& GetJoystickState(int index) const;
+
+	/// Go to the next frame.
+	void NextFrame();
+	/// Return true when all the recorded frames were replayed.
+	bool IsReplayFinished() const;
+};
+
+#endif  // __DEV_INPUTRECORDER_H__
@@ -52,11 +52,13 @@ DEV_Joystick::DEV_Joystick(short index)
 	m_axismax(-1),
 	m_buttonmax(-1),
 	m_isinit(0),
+	m_isreplay(false),
 	m_istrig_axis(0),
 	m_istrig_button(0)
 {
 	for (int i=0; i < JOYAXIS_MAX; i++)
 		m_axis_array[i] = 0;
+	m_button_mask = 0;
 	
 #ifdef WITH_SDL
 	m_private = new PrivateData();
@@ -69,6 +71,7 @@ DEV_Joystick::~DEV_Joystick()
 }
 
 DEV_Joystick *DEV_Joystick::m_instance[JOYINDEX_MAX];
+DEV_InputRecorder *DEV_Joystick::m_recorder = nullptr;
 
 
 void DEV_Joystick::Init()
@@ -123,6 +126,11 @@ void DEV_Joystick::Close()
 #endif
 }
 
+void DEV_Joystick::SetRecorder(DEV_InputRecorder *recorder)
+{
+	m_recorder = recorder;
+}
+
 DEV_Joystick *DEV_Joystick::GetInstance(short joyindex)
 {
 #ifndef WITH_SDL
@@ -184,46 +192,41 @@ bool DEV_Joystick::aAxisIsPositive(int axis_single)
 
 bool DEV_Joystick::aAnyButtonPressIsPositive(void)
 {
-#ifdef WITH_SDL
-	if (!(SDL_CHECK(SDL_GameControllerGetButton))) {
-		return false;
-	}
-
 	/* this is needed for the "all events" option
 	 * so we know if there are no buttons pressed */
-	for (int i = 0; i < m_buttonmax; i++) {
-		if (SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)i)) {
-			return true;
-		}
-	}
-#endif
-	return false;
+	return (m_button_mask != 0);
 }
 
 bool DEV_Joystick::aButtonPressIsPositive(int button)
 {
-#ifdef WITH_SDL
-	if ((SDL_CHECK(SDL_GameControllerGetButton) &&
-		SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)button)))
-	{
-		return true;
+	if (button < 0 || button >= JOYBUT_MAX) {
+		return false;
 	}
-#endif
-	return false;
+	return (m_button_mask & (1u << button)) != 0;
 }
 
 
 bool DEV_Joystick::aButtonReleaseIsPositive(int button)
 {
+	return !aButtonPressIsPositive(button);
+}
+
 #ifdef WITH_SDL
-	if (!(SDL_CHECK(SDL_GameControllerGetButton) &&
-		SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)button)))
-	{
-		return true;
+void DEV_Joystick::UpdateButtons()
+{
+	m_button_mask = 0;
+
+	if (m_isreplay || !m_private->m_gamecontroller || !(SDL_CHECK(SDL_GameControllerGetButton))) {
+		return;
+	}
+
+	for (int i = 0; i < m_buttonmax && i < JOYBUT_MAX; i++) {
+		if (SDL_GameControllerGetButton(m_private->m_gamecontroller, (SDL_GameControllerButton)i)) {
+			m_button_mask |= (1u << i);
+		}
 	}
-#endif
-	return false;
 }
+#endif  /* WITH_SDL */
 
 bool DEV_Joystick::CreateJoystickDevice(void)
 {
@@ -344,6 +347,10 @@ void DEV_Joystick::DestroyJoystickDevice(void)
 int DEV_Joystick::Connected(void)
 {
 #ifdef WITH_SDL
+	if (m_isreplay) {
+		return m_isinit;
+	}
+
 	if (m_isinit &&
 		(SDL_CHECK(SDL_GameControllerGetAttached) &&
 		SDL_GameControllerGetAttached(m_private->m_gamecontroller)))
@@ -386,7 +393,11 @@ int DEV_Joystick::pAxisTest(int axisnum)
 const std::string DEV_Joystick::GetName()
 {
 #ifdef WITH_SDL
-	return (SDL_CHECK(SDL_GameControllerName)) ? SDL_GameControllerName(m_private->m_gamecontroller) : "";
+	if (m_private->m_gamecontroller && SDL_CHECK(SDL_GameControllerName)) {
+		const char *name = SDL_GameControllerName(m_private->m_gamecontroller);
+		return (name) ? name : "";
+	}
+	return "";
 #else /* WITH_SDL */
 	return "";
 #endif /* WITH_SDL */
@@ -50,6 +50,8 @@
 
 #include <string>
 
+class DEV_InputRecorder;
+
 /**
  * Basic Joystick class
  * I will make this class a singleton because there should be only one joystick
@@ -61,6 +63,8 @@ class DEV_Joystick
 
 {
 	static DEV_Joystick *m_instance[JOYINDEX_MAX];
+	/// Recorder of the joystick states, or replacing them when replaying.
+	static DEV_InputRecorder *m_recorder;
 
 	class PrivateData;
 #ifdef WITH_SDL
@@ -72,6 +76,11 @@ class DEV_Joystick
 	 *support for JOYAXIS_MAX axes (in pairs)
 	 */
 	int m_axis_array[JOYAXIS_MAX];
+
+	/**
+	 * One bit per pressed button, read once per frame
+	 */
+	unsigned int m_button_mask;
 	
 	/**
 	 * Precision or range of the axes
@@ -88,6 +97,9 @@ class DEV_Joystick
 	/** is the joystick initialized ?*/
 	bool			m_isinit;
 
+	/** is the joystick only made of replayed states ? */
+	bool			m_isreplay;
+
 	
 	/** is triggered for each event type */
 	bool			m_istrig_axis;
@@ -100,6 +112,14 @@ class DEV_Joystick
 	void OnAxisEvent(SDL_Event *sdl_event);
 	void OnButtonEvent(SDL_Event *sdl_event);
 	void OnNothing(SDL_Event *sdl_event);
+
+	/// Read the pressed buttons of the game controller.
+	void UpdateButtons();
+
+	/// Replace the SDL events by the replayed joystick states.
+	static bool HandleReplayEvents(short (&addrem)[JOYINDEX_MAX]);
+	/// Record the state of all the joysticks.
+	static void RecordStates();
 		
 #endif /* WITH_SDL */
 	/**
@@ -133,6 +153,8 @@ public:
 	void ReleaseInstance(short joyindex);
 	static void Init();
 	static void Close();
+	/// Set the recorder of the joystick states, nullptr to disable the record and replay.
+	static void SetRecorder(DEV_InputRecorder *recorder);
 
 	/*
 	 */
@@ -31,6 +31,7 @@
 
 #include "DEV_Joystick.h"
 #include "DEV_JoystickPrivate.h"
+#include "DEV_InputRecorder.h"
 
 #include "CM_Message.h"
 
@@ -61,6 +62,11 @@ bool DEV_Joystick::HandleEvents(short (&addrem)[JOYINDEX_MAX])
 	SDL_Event		sdl_event;
 	bool remap = false;
 
+	// The live joysticks are ignored during a replay.
+	if (m_recorder && m_recorder->GetMode() == DEV_InputRecorder::MODE_REPLAY) {
+		return HandleReplayEvents(addrem);
+	}
+
 	if (SDL_PollEvent == (void*)0) {
 		return 0;
 	}
@@ -141,6 +147,80 @@ bool DEV_Joystick::HandleEvents(short (&addrem)[JOYINDEX_MAX])
 				break;
 		}
 	}
+
+	/* The buttons are read once per frame, all the sensors then use the same state
+	 * which can be recorded. */
+	for (int i = 0; i < JOYINDEX_MAX; i++) {
+		if (DEV_Joystick::m_instance[i]) {
+			DEV_Joystick::m_instance[i]->UpdateButtons();
+		}
+	}
+
+	if (m_recorder && m_recorder->GetMode() == DEV_InputRecorder::MODE_RECORD) {
+		RecordStates();
+	}
+
+	return remap;
+}
+
+void DEV_Joystick::RecordStates()
+{
+	for (int i = 0; i < JOYINDEX_MAX; i++) {
+		DEV_Joystick *joy = m_instance[i];
+		DEV_InputRecorder::JoystickState state = {false, {0}, 0};
+		if (joy && joy->m_isinit) {
+			state.m_connected = true;
+			for (int j = 0; j < JOYAXIS_MAX; j++) {
+				state.m_axes[j] = joy->m_axis_array[j];
+			}
+			state.m_buttons = joy->m_button_mask;
+		}
+		m_recorder->RecordJoystick(i, state);
+	}
+}
+
+bool DEV_Joystick::HandleReplayEvents(short (&addrem)[JOYINDEX_MAX])
+{
+	bool remap = false;
+
+	m_recorder->ReplayJoysticks();
+
+	for (int i = 0; i < JOYINDEX_MAX; i++) {
+		const DEV_InputRecorder::JoystickState& state = m_recorder->GetJoystickState(i);
+		DEV_Joystick *joy = m_instance[i];
+
+		if (state.m_connected && !joy) {
+			// The replayed joystick has no device, it only returns the recorded states.
+			joy = m_instance[i] = new DEV_Joystick(i);
+			joy->m_isinit = true;
+			joy->m_isreplay = true;
+			joy->m_axismax = JOYAXIS_MAX;
+			joy->m_buttonmax = JOYBUT_MAX;
+			addrem[i] = 1;
+			remap = true;
+		}
+		else if (!state.m_connected && joy) {
+			joy->ReleaseInstance(i);
+			addrem[i] = 2;
+			remap = true;
+			continue;
+		}
+
+		if (!joy) {
+			continue;
+		}
+
+		joy->m_istrig_axis = false;
+		for (int j = 0; j < JOYAXIS_MAX; j++) {
+			if (joy->m_axis_array[j] != state.m_axes[j]) {
+				joy->m_axis_array[j] = state.m_axes[j];
+				joy->m_istrig_axis = true;
+			}
+		}
+		joy->m_istrig_button = (joy->m_button_mask != state.m_buttons);
+		joy->m_button_mask = state.m_buttons;
+	}
+
 	return remap;
 }
 #endif /* WITH_SDL */
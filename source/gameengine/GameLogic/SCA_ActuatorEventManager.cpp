@@ -50,11 +50,7 @@ SCA_ActuatorEventManager::~SCA_ActuatorEventManager()
 void SCA_ActuatorEventManager::NextFrame()
 {
 	// check for changed actuator
-	SG_DList::iterator<SCA_ISensor> it(m_sensors);
-	for (it.begin();!it.end();++it)
-	{
-		(*it)->Activate(m_logicmgr);
-	}
+	ActivateSensors();
 }
 
 void SCA_ActuatorEventManager::UpdateFrame()
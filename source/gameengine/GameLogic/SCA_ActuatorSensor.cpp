@@ -82,6 +82,11 @@ bool SCA_ActuatorSensor::IsPositiveTrigger()
 	return result;
 }
 
+bool SCA_ActuatorSensor::IsThreadSafe() const
+{
+	return true;
+}
+
 
 
 SCA_ActuatorSensor::~SCA_ActuatorSensor()
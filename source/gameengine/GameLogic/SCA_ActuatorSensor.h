@@ -53,6 +53,7 @@ public:
 	virtual void Init();
 	virtual bool Evaluate();
 	virtual bool	IsPositiveTrigger();
+	virtual bool	IsThreadSafe() const;
 	virtual void	ReParent(SCA_IObject* parent);
 	void Update();
 
@@ -82,6 +82,11 @@ bool SCA_AlwaysSensor::IsPositiveTrigger()
 	return (m_invert ? false : true);
 }
 
+bool SCA_AlwaysSensor::IsThreadSafe() const
+{
+	return true;
+}
+
 
 
 bool SCA_AlwaysSensor::Evaluate()
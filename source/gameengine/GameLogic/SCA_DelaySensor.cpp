@@ -89,6 +89,11 @@ bool SCA_DelaySensor::IsPositiveTrigger()
 	return (m_invert ? !m_lastResult : m_lastResult);
 }
 
+bool SCA_DelaySensor::IsThreadSafe() const
+{
+	return true;
+}
+
 bool SCA_DelaySensor::Evaluate()
 {
 	bool trigger = false;
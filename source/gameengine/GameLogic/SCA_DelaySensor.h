@@ -55,6 +55,7 @@ public:
 	virtual CValue* GetReplica();
 	virtual bool Evaluate();
 	virtual bool IsPositiveTrigger();
+	virtual bool IsThreadSafe() const;
 	virtual void Init();
 
 
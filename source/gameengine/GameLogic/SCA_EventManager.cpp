@@ -31,8 +31,17 @@
 
 
 #include <assert.h>
+#include <algorithm>
 #include "SCA_EventManager.h"
 #include "SCA_ISensor.h"
+#include "SCA_LogicManager.h"
+
+#include "CM_JobSystem.h"
+
+/// Minimum number of thread safe sensors to use the parallel evaluation.
+static const unsigned int PARALLEL_SENSORS_MIN = 256;
+/// Number of sensors evaluated by a task.
+static const unsigned int PARALLEL_SENSORS_TASK_SIZE = 128;
 
 
 SCA_EventManager::SCA_EventManager(SCA_LogicManager* logicmgr, EVENT_MANAGER_TYPE mgrtype)
@@ -77,6 +86,47 @@ void SCA_EventManager::UpdateFrame()
 {
 }
 
+static void evaluate_sensors_task_func(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	SCA_EventManager::SensorRange *range = (SCA_EventManager::SensorRange *)taskdata;
+	for (unsigned int i = 0; i < range->m_size; ++i) {
+		range->m_sensors[i]->PreEvaluate();
+	}
+}
+
+void SCA_EventManager::ActivateSensors()
+{
+	CM_JobPool *pool = m_logicmgr->GetSensorJobPool();
+	SG_DList::iterator<SCA_ISensor> it(m_sensors);
+
+	if (pool) {
+		for (it.begin(); !it.end(); ++it) {
+			SCA_ISensor *sensor = *it;
+			if (sensor->NeedEvaluate() && sensor->IsThreadSafe()) {
+				m_parallelSensors.push_back(sensor);
+			}
+		}
+
+		const unsigned int size = m_parallelSensors.size();
+		if (size >= PARALLEL_SENSORS_MIN) {
+			// Fill all the ranges before pushing tasks, the ranges must not be reallocated.
+			for (unsigned int i = 0; i < size; i += PARALLEL_SENSORS_TASK_SIZE) {
+				m_parallelRanges.push_back({&m_parallelSensors[i], std::min(PARALLEL_SENSORS_TASK_SIZE, size - i)});
+			}
+			for (SensorRange& range : m_parallelRanges) {
+				pool->Push(evaluate_sensors_task_func, &range);
+			}
+			pool->WorkAndWait();
+			m_parallelRanges.clear();
+		}
+		m_parallelSensors.clear();
+	}
+
+	for (it.begin(); !it.end(); ++it) {
+		(*it)->Activate(m_logicmgr);
+	}
+}
+
 int SCA_EventManager::GetType()
 {
 	return (int) m_mgrtype;
@@ -40,6 +40,14 @@
 
 class SCA_EventManager
 {
+public:
+	/// Range of thread safe sensors evaluated by a task.
+	struct SensorRange
+	{
+		class SCA_ISensor **m_sensors;
+		unsigned int m_size;
+	};
+
 protected:
 	class SCA_LogicManager* m_logicmgr; /* all event manager subclasses use this (other then TimeEventManager) */
 
@@ -47,6 +55,15 @@ protected:
 	//std::set <class SCA_ISensor*>				m_sensors;
 	SG_DList		m_sensors;
 
+	std::vector<class SCA_ISensor *> m_parallelSensors;
+	std::vector<SensorRange> m_parallelRanges;
+
+	/** Activate all the registered sensors in order. When enabled by the logic manager the
+	 * thread safe sensors are first evaluated in parallel, the controllers are still
+	 * triggered from the calling thread in the sensor list order.
+	 */
+	void ActivateSensors();
+
 public:
 	enum EVENT_MANAGER_TYPE {
 		KEYBOARD_EVENTMGR = 0,
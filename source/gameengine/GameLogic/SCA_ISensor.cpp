@@ -60,7 +60,9 @@ SCA_ISensor::SCA_ISensor(SCA_IObject *gameobj, SCA_EventManager *eventmgr)
 	m_suspended(false),
 	m_links(0),
 	m_state(false),
-	m_prev_state(false)
+	m_prev_state(false),
+	m_preEvaluated(false),
+	m_preEvaluatedResult(false)
 {
 }
 
@@ -251,13 +253,44 @@ void SCA_ISensor::ActivateControllers(class SCA_LogicManager *logicmgr)
 	}
 }
 
+bool SCA_ISensor::IsThreadSafe() const
+{
+	return false;
+}
+
+bool SCA_ISensor::NeedEvaluate() const
+{
+	return (m_links && !m_suspended);
+}
+
+void SCA_ISensor::PreEvaluate()
+{
+	m_preEvaluatedResult = Evaluate();
+	m_preEvaluated = true;
+}
+
 void SCA_ISensor::Activate(class SCA_LogicManager *logicmgr)
 {
 	/* Calculate if a __triggering__ is wanted
 	 * don't evaluate a sensor that is not connected to any controller
 	 */
 	if (m_links && !m_suspended) {
-		bool result = this->Evaluate();
+		bool result;
+		if (m_preEvaluated) {
+			result = m_preEvaluatedResult;
+			m_preEvaluated = false;
+		}
+		else {
+			SCA_LogicProfiler& profiler = logicmgr->GetProfiler();
+			if (profiler.GetEnabled()) {
+				const SCA_LogicProfiler::Clock::time_point start = SCA_LogicProfiler::Clock::now();
+				result = this->Evaluate();
+				profiler.AddTime(this, SCA_LogicProfiler::SENSOR, start);
+			}
+			else {
+				result = this->Evaluate();
+			}
+		}
 		// store the state for the rest of the logic system
 		m_prev_state = m_state;
 		m_state = this->IsPositiveTrigger();
@@ -91,6 +91,10 @@ protected:
 	/// Previous state (for tap option).
 	bool m_prev_state;
 
+	/// The sensor was evaluated by PreEvaluate, the result is used by the next Activate.
+	bool m_preEvaluated;
+	bool m_preEvaluatedResult;
+
 	std::vector<SCA_IController *> m_linkedcontrollers;
 
 public:
@@ -114,6 +118,18 @@ public:
 	/* The IsPosTrig() also has to change, to keep things consistent.        */
 	void Activate(SCA_LogicManager *logicmgr);
 	virtual bool Evaluate() = 0;
+
+	/** Return true if Evaluate only modifies the sensor and reads the scene, the sensor
+	 * can then be evaluated from a worker thread. Sensors calling python or the physics
+	 * engine or writing properties must return false.
+	 */
+	virtual bool IsThreadSafe() const;
+	/// Return true if the sensor will be evaluated by Activate.
+	bool NeedEvaluate() const;
+	/** Evaluate the sensor before calling Activate, the result is stored until the next
+	 * call to Activate. Used to evaluate thread safe sensors in parallel.
+	 */
+	void PreEvaluate();
 	virtual bool IsPositiveTrigger();
 	virtual void Init();
 
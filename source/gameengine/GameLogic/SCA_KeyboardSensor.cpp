@@ -107,6 +107,12 @@ bool SCA_KeyboardSensor::IsPositiveTrigger()
 	return result;
 }
 
+bool SCA_KeyboardSensor::IsThreadSafe() const
+{
+	// Logging keystrokes writes the target property.
+	return m_toggleprop.empty();
+}
+
 bool SCA_KeyboardSensor::Evaluate()
 {
 	bool result    = false;
@@ -93,6 +93,7 @@ public:
 
 	virtual bool Evaluate();
 	virtual bool IsPositiveTrigger();
+	virtual bool IsThreadSafe() const;
 
 #ifdef WITH_PYTHON
 	/* --------------------------------------------------------------------- */
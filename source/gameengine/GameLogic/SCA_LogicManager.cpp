@@ -39,8 +39,11 @@
 #include "SCA_PythonController.h"
 #include <set>
 
+#include "CM_JobSystem.h"
 
 SCA_LogicManager::SCA_LogicManager()
+	:m_sensorJobPool(nullptr),
+	m_parallelSensors(false)
 {
 }
 
@@ -54,6 +57,35 @@ SCA_LogicManager::~SCA_LogicManager()
 	}
 	m_eventmanagers.clear();
 	BLI_assert(m_activeActuators.Empty());
+
+	delete m_sensorJobPool;
+}
+
+void SCA_LogicManager::SetJobSystem(CM_JobSystem *jobSystem)
+{
+	delete m_sensorJobPool;
+	m_sensorJobPool = new CM_JobPool(jobSystem, CM_JobSystem::QUEUE_FRAME);
+}
+
+void SCA_LogicManager::SetParallelSensors(bool parallel)
+{
+	m_parallelSensors = parallel;
+}
+
+bool SCA_LogicManager::GetParallelSensors() const
+{
+	return m_parallelSensors;
+}
+
+CM_JobPool *SCA_LogicManager::GetSensorJobPool() const
+{
+	// The profiler measures the sensors evaluation from the main thread.
+	return (m_parallelSensors && !m_profiler.GetEnabled()) ? m_sensorJobPool : nullptr;
+}
+
+SCA_LogicProfiler& SCA_LogicManager::GetProfiler()
+{
+	return m_profiler;
 }
 
 void SCA_LogicManager::RegisterEventManager(SCA_EventManager* eventmgr)
@@ -123,6 +155,7 @@ void SCA_LogicManager::RemoveSensor(SCA_ISensor* sensor)
 {
 	sensor->UnlinkAllControllers();
 	sensor->UnregisterToManager();
+	m_profiler.RemoveBrick(sensor);
 }
 
 void SCA_LogicManager::RemoveController(SCA_IController* controller)
@@ -130,6 +163,7 @@ void SCA_LogicManager::RemoveController(SCA_IController* controller)
 	controller->UnlinkAllSensors();
 	controller->UnlinkAllActuators();
 	controller->Deactivate();
+	m_profiler.RemoveBrick(controller);
 }
 
 
@@ -138,6 +172,7 @@ void SCA_LogicManager::RemoveActuator(SCA_IActuator* actuator)
 	actuator->UnlinkAllControllers();
 	actuator->Deactivate();
 	actuator->SetActive(false);
+	m_profiler.RemoveBrick(actuator);
 }
 
 
@@ -171,7 +206,14 @@ void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 			contr != nullptr;
 			contr = (SCA_IController*)obj->QRemove())
 		{
-			contr->Trigger(this);
+			if (m_profiler.GetEnabled()) {
+				const SCA_LogicProfiler::Clock::time_point start = SCA_LogicProfiler::Clock::now();
+				contr->Trigger(this);
+				m_profiler.AddTime(contr, SCA_LogicProfiler::CONTROLLER, start);
+			}
+			else {
+				contr->Trigger(this);
+			}
 			contr->ClrJustActivated();
 		}
 	}
@@ -196,7 +238,16 @@ void SCA_LogicManager::UpdateFrame(double curtime)
 			SCA_IActuator* actua = *ia;
 			// increment first to allow removal of inactive actuators.
 			++ia;
-			if (!actua->Update(curtime))
+			bool active;
+			if (m_profiler.GetEnabled()) {
+				const SCA_LogicProfiler::Clock::time_point start = SCA_LogicProfiler::Clock::now();
+				active = actua->Update(curtime);
+				m_profiler.AddTime(actua, SCA_LogicProfiler::ACTUATOR, start);
+			}
+			else {
+				active = actua->Update(curtime);
+			}
+			if (!active)
 			{
 				// this actuator is not active anymore, remove
 				actua->QDelink(); 
@@ -43,6 +43,9 @@
 #include "EXP_Value.h"
 #include "SG_QList.h"
 
+class CM_JobSystem;
+class CM_JobPool;
+
 typedef std::list<class SCA_IController*> controllerlist;
 typedef std::map<class SCA_ISensor*,controllerlist > sensormap_t;
 
@@ -62,6 +65,7 @@ typedef std::map<class SCA_ISensor*,controllerlist > sensormap_t;
 #include "SCA_ILogicBrick.h"
 #include "SCA_IActuator.h"
 #include "SCA_EventManager.h"
+#include "SCA_LogicProfiler.h"
 
 
 class SCA_LogicManager
@@ -83,10 +87,28 @@ class SCA_LogicManager
 
 	std::map<std::string, void *>		m_map_gamemeshname_to_blendobj;
 	std::map<void *, CValue *>			m_map_blendobj_to_gameobj;
+
+	/// Pool used to evaluate the thread safe sensors in parallel.
+	CM_JobPool *m_sensorJobPool;
+	/// Evaluate the thread safe sensors in parallel, disabled by default.
+	bool m_parallelSensors;
+
+	/// Per brick timing, disabled by default.
+	SCA_LogicProfiler m_profiler;
+
 public:
 	SCA_LogicManager();
 	virtual ~SCA_LogicManager();
 
+	/// Set the job system used for the parallel sensor evaluation.
+	void SetJobSystem(CM_JobSystem *jobSystem);
+	void SetParallelSensors(bool parallel);
+	bool GetParallelSensors() const;
+	/// Return the pool used to evaluate the sensors in parallel, nullptr when disabled or profiling.
+	CM_JobPool *GetSensorJobPool() const;
+
+	SCA_LogicProfiler& GetProfiler();
+
 	//void	SetKeyboardManager(SCA_KeyboardManager* keyboardmgr) { m_keyboardmgr=keyboardmgr;}
 	void	RegisterEventManager(SCA_EventManager* eventmgr);
 	void	RegisterToSensor(SCA_IController* controller,
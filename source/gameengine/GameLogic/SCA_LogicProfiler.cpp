@@ -0,0 +1,297 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file gameengine/GameLogic/SCA_LogicProfiler.cpp
+ *  \ingroup gamelogic
+ */
+
+#include "SCA_LogicProfiler.h"
+#include "SCA_ILogicBrick.h"
+#include "SCA_IObject.h"
+
+#include <algorithm>
+#include <iomanip>
+
+SCA_LogicProfiler::SCA_LogicProfiler()
+	:m_enabled(false)
+{
+}
+
+SCA_LogicProfiler::~SCA_LogicProfiler()
+{
+}
+
+const char *SCA_LogicProfiler::GetCategoryName(Category category)
+{
+	static const char *names[CATEGORY_MAX] = {"sensor", "controller", "actuator"};
+	return names[category];
+}
+
+void SCA_LogicProfiler::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+void SCA_LogicProfiler::Reset()
+{
+	m_bricks.clear();
+	m_brickIndices.clear();
+	m_brickCache.clear();
+}
+
+unsigned int SCA_LogicProfiler::FindBrickIndex(SCA_ILogicBrick *brick, Category category)
+{
+	std::unordered_map<SCA_ILogicBrick *, unsigned int>::const_iterator cacheit = m_brickCache.find(brick);
+	if (cacheit != m_brickCache.end()) {
+		return cacheit->second;
+	}
+
+	SCA_IObject *parent = brick->GetParent();
+	const std::string objectName = (parent) ? parent->GetName() : "";
+	const std::string brickName = brick->GetName();
+	const std::string key = std::string(GetCategoryName(category)) + "/" + objectName + "/" + brickName;
+
+	unsigned int index;
+	std::map<std::string, unsigned int>::const_iterator it = m_brickIndices.find(key);
+	if (it != m_brickIndices.end()) {
+		index = it->second;
+	}
+	else {
+		index = m_bricks.size();
+		m_brickIndices[key] = index;
+
+		BrickStats stats;
+		stats.m_time = 0.0;
+		stats.m_calls = 0;
+		stats.m_objectName = objectName;
+		stats.m_brickName = brickName;
+#ifdef WITH_PYTHON
+		stats.m_typeName = brick->GetType()->tp_name;
+#else
+		stats.m_typeName = GetCategoryName(category);
+#endif  // WITH_PYTHON
+		stats.m_category = category;
+		m_bricks.push_back(stats);
+	}
+
+	m_brickCache[brick] = index;
+	return index;
+}
+
+void SCA_LogicProfiler::RemoveBrick(SCA_ILogicBrick *brick)
+{
+	m_brickCache.erase(brick);
+}
+
+const std::vector<SCA_LogicProfiler::BrickStats>& SCA_LogicProfiler::GetBrickStats() const
+{
+	return m_bricks;
+}
+
+std::map<std::string, SCA_LogicProfiler::Stats> SCA_LogicProfiler::GetTypeStats() const
+{
+	std::map<std::string, Stats> types;
+	for (const BrickStats& brick : m_bricks) {
+		std::map<std::string, Stats>::iterator it = types.find(brick.m_typeName);
+		if (it == types.end()) {
+			types[brick.m_typeName] = brick;
+		}
+		else {
+			it->second.m_time += brick.m_time;
+			it->second.m_calls += brick.m_calls;
+		}
+	}
+	return types;
+}
+
+SCA_LogicProfiler::Stats SCA_LogicProfiler::GetCategoryStats(Category category) const
+{
+	Stats stats = {0.0, 0};
+	for (const BrickStats& brick : m_bricks) {
+		if (brick.m_category == category) {
+			stats.m_time += brick.m_time;
+			stats.m_calls += brick.m_calls;
+		}
+	}
+	return stats;
+}
+
+void SCA_LogicProfiler::WriteJsonString(std::ostream& stream, const std::string& str)
+{
+	stream << '"';
+	for (const char c : str) {
+		switch (c) {
+			case '"':
+			{
+				stream << "\\\"";
+				break;
+			}
+			case '\\':
+			{
+				stream << "\\\\";
+				break;
+			}
+			case '\n':
+			{
+				stream << "\\n";
+				break;
+			}
+			case '\t':
+			{
+				stream << "\\t";
+				break;
+			}
+			default:
+			{
+				if ((unsigned char)c < 0x20) {
+					stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+				}
+				else {
+					stream << c;
+				}
+			}
+		}
+	}
+	stream << '"';
+}
+
+static void write_json_stats(std::ostream& stream, const SCA_LogicProfiler::Stats& stats)
+{
+	stream << "\"time\": " << stats.m_time << ", \"calls\": " << stats.m_calls;
+}
+
+void SCA_LogicProfiler::WriteJson(std::ostream& stream) const
+{
+	// Most expensive bricks first.
+	std::vector<const BrickStats *> bricks;
+	bricks.reserve(m_bricks.size());
+	for (const BrickStats& brick : m_bricks) {
+		bricks.push_back(&brick);
+	}
+	std::sort(bricks.begin(), bricks.end(), [](const BrickStats *a, const BrickStats *b) { return a->m_time > b->m_time; });
+
+	stream << std::setprecision(9);
+	stream << "{\n\t\"categories\": {";
+	for (unsigned short i = 0; i < CATEGORY_MAX; ++i) {
+		stream << ((i == 0) ? "\n" : ",\n") << "\t\t\"" << GetCategoryName((Category)i) << "\": {";
+		write_json_stats(stream, GetCategoryStats((Category)i));
+		stream << "}";
+	}
+
+	stream << "\n\t},\n\t\"types\": {";
+	const std::map<std::string, Stats> types = GetTypeStats();
+	for (std::map<std::string, Stats>::const_iterator it = types.begin(); it != types.end(); ++it) {
+		stream << ((it == types.begin()) ? "\n" : ",\n") << "\t\t";
+		WriteJsonString(stream, it->first);
+		stream << ": {";
+		write_json_stats(stream, it->second);
+		stream << "}";
+	}
+
+	stream << "\n\t},\n\t\"bricks\": [";
+	for (unsigned int i = 0, size = bricks.size(); i < size; ++i) {
+		const BrickStats *brick = bricks[i];
+		stream << ((i == 0) ? "\n" : ",\n") << "\t\t{\"object\": ";
+		WriteJsonString(stream, brick->m_objectName);
+		stream << ", \"name\": ";
+		WriteJsonString(stream, brick->m_brickName);
+		stream << ", \"type\": ";
+		WriteJsonString(stream, brick->m_typeName);
+		stream << ", \"category\": \"" << GetCategoryName(brick->m_category) << "\", ";
+		write_json_stats(stream, *brick);
+		stream << "}";
+	}
+	stream << "\n\t]\n}";
+}
+
+#ifdef WITH_PYTHON
+
+static PyObject *py_stats_dict(const SCA_LogicProfiler::Stats& stats)
+{
+	PyObject *dict = PyDict_New();
+	PyObject *item;
+
+	item = PyFloat_FromDouble(stats.m_time);
+	PyDict_SetItemString(dict, "time", item);
+	Py_DECREF(item);
+
+	item = PyLong_FromUnsignedLong(stats.m_calls);
+	PyDict_SetItemString(dict, "calls", item);
+	Py_DECREF(item);
+
+	return dict;
+}
+
+PyObject *SCA_LogicProfiler::GetPyProfileDict() const
+{
+	PyObject *result = PyDict_New();
+	PyObject *item;
+
+	PyObject *categories = PyDict_New();
+	for (unsigned short i = 0; i < CATEGORY_MAX; ++i) {
+		item = py_stats_dict(GetCategoryStats((Category)i));
+		PyDict_SetItemString(categories, GetCategoryName((Category)i), item);
+		Py_DECREF(item);
+	}
+	PyDict_SetItemString(result, "categories", categories);
+	Py_DECREF(categories);
+
+	PyObject *types = PyDict_New();
+	for (const std::pair<std::string, Stats>& type : GetTypeStats()) {
+		item = py_stats_dict(type.second);
+		PyDict_SetItemString(types, type.first.c_str(), item);
+		Py_DECREF(item);
+	}
+	PyDict_SetItemString(result, "types", types);
+	Py_DECREF(types);
+
+	PyObject *bricks = PyList_New(m_bricks.size());
+	for (unsigned int i = 0, size = m_bricks.size(); i < size; ++i) {
+		const BrickStats& brick = m_bricks[i];
+		PyObject *dict = py_stats_dict(brick);
+
+		item = PyUnicode_FromString(brick.m_objectName.c_str());
+		PyDict_SetItemString(dict, "object", item);
+		Py_DECREF(item);
+
+		item = PyUnicode_FromString(brick.m_brickName.c_str());
+		PyDict_SetItemString(dict, "name", item);
+		Py_DECREF(item);
+
+		item = PyUnicode_FromString(brick.m_typeName.c_str());
+		PyDict_SetItemString(dict, "type", item);
+		Py_DECREF(item);
+
+		item = PyUnicode_FromString(GetCategoryName(brick.m_category));
+		PyDict_SetItemString(dict, "category", item);
+		Py_DECREF(item);
+
+		PyList_SET_ITEM(bricks, i, dict);
+	}
+	PyDict_SetItemString(result, "bricks", bricks);
+	Py_DECREF(bricks);
+
+	return result;
+}
+
+#endif  // WITH_PYTHON
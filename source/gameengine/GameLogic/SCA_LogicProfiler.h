@@ -0,0 +1,130 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file SCA_LogicProfiler.h
+ *  \ingroup gamelogic
+ */
+
+#ifndef __SCA_LOGICPROFILER_H__
+#define __SCA_LOGICPROFILER_H__
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <ostream>
+#include <chrono>
+
+#ifdef WITH_PYTHON
+#  include "Python.h"
+#endif
+
+class SCA_ILogicBrick;
+
+/** Accumulate the time spent and the number of calls of each logic brick: sensor evaluation,
+ * controller trigger and actuator update. Bricks are identified by their object and brick
+ * names so that the replicas of added objects are merged together.
+ * The profiler is disabled by default and only costs a boolean test per brick call.
+ */
+class SCA_LogicProfiler
+{
+public:
+	enum Category {
+		SENSOR = 0,
+		CONTROLLER,
+		ACTUATOR,
+		CATEGORY_MAX
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct Stats
+	{
+		/// Total time in seconds.
+		double m_time;
+		unsigned int m_calls;
+	};
+
+	struct BrickStats : Stats
+	{
+		std::string m_objectName;
+		std::string m_brickName;
+		std::string m_typeName;
+		Category m_category;
+	};
+
+private:
+	bool m_enabled;
+
+	std::vector<BrickStats> m_bricks;
+	/// Index in m_bricks by category, object and brick names.
+	std::map<std::string, unsigned int> m_brickIndices;
+	/// Index in m_bricks by brick, avoid the names look up for each call.
+	std::unordered_map<SCA_ILogicBrick *, unsigned int> m_brickCache;
+
+	unsigned int FindBrickIndex(SCA_ILogicBrick *brick, Category category);
+
+public:
+	SCA_LogicProfiler();
+	~SCA_LogicProfiler();
+
+	static const char *GetCategoryName(Category category);
+
+	inline bool GetEnabled() const
+	{
+		return m_enabled;
+	}
+	void SetEnabled(bool enabled);
+
+	/// Clear all the measurements.
+	void Reset();
+
+	/// Accumulate the time elapsed since start for the brick.
+	inline void AddTime(SCA_ILogicBrick *brick, Category category, const Clock::time_point& start)
+	{
+		const std::chrono::duration<double> elapsed = Clock::now() - start;
+		BrickStats& stats = m_bricks[FindBrickIndex(brick, category)];
+		stats.m_time += elapsed.count();
+		++stats.m_calls;
+	}
+
+	/// Forget a brick being deleted, its measurements are kept.
+	void RemoveBrick(SCA_ILogicBrick *brick);
+
+	const std::vector<BrickStats>& GetBrickStats() const;
+	/// Return the measurements accumulated per brick type.
+	std::map<std::string, Stats> GetTypeStats() const;
+	/// Return the measurements accumulated per category.
+	Stats GetCategoryStats(Category category) const;
+
+	/// Write the measurements as a JSON object.
+	void WriteJson(std::ostream& stream) const;
+	/// Write an escaped JSON string.
+	static void WriteJsonString(std::ostream& stream, const std::string& str);
+
+#ifdef WITH_PYTHON
+	PyObject *GetPyProfileDict() const;
+#endif  // WITH_PYTHON
+};
+
+#endif  // __SCA_LOGICPROFILER_H__
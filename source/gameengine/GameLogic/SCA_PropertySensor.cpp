@@ -124,6 +124,18 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 	m_recentresult=false;
 	bool result=false;
 	bool reverse = false;
+
+	/* Properties without sub context are borrowed from the parent to avoid
+	 * the non atomic reference counting when evaluated outside the main thread. */
+	const bool borrowed = IsThreadSafe();
+	CValue *orgprop = (borrowed) ? GetParent()->GetProperty(m_checkpropname) : GetParent()->FindIdentifier(m_checkpropname);
+	if (orgprop && orgprop->IsError()) {
+		if (!borrowed) {
+			orgprop->Release();
+		}
+		orgprop = nullptr;
+	}
+
 	switch (m_checktype)
 	{
 	case KX_PROPSENSOR_NOTEQUAL:
@@ -131,8 +143,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		ATTR_FALLTHROUGH;
 	case KX_PROPSENSOR_EQUAL:
 		{
-			CValue* orgprop = GetParent()->FindIdentifier(m_checkpropname);
-			if (!orgprop->IsError())
+			if (orgprop)
 			{
 				const std::string& testprop = orgprop->GetText();
 				// Force strings to upper case, to avoid confusion in
@@ -154,8 +165,6 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 				}
 				/* end patch */
 			}
-			orgprop->Release();
-
 			if (reverse)
 				result = !result;
 			break;
@@ -168,8 +177,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		}
 	case KX_PROPSENSOR_INTERVAL:
 		{
-			CValue* orgprop = GetParent()->FindIdentifier(m_checkpropname);
-			if (!orgprop->IsError())
+			if (orgprop)
 			{
 				float min;
 				float max;
@@ -186,15 +194,11 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 
 				result = (min <= val) && (val <= max);
 			}
-			orgprop->Release();
-
 		break;
 		}
 	case KX_PROPSENSOR_CHANGED:
 		{
-			CValue* orgprop = GetParent()->FindIdentifier(m_checkpropname);
-				
-			if (!orgprop->IsError())
+			if (orgprop)
 			{
 				if (m_previoustext != orgprop->GetText())
 				{
@@ -202,8 +206,6 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 					result = true;
 				}
 			}
-			orgprop->Release();
-
 			break;
 		}
 	case KX_PROPSENSOR_LESSTHAN:
@@ -211,8 +213,7 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 		ATTR_FALLTHROUGH;
 	case KX_PROPSENSOR_GREATERTHAN:
 		{
-			CValue* orgprop = GetParent()->FindIdentifier(m_checkpropname);
-			if (!orgprop->IsError())
+			if (orgprop)
 			{
 				float ref;
 				CM_StringTo(m_checkpropval, ref);
@@ -233,14 +234,16 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 				}
 
 			}
-			orgprop->Release();
-
 			break;
 		}
 	default:
 		; /* error */
 	}
 
+	if (orgprop && !borrowed) {
+		orgprop->Release();
+	}
+
 	//the concept of Edge and Level triggering has unwanted effect for KX_PROPSENSOR_CHANGED
 	//see Game Engine bugtracker [ #3809 ]
 	m_recentresult = result;
@@ -248,6 +251,12 @@ bool	SCA_PropertySensor::CheckPropertyCondition()
 	return result;
 }
 
+bool SCA_PropertySensor::IsThreadSafe() const
+{
+	// Dotted names can resolve through sub contexts which are not safe to read from a task.
+	return (m_checkpropname.find('.') == std::string::npos);
+}
+
 CValue* SCA_PropertySensor::FindIdentifier(const std::string& identifiername)
 {
 	return  GetParent()->FindIdentifier(identifiername);
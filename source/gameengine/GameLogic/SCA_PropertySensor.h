@@ -78,6 +78,7 @@ public:
 
 	virtual bool Evaluate();
 	virtual bool	IsPositiveTrigger();
+	virtual bool	IsThreadSafe() const;
 	virtual CValue*		FindIdentifier(const std::string& identifiername);
 
 #ifdef WITH_PYTHON
@@ -0,0 +1,119 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/GamePlayer/GPG_NullCanvas.cpp
+ *  \ingroup player
+ */
+
+#include "GPG_NullCanvas.h"
+#include "RAS_Rect.h"
+
+#include "BLI_utildefines.h"
+
+GPG_NullCanvas::GPG_NullCanvas(RAS_Rasterizer *rasty, int width, int height)
+	:RAS_ICanvas(rasty)
+{
+	Resize(width, height);
+}
+
+GPG_NullCanvas::~GPG_NullCanvas()
+{
+}
+
+void GPG_NullCanvas::Init()
+{
+}
+
+void GPG_NullCanvas::BeginFrame()
+{
+}
+
+void GPG_NullCanvas::EndFrame()
+{
+}
+
+void GPG_NullCanvas::BeginDraw()
+{
+}
+
+void GPG_NullCanvas::EndDraw()
+{
+}
+
+void GPG_NullCanvas::SwapBuffers()
+{
+}
+
+void GPG_NullCanvas::SetSwapInterval(int UNUSED(interval))
+{
+}
+
+bool GPG_NullCanvas::GetSwapInterval(int& UNUSED(intervalOut))
+{
+	return false;
+}
+
+void GPG_NullCanvas::ConvertMousePosition(int x, int y, int &r_x, int &r_y, bool UNUSED(screen))
+{
+	r_x = x;
+	r_y = y;
+}
+
+void GPG_NullCanvas::SetMouseState(RAS_MouseState mousestate)
+{
+	m_mousestate = mousestate;
+}
+
+void GPG_NullCanvas::SetMousePosition(int UNUSED(x), int UNUSED(y))
+{
+}
+
+void GPG_NullCanvas::MakeScreenShot(const std::string& UNUSED(filename))
+{
+	// Nothing is drawn.
+}
+
+void GPG_NullCanvas::GetDisplayDimensions(int &width, int &height)
+{
+	width = GetWidth();
+	height = GetHeight();
+}
+
+void GPG_NullCanvas::ResizeWindow(int width, int height)
+{
+	Resize(width, height);
+}
+
+void GPG_NullCanvas::Resize(int width, int height)
+{
+	m_viewportArea = RAS_Rect(width, height);
+	m_windowArea = RAS_Rect(width, height);
+}
+
+void GPG_NullCanvas::SetFullScreen(bool UNUSED(enable))
+{
+}
+
+bool GPG_NullCanvas::GetFullScreen()
+{
+	return false;
+}
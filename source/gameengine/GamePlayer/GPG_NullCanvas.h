@@ -0,0 +1,71 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file GPG_NullCanvas.h
+ *  \ingroup player
+ */
+
+#ifndef __GPG_NULLCANVAS_H__
+#define __GPG_NULLCANVAS_H__
+
+#include "RAS_ICanvas.h"
+
+class RAS_Rasterizer;
+
+/** Canvas of the headless player: it has the size of the game but no window,
+ * nothing is drawn, swapped or captured.
+ */
+class GPG_NullCanvas : public RAS_ICanvas
+{
+public:
+	GPG_NullCanvas(RAS_Rasterizer *rasty, int width, int height);
+	virtual ~GPG_NullCanvas();
+
+	virtual void Init();
+
+	virtual void BeginFrame();
+	virtual void EndFrame();
+
+	virtual void BeginDraw();
+	virtual void EndDraw();
+
+	virtual void SwapBuffers();
+	virtual void SetSwapInterval(int interval);
+	virtual bool GetSwapInterval(int& intervalOut);
+
+	virtual void ConvertMousePosition(int x, int y, int &r_x, int &r_y, bool screen);
+
+	virtual void SetMouseState(RAS_MouseState mousestate);
+	virtual void SetMousePosition(int x, int y);
+
+	virtual void MakeScreenShot(const std::string& filename);
+
+	virtual void GetDisplayDimensions(int &width, int &height);
+
+	virtual void ResizeWindow(int width, int height);
+	virtual void Resize(int width, int height);
+
+	virtual void SetFullScreen(bool enable);
+	virtual bool GetFullScreen();
+};
+
+#endif  // __GPG_NULLCANVAS_H__
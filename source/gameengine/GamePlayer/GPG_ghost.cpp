@@ -400,6 +400,28 @@ static GHOST_IWindow *startWindow(
 	return window;
 }
 
+/** The headless player never draws, but the scene conversion creates the EEVEE materials
+ * and off-screen buffers, they need an OpenGL context only provided by a window.
+ */
+static GHOST_IWindow *startHiddenWindow(GHOST_ISystem *system)
+{
+	GHOST_GLSettings glSettings = {0};
+	STR_String title("blenderplayer");
+
+	GHOST_IWindow *window = system->createWindow(title, 0, 0, 16, 16, GHOST_kWindowStateMinimized,
+	                                     GHOST_kDrawingContextTypeOpenGL, glSettings);
+	if (!window) {
+		CM_Error("could not create the OpenGL context of the headless mode");
+		exit(-1);
+	}
+
+	// Some systems ignore the state at the window creation.
+	window->setState(GHOST_kWindowStateMinimized);
+	window->setCursorVisibility(false);
+
+	return window;
+}
+
 static GHOST_IWindow *startEmbeddedWindow(
 		GHOST_ISystem *system,
         STR_String& title,
@@ -503,8 +525,26 @@ static void usage(const std::string& program, bool isBlenderPlayer)
 	CM_Message("       show_armatures                 0         Show debug armatures");
 	CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
 	CM_Message("       show_shadow_frustum            0         Show debug light shadow frustum volume");
-	CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings" << std::endl);
+	CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+	CM_Message("       job_threads                    0         Engine worker threads including the main thread, 0 for all cores");
+	CM_Message("       fixed_step                     0         Proceed one logic frame per frame whatever the real time (1 with -b)");
+	CM_Message("       max_frames                     0         Exit after the given number of frames, 0 for no limit");
+	CM_Message("       input_record                             Record the input events of the session in the given file");
+	CM_Message("       input_replay                             Replay the input events of a record and exit at its end");
+	CM_Message("       mesh_cache                     1         Reuse the converted meshes data when converting again the same meshes");
+	CM_Message("       mesh_cache_size                256       Maximum memory used by the converted meshes data in MB");
+	CM_Message("       mesh_cache_dir                           Save the converted meshes data in the given directory for the next launches" << std::endl);
 	CM_Message("  -p: override python main loop script");
+	CM_Message("  -t: write a timeline of the engine stages in Chrome trace format (chrome://tracing) at exit");
+	CM_Message("       Example: -t trace.json" << std::endl);
+	CM_Message("  -b: headless mode, run the logic, physics, culling and animations without drawing or showing a window");
+	CM_Message("       A display is still needed: the scene conversion creates the materials in an OpenGL context");
+	CM_Message("       of a hidden window, nothing uses it once the game runs.");
+	CM_Message("       Example: -b -g max_frames = 1000 -r profile.json" << std::endl);
+	CM_Message("  -r: write the time spent per profile category in JSON at exit");
+	CM_Message("       Example: -r profile.json" << std::endl);
+	CM_Message("  --enable-memory-pool: keep freed small memory blocks in per-thread caches, for faster allocation" << std::endl);
+	CM_Message("  Example of benchmark: -g input_record = session.rec game.blend, then -b -r profile.json -g input_replay = session.rec game.blend" << std::endl);
 	CM_Message(std::endl);
 	CM_Message("  - : all arguments after this are ignored, allowing python to access them from sys.argv");
 	CM_Message(std::endl);
@@ -674,6 +714,7 @@ int main(
 	std::string pythonControllerFile;
 	GHOST_TUns16 aasamples = 0;
 	int alphaBackground = 0;
+	bool headless = false;
 	
 #ifdef WIN32
 	char **argv;
@@ -709,6 +750,28 @@ int main(
 #endif /* __alpha__ */
 #endif /* __linux__ */
 
+	/* Switch to the pool allocator before any allocation happened,
+	 * not with the guarded allocator used to debug memory. */
+	{
+		bool use_memory_pool = false;
+		for (i = 1; i < argc; i++) {
+			if (strcmp(argv[i], "--enable-memory-pool") == 0) {
+				use_memory_pool = true;
+			}
+			else if (strcmp(argv[i], "-d") == 0 && (i + 1) < argc && strcmp(argv[i + 1], "memory") == 0) {
+				use_memory_pool = false;
+				break;
+			}
+			else if (strcmp(argv[i], "-") == 0) {
+				break;
+			}
+		}
+
+		if (use_memory_pool) {
+			MEM_use_pool_allocator();
+		}
+	}
+
 #ifdef WITH_SDL_DYNLOAD
 	sdlewInit();
 #endif
@@ -1030,6 +1093,48 @@ int main(
 				pythonControllerFile = argv[i++];
 				break;
 			}
+			case 't': //write a chrome trace of the engine stages at exit
+			{
+				++i;
+				if ((i + 1) <= validArguments) {
+					SYS_WriteCommandLineString(syshandle, "trace_file", argv[i++]);
+				}
+				else {
+					error = true;
+					CM_Error("no argument supplied for -t");
+				}
+				break;
+			}
+			case 'b': //headless mode for benchmarking
+			{
+				++i;
+				headless = true;
+				SYS_WriteCommandLineInt(syshandle, "headless", 1);
+				break;
+			}
+			case 'r': //write the profile categories at exit
+			{
+				++i;
+				if ((i + 1) <= validArguments) {
+					SYS_WriteCommandLineString(syshandle, "profile_file", argv[i++]);
+				}
+				else {
+					error = true;
+					CM_Error("no argument supplied for -r");
+				}
+				break;
+			}
+			case '-':
+			{
+				if (strcmp(argv[i], "--enable-memory-pool") == 0) {
+					// Handled at startup, before any allocation.
+					++i;
+				}
+				else {
+					CM_Warning("unknown argument: " << argv[i++]);
+				}
+				break;
+			}
 			default:  //not recognized
 			{
 				CM_Warning("unknown argument: " << argv[i++]);
@@ -1174,7 +1279,10 @@ int main(
 						titlename = maggie->name;
 						
 						// Check whether the game should be displayed full-screen
-						if ((!fullScreenParFound) && (!windowParFound)) {
+						if (headless) {
+							fullScreen = false;
+						}
+						else if ((!fullScreenParFound) && (!windowParFound)) {
 							// Only use file settings when command line did not override
 							if ((scene->gm.playerflag & GAME_PLAYER_FULLSCREEN)) {
 								fullScreen = true;
@@ -1198,7 +1306,10 @@ int main(
 						if (firstTimeRunning) {
 							firstTimeRunning = false;
 
-							if (fullScreen) {
+							if (headless) {
+								window = startHiddenWindow(system);
+							}
+							else if (fullScreen) {
 #ifdef WIN32
 								if (scr_saver_mode == SCREEN_SAVER_MODE_SAVER)
 								{
@@ -1295,6 +1406,10 @@ int main(
 						exitcode = launcher.GetExitRequested();
 						exitstring = launcher.GetExitString();
 						gs = *launcher.GetGlobalSettings();
+						// The game was stopped at the start, like for an invalid input replay file.
+						if (launcher.GetInitError()) {
+							error = true;
+						}
 
 						/* Delete the globalDict before free the launcher, because the launcher calls
 						 * Py_Finalize() which disallow any python commands after.
@@ -599,6 +599,11 @@ void KX_GameObject::ReplaceShadowShadingGroups(std::vector<DRWShadingGroup *>sha
 	m_shadowShGroups = shadowShgroups;
 }
 
+bool KX_GameObject::GetCastShadows() const
+{
+	return m_castShadows;
+}
+
 BGEShCaster *KX_GameObject::GetShadowCaster()
 {
 	return &m_shcaster;
@@ -718,24 +723,28 @@ KX_LodManager *KX_GameObject::GetLodManager() const
 	return m_lodManager;
 }
 
-void KX_GameObject::UpdateLod(const MT_Vector3& cam_pos, float lodfactor)
+KX_LodLevel *KX_GameObject::ComputeLodLevel(const MT_Vector3& cam_pos, float lodfactor, float& distance2)
 {
 	if (!m_lodManager) {
-		return;
+		return nullptr;
 	}
 
-	KX_Scene *scene = GetScene();
-	const float distance2 = NodeGetWorldPosition().distance2(cam_pos) * (lodfactor * lodfactor);
-	KX_LodLevel *lodLevel = m_lodManager->GetLevel(scene, m_currentLodLevel, distance2);
+	distance2 = NodeGetWorldPosition().distance2(cam_pos) * (lodfactor * lodfactor);
+	return m_lodManager->GetLevel(GetScene(), m_currentLodLevel, distance2);
+}
 
-	if (lodLevel) {
-		RAS_MeshObject *mesh = lodLevel->GetMesh();
-		if (mesh != m_rasMeshObject) {
-			scene->ReplaceMesh(this, mesh, true, false);
-		}
+bool KX_GameObject::NeedLodMeshReplace(KX_LodLevel *lodLevel) const
+{
+	return (lodLevel->GetMesh() != m_rasMeshObject);
+}
 
-		m_currentLodLevel = lodLevel->GetLevel();
+void KX_GameObject::SetLodLevel(KX_LodLevel *lodLevel, bool update_shadows)
+{
+	if (NeedLodMeshReplace(lodLevel)) {
+		GetScene()->ReplaceMesh(this, lodLevel->GetMesh(), true, false, update_shadows);
 	}
+
+	m_currentLodLevel = lodLevel->GetLevel();
 }
 
 /******************************End of LEVEL OF DETAIL****************************/
@@ -55,6 +55,7 @@
 struct KX_ClientObjectInfo;
 class KX_RayCast;
 class KX_LodManager;
+class KX_LodLevel;
 class KX_CullingNode;
 class RAS_MeshObject;
 class PHY_IGraphicController;
@@ -267,8 +268,20 @@ public:
 	/// Get current lod manager.
 	KX_LodManager *GetLodManager() const;
 
-	/* Updates the current lod level based on distance from camera */
-	void UpdateLod(const MT_Vector3& cam_pos, float lodfactor);
+	/** Compute the lod level matching the distance from the camera, can be called from any thread.
+	 * \param cam_pos The camera position.
+	 * \param lodfactor The camera lod distance factor.
+	 * \param distance2 Set to the squared distance from the camera scaled by the lod factor.
+	 * \return The new lod level or nullptr if the level didn't change.
+	 */
+	KX_LodLevel *ComputeLodLevel(const MT_Vector3& cam_pos, float lodfactor, float& distance2);
+	/** Set the current lod level and replace the mesh if needed.
+	 * \param update_shadows False when the caller rebuilds the shadow passes after replacing several meshes.
+	 */
+	void SetLodLevel(KX_LodLevel *lodLevel, bool update_shadows);
+	/// Return true if the lod level uses a different mesh than the current one.
+	bool NeedLodMeshReplace(KX_LodLevel *lodLevel) const;
+	bool GetCastShadows() const;
 	/****************End of LEVEL OF DETAIL************************/
 
 	/*****************VISIBILITY/CULLING***************************/
@@ -37,8 +37,9 @@
 #include "CM_Message.h"
 
 #include <boost/format.hpp>
-
-#include "BLI_task.h"
+#include <fstream>
+#include <limits>
+#include <algorithm>
 
 #include "KX_KetsjiEngine.h"
 
@@ -54,6 +55,7 @@
 #include "MT_Vector3.h"
 #include "MT_Transform.h"
 #include "SCA_IInputDevice.h"
+#include "SCA_LogicManager.h"
 #include "KX_Camera.h"
 #include "KX_Light.h"
 #include "KX_Globals.h"
@@ -138,7 +140,7 @@ const std::string KX_KetsjiEngine::m_profileLabels[tc_numCategories] = {
 /**
  * Constructor of the Ketsji Engine
  */
-KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
+KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system, CM_JobSystem *jobSystem)
 	:m_canvas(nullptr),
 	m_rasterizer(nullptr),
 	m_kxsystem(system),
@@ -167,7 +169,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
 	m_showBoundingBox(KX_DebugOption::DISABLE),
 	m_showArmature(KX_DebugOption::DISABLE),
 	m_showCameraFrustum(KX_DebugOption::DISABLE),
-	m_showShadowFrustum(KX_DebugOption::DISABLE)
+	m_showShadowFrustum(KX_DebugOption::DISABLE),
+	m_jobSystem(jobSystem)
 {
 	for (int i = tc_first; i < tc_numCategories; i++) {
 		m_logger.AddCategory((KX_TimeCategory)i);
@@ -177,8 +180,6 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system)
 	m_pyprofiledict = PyDict_New();
 #endif
 
-	m_taskscheduler = BLI_task_scheduler_create(TASK_SCHEDULER_AUTO_THREADS);
-
 	m_scenes = new CListValue<KX_Scene>();
 }
 
@@ -191,9 +192,6 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
 	Py_CLEAR(m_pyprofiledict);
 #endif
 
-	if (m_taskscheduler)
-		BLI_task_scheduler_free(m_taskscheduler);
-
 	m_scenes->Release();
 }
 
@@ -241,6 +239,13 @@ void KX_KetsjiEngine::StartEngine()
 	m_previousClockTime = m_kxsystem->GetTimeInSeconds();
 	m_previousRealTime = m_kxsystem->GetTimeInSeconds();
 
+	m_frameProfile.frames = 0;
+	for (int i = tc_first; i < tc_numCategories; ++i) {
+		m_frameProfile.categories[i] = 0.0;
+	}
+	m_frameProfile.minFrame = std::numeric_limits<double>::max();
+	m_frameProfile.maxFrame = 0.0;
+
 	m_bInitialized = true;
 }
 
@@ -260,6 +265,27 @@ void KX_KetsjiEngine::EndFrame()
 		RenderDebugProperties();
 	}
 
+	UpdateProfile();
+
+	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
+	m_rasterizer->EndFrame();
+
+	m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+	m_canvas->FlushScreenshots();
+
+	// swap backbuffer (drawing into this buffer) <-> front/visible buffer
+	m_logger.StartLog(tc_latency, m_kxsystem->GetTimeInSeconds());
+	{
+		KX_TraceScope traceScope(m_traceRecorder, "render", "SwapBuffers");
+		m_canvas->SwapBuffers();
+	}
+	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
+
+	m_canvas->EndDraw();
+}
+
+void KX_KetsjiEngine::UpdateProfile()
+{
 	double tottime = m_logger.GetAverage();
 	if (tottime < 1e-6)
 		tottime = 1e-6;
@@ -281,22 +307,25 @@ void KX_KetsjiEngine::EndFrame()
 	// Go to next profiling measurement, time spent after this call is shown in the next frame.
 	m_logger.NextMeasurement(m_kxsystem->GetTimeInSeconds());
 
-	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
-	m_rasterizer->EndFrame();
-
-	m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-	m_canvas->FlushScreenshots();
-
-	// swap backbuffer (drawing into this buffer) <-> front/visible buffer
-	m_logger.StartLog(tc_latency, m_kxsystem->GetTimeInSeconds());
-	m_canvas->SwapBuffers();
-	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
-
-	m_canvas->EndDraw();
+	if (!m_frameProfileFile.empty()) {
+		// Accumulate the measurement just completed.
+		double frametime = 0.0;
+		for (int i = tc_first; i < tc_numCategories; ++i) {
+			const double time = m_logger.GetLast((KX_TimeCategory)i);
+			m_frameProfile.categories[i] += time;
+			frametime += time;
+		}
+		m_frameProfile.minFrame = std::min(m_frameProfile.minFrame, frametime);
+		m_frameProfile.maxFrame = std::max(m_frameProfile.maxFrame, frametime);
+		++m_frameProfile.frames;
+	}
 }
 
 bool KX_KetsjiEngine::NextFrame()
 {
+	m_traceRecorder.NextFrame();
+	KX_TraceScope traceScope(m_traceRecorder, "engine", "NextFrame");
+
 	m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
 
 	/*
@@ -371,7 +400,10 @@ bool KX_KetsjiEngine::NextFrame()
 	while (frames) {
 		m_frameTime += framestep;
 
-		m_converter->MergeAsyncLoads();
+		{
+			KX_TraceScope traceScope(m_traceRecorder, "converter", "MergeAsyncLoads");
+			m_converter->MergeAsyncLoads();
+		}
 
 		if (m_inputDevice) {
 			m_inputDevice->ReleaseMoveEvent();
@@ -408,34 +440,52 @@ bool KX_KetsjiEngine::NextFrame()
 
 				// Process sensors, and controllers
 				m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-				scene->LogicBeginFrame(m_frameTime, framestep);
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "logic", "LogicBeginFrame", scene);
+					scene->LogicBeginFrame(m_frameTime, framestep);
+				}
 
 				// Scenegraph needs to be updated again, because Logic Controllers
 				// can affect the local matrices.
 				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-				scene->UpdateParents(m_frameTime);
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "scenegraph", "UpdateParents", scene);
+					scene->UpdateParents(m_frameTime);
+				}
 
 				// Process actuators
 
 				// Do some cleanup work for this logic frame
 				m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-				scene->LogicUpdateFrame(m_frameTime);
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "logic", "LogicUpdateFrame", scene);
+					scene->LogicUpdateFrame(m_frameTime);
 
-				scene->LogicEndFrame();
+					scene->LogicEndFrame();
+				}
 
 				// Actuators can affect the scenegraph
 				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-				scene->UpdateParents(m_frameTime);
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "scenegraph", "UpdateParents", scene);
+					scene->UpdateParents(m_frameTime);
+				}
 
 				m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
-				scene->GetPhysicsEnvironment()->BeginFrame();
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "physics", "ProceedDeltaTime", scene);
+					scene->GetPhysicsEnvironment()->BeginFrame();
 
-				// Perform physics calculations on the scene. This can involve
-				// many iterations of the physics solver.
-				scene->GetPhysicsEnvironment()->ProceedDeltaTime(m_frameTime, timestep, framestep);//m_deltatimerealDeltaTime);
+					// Perform physics calculations on the scene. This can involve
+					// many iterations of the physics solver.
+					scene->GetPhysicsEnvironment()->ProceedDeltaTime(m_frameTime, timestep, framestep);//m_deltatimerealDeltaTime);
+				}
 
 				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-				scene->UpdateParents(m_frameTime);
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "scenegraph", "UpdateParents", scene);
+					scene->UpdateParents(m_frameTime);
+				}
 			}
 
 			m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
@@ -532,6 +582,13 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData>& frameData
 
 void KX_KetsjiEngine::Render()
 {
+	if (m_flags & HEADLESS) {
+		RenderHeadless();
+		return;
+	}
+
+	KX_TraceScope traceScope(m_traceRecorder, "render", "Render");
+
 	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 
 	BeginFrame();
@@ -572,6 +629,7 @@ void KX_KetsjiEngine::Render()
 
 			// Draw the scene once for each camera with an enabled viewport or an active camera.
 			for (const CameraRenderData& cameraFrameData : sceneFrameData.m_cameraDataList) {
+				KX_TraceScope traceScope(m_traceRecorder, "render", "RenderCamera", scene);
 				// do the rendering
 				RenderCamera(scene, cameraFrameData, pass++);
 			}
@@ -583,7 +641,10 @@ void KX_KetsjiEngine::Render()
 
 			RAS_Rasterizer::FrameBufferType next = m_rasterizer->NextRenderFrameBuffer(fb->GetType());
 
-			fb = PostRenderScene(scene, fb, m_rasterizer->GetFrameBuffer(next));
+			{
+				KX_TraceScope traceScope(m_traceRecorder, "render", "PostRenderScene", scene);
+				fb = PostRenderScene(scene, fb, m_rasterizer->GetFrameBuffer(next));
+			}
 			lastfb = fb;
 
 			frameData.m_fbType = fb->GetType();
@@ -606,6 +667,46 @@ void KX_KetsjiEngine::Render()
 	EndFrame();
 }
 
+void KX_KetsjiEngine::RenderHeadless()
+{
+	KX_TraceScope traceScope(m_traceRecorder, "render", "RenderHeadless");
+
+	m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+
+	std::vector<FrameRenderData> frameDataList;
+	GetFrameRenderData(frameDataList);
+
+	for (const FrameRenderData& frameData : frameDataList) {
+		for (const SceneRenderData& sceneFrameData : frameData.m_sceneDataList) {
+			KX_Scene *scene = sceneFrameData.m_scene;
+			KX_SetActiveScene(scene);
+
+			for (const CameraRenderData& cameraFrameData : sceneFrameData.m_cameraDataList) {
+				cameraFrameData.m_renderCamera->UpdateViewVecs();
+
+				m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+				// The culling is kept as it updates the visibility used by the logic and the level of details.
+				KX_CullingNodeList nodes;
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "scenegraph", "CalculateVisibleMeshes", scene);
+					scene->CalculateVisibleMeshes(nodes, cameraFrameData.m_cullingCamera, 0);
+				}
+
+				m_logger.StartLog(tc_animations, m_kxsystem->GetTimeInSeconds());
+				{
+					KX_TraceScope traceScope(m_traceRecorder, "animation", "UpdateAnimations", scene);
+					UpdateAnimations(scene);
+				}
+			}
+		}
+	}
+
+	m_logger.StartLog(tc_overhead, m_kxsystem->GetTimeInSeconds());
+	UpdateProfile();
+
+	m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+}
+
 void KX_KetsjiEngine::RequestExit(KX_ExitRequest exitrequestmode)
 {
 	m_exitcode = exitrequestmode;
@@ -838,10 +939,16 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene, const CameraRenderData& came
 	m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
 
 	KX_CullingNodeList nodes;
-	scene->CalculateVisibleMeshes(nodes, cullingcam, 0);
+	{
+		KX_TraceScope traceScope(m_traceRecorder, "scenegraph", "CalculateVisibleMeshes", scene);
+		scene->CalculateVisibleMeshes(nodes, cullingcam, 0);
+	}
 
 	m_logger.StartLog(tc_animations, m_kxsystem->GetTimeInSeconds());
-	UpdateAnimations(scene);
+	{
+		KX_TraceScope traceScope(m_traceRecorder, "animation", "UpdateAnimations", scene);
+		UpdateAnimations(scene);
+	}
 
 	m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 
@@ -897,6 +1004,18 @@ void KX_KetsjiEngine::StopEngine()
 	if (m_bInitialized) {
 		m_converter->FinalizeAsyncLoads();
 
+		if (!m_logicProfileFile.empty()) {
+			WriteLogicProfile();
+		}
+
+		if (!m_frameProfileFile.empty()) {
+			WriteFrameProfile();
+		}
+
+		if (!m_traceFile.empty() && !m_traceRecorder.WriteChromeTrace(m_traceFile)) {
+			CM_Error("failed to write the trace in " << m_traceFile);
+		}
+
 		while (m_scenes->GetCount() > 0) {
 			KX_Scene *scene = m_scenes->GetFront();
 			m_converter->RemoveScene(scene);
@@ -919,6 +1038,10 @@ void KX_KetsjiEngine::AddScene(KX_Scene *scene)
 
 void KX_KetsjiEngine::PostProcessScene(KX_Scene *scene)
 {
+	if (!m_logicProfileFile.empty()) {
+		scene->GetLogicManager()->GetProfiler().SetEnabled(true);
+	}
+
 	bool override_camera = ((m_flags & CAMERA_OVERRIDE) && (scene->GetName() == m_overrideSceneName));
 
 	// if there is no activecamera, or the camera is being
@@ -1303,6 +1426,85 @@ void KX_KetsjiEngine::SetMaxLogicFrame(int frame)
 	m_maxLogicFrame = frame;
 }
 
+void KX_KetsjiEngine::SetLogicProfileFile(const std::string& filepath)
+{
+	m_logicProfileFile = filepath;
+
+	for (KX_Scene *scene : m_scenes) {
+		scene->GetLogicManager()->GetProfiler().SetEnabled(!m_logicProfileFile.empty());
+	}
+}
+
+const std::string& KX_KetsjiEngine::GetLogicProfileFile() const
+{
+	return m_logicProfileFile;
+}
+
+void KX_KetsjiEngine::SetFrameProfileFile(const std::string& filepath)
+{
+	m_frameProfileFile = filepath;
+}
+
+KX_TraceRecorder& KX_KetsjiEngine::GetTraceRecorder()
+{
+	return m_traceRecorder;
+}
+
+void KX_KetsjiEngine::SetTraceFile(const std::string& filepath)
+{
+	m_traceFile = filepath;
+	m_traceRecorder.SetEnabled(true);
+}
+
+void KX_KetsjiEngine::WriteLogicProfile()
+{
+	std::ofstream file(m_logicProfileFile);
+	if (!file) {
+		CM_Error("failed to write the logic profile in " << m_logicProfileFile);
+		return;
+	}
+
+	file << "{\n\"scenes\": [";
+	for (unsigned int i = 0, size = m_scenes->GetCount(); i < size; ++i) {
+		KX_Scene *scene = m_scenes->GetValue(i);
+		file << ((i == 0) ? "\n" : ",\n") << "{\"name\": ";
+		SCA_LogicProfiler::WriteJsonString(file, scene->GetName());
+		file << ",\n\"profile\": ";
+		scene->GetLogicManager()->GetProfiler().WriteJson(file);
+		file << "}";
+	}
+	file << "\n]\n}\n";
+}
+
+void KX_KetsjiEngine::WriteFrameProfile()
+{
+	std::ofstream file(m_frameProfileFile);
+	if (!file) {
+		CM_Error("failed to write the frame profile in " << m_frameProfileFile);
+		return;
+	}
+
+	const unsigned int frames = m_frameProfile.frames;
+	double total = 0.0;
+	for (int i = tc_first; i < tc_numCategories; ++i) {
+		total += m_frameProfile.categories[i];
+	}
+
+	// Times are in seconds, the labels are written without the display colon.
+	file << "{\n\"frames\": " << frames << ",\n\"time\": " << total << ",\n\"frame\": {";
+	file << "\"average\": " << ((frames > 0) ? total / frames : 0.0);
+	file << ", \"min\": " << ((frames > 0) ? m_frameProfile.minFrame : 0.0);
+	file << ", \"max\": " << m_frameProfile.maxFrame << "},\n\"categories\": [";
+	for (int i = tc_first; i < tc_numCategories; ++i) {
+		const std::string& label = m_profileLabels[i];
+		const double time = m_frameProfile.categories[i];
+		file << ((i == tc_first) ? "\n" : ",\n") << "{\"name\": ";
+		SCA_LogicProfiler::WriteJsonString(file, label.substr(0, label.size() - 1));
+		file << ", \"time\": " << time << ", \"average\": " << ((frames > 0) ? time / frames : 0.0) << "}";
+	}
+	file << "\n]\n}\n";
+}
+
 int KX_KetsjiEngine::GetMaxPhysicsFrame()
 {
 	return m_maxPhysicsFrame;
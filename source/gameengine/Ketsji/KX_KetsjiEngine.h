@@ -38,13 +38,14 @@
 #include "KX_ISystem.h"
 #include "KX_Scene.h"
 #include "KX_TimeCategoryLogger.h"
+#include "KX_TraceRecorder.h"
 #include "EXP_Python.h"
 #include "KX_WorldInfo.h"
 #include "RAS_CameraData.h"
 #include "RAS_Rasterizer.h"
 #include <vector>
 
-struct TaskScheduler;
+class CM_JobSystem;
 class KX_ISystem;
 class KX_BlenderConverter;
 class KX_NetworkMessageManager;
@@ -100,7 +101,9 @@ public:
 		/// Automatic add debug properties to the debug list.
 		AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
 		/// Use override camera?
-		CAMERA_OVERRIDE = (1 << 7)
+		CAMERA_OVERRIDE = (1 << 7),
+		/// Proceed the frames without drawing, the canvas and rasterizer are unused after the scene conversion.
+		HEADLESS = (1 << 8)
 	};
 
 private:
@@ -191,6 +194,14 @@ private:
 	KX_ExitRequest m_exitcode;
 	std::string m_exitstring;
 
+	/// File receiving the logic bricks profile at engine exit, empty to disable the profiling.
+	std::string m_logicProfileFile;
+
+	/// Timeline of the engine stages.
+	KX_TraceRecorder m_traceRecorder;
+	/// File receiving the Chrome trace at engine exit, empty to not write the trace.
+	std::string m_traceFile;
+
 	float m_cameraZoom;
 
 	std::string m_overrideSceneName;
@@ -221,6 +232,16 @@ private:
 
 	/// Labels for profiling display.
 	static const std::string m_profileLabels[tc_numCategories];
+
+	/// File receiving the frame time profile at engine exit, empty to disable the profile.
+	std::string m_frameProfileFile;
+	/// Time measurements accumulated over all the frames since the engine start.
+	struct FrameProfile {
+		unsigned int frames;
+		double categories[tc_numCategories];
+		double minFrame;
+		double maxFrame;
+	} m_frameProfile;
 	/// Last estimated framerate
 	double m_average_framerate;
 
@@ -236,8 +257,8 @@ private:
 	/// Settings that doesn't go away with Game Actuator
 	GlobalSettings m_globalsettings;
 
-	/// Task scheduler for multi-threading
-	TaskScheduler *m_taskscheduler;
+	/// Worker threads shared by all the engine subsystems.
+	CM_JobSystem *m_jobSystem;
 
 	/** Set scene's total pause duration for animations process.
 	 * This is done in a separate loop to get the proper state of each scenes.
@@ -281,12 +302,22 @@ private:
 	void AddScheduledScenes(void);
 	void ReplaceScheduledScenes(void);
 	void PostProcessScene(KX_Scene *scene);
+	/// Write the logic bricks profile of all the scenes in m_logicProfileFile.
+	void WriteLogicProfile();
+	/// Write the time spent per category and per frame in m_frameProfileFile.
+	void WriteFrameProfile();
 
 	void BeginFrame();
 	void EndFrame();
+	/** Proceed the render stages that don't draw: camera matrices, culling and animations.
+	 * Nothing uses the canvas or the rasterizer, the drawing callbacks of the scenes are not called.
+	 */
+	void RenderHeadless();
+	/// Update the averages of the profile and start the next measurement.
+	void UpdateProfile();
 
 public:
-	KX_KetsjiEngine(KX_ISystem *system);
+	KX_KetsjiEngine(KX_ISystem *system, CM_JobSystem *jobSystem);
 	virtual ~KX_KetsjiEngine();
 
 	RAS_FrameBuffer *PostRenderScene(KX_Scene *scene, RAS_FrameBuffer *inputfb, RAS_FrameBuffer *targetfb);
@@ -322,13 +353,14 @@ public:
 		return m_networkMessageManager;
 	}
 
-	TaskScheduler *GetTaskScheduler()
+	CM_JobSystem *GetJobSystem() const
 	{
-		return m_taskscheduler;
+		return m_jobSystem;
 	}
 
 	/// returns true if an update happened to indicate -> Render
 	bool NextFrame();
+	/// Draw the scenes, or only proceed the stages that don't draw with the HEADLESS flag.
 	void Render();
 
 	void StartEngine();
@@ -404,6 +436,24 @@ public:
 	 * Sets the maximum number of logic frame before render frame
 	 */
 	void SetMaxLogicFrame(int frame);
+	KX_TraceRecorder& GetTraceRecorder();
+	/**
+	 * Sets the file receiving the Chrome trace at engine exit and enables the trace recording.
+	 */
+	void SetTraceFile(const std::string& filepath);
+
+	/**
+	 * Sets the file receiving the logic bricks profile of all scenes at engine exit
+	 * and enables the profiling, an empty path disables it.
+	 */
+	void SetLogicProfileFile(const std::string& filepath);
+	const std::string& GetLogicProfileFile() const;
+
+	/**
+	 * Sets the file receiving the time spent per profile category at engine exit
+	 * in JSON, an empty path disables it.
+	 */
+	void SetFrameProfileFile(const std::string& filepath);
 	/**
 	 * Gets the maximum number of physics frame before render frame
 	 */
@@ -121,6 +121,7 @@ extern "C" {
 
 #include "KX_PythonInitTypes.h"
 
+#include "CM_JobSystem.h"
 #include "CM_Message.h"
 
 /* we only need this to get a list of libraries from the main struct */
@@ -401,6 +402,91 @@ static PyObject *gPyGetMaxLogicFrame(PyObject *)
 	return PyLong_FromLong(KX_GetActiveEngine()->GetMaxLogicFrame());
 }
 
+static PyObject *gPySetLogicProfileFile(PyObject *, PyObject *args)
+{
+	char *filepath;
+	if (!PyArg_ParseTuple(args, "s:setLogicProfileFile", &filepath))
+		return nullptr;
+
+	KX_GetActiveEngine()->SetLogicProfileFile(filepath);
+	Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetLogicProfileFile(PyObject *)
+{
+	return PyUnicode_FromStdString(KX_GetActiveEngine()->GetLogicProfileFile());
+}
+
+static PyObject *gPySetTraceRecording(PyObject *, PyObject *args)
+{
+	int enable;
+	if (!PyArg_ParseTuple(args, "i:setTraceRecording", &enable))
+		return nullptr;
+
+	KX_GetActiveEngine()->GetTraceRecorder().SetEnabled(enable);
+	Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetTraceRecording(PyObject *)
+{
+	return PyBool_FromLong(KX_GetActiveEngine()->GetTraceRecorder().GetEnabled());
+}
+
+static PyObject *gPyWriteTrace(PyObject *, PyObject *args)
+{
+	char *filepath;
+	if (!PyArg_ParseTuple(args, "s:writeTrace", &filepath))
+		return nullptr;
+
+	if (!KX_GetActiveEngine()->GetTraceRecorder().WriteChromeTrace(filepath)) {
+		PyErr_Format(PyExc_IOError, "writeTrace(filepath): failed to write \"%s\"", filepath);
+		return nullptr;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject *gPyGetJobThreadCount(PyObject *)
+{
+	return PyLong_FromLong(KX_GetActiveEngine()->GetJobSystem()->GetNumThreads());
+}
+
+static PyObject *gPyGetJobQueueStats(PyObject *)
+{
+	CM_JobSystem *jobSystem = KX_GetActiveEngine()->GetJobSystem();
+	PyObject *dict = PyDict_New();
+
+	for (unsigned short i = 0; i < CM_JobSystem::QUEUE_MAX; ++i) {
+		const CM_JobSystem::Queue queue = (CM_JobSystem::Queue)i;
+		const CM_JobSystem::QueueStats stats = jobSystem->GetQueueStats(queue);
+
+		PyObject *queueDict = PyDict_New();
+		PyObject *item;
+
+		item = PyLong_FromUnsignedLong(stats.m_jobs);
+		PyDict_SetItemString(queueDict, "jobs", item);
+		Py_DECREF(item);
+
+		item = PyFloat_FromDouble(stats.m_busyTime);
+		PyDict_SetItemString(queueDict, "busyTime", item);
+		Py_DECREF(item);
+
+		item = PyFloat_FromDouble(stats.m_utilisation);
+		PyDict_SetItemString(queueDict, "utilisation", item);
+		Py_DECREF(item);
+
+		PyDict_SetItemString(dict, CM_JobSystem::GetQueueName(queue), queueDict);
+		Py_DECREF(queueDict);
+	}
+
+	return dict;
+}
+
+static PyObject *gPyResetJobQueueStats(PyObject *)
+{
+	KX_GetActiveEngine()->GetJobSystem()->ResetStats();
+	Py_RETURN_NONE;
+}
+
 static PyObject *gPySetMaxPhysicsFrame(PyObject *, PyObject *args)
 {
 	int frame;
@@ -807,6 +893,14 @@ static struct PyMethodDef game_methods[] = {
 	{"getSpectrum",(PyCFunction) gPyGetSpectrum, METH_NOARGS, (const char *)"get audio spectrum"},
 	{"getMaxLogicFrame", (PyCFunction) gPyGetMaxLogicFrame, METH_NOARGS, (const char *)"Gets the max number of logic frame per render frame"},
 	{"setMaxLogicFrame", (PyCFunction) gPySetMaxLogicFrame, METH_VARARGS, (const char *)"Sets the max number of logic frame per render frame"},
+	{"getLogicProfileFile", (PyCFunction) gPyGetLogicProfileFile, METH_NOARGS, (const char *)"Gets the file receiving the logic bricks profile at exit"},
+	{"setLogicProfileFile", (PyCFunction) gPySetLogicProfileFile, METH_VARARGS, (const char *)"Sets the file receiving the logic bricks profile at exit"},
+	{"getTraceRecording", (PyCFunction) gPyGetTraceRecording, METH_NOARGS, (const char *)"Gets if the engine stages timeline is recorded"},
+	{"setTraceRecording", (PyCFunction) gPySetTraceRecording, METH_VARARGS, (const char *)"Sets if the engine stages timeline is recorded"},
+	{"writeTrace", (PyCFunction) gPyWriteTrace, METH_VARARGS, (const char *)"Writes the engine stages timeline in Chrome trace format"},
+	{"getJobThreadCount", (PyCFunction) gPyGetJobThreadCount, METH_NOARGS, (const char *)"Gets the number of engine worker threads including the main thread"},
+	{"getJobQueueStats", (PyCFunction) gPyGetJobQueueStats, METH_NOARGS, (const char *)"Gets the jobs count, busy time and utilisation of each job queue"},
+	{"resetJobQueueStats", (PyCFunction) gPyResetJobQueueStats, METH_NOARGS, (const char *)"Resets the job queues statistics"},
 	{"getMaxPhysicsFrame", (PyCFunction) gPyGetMaxPhysicsFrame, METH_NOARGS, (const char *)"Gets the max number of physics frame per render frame"},
 	{"setMaxPhysicsFrame", (PyCFunction) gPySetMaxPhysicsFrame, METH_VARARGS, (const char *)"Sets the max number of physics farme per render frame"},
 	{"getLogicTicRate", (PyCFunction) gPyGetLogicTicRate, METH_NOARGS, (const char *)"Gets the logic tic rate"},
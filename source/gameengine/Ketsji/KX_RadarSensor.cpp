@@ -65,6 +65,7 @@ KX_RadarSensor::KX_RadarSensor(SCA_EventManager* eventmgr,
 				m_coneheight(coneheight),
 				m_axis(axis)
 {
+	UpdateConeLocalTransform();
 	m_client_info->m_type = KX_ClientObjectInfo::SENSOR;
 	//m_client_info->m_clientobject = gameobj;
 	//m_client_info->m_auxilary_info = nullptr;
@@ -84,68 +85,83 @@ CValue* KX_RadarSensor::GetReplica()
 }
 
 /**
- *	Transforms the collision object. A cone is not correctly centered
- *	for usage.  */
-void KX_RadarSensor::SynchronizeTransform()
+ *	Computes the cone transform relative to the object. A cone is not correctly centered
+ *	for usage. */
+void KX_RadarSensor::UpdateConeLocalTransform()
 {
-	// Getting the parent location was commented out. Why?
-	MT_Transform trans;
-	trans.setOrigin(((KX_GameObject*)GetParent())->NodeGetWorldPosition());
-	trans.setBasis(((KX_GameObject*)GetParent())->NodeGetWorldOrientation());
 	// What is the default orientation? pointing in the -y direction?
 	// is the geometry correctly converted?
 
 	// a collision cone is oriented
 	// center the cone correctly 
 	// depends on the radar 'axis'
+	m_coneLocalTrans.setIdentity();
 	switch (m_axis)
 	{
 	case SENS_RADAR_X_AXIS: // +X Axis
 		{
 			MT_Quaternion rotquatje(MT_Vector3(0,0,1),MT_radians(90));
-			trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	case SENS_RADAR_Y_AXIS: // +Y Axis
 		{
 			MT_Quaternion rotquatje(MT_Vector3(1,0,0),MT_radians(-180));
-			trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	case SENS_RADAR_Z_AXIS: // +Z Axis
 		{
 			MT_Quaternion rotquatje(MT_Vector3(1,0,0),MT_radians(-90));
-			trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	case SENS_RADAR_NEG_X_AXIS: // -X Axis
 		{
 			MT_Quaternion rotquatje(MT_Vector3(0,0,1),MT_radians(-90));
-			trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	case SENS_RADAR_NEG_Y_AXIS: // -Y Axis
 		{
 			//MT_Quaternion rotquatje(MT_Vector3(1,0,0),MT_radians(-180));
-			//trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			//m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	case SENS_RADAR_NEG_Z_AXIS: // -Z Axis
 		{
 			MT_Quaternion rotquatje(MT_Vector3(1,0,0),MT_radians(90));
-			trans.rotate(rotquatje);
-			trans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
+			m_coneLocalTrans.rotate(rotquatje);
+			m_coneLocalTrans.translate(MT_Vector3 (0, -m_coneheight/2.0f, 0));
 			break;
 		};
 	default:
 		{
 		}
 	}
+
+	m_coneLocalAxis = m_axis;
+}
+
+/**
+ *	Transforms the collision object. */
+void KX_RadarSensor::SynchronizeTransform()
+{
+	// The axis can be changed from python.
+	if (m_coneLocalAxis != m_axis) {
+		UpdateConeLocalTransform();
+	}
+
+	// Getting the parent location was commented out. Why?
+	MT_Transform trans;
+	trans.setOrigin(((KX_GameObject*)GetParent())->NodeGetWorldPosition());
+	trans.setBasis(((KX_GameObject*)GetParent())->NodeGetWorldOrientation());
+	trans *= m_coneLocalTrans;
 	
 	//Using a temp variable to translate MT_Vector3 to float[3].
 	//float[3] works better for the Python interface.
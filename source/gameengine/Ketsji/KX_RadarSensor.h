@@ -34,6 +34,7 @@
 
 #include "KX_NearSensor.h"
 #include "MT_Vector3.h"
+#include "MT_Transform.h"
 
 /**
  * Radar 'cone' sensor. Very similar to a near-sensor, but instead of a sphere, a cone is used.
@@ -60,6 +61,18 @@ class KX_RadarSensor : public KX_NearSensor
 	 * The previous direction of the cone (origin to bottom plane).
 	 */
 	float       m_cone_target[3];
+
+	/**
+	 * Transform of the cone relative to the object, only depending on the axis.
+	 */
+	MT_Transform m_coneLocalTrans;
+
+	/**
+	 * The axis used to compute m_coneLocalTrans.
+	 */
+	int m_coneLocalAxis;
+
+	void UpdateConeLocalTransform();
 	
 public:
 
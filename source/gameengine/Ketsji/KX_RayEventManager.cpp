@@ -0,0 +1,63 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_RayEventManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_RayEventManager.h"
+#include "KX_RaySensor.h"
+
+KX_RayEventManager::KX_RayEventManager(SCA_LogicManager *logicmgr)
+	:SCA_EventManager(logicmgr, RAY_EVENTMGR)
+{
+}
+
+KX_RayEventManager::~KX_RayEventManager()
+{
+}
+
+void KX_RayEventManager::NextFrame()
+{
+	SG_DList::iterator<KX_RaySensor> it(m_sensors);
+
+	// Compute the rays of all the sensors which will be evaluated.
+	for (it.begin(); !it.end(); ++it) {
+		KX_RaySensor *sensor = *it;
+		if (sensor->PrepareRayQuery()) {
+			m_queries.push_back(sensor);
+		}
+	}
+
+	/* Cast all the rays in a row. The physics queries are not run in parallel because
+	 * the broadphase ray test of bullet uses a stack shared by the whole world and the
+	 * hit callbacks read game object properties. */
+	for (KX_RaySensor *sensor : m_queries) {
+		sensor->ExecuteRayQuery();
+	}
+	m_queries.clear();
+
+	// Evaluate the sensors with the cached ray results.
+	for (it.begin(); !it.end(); ++it) {
+		(*it)->Activate(m_logicmgr);
+	}
+}
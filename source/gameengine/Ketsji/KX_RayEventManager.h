@@ -0,0 +1,55 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_RayEventManager.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_RAYEVENTMANAGER_H__
+#define __KX_RAYEVENTMANAGER_H__
+
+#include "SCA_EventManager.h"
+
+#include <vector>
+
+class KX_RaySensor;
+
+/** Event manager for ray sensors.
+ * The ray queries of all the sensors are resolved in a single stage before
+ * the sensors are evaluated: first all the ray end points are computed, then
+ * all the physics queries are cast back to back and finally the sensors are
+ * activated using the cached results.
+ */
+class KX_RayEventManager : public SCA_EventManager
+{
+private:
+	/// Sensors with a ray query pending for the current frame.
+	std::vector<KX_RaySensor *> m_queries;
+
+public:
+	KX_RayEventManager(SCA_LogicManager *logicmgr);
+	virtual ~KX_RayEventManager();
+
+	virtual void NextFrame();
+};
+
+#endif  // __KX_RAYEVENTMANAGER_H__
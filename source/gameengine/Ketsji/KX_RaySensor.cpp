@@ -77,6 +77,7 @@ void KX_RaySensor::Init()
 	m_rayHit = false;
 	m_hitObject = nullptr;
 	m_reset = true;
+	m_queryStatus = RAY_QUERY_NONE;
 }
 
 KX_RaySensor::~KX_RaySensor() 
@@ -198,96 +199,150 @@ bool KX_RaySensor::NeedRayCast(KX_ClientObjectInfo *client, void *UNUSED(data))
 	return true;
 }
 
-bool KX_RaySensor::Evaluate()
+bool KX_RaySensor::PrepareRayQuery()
 {
-	bool result = false;
-	bool reset = m_reset && m_level;
-	m_rayHit = false; 
-	m_hitObject = nullptr;
-	m_hitPosition[0] = 0;
-	m_hitPosition[1] = 0;
-	m_hitPosition[2] = 0;
+	if (IsNoLink() || IsSuspended()) {
+		// The sensor is not evaluated, avoid a useless ray cast.
+		return false;
+	}
 
-	m_hitNormal[0] = 1;
-	m_hitNormal[1] = 0;
-	m_hitNormal[2] = 0;
-	
-	KX_GameObject* obj = (KX_GameObject*)GetParent();
-	MT_Vector3 frompoint = obj->NodeGetWorldPosition();
-	MT_Matrix3x3 matje = obj->NodeGetWorldOrientation();
-	MT_Matrix3x3 invmat = matje.inverse();
-	
-	MT_Vector3 todir;
-	m_reset = false;
-	switch (m_axis)
-	{
-	case SENS_RAY_X_AXIS: // X
+	KX_GameObject *obj = (KX_GameObject *)GetParent();
+	const MT_Matrix3x3& ori = obj->NodeGetWorldOrientation();
+
+	/* The ray direction is a row of the inverse world orientation. A row of an inverse
+	 * matrix is the cross product of two columns of the original matrix divided by its
+	 * determinant, as the direction is normalized only the sign of the determinant matters. */
+	int row;
+	MT_Scalar sign;
+	switch (m_axis) {
+		case SENS_RAY_X_AXIS:
 		{
-			todir[0] = invmat[0][0];
-			todir[1] = invmat[0][1];
-			todir[2] = invmat[0][2];
+			row = 0;
+			sign = 1.0f;
 			break;
 		}
-	case SENS_RAY_Y_AXIS: // Y
+		case SENS_RAY_Y_AXIS:
 		{
-			todir[0] = invmat[1][0];
-			todir[1] = invmat[1][1];
-			todir[2] = invmat[1][2];
+			row = 1;
+			sign = 1.0f;
 			break;
 		}
-	case SENS_RAY_Z_AXIS: // Z
+		case SENS_RAY_Z_AXIS:
 		{
-			todir[0] = invmat[2][0];
-			todir[1] = invmat[2][1];
-			todir[2] = invmat[2][2];
+			row = 2;
+			sign = 1.0f;
 			break;
 		}
-	case SENS_RAY_NEG_X_AXIS: // -X
+		case SENS_RAY_NEG_X_AXIS:
 		{
-			todir[0] = -invmat[0][0];
-			todir[1] = -invmat[0][1];
-			todir[2] = -invmat[0][2];
+			row = 0;
+			sign = -1.0f;
 			break;
 		}
-	case SENS_RAY_NEG_Y_AXIS: // -Y
+		case SENS_RAY_NEG_Y_AXIS:
 		{
-			todir[0] = -invmat[1][0];
-			todir[1] = -invmat[1][1];
-			todir[2] = -invmat[1][2];
+			row = 1;
+			sign = -1.0f;
 			break;
 		}
-	case SENS_RAY_NEG_Z_AXIS: // -Z
+		case SENS_RAY_NEG_Z_AXIS:
+		default:
 		{
-			todir[0] = -invmat[2][0];
-			todir[1] = -invmat[2][1];
-			todir[2] = -invmat[2][2];
+			row = 2;
+			sign = -1.0f;
 			break;
 		}
 	}
-	todir.normalize();
+
+	const MT_Vector3 col0 = ori.getColumn(0);
+	const MT_Vector3 col1 = ori.getColumn(1);
+	const MT_Vector3 col2 = ori.getColumn(2);
+	if (col0.dot(col1.cross(col2)) < 0.0f) {
+		sign = -sign;
+	}
+
+	MT_Vector3 todir;
+	switch (row) {
+		case 0:
+		{
+			todir = col1.cross(col2);
+			break;
+		}
+		case 1:
+		{
+			todir = col2.cross(col0);
+			break;
+		}
+		case 2:
+		{
+			todir = col0.cross(col1);
+			break;
+		}
+	}
+	todir = sign * todir.safe_normalized();
+
 	m_rayDirection[0] = todir[0];
 	m_rayDirection[1] = todir[1];
 	m_rayDirection[2] = todir[2];
 
-	MT_Vector3 topoint = frompoint + (m_distance) * todir;
-	PHY_IPhysicsEnvironment* pe = m_scene->GetPhysicsEnvironment();
+	m_queryFrom = obj->NodeGetWorldPosition();
+	m_queryTo = m_queryFrom + m_distance * todir;
+	m_queryStatus = RAY_QUERY_PENDING;
 
-	if (!pe) {
+	return true;
+}
+
+void KX_RaySensor::ExecuteRayQuery()
+{
+	m_rayHit = false;
+	m_hitObject = nullptr;
+	m_hitPosition[0] = 0;
+	m_hitPosition[1] = 0;
+	m_hitPosition[2] = 0;
+
+	m_hitNormal[0] = 1;
+	m_hitNormal[1] = 0;
+	m_hitNormal[2] = 0;
+
+	PHY_IPhysicsEnvironment *physics_environment = m_scene->GetPhysicsEnvironment();
+	if (!physics_environment) {
 		CM_LogicBrickWarning(this, "there is no physics environment! Check universe for malfunction.");
-		return false;
-	} 
+		m_queryStatus = RAY_QUERY_FAILED;
+		return;
+	}
 
+	KX_GameObject *obj = (KX_GameObject *)GetParent();
 	PHY_IPhysicsController *spc = obj->GetPhysicsController();
 	KX_GameObject *parent = obj->GetParent();
-	if (!spc && parent)
+	if (!spc && parent) {
 		spc = parent->GetPhysicsController();
-	
-
-	PHY_IPhysicsEnvironment* physics_environment = this->m_scene->GetPhysicsEnvironment();
-	
+	}
 
 	KX_RayCast::Callback<KX_RaySensor, void> callback(this, spc);
-	KX_RayCast::RayTest(physics_environment, frompoint, topoint, callback);
+	KX_RayCast::RayTest(physics_environment, m_queryFrom, m_queryTo, callback);
+
+	m_queryStatus = RAY_QUERY_DONE;
+}
+
+bool KX_RaySensor::Evaluate()
+{
+	bool result = false;
+	bool reset = m_reset && m_level;
+	m_reset = false;
+
+	// The ray was not resolved by the event manager, cast it now.
+	if (m_queryStatus == RAY_QUERY_NONE) {
+		PrepareRayQuery();
+	}
+	if (m_queryStatus == RAY_QUERY_PENDING) {
+		ExecuteRayQuery();
+	}
+
+	const bool failed = (m_queryStatus == RAY_QUERY_FAILED);
+	m_queryStatus = RAY_QUERY_NONE;
+	if (failed) {
+		return false;
+	}
 
 	/* now pass this result to some controller */
 
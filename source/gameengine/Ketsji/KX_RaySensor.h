@@ -61,6 +61,17 @@ class KX_RaySensor : public SCA_ISensor
 	float			m_rayDirection[3];
 	std::string		m_hitMaterial;
 
+	/// State of the ray query of the current logic frame.
+	enum RayQueryStatus {
+		RAY_QUERY_NONE = 0,
+		RAY_QUERY_PENDING,
+		RAY_QUERY_DONE,
+		RAY_QUERY_FAILED
+	} m_queryStatus;
+	/// Ray end points computed by PrepareRayQuery.
+	MT_Vector3		m_queryFrom;
+	MT_Vector3		m_queryTo;
+
 public:
 	KX_RaySensor(class SCA_EventManager* eventmgr,
 					SCA_IObject* gameobj,
@@ -78,6 +89,13 @@ public:
 	virtual bool IsPositiveTrigger();
 	virtual void Init();
 
+	/** Compute the ray of the current frame.
+	 * \return False if the sensor will not be evaluated this frame.
+	 */
+	bool PrepareRayQuery();
+	/// Cast the ray computed by PrepareRayQuery and store the hit informations.
+	void ExecuteRayQuery();
+
 	/// \see KX_RayCast
 	bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void *UNUSED(data));
 	/// \see KX_RayCast
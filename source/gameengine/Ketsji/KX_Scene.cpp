@@ -48,6 +48,7 @@
 #include "SCA_2DFilterActuator.h"
 #include "SCA_PythonController.h"
 #include "KX_CollisionEventManager.h"
+#include "KX_RayEventManager.h"
 #include "SCA_KeyboardManager.h"
 #include "SCA_MouseManager.h"
 #include "SCA_ActuatorEventManager.h"
@@ -111,8 +112,13 @@
 #include "BLI_math.h"
 #include "BLI_task.h"
 
+#include "CM_JobSystem.h"
 #include "CM_Message.h"
 
+#include <algorithm>
+#include <climits>
+#include <cfloat>
+
 /**************************EEVEE INTEGRATION*****************************/
 extern "C" {
 #  include "BKE_camera.h"
@@ -177,6 +183,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 	m_blenderScene(scene),
 	m_isActivedHysteresis(false),
 	m_lodHysteresisValue(0),
+	m_lodReplaceBudget(0),
 	m_dofInitialized(false),
 	m_doingProbeUpdate(false),
 	m_doingTAA(false),
@@ -196,6 +203,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 
 	m_filterManager = new KX_2DFilterManager();
 	m_logicmgr = new SCA_LogicManager();
+	m_logicmgr->SetJobSystem(KX_GetActiveEngine()->GetJobSystem());
 	
 	m_timemgr = new SCA_TimeEventManager(m_logicmgr);
 	m_keyboardmgr = new SCA_KeyboardManager(m_logicmgr, inputDevice);
@@ -203,12 +211,14 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 	
 	SCA_ActuatorEventManager* actmgr = new SCA_ActuatorEventManager(m_logicmgr);
 	SCA_BasicEventManager* basicmgr = new SCA_BasicEventManager(m_logicmgr);
+	KX_RayEventManager* raymgr = new KX_RayEventManager(m_logicmgr);
 
 	m_logicmgr->RegisterEventManager(actmgr);
 	m_logicmgr->RegisterEventManager(m_keyboardmgr);
 	m_logicmgr->RegisterEventManager(m_mousemgr);
 	m_logicmgr->RegisterEventManager(m_timemgr);
 	m_logicmgr->RegisterEventManager(basicmgr);
+	m_logicmgr->RegisterEventManager(raymgr);
 
 	SCA_JoystickManager *joymgr = new SCA_JoystickManager(m_logicmgr);
 	m_logicmgr->RegisterEventManager(joymgr);
@@ -233,7 +243,9 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
 		m_obstacleSimulation = nullptr;
 	}
 
-	m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), &m_animationPoolData);
+	CM_JobSystem *jobSystem = KX_GetActiveEngine()->GetJobSystem();
+	m_animationPool = new CM_JobPool(jobSystem, CM_JobSystem::QUEUE_FRAME, &m_animationPoolData);
+	m_lodPool = new CM_JobPool(jobSystem, CM_JobSystem::QUEUE_FRAME);
 
 	/*************************************************EEVEE INTEGRATION***********************************************************/
 	InitEeveeData();
@@ -274,9 +286,8 @@ KX_Scene::~KX_Scene()
 	if (m_obstacleSimulation)
 		delete m_obstacleSimulation;
 
-	if (m_animationPool) {
-		BLI_task_pool_free(m_animationPool);
-	}
+	delete m_animationPool;
+	delete m_lodPool;
 
 	if (m_objectlist)
 		m_objectlist->Release();
@@ -1796,7 +1807,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
 
 
-void KX_Scene::ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys)
+void KX_Scene::ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys, bool update_shadows)
 {
 	if (!gameobj) {
 		CM_FunctionWarning("invalid object, doing nothing");
@@ -1817,9 +1828,14 @@ void KX_Scene::ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool us
 		gameobj->AddNewMaterialBatchesToPasses();
 
 		/* Shadow shgroups then */
-		gameobj->RemoveShadowShadingGroups();
-		gameobj->ReplaceShadowShadingGroups(meshShadowShgroups);
-		gameobj->AddNewShadowShadingGroupsToPasses();
+		if (update_shadows) {
+			gameobj->RemoveShadowShadingGroups();
+			gameobj->ReplaceShadowShadingGroups(meshShadowShgroups);
+			gameobj->AddNewShadowShadingGroupsToPasses();
+		}
+		else {
+			gameobj->ReplaceShadowShadingGroups(meshShadowShgroups);
+		}
 		/* End of EEVEE INTEGRATION */
 
 		gameobj->RemoveRasMeshObject();
@@ -1963,6 +1979,18 @@ void KX_Scene::ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool us
 	gameobj->UpdateBounds(true);
 }
 
+void KX_Scene::RebuildShadowPasses()
+{
+	EEVEE_PassList *psl = EEVEE_engine_data_get()->psl;
+	DRW_game_pass_free(psl->shadow_cube_pass);
+	DRW_game_pass_free(psl->shadow_cascade_pass);
+	for (KX_GameObject *gameobj : GetObjectList()) {
+		if (gameobj->GetCastShadows()) {
+			gameobj->AddNewShadowShadingGroupsToPasses();
+		}
+	}
+}
+
 
 KX_Camera* KX_Scene::GetActiveCamera()
 {
@@ -2217,6 +2245,8 @@ static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(t
 
 	gameobj = (KX_GameObject*)taskdata;
 
+	KX_TraceScope traceScope(KX_GetActiveEngine()->GetTraceRecorder(), "animation", "UpdateAnimation", gameobj->GetScene());
+
 	// Non-armature updates are fast enough, so just update them
 	needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
 
@@ -2276,10 +2306,10 @@ void KX_Scene::UpdateAnimations(double curtime)
 	m_animationPoolData.curtime = curtime;
 
 	for (KX_GameObject *gameobj : m_animatedlist) {
-		BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false, TASK_PRIORITY_LOW);
+		m_animationPool->Push(update_anim_thread_func, gameobj);
 	}
 
-	BLI_task_pool_work_and_wait(m_animationPool);
+	m_animationPool->WorkAndWait();
 }
 
 void KX_Scene::LogicUpdateFrame(double curtime)
@@ -2341,13 +2371,195 @@ RAS_MaterialBucket* KX_Scene::FindBucket(class RAS_IPolyMaterial* polymat, bool
 	return m_bucketmanager->FindBucket(polymat, bucketCreated);
 }
 
+struct LodTaskData
+{
+	const KX_CullingNodeList& m_nodes;
+	std::vector<KX_Scene::LodUpdate>& m_updates;
+	const MT_Vector3& m_camPos;
+	const float m_lodFactor;
+};
+
+/// Range of culling nodes computed by one LOD job.
+struct LodTaskRange
+{
+	const LodTaskData *m_data;
+	unsigned int m_start;
+	unsigned int m_end;
+};
+
+/// Minimum number of nodes computed by one LOD job.
+static const unsigned int LOD_TASK_SIZE = 256;
+
+static void update_lod_task_func(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	const LodTaskRange *range = (LodTaskRange *)taskdata;
+	const LodTaskData *data = range->m_data;
+
+	for (unsigned int i = range->m_start; i < range->m_end; ++i) {
+		KX_GameObject *gameobj = data->m_nodes[i]->GetObject();
+		KX_Scene::LodUpdate& update = data->m_updates[i];
+
+		float distance2;
+		update.m_gameobj = gameobj;
+		update.m_level = gameobj->ComputeLodLevel(data->m_camPos, data->m_lodFactor, distance2);
+
+		if (update.m_level) {
+			// Compare the bounding sphere radius with the distance to approximate the screen size.
+			const MT_Vector3& scale = gameobj->NodeGetWorldScaling();
+			const float radius = data->m_nodes[i]->GetAabb().GetRadius() *
+			                     std::max(MT_abs(scale.x()), std::max(MT_abs(scale.y()), MT_abs(scale.z())));
+			update.m_priority = (radius * radius) / std::max(distance2, FLT_EPSILON);
+		}
+	}
+}
+
 void KX_Scene::UpdateObjectLods(KX_Camera *cam, const KX_CullingNodeList& nodes)
 {
 	const MT_Vector3& cam_pos = cam->NodeGetWorldPosition();
 	const float lodfactor = cam->GetLodDistanceFactor();
+	const unsigned int size = nodes.size();
+
+	m_lodUpdates.resize(size);
+
+	LodTaskData data = {nodes, m_lodUpdates, cam_pos, lodfactor};
+
+	std::vector<LodTaskRange> ranges;
+	ranges.reserve(size / LOD_TASK_SIZE + 1);
+	for (unsigned int i = 0; i < size; i += LOD_TASK_SIZE) {
+		ranges.push_back({&data, i, std::min(i + LOD_TASK_SIZE, size)});
+	}
+
+	// Small lists are not worth waking up the workers.
+	if (ranges.size() == 1) {
+		update_lod_task_func(nullptr, &ranges.front(), 0);
+	}
+	else {
+		for (LodTaskRange& range : ranges) {
+			m_lodPool->Push(update_lod_task_func, &range);
+		}
+		m_lodPool->WorkAndWait();
+	}
+
+	// Level changes without mesh changes are free, the others are sorted by priority.
+	std::vector<LodUpdate>::iterator end = m_lodUpdates.begin();
+	for (const LodUpdate& update : m_lodUpdates) {
+		if (!update.m_level) {
+			continue;
+		}
+		if (update.m_gameobj->NeedLodMeshReplace(update.m_level)) {
+			*end++ = update;
+		}
+		else {
+			update.m_gameobj->SetLodLevel(update.m_level, false);
+		}
+	}
+
+	const unsigned int numupdates = end - m_lodUpdates.begin();
+	const unsigned int numreplaces = (m_lodReplaceBudget > 0) ? std::min(numupdates, (unsigned int)m_lodReplaceBudget) : numupdates;
+	if (numreplaces == 0) {
+		return;
+	}
+
+	/* Only the replaced objects are ordered, the postponed ones keep their previous level
+	 * and are evaluated again the next frame. */
+	std::partial_sort(m_lodUpdates.begin(), m_lodUpdates.begin() + numreplaces, end,
+		[](const LodUpdate& a, const LodUpdate& b) { return a.m_priority > b.m_priority; });
+
+	// The mesh replacements share the same shadow passes rebuild.
+	for (unsigned int i = 0; i < numreplaces; ++i) {
+		const LodUpdate& update = m_lodUpdates[i];
+		update.m_gameobj->SetLodLevel(update.m_level, false);
+	}
+	RebuildShadowPasses();
+}
+
+unsigned int KX_Scene::GetTransformSize(TransformType type)
+{
+	static const unsigned int sizes[] = {3, 4, 16};
+	return sizes[type];
+}
 
-	for (KX_CullingNode *node : nodes) {
-		node->GetObject()->UpdateLod(cam_pos, lodfactor);
+void KX_Scene::GetTransforms(const std::vector<KX_GameObject *>& objects, TransformType type, float *data) const
+{
+	switch (type) {
+		case TRANSFORM_POSITION:
+		{
+			for (KX_GameObject *gameobj : objects) {
+				gameobj->NodeGetWorldPosition().getValue(data);
+				data += 3;
+			}
+			break;
+		}
+		case TRANSFORM_ORIENTATION:
+		{
+			for (KX_GameObject *gameobj : objects) {
+				const MT_Quaternion quat = gameobj->NodeGetWorldOrientation().getRotation();
+				// Same order as mathutils.
+				data[0] = quat.w();
+				data[1] = quat.x();
+				data[2] = quat.y();
+				data[3] = quat.z();
+				data += 4;
+			}
+			break;
+		}
+		case TRANSFORM_MATRIX:
+		{
+			for (KX_GameObject *gameobj : objects) {
+				const MT_Matrix4x4 mat(gameobj->NodeGetWorldTransform());
+				for (unsigned short i = 0; i < 4; ++i) {
+					for (unsigned short j = 0; j < 4; ++j) {
+						data[i * 4 + j] = mat[i][j];
+					}
+				}
+				data += 16;
+			}
+			break;
+		}
+	}
+}
+
+void KX_Scene::SetTransforms(const std::vector<KX_GameObject *>& objects, TransformType type, const float *data)
+{
+	for (KX_GameObject *gameobj : objects) {
+		switch (type) {
+			case TRANSFORM_POSITION:
+			{
+				gameobj->NodeSetWorldPosition(MT_Vector3(data));
+				break;
+			}
+			case TRANSFORM_ORIENTATION:
+			{
+				// Same order as mathutils, the quaternion doesn't need to be normalized.
+				const MT_Quaternion quat(data[1], data[2], data[3], data[0]);
+				gameobj->NodeSetGlobalOrientation(MT_Matrix3x3(quat));
+				break;
+			}
+			case TRANSFORM_MATRIX:
+			{
+				float transform[4][4];
+				float loc[3], rot[3][3], size[3];
+				// Row major data to column major Blender matrix.
+				for (unsigned short i = 0; i < 4; ++i) {
+					for (unsigned short j = 0; j < 4; ++j) {
+						transform[j][i] = data[i * 4 + j];
+					}
+				}
+				mat4_to_loc_rot_size(loc, rot, size, transform);
+
+				MT_Matrix3x3 orientation;
+				orientation.setValue3x3(*rot);
+
+				gameobj->NodeSetWorldPosition(MT_Vector3(loc));
+				gameobj->NodeSetGlobalOrientation(orientation);
+				gameobj->NodeSetWorldScale(MT_Vector3(size));
+				break;
+			}
+		}
+
+		// Update the node and its children once for all the transform components.
+		gameobj->NodeUpdateGS(0.0f);
+		data += GetTransformSize(type);
 	}
 }
 
@@ -2371,6 +2583,16 @@ int KX_Scene::GetLodHysteresisValue(void)
 	return m_lodHysteresisValue;
 }
 
+void KX_Scene::SetLodReplaceBudget(int budget)
+{
+	m_lodReplaceBudget = budget;
+}
+
+int KX_Scene::GetLodReplaceBudget() const
+{
+	return m_lodReplaceBudget;
+}
+
 void KX_Scene::UpdateObjectActivity(void) 
 {
 	if (m_activity_culling) {
@@ -2717,6 +2939,10 @@ PyMethodDef KX_Scene::Methods[] = {
 	KX_PYMETHODTABLE(KX_Scene, suspend),
 	KX_PYMETHODTABLE(KX_Scene, resume),
 	KX_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
+	KX_PYMETHODTABLE(KX_Scene, getLogicProfileInfo),
+	KX_PYMETHODTABLE(KX_Scene, resetLogicProfile),
+	KX_PYMETHODTABLE(KX_Scene, getTransforms),
+	KX_PYMETHODTABLE(KX_Scene, setTransforms),
 
 	
 	/* dict style access */
@@ -2997,6 +3223,46 @@ int KX_Scene::pyattr_set_gravity(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF
 	return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_parallel_sensors(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef)
+{
+	KX_Scene* self = static_cast<KX_Scene*>(self_v);
+	return PyBool_FromLong(self->GetLogicManager()->GetParallelSensors());
+}
+
+int KX_Scene::pyattr_set_parallel_sensors(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value)
+{
+	KX_Scene* self = static_cast<KX_Scene*>(self_v);
+
+	int param = PyObject_IsTrue(value);
+	if (param == -1) {
+		PyErr_SetString(PyExc_AttributeError, "scene.parallelSensors = bool: KX_Scene, expected True or False");
+		return PY_SET_ATTR_FAIL;
+	}
+
+	self->GetLogicManager()->SetParallelSensors(param);
+	return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *KX_Scene::pyattr_get_logic_profiling(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef)
+{
+	KX_Scene* self = static_cast<KX_Scene*>(self_v);
+	return PyBool_FromLong(self->GetLogicManager()->GetProfiler().GetEnabled());
+}
+
+int KX_Scene::pyattr_set_logic_profiling(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value)
+{
+	KX_Scene* self = static_cast<KX_Scene*>(self_v);
+
+	int param = PyObject_IsTrue(value);
+	if (param == -1) {
+		PyErr_SetString(PyExc_AttributeError, "scene.logicProfiling = bool: KX_Scene, expected True or False");
+		return PY_SET_ATTR_FAIL;
+	}
+
+	self->GetLogicManager()->GetProfiler().SetEnabled(param);
+	return PY_SET_ATTR_SUCCESS;
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
 	KX_PYATTRIBUTE_RO_FUNCTION("name",				KX_Scene, pyattr_get_name),
 	KX_PYATTRIBUTE_RO_FUNCTION("objects",			KX_Scene, pyattr_get_objects),
@@ -3016,6 +3282,9 @@ PyAttributeDef KX_Scene::Attributes[] = {
 	KX_PYATTRIBUTE_BOOL_RO("activity_culling",		KX_Scene, m_activity_culling),
 	KX_PYATTRIBUTE_FLOAT_RW("activity_culling_radius", 0.5f, FLT_MAX, KX_Scene, m_activity_box_radius),
 	KX_PYATTRIBUTE_BOOL_RO("dbvt_culling",			KX_Scene, m_dbvt_culling),
+	KX_PYATTRIBUTE_INT_RW("lodReplaceBudget", 0, INT_MAX, true, KX_Scene, m_lodReplaceBudget),
+	KX_PYATTRIBUTE_RW_FUNCTION("parallelSensors",	KX_Scene, pyattr_get_parallel_sensors, pyattr_set_parallel_sensors),
+	KX_PYATTRIBUTE_RW_FUNCTION("logicProfiling",	KX_Scene, pyattr_get_logic_profiling, pyattr_set_logic_profiling),
 	KX_PYATTRIBUTE_NULL	//Sentinel
 };
 
@@ -3110,6 +3379,142 @@ KX_PYMETHODDEF_DOC(KX_Scene, drawObstacleSimulation,
 	Py_RETURN_NONE;
 }
 
+KX_PYMETHODDEF_DOC(KX_Scene, getLogicProfileInfo,
+				   "getLogicProfileInfo()\n"
+				   "Returns a dictionary with the time spent in each logic brick.\n")
+{
+	return m_logicmgr->GetProfiler().GetPyProfileDict();
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene, resetLogicProfile,
+				   "resetLogicProfile()\n"
+				   "Clears the logic bricks profile.\n")
+{
+	m_logicmgr->GetProfiler().Reset();
+
+	Py_RETURN_NONE;
+}
+
+/** Parse the arguments of getTransforms and setTransforms.
+ * On success the buffer must be released with PyBuffer_Release.
+ */
+static bool convert_python_transforms_args(SCA_LogicManager *logicmgr, PyObject *args, bool writable, const char *errorPrefix,
+										   std::vector<KX_GameObject *>& objects, KX_Scene::TransformType& type, Py_buffer& view)
+{
+	static const char *typeNames[] = {"position", "orientation", "matrix"};
+
+	PyObject *pyobjects;
+	PyObject *pybuffer;
+	const char *typeName = typeNames[KX_Scene::TRANSFORM_POSITION];
+
+	if (!PyArg_ParseTuple(args, "OO|s", &pyobjects, &pybuffer, &typeName)) {
+		return false;
+	}
+
+	unsigned short i;
+	for (i = 0; i < ARRAY_SIZE(typeNames); ++i) {
+		if (STREQ(typeName, typeNames[i])) {
+			type = (KX_Scene::TransformType)i;
+			break;
+		}
+	}
+	if (i == ARRAY_SIZE(typeNames)) {
+		PyErr_Format(PyExc_ValueError, "%s, type must be \"position\", \"orientation\" or \"matrix\"", errorPrefix);
+		return false;
+	}
+
+	PyObject *fast = PySequence_Fast(pyobjects, errorPrefix);
+	if (!fast) {
+		return false;
+	}
+
+	const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+	PyObject **items = PySequence_Fast_ITEMS(fast);
+	objects.resize(size);
+	for (Py_ssize_t j = 0; j < size; ++j) {
+		if (!ConvertPythonToGameObject(logicmgr, items[j], &objects[j], false, errorPrefix)) {
+			Py_DECREF(fast);
+			return false;
+		}
+	}
+	Py_DECREF(fast);
+
+	const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+	if (PyObject_GetBuffer(pybuffer, &view, flags) == -1) {
+		return false;
+	}
+
+	if (view.itemsize != sizeof(float) || !view.format || !STREQ(view.format, "f")) {
+		PyErr_Format(PyExc_TypeError, "%s, buffer must contain 32 bits floats", errorPrefix);
+		PyBuffer_Release(&view);
+		return false;
+	}
+
+	const Py_ssize_t expected = size * KX_Scene::GetTransformSize(type);
+	if (view.len / view.itemsize < expected) {
+		PyErr_Format(PyExc_ValueError, "%s, buffer is too small, expected at least %zd floats, got %zd",
+					 errorPrefix, expected, view.len / view.itemsize);
+		PyBuffer_Release(&view);
+		return false;
+	}
+
+	return true;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene, getTransforms,
+				   "getTransforms(objects, buffer, type=\"position\")\n"
+				   "Copies the world transform of the objects in a float buffer.\n")
+{
+	std::vector<KX_GameObject *> objects;
+	TransformType type;
+	Py_buffer view;
+
+	if (!convert_python_transforms_args(m_logicmgr, args, true, "scene.getTransforms(objects, buffer, type): KX_Scene",
+										objects, type, view))
+	{
+		return nullptr;
+	}
+
+	GetTransforms(objects, type, (float *)view.buf);
+	PyBuffer_Release(&view);
+
+	Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene, setTransforms,
+				   "setTransforms(objects, buffer, type=\"position\")\n"
+				   "Sets the world transform of the objects from a float buffer.\n")
+{
+	std::vector<KX_GameObject *> objects;
+	TransformType type;
+	Py_buffer view;
+
+	if (!convert_python_transforms_args(m_logicmgr, args, false, "scene.setTransforms(objects, buffer, type): KX_Scene",
+										objects, type, view))
+	{
+		return nullptr;
+	}
+
+	const float *data = (const float *)view.buf;
+	if (type == TRANSFORM_ORIENTATION) {
+		// Check all the quaternions first to not leave the objects half updated.
+		for (unsigned int i = 0, size = objects.size(); i < size; ++i) {
+			const float *quat = &data[i * 4];
+			if (MT_fuzzyZero2(quat[0] * quat[0] + quat[1] * quat[1] + quat[2] * quat[2] + quat[3] * quat[3])) {
+				PyErr_Format(PyExc_ValueError, "scene.setTransforms(objects, buffer, type): KX_Scene, "
+							 "null quaternion at index %u", i);
+				PyBuffer_Release(&view);
+				return nullptr;
+			}
+		}
+	}
+
+	SetTransforms(objects, type, data);
+	PyBuffer_Release(&view);
+
+	Py_RETURN_NONE;
+}
+
 /* Matches python dict.get(key, [default]) */
 KX_PYMETHODDEF_DOC(KX_Scene, get, "")
 {
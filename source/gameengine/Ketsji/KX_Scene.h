@@ -77,6 +77,7 @@ class KX_Camera;
 class KX_FontObject;
 class KX_GameObject;
 class KX_LightObject;
+class KX_LodLevel;
 class RAS_MeshObject;
 class RAS_BoundingBoxManager;
 class RAS_BucketManager;
@@ -93,7 +94,7 @@ class btCollisionShape;
 class KX_BlenderSceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
-struct TaskPool;
+class CM_JobPool;
 
 /*********EEVEE INTEGRATION************/
 struct DRWPass;
@@ -123,6 +124,26 @@ public:
 		double curtime;
 	};
 
+	/// Lod level change computed by UpdateObjectLods.
+	struct LodUpdate
+	{
+		KX_GameObject *m_gameobj;
+		/// The new lod level, nullptr if unchanged.
+		KX_LodLevel *m_level;
+		/// Approximated projected size of the object, biggest objects replace their mesh first.
+		float m_priority;
+	};
+
+	/// World transform component read or written by GetTransforms and SetTransforms.
+	enum TransformType {
+		/// 3 floats per object: x, y, z.
+		TRANSFORM_POSITION = 0,
+		/// 4 floats per object: quaternion w, x, y, z.
+		TRANSFORM_ORIENTATION,
+		/// 16 floats per object: 4x4 matrix, row major.
+		TRANSFORM_MATRIX
+	};
+
 private:
 	Py_Header
 
@@ -286,12 +307,18 @@ protected:
 	KX_ObstacleSimulation* m_obstacleSimulation;
 
 	AnimationPoolData m_animationPoolData;
-	TaskPool *m_animationPool;
+	CM_JobPool *m_animationPool;
+	CM_JobPool *m_lodPool;
 
 	/* LOD Hysteresis settings */
 	bool m_isActivedHysteresis;
 	int m_lodHysteresisValue;
 
+	/// Lod updates of the culled objects, reused every frame.
+	std::vector<LodUpdate> m_lodUpdates;
+	/// Maximum number of lod mesh replacements per frame, 0 for no limit.
+	int m_lodReplaceBudget;
+
 public:
 	KX_Scene(SCA_IInputDevice *inputDevice,
 		const std::string& scenename,
@@ -353,7 +380,12 @@ public:
 	void DelayedRemoveObject(KX_GameObject *gameobj);
 
 	bool NewRemoveObject(KX_GameObject *gameobj);
-	void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
+	/** Replace the mesh of an object.
+	 * \param update_shadows False to skip the shadow passes rebuild, the caller must then call RebuildShadowPasses.
+	 */
+	void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys, bool update_shadows = true);
+	/// Recreate the shadow passes from all the shadow casting objects.
+	void RebuildShadowPasses();
 
 	void AddAnimatedObject(KX_GameObject *gameobj);
 
@@ -445,14 +477,26 @@ public:
 	/* Resume a suspended scene */
 	void Resume();
 
-	/* Update the mesh for objects based on level of detail settings */
+	/** Update the mesh for objects based on level of detail settings.
+	 * The levels are computed in parallel, the mesh replacements are limited by the lod
+	 * replace budget and the remaining ones are postponed to the next frames.
+	 */
 	void UpdateObjectLods(KX_Camera *cam, const KX_CullingNodeList& nodes);
 
+	/// Return the number of floats per object of a transform type.
+	static unsigned int GetTransformSize(TransformType type);
+	/// Copy the world transform of the objects in data, data must hold GetTransformSize(type) floats per object.
+	void GetTransforms(const std::vector<KX_GameObject *>& objects, TransformType type, float *data) const;
+	/// Set the world transform of the objects from data and update each node once.
+	void SetTransforms(const std::vector<KX_GameObject *>& objects, TransformType type, const float *data);
+
 	/* LoD Hysteresis functions */
 	void SetLodHysteresis(bool active);
 	bool IsActivedLodHysteresis();
 	void SetLodHysteresisValue(int hysteresisvalue);
 	int GetLodHysteresisValue();
+	void SetLodReplaceBudget(int budget);
+	int GetLodReplaceBudget() const;
 	
 	/* Update the activity box settings for objects in this scene, if needed */
 	void UpdateObjectActivity(void);
@@ -536,6 +580,10 @@ public:
 	KX_PYMETHOD_DOC(KX_Scene, resume);
 	KX_PYMETHOD_DOC(KX_Scene, get);
 	KX_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
+	KX_PYMETHOD_DOC(KX_Scene, getLogicProfileInfo);
+	KX_PYMETHOD_DOC(KX_Scene, resetLogicProfile);
+	KX_PYMETHOD_DOC(KX_Scene, getTransforms);
+	KX_PYMETHOD_DOC(KX_Scene, setTransforms);
 
 
 	/* attributes */
@@ -555,6 +603,10 @@ public:
 	static int			pyattr_set_drawing_callback(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value);
 	static PyObject*	pyattr_get_gravity(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
 	static int			pyattr_set_gravity(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value);
+	static PyObject*	pyattr_get_parallel_sensors(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+	static int			pyattr_set_parallel_sensors(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value);
+	static PyObject*	pyattr_get_logic_profiling(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+	static int			pyattr_set_logic_profiling(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value);
 
 	virtual PyObject *py_repr(void) { return PyUnicode_FromStdString(GetName()); }
 	
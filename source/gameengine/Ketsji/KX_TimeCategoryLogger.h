@@ -116,6 +116,11 @@ public:
 	 */
 	double GetAverage();
 
+	/**
+	 * Returns the last complete measurement of the given category.
+	 */
+	double GetLast(TimeCategory tc);
+
 protected:
 	/// Storage for the loggers.
 	TimeLoggerMap m_loggers;
@@ -89,6 +89,12 @@ public:
 	 */
 	double GetAverage() const;
 
+	/**
+	 * Returns the last complete measurement.
+	 * \return The measurement preceding the current one, zero if there is none.
+	 */
+	double GetLast() const;
+
 protected:
 	/// Storage for the measurements.
 	std::deque<double> m_measurements;
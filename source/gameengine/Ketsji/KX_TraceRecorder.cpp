@@ -0,0 +1,141 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file gameengine/Ketsji/KX_TraceRecorder.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_TraceRecorder.h"
+#include "KX_Scene.h"
+
+#include "BLI_string.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+KX_TraceRecorder::KX_TraceRecorder(unsigned int capacity)
+	:m_enabled(false),
+	m_count(0),
+	m_frame(0),
+	m_capacity(capacity),
+	m_startTime(Clock::now())
+{
+}
+
+KX_TraceRecorder::~KX_TraceRecorder()
+{
+}
+
+unsigned int KX_TraceRecorder::GetThreadId()
+{
+	static std::atomic<unsigned int> threadCount(0);
+	static thread_local const unsigned int threadId = threadCount++;
+	return threadId;
+}
+
+void KX_TraceRecorder::SetEnabled(bool enabled)
+{
+	if (enabled && m_events.empty()) {
+		m_events.resize(m_capacity);
+	}
+	m_enabled = enabled;
+}
+
+void KX_TraceRecorder::NextFrame()
+{
+	++m_frame;
+}
+
+void KX_TraceRecorder::Clear()
+{
+	m_count = 0;
+}
+
+void KX_TraceRecorder::AddEvent(const char *name, const char *category, KX_Scene *scene, const Clock::time_point& start)
+{
+	const Clock::time_point end = Clock::now();
+	// Each thread owns the slot it reserved.
+	Event& event = m_events[(m_count++) % m_capacity];
+
+	event.m_name = name;
+	event.m_category = category;
+	if (scene) {
+		BLI_strncpy(event.m_scene, scene->GetName().c_str(), SCENE_NAME_SIZE);
+	}
+	else {
+		event.m_scene[0] = '\0';
+	}
+	event.m_thread = GetThreadId();
+	event.m_frame = m_frame;
+	event.m_start = std::chrono::duration<double, std::micro>(start - m_startTime).count();
+	event.m_duration = std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static void write_json_string(std::ostream& stream, const char *str)
+{
+	stream << '"';
+	for (const char *c = str; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			stream << '\\' << *c;
+		}
+		else if ((unsigned char)*c < 0x20) {
+			stream << ' ';
+		}
+		else {
+			stream << *c;
+		}
+	}
+	stream << '"';
+}
+
+bool KX_TraceRecorder::WriteChromeTrace(const std::string& filepath) const
+{
+	std::ofstream file(filepath);
+	if (!file) {
+		return false;
+	}
+
+	const unsigned int count = m_count;
+	const unsigned int size = std::min(count, m_capacity);
+	// Oldest event first.
+	const unsigned int first = count - size;
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	for (unsigned int i = 0; i < size; ++i) {
+		const Event& event = m_events[(first + i) % m_capacity];
+		file << ((i == 0) ? "\n" : ",\n") << "{\"name\": ";
+		write_json_string(file, event.m_name);
+		file << ", \"cat\": ";
+		write_json_string(file, event.m_category);
+		file << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.m_thread
+		     << ", \"ts\": " << event.m_start << ", \"dur\": " << event.m_duration
+		     << ", \"args\": {\"frame\": " << event.m_frame << ", \"scene\": ";
+		write_json_string(file, event.m_scene);
+		file << "}}";
+	}
+	file << "\n]}\n";
+
+	return true;
+}
@@ -0,0 +1,131 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file KX_TraceRecorder.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_TRACERECORDER_H__
+#define __KX_TRACERECORDER_H__
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+class KX_Scene;
+
+/** Records timed scopes of the engine stages in a ring buffer, the oldest events are
+ * overwritten when the buffer is full. Events can be added from any thread and are
+ * exported in the Chrome trace event format (chrome://tracing).
+ * The recorder is disabled by default and only costs a boolean test per scope.
+ */
+class KX_TraceRecorder
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	enum {
+		SCENE_NAME_SIZE = 64
+	};
+
+	struct Event
+	{
+		/// Static strings describing the scope.
+		const char *m_name;
+		const char *m_category;
+		char m_scene[SCENE_NAME_SIZE];
+		unsigned int m_thread;
+		unsigned int m_frame;
+		/// Start time and duration in microseconds.
+		double m_start;
+		double m_duration;
+	};
+
+private:
+	std::atomic<bool> m_enabled;
+	std::vector<Event> m_events;
+	/// Total number of recorded events, the next event index is m_count modulo the capacity.
+	std::atomic<unsigned int> m_count;
+	std::atomic<unsigned int> m_frame;
+	unsigned int m_capacity;
+	Clock::time_point m_startTime;
+
+	/// Return a small id for the calling thread.
+	static unsigned int GetThreadId();
+
+public:
+	KX_TraceRecorder(unsigned int capacity = 65536);
+	~KX_TraceRecorder();
+
+	inline bool GetEnabled() const
+	{
+		return m_enabled;
+	}
+	/// Enable the recording, the buffer is allocated the first time.
+	void SetEnabled(bool enabled);
+
+	/// Increase the frame number stored in the events.
+	void NextFrame();
+	/// Discard all the recorded events.
+	void Clear();
+
+	void AddEvent(const char *name, const char *category, KX_Scene *scene, const Clock::time_point& start);
+
+	/// Write the recorded events as Chrome trace JSON, return false if the file can't be written.
+	bool WriteChromeTrace(const std::string& filepath) const;
+};
+
+/// Records an event in the trace recorder for the life time of the object.
+class KX_TraceScope
+{
+private:
+	KX_TraceRecorder& m_recorder;
+	const char *m_name;
+	const char *m_category;
+	KX_Scene *m_scene;
+	bool m_enabled;
+	KX_TraceRecorder::Clock::time_point m_start;
+
+public:
+	inline KX_TraceScope(KX_TraceRecorder& recorder, const char *category, const char *name, KX_Scene *scene = nullptr)
+		:m_recorder(recorder),
+		m_name(name),
+		m_category(category),
+		m_scene(scene),
+		m_enabled(recorder.GetEnabled())
+	{
+		if (m_enabled) {
+			m_start = KX_TraceRecorder::Clock::now();
+		}
+	}
+
+	inline ~KX_TraceScope()
+	{
+		if (m_enabled) {
+			m_recorder.AddEvent(m_name, m_category, m_scene, m_start);
+		}
+	}
+};
+
+#endif  // __KX_TRACERECORDER_H__
@@ -59,6 +59,7 @@
 
 #include "DEV_Joystick.h"
 
+#include "CM_JobSystem.h"
 #include "CM_Message.h"
 
 extern "C" {
@@ -91,8 +92,10 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system, Main *maggie, Scene *scene, Glob
 	m_maggie(maggie),
 	m_kxStartScene(nullptr),
 	m_exitRequested(KX_ExitRequest::NO_REQUEST),
+	m_initError(false),
 	m_globalSettings(gs),
 	m_system(system),
+	m_jobSystem(nullptr),
 	m_ketsjiEngine(nullptr),
 	m_kxsystem(nullptr), 
 	m_inputDevice(nullptr),
@@ -105,6 +108,10 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system, Main *maggie, Scene *scene, Glob
 	m_gameLogic(nullptr),
 #endif  // WITH_PYTHON
 	m_samples(samples),
+	m_headless(false),
+	m_fixedStep(false),
+	m_maxFrames(0),
+	m_frameCount(0),
 	m_argc(argc),
 	m_argv(argv)
 {
@@ -137,6 +144,11 @@ const std::string& LA_Launcher::GetExitString()
 	return m_exitString;
 }
 
+bool LA_Launcher::GetInitError() const
+{
+	return m_initError;
+}
+
 void LA_Launcher::InitEngine()
 {
 	// Get and set the preferences.
@@ -154,14 +166,29 @@ void LA_Launcher::InitEngine()
 	bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
 	bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
 	bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+	// Number of threads including the main thread, 0 for all the cores.
+	int jobThreads = SYS_GetCommandLineInt(syshandle, "job_threads", 0);
+	// Benchmarking options, the headless mode and the input record or replay use a fixed time step by default.
+	m_headless = (SYS_GetCommandLineInt(syshandle, "headless", 0) != 0);
+	m_inputRecordFile = SYS_GetCommandLineString(syshandle, "input_record", "");
+	const std::string inputReplayFile = SYS_GetCommandLineString(syshandle, "input_replay", "");
+	const bool inputRecording = !m_inputRecordFile.empty() || !inputReplayFile.empty();
+	m_fixedStep = (SYS_GetCommandLineInt(syshandle, "fixed_step", m_headless || inputRecording) != 0);
+	m_maxFrames = SYS_GetCommandLineInt(syshandle, "max_frames", 0);
+	m_frameCount = 0;
 
 	const KX_KetsjiEngine::FlagType flags = (KX_KetsjiEngine::FlagType)
 		((fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
+		(m_fixedStep ? KX_KetsjiEngine::USE_EXTERNAL_CLOCK : 0) |
+		(m_headless ? KX_KetsjiEngine::HEADLESS : 0) |
 		(frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
 		(restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
 		(properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
 		(profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
 
+	// Create the worker threads first, they are used by the canvas, engine and converter.
+	m_jobSystem = new CM_JobSystem(jobThreads);
+
 	m_rasterizer = new RAS_Rasterizer();
 
 	// Copy current anisotropic level to restore it at the game end.
@@ -171,6 +198,7 @@ void LA_Launcher::InitEngine()
 
 	// Create the canvas, rasterizer and rendertools.
 	m_canvas = CreateCanvas();
+	m_canvas->SetJobSystem(m_jobSystem);
 
 	// Copy current vsync mode to restore at the game end.
 	m_canvas->GetSwapInterval(m_savedData.vsync);
@@ -196,6 +224,19 @@ void LA_Launcher::InitEngine()
 
 	// Create the inputdevices.
 	m_inputDevice = new DEV_InputDevice();
+	m_initError = false;
+	if (!inputReplayFile.empty()) {
+		/* Running on live input would not reproduce the recorded session,
+		 * and a benchmark without max_frames would never end. */
+		if (!m_inputDevice->GetRecorder().StartReplay(inputReplayFile)) {
+			CM_Error("can't replay the input record " << inputReplayFile << ", exiting");
+			m_initError = true;
+			m_exitRequested = KX_ExitRequest::QUIT_GAME;
+		}
+	}
+	else if (!m_inputRecordFile.empty()) {
+		m_inputDevice->GetRecorder().StartRecording();
+	}
 	m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
 	m_system->addEventConsumer(m_eventConsumer);
 
@@ -205,7 +246,7 @@ void LA_Launcher::InitEngine()
 	m_networkMessageManager = new KX_NetworkMessageManager();
 	
 	// Create the ketsjiengine.
-	m_ketsjiEngine = new KX_KetsjiEngine(m_kxsystem);
+	m_ketsjiEngine = new KX_KetsjiEngine(m_kxsystem, m_jobSystem);
 	KX_SetActiveEngine(m_ketsjiEngine);
 
 	// Set the devices.
@@ -215,6 +256,8 @@ void LA_Launcher::InitEngine()
 	m_ketsjiEngine->SetNetworkMessageManager(m_networkMessageManager);
 
 	DEV_Joystick::Init();
+	// The joystick states are recorded and replayed with the other input events.
+	DEV_Joystick::SetRecorder(&m_inputDevice->GetRecorder());
 
 	m_ketsjiEngine->SetExitKey(ConvertKeyCode(gm.exitkey));
 #ifdef WITH_PYTHON
@@ -230,6 +273,16 @@ void LA_Launcher::InitEngine()
 	m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
 	m_ketsjiEngine->SetMaxPhysicsFrame(gm.maxphystep);
 
+	const char *traceFile = SYS_GetCommandLineString(syshandle, "trace_file", "");
+	if (traceFile[0]) {
+		m_ketsjiEngine->SetTraceFile(traceFile);
+	}
+
+	const char *profileFile = SYS_GetCommandLineString(syshandle, "profile_file", "");
+	if (profileFile[0]) {
+		m_ketsjiEngine->SetFrameProfileFile(profileFile);
+	}
+
 	// Set the global settings (carried over if restart/load new files).
 	m_ketsjiEngine->SetGlobalSettings(m_globalSettings);
 
@@ -287,6 +340,7 @@ void LA_Launcher::ExitEngine()
 #endif  // WITH_PYTHON
 
 	DEV_Joystick::Close();
+	DEV_Joystick::SetRecorder(nullptr);
 	m_ketsjiEngine->StopEngine();
 
 #ifdef WITH_PYTHON
@@ -330,6 +384,9 @@ void LA_Launcher::ExitEngine()
 		m_kxsystem = nullptr;
 	}
 	if (m_inputDevice) {
+		if (!m_inputRecordFile.empty()) {
+			m_inputDevice->GetRecorder().WriteRecord(m_inputRecordFile);
+		}
 		delete m_inputDevice;
 		m_inputDevice = nullptr;
 	}
@@ -345,6 +402,10 @@ void LA_Launcher::ExitEngine()
 		delete m_canvas;
 		m_canvas = nullptr;
 	}
+	if (m_jobSystem) {
+		delete m_jobSystem;
+		m_jobSystem = nullptr;
+	}
 	if (m_networkMessageManager) {
 		delete m_networkMessageManager;
 		m_networkMessageManager = nullptr;
@@ -454,6 +515,12 @@ bool LA_Launcher::EngineNextFrame()
 		HandlePythonConsole();
 #endif
 
+		if (m_fixedStep) {
+			// Proceed exactly one logic frame.
+			m_ketsjiEngine->SetClockTime(m_ketsjiEngine->GetClockTime() +
+				m_ketsjiEngine->GetTimeScale() / m_ketsjiEngine->GetTicRate());
+		}
+
 		// Kick the engine.
 		bool renderFrame = m_ketsjiEngine->NextFrame();
 		if (renderFrame) {
@@ -462,6 +529,8 @@ bool LA_Launcher::EngineNextFrame()
 
 		m_system->processEvents(false);
 		m_system->dispatchEvents();
+		// Replay the recorded events in place of the live events.
+		m_inputDevice->NextFrame();
 
 		if (m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_ketsjiEngine->GetExitKey()).Find(SCA_InputEvent::ACTIVE) &&
 			!m_inputDevice->GetHookExitKey())
@@ -476,6 +545,13 @@ bool LA_Launcher::EngineNextFrame()
 			m_inputDevice->ConvertEvent(SCA_IInputDevice::WINQUIT, 0, 0);
 			m_exitRequested = KX_ExitRequest::OUTSIDE;
 		}
+
+		if (m_maxFrames > 0 && ++m_frameCount >= m_maxFrames && m_exitRequested == KX_ExitRequest::NO_REQUEST) {
+			m_exitRequested = KX_ExitRequest::QUIT_GAME;
+		}
+		if (m_inputDevice->GetRecorder().IsReplayFinished() && m_exitRequested == KX_ExitRequest::NO_REQUEST) {
+			m_exitRequested = KX_ExitRequest::QUIT_GAME;
+		}
 	}
 	m_exitString = m_ketsjiEngine->GetExitString();
 
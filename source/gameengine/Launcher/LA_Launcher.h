@@ -40,6 +40,7 @@ class KX_Scene;
 class KX_ISystem;
 class KX_BlenderConverter;
 class KX_NetworkMessageManager;
+class CM_JobSystem;
 class RAS_ICanvas;
 class DEV_EventConsumer;
 class DEV_InputDevice;
@@ -59,11 +60,15 @@ protected:
 	/// \section Exit state.
 	KX_ExitRequest m_exitRequested;
 	std::string m_exitString;
+	/// The engine could not be initialized as requested, the game exits at the first frame.
+	bool m_initError;
 	GlobalSettings *m_globalSettings;
 
 	/// GHOST system abstraction.
 	GHOST_ISystem *m_system;
 
+	/// Worker threads shared by the engine, canvas and converter.
+	CM_JobSystem *m_jobSystem;
 	/// The gameengine itself.
 	KX_KetsjiEngine* m_ketsjiEngine;
 	/// The game engine's system abstraction.
@@ -88,6 +93,17 @@ protected:
 	/// The number of render samples.
 	int m_samples;
 
+	/// Skip the drawing, only the culling and animations of the render are proceeded.
+	bool m_headless;
+	/// Advance the engine clock of one logic step per frame whatever the real time spent.
+	bool m_fixedStep;
+	/// Number of frames before exiting, 0 for no limit.
+	int m_maxFrames;
+	/// Number of frames proceeded since the engine initialization.
+	int m_frameCount;
+	/// File receiving the recorded input events at exit, empty when not recording.
+	std::string m_inputRecordFile;
+
 	/// argc and argv need to be passed on to python
 	int m_argc;
 	char **m_argv;
@@ -140,6 +156,8 @@ public:
 
 	KX_ExitRequest GetExitRequested();
 	const std::string& GetExitString();
+	/// Return true when the initialization failed, like for an invalid input replay file.
+	bool GetInitError() const;
 	GlobalSettings *GetGlobalSettings();
 
 	inline KX_Scene *GetStartScene() const
@@ -44,11 +44,14 @@ extern "C" {
 #  include "BLI_fileops.h"
 
 #  include "MEM_guardedalloc.h"
+
+#  include "DNA_scene_types.h"
 }
 
 #include "KX_PythonInit.h"
 
 #include "GPG_Canvas.h" 
+#include "GPG_NullCanvas.h"
 
 #include "GHOST_ISystem.h"
 
@@ -135,7 +138,7 @@ void LA_PlayerLauncher::ExitEngine()
 
 bool LA_PlayerLauncher::EngineNextFrame()
 {
-	if (m_inputDevice->GetInput(SCA_IInputDevice::WINRESIZE).Find(SCA_InputEvent::ACTIVE)) {
+	if (!m_headless && m_inputDevice->GetInput(SCA_IInputDevice::WINRESIZE).Find(SCA_InputEvent::ACTIVE)) {
 		GHOST_Rect bnds;
 		m_mainWindow->getClientBounds(bnds);
 		m_canvas->Resize(bnds.getWidth(), bnds.getHeight());
@@ -148,5 +151,10 @@ bool LA_PlayerLauncher::EngineNextFrame()
 
 RAS_ICanvas *LA_PlayerLauncher::CreateCanvas()
 {
+	if (m_headless) {
+		// Nothing is drawn, the canvas only keeps the size of the game for the cameras.
+		return (new GPG_NullCanvas(m_rasterizer, m_startScene->gm.xplay, m_startScene->gm.yplay));
+	}
+
 	return (new GPG_Canvas(m_rasterizer, m_mainWindow));
 }
@@ -35,6 +35,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "CM_JobSystem.h"
+
 #include "KX_KetsjiEngine.h"
 
 extern "C" {
@@ -68,24 +70,27 @@ void save_screenshot_thread_func(TaskPool *__restrict pool, void *taskdata, int
 RAS_ICanvas::RAS_ICanvas(RAS_Rasterizer *rasty)
 	:m_samples(0),
 	m_hdrType(RAS_Rasterizer::RAS_HDR_NONE),
+	m_jobPool(nullptr),
 	m_rasterizer(rasty)
 {
-	m_taskscheduler = BLI_task_scheduler_create(TASK_SCHEDULER_AUTO_THREADS);
-	m_taskpool = BLI_task_pool_create(m_taskscheduler, nullptr);
 }
 
 RAS_ICanvas::~RAS_ICanvas()
 {
-	if (m_taskpool) {
-		BLI_task_pool_work_and_wait(m_taskpool);
-		BLI_task_pool_free(m_taskpool);
-		m_taskpool = nullptr;
+	if (m_jobPool) {
+		m_jobPool->WorkAndWait();
+		delete m_jobPool;
 	}
+}
 
-	if (m_taskscheduler) {
-		BLI_task_scheduler_free(m_taskscheduler);
-		m_taskscheduler = nullptr;
+void RAS_ICanvas::SetJobSystem(CM_JobSystem *jobSystem)
+{
+	if (m_jobPool) {
+		m_jobPool->WorkAndWait();
+		delete m_jobPool;
 	}
+
+	m_jobPool = new CM_JobPool(jobSystem, CM_JobSystem::QUEUE_BACKGROUND);
 }
 
 void RAS_ICanvas::SetSamples(int samples)
@@ -199,9 +204,11 @@ void RAS_ICanvas::SaveScreeshot(const Screenshot& screenshot)
 	m_frame++;
 	BKE_image_path_ensure_ext_from_imtype(task->path, task->im_format->imtype);
 
-	BLI_task_pool_push(m_taskpool,
-	                   save_screenshot_thread_func,
-	                   task,
-	                   true, // free task data
-	                   TASK_PRIORITY_LOW);
+	if (m_jobPool) {
+		m_jobPool->Push(save_screenshot_thread_func, task, true); // free task data
+	}
+	else {
+		save_screenshot_thread_func(nullptr, task, 0);
+		MEM_freeN(task);
+	}
 }
@@ -35,8 +35,8 @@
 #include "RAS_Rasterizer.h" // for RAS_Rasterizer::HdrType
 
 class RAS_Rect;
-struct TaskScheduler;
-struct TaskPool;
+class CM_JobSystem;
+class CM_JobPool;
 struct ImageFormatData;
 
 /**
@@ -55,6 +55,9 @@ public:
 	RAS_ICanvas(RAS_Rasterizer *rasty);
 	virtual ~RAS_ICanvas();
 
+	/// Set the job system used to save the screenshots in the background.
+	void SetJobSystem(CM_JobSystem *jobSystem);
+
 	virtual void Init() = 0;
 
 	virtual void BeginFrame() = 0;
@@ -152,8 +155,8 @@ protected:
 	RAS_MouseState m_mousestate;
 	/// frame number for screenshots.
 	int m_frame;
-	TaskScheduler *m_taskscheduler;
-	TaskPool *m_taskpool;
+	/// Pool saving the screenshots, nullptr without job system.
+	CM_JobPool *m_jobPool;
 
 	RAS_Rect m_windowArea;
 	RAS_Rect m_viewportArea;
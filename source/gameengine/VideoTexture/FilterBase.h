@@ -94,6 +94,11 @@ public:
 	/// get first filter's source pixel size
 	unsigned int firstPixelSize (void) { return findFirst()->getPixelSize(); }
 
+	/// filter only depends on the converted pixel value, see filterRow
+	virtual bool isRowFilter (void) { return false; }
+	/// filter a row of converted pixels in place, only used if isRowFilter returns true
+	virtual void filterRow (unsigned int *row, unsigned int count) {}
+
 protected:
 	/// previous pixel filter
 	PyFilter * m_previous;
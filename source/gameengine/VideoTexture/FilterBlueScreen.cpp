@@ -67,6 +67,31 @@ void FilterBlueScreen::setLimits (unsigned short minLimit, unsigned short maxLim
 	m_limitDist = m_squareLimits[1] - m_squareLimits[0];
 }
 
+// filter a row of pixels
+void FilterBlueScreen::filterRow (unsigned int *row, unsigned int count)
+{
+	const int red = m_color[0];
+	const int green = m_color[1];
+	const int blue = m_color[2];
+	const unsigned int minLimit = m_squareLimits[0];
+	const unsigned int maxLimit = m_squareLimits[1];
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned char *pix = (unsigned char *)(row + i);
+		// same calculation as tFilter
+		int difRed = int(pix[0]) - red;
+		int difGreen = int(pix[1]) - green;
+		int difBlue = int(pix[2]) - blue;
+		unsigned int dist = (unsigned int)(difRed * difRed + difGreen * difGreen + difBlue * difBlue);
+		if (minLimit >= dist)
+			pix[3] = 0;
+		else if (maxLimit <= dist)
+			pix[3] = 0xFF;
+		else
+			pix[3] = (unsigned char)(((dist - minLimit) << 8) / m_limitDist);
+	}
+}
+
 
 
 // cast Filter pointer to FilterBlueScreen
@@ -55,6 +55,11 @@ public:
 	/// set limits for color variation
 	void setLimits (unsigned short minLimit, unsigned short maxLimit);
 
+	/// blue screen only depends on the pixel value
+	virtual bool isRowFilter (void) { return true; }
+	/// filter a row of pixels
+	virtual void filterRow (unsigned int *row, unsigned int count);
+
 protected:
 	///  blue screen color (red component first)
 	unsigned char m_color[3];
@@ -36,8 +36,25 @@
 #include "FilterBase.h"
 #include "PyTypeList.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 // implementation FilterGray
 
+// filter a row of pixels
+void FilterGray::filterRow (unsigned int *row, unsigned int count)
+{
+	// grayscale weights of FilterGray::tFilter, alpha is kept
+	static const ColorMatrix grayMatrix = {
+		{77, 151, 28, 0, 0},
+		{77, 151, 28, 0, 0},
+		{77, 151, 28, 0, 0},
+		{0, 0, 0, 256, 0}
+	};
+	FilterColor::calcMatrixRow(grayMatrix, row, count);
+}
+
 // attributes structure
 static PyGetSetDef filterGrayGetSets[] =
 { // attributes from FilterBase class
@@ -109,6 +126,48 @@ void FilterColor::setMatrix (ColorMatrix & mat)
 			m_matrix[r][c] = mat[r][c]; 
 }
 
+// apply color matrix to a row of pixels
+void FilterColor::calcMatrixRow (const ColorMatrix & mat, unsigned int *row, unsigned int count)
+{
+#ifdef __SSE2__
+	// matrix factors of two output components per register, offsets apart
+	const __m128i mat01 = _mm_setr_epi16(mat[0][0], mat[0][1], mat[0][2], mat[0][3],
+	                                     mat[1][0], mat[1][1], mat[1][2], mat[1][3]);
+	const __m128i mat23 = _mm_setr_epi16(mat[2][0], mat[2][1], mat[2][2], mat[2][3],
+	                                     mat[3][0], mat[3][1], mat[3][2], mat[3][3]);
+	const __m128i offset = _mm_setr_epi32(mat[0][4], mat[1][4], mat[2][4], mat[3][4]);
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i zero = _mm_setzero_si128();
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		// expand RGBA bytes to two copies of 16 bits components
+		__m128i pix = _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(row[i])), zero);
+		pix = _mm_unpacklo_epi64(pix, pix);
+		// partial sums (R, G) and (B, A) for each output component
+		const __m128 sum01 = _mm_castsi128_ps(_mm_madd_epi16(pix, mat01));
+		const __m128 sum23 = _mm_castsi128_ps(_mm_madd_epi16(pix, mat23));
+		__m128i res = _mm_add_epi32(
+			_mm_castps_si128(_mm_shuffle_ps(sum01, sum23, _MM_SHUFFLE(2, 0, 2, 0))),
+			_mm_castps_si128(_mm_shuffle_ps(sum01, sum23, _MM_SHUFFLE(3, 1, 3, 1))));
+		// same rounding and wrapping as calcColor
+		res = _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(res, offset), 8), mask);
+		res = _mm_packs_epi32(res, res);
+		row[i] = (unsigned int)_mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+	}
+#else
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int val = row[i];
+		unsigned char color[4];
+		for (int idx = 0; idx < 4; ++idx)
+			color[idx] = (((mat[idx][0] * (VT_R(val)) + mat[idx][1] * (VT_G(val)) +
+			                mat[idx][2] * (VT_B(val)) + mat[idx][3] * (VT_A(val)) +
+			                mat[idx][4]) >> 8) & 0xFF);
+		VT_RGBA(row[i], color[0], color[1], color[2], color[3]);
+	}
+#endif
+}
+
 
 
 // cast Filter pointer to FilterColor
@@ -231,6 +290,7 @@ FilterLevel::FilterLevel (void)
 		levels[r][1] = 0xFF;
 		levels[r][2] = 0xFF;
 	}
+	updateLut();
 }
 
 // set color levels
@@ -243,6 +303,32 @@ void FilterLevel::setLevels (ColorLevel & lev)
 			levels[r][c] = lev[r][c];
 		levels[r][2] = lev[r][0] < lev[r][1] ? lev[r][1] - lev[r][0] : 1;
 	}
+	updateLut();
+}
+
+// update lookup table from levels
+void FilterLevel::updateLut (void)
+{
+	for (short idx = 0; idx < 4; ++idx)
+		for (unsigned int col = 0; col < 256; ++col)
+		{
+			unsigned int val = 0;
+			VT_C(val, idx) = (unsigned char)col;
+			m_lut[idx][col] = (unsigned char)calcColor(val, idx);
+		}
+}
+
+// filter a row of pixels
+void FilterLevel::filterRow (unsigned int *row, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned char *pix = (unsigned char *)(row + i);
+		pix[0] = m_lut[0][pix[0]];
+		pix[1] = m_lut[1][pix[1]];
+		pix[2] = m_lut[2][pix[2]];
+		pix[3] = m_lut[3][pix[3]];
+	}
 }
 
 
@@ -45,6 +45,11 @@ public:
 	/// destructor
 	virtual ~FilterGray (void) {}
 
+	/// grayscale only depends on the pixel value
+	virtual bool isRowFilter (void) { return true; }
+	/// filter a row of pixels
+	virtual void filterRow (unsigned int *row, unsigned int count);
+
 protected:
 	/// filter pixel template, source int buffer
 	template <class SRC> unsigned int tFilter (SRC src, short x, short y,
@@ -88,6 +93,15 @@ public:
 	/// set color matrix
 	void setMatrix (ColorMatrix & mat);
 
+	/// color calculation only depends on the pixel value
+	virtual bool isRowFilter (void) { return true; }
+	/// filter a row of pixels
+	virtual void filterRow (unsigned int *row, unsigned int count)
+	{ calcMatrixRow(m_matrix, row, count); }
+
+	/// apply a color matrix to a row of pixels, same result as calcColor
+	static void calcMatrixRow (const ColorMatrix & mat, unsigned int *row, unsigned int count);
+
 protected:
 	///  color calculation matrix
 	ColorMatrix m_matrix;
@@ -138,9 +152,19 @@ public:
 	/// set color matrix
 	void setLevels (ColorLevel & lev);
 
+	/// levels only depend on the pixel value
+	virtual bool isRowFilter (void) { return true; }
+	/// filter a row of pixels
+	virtual void filterRow (unsigned int *row, unsigned int count);
+
 protected:
 	///  color calculation matrix
 	ColorLevel levels;
+	/// lookup table of calcColor results per color component
+	unsigned char m_lut[4][256];
+
+	/// update lookup table from levels
+	void updateLut (void);
 
 	/// calculate one color component
 	unsigned int calcColor (unsigned int val, short idx)
@@ -61,6 +61,8 @@ ExpDesc ImageHasExportsDesc(ImageHasExports, "Image has exported buffers, cannot
 ExpDesc InvalidColorChannelDesc(InvalidColorChannel, "Invalid or too many color channels specified. At most 4 values within R, G, B, A, 0, 1");
 ExpDesc InvalidImageModeDesc(InvalidImageMode, "Invalid image mode, only RGBA and BGRA are supported");
 
+bool ImageBase::m_useRowFilters = true;
+
 // constructor
 ImageBase::ImageBase (bool staticSrc) : m_image(nullptr), m_imgSize(0), m_internalFormat(GL_RGBA8),
 m_avail(false), m_scale(false), m_scaleChange(false), m_flip(false),
@@ -210,6 +212,64 @@ void ImageBase::setFilter (PyFilter * filt)
 	Py_XDECREF(m_pyfilter);
 	// set new filter
 	m_pyfilter = filt;
+	// prepare fused row filters
+	compileRowFilters();
+}
+
+// compile pixel filter chain in row filters
+void ImageBase::compileRowFilters (void)
+{
+	m_rowFilters.clear();
+	for (PyFilter *pyfilt = m_pyfilter; pyfilt != nullptr; pyfilt = pyfilt->m_filter->getPrevious())
+	{
+		// a filter reading the source or neighbor pixels needs the generic conversion
+		if (!pyfilt->m_filter->isRowFilter())
+		{
+			m_rowFilters.clear();
+			return;
+		}
+		m_rowFilters.push_back(pyfilt->m_filter);
+	}
+}
+
+// check that row filters match the filter chain
+bool ImageBase::checkRowFilters (void)
+{
+	if (!m_useRowFilters)
+		return false;
+	// the previous filters can be changed from python after setFilter
+	unsigned int idx = 0;
+	PyFilter *pyfilt;
+	for (pyfilt = m_pyfilter; pyfilt != nullptr && idx < m_rowFilters.size();
+	     pyfilt = pyfilt->m_filter->getPrevious(), ++idx)
+	{
+		if (pyfilt->m_filter != m_rowFilters[idx])
+			break;
+	}
+	if (pyfilt != nullptr || idx != m_rowFilters.size())
+		compileRowFilters();
+	return !m_rowFilters.empty();
+}
+
+// apply row filters on one image row
+void ImageBase::applyRowFiltersRow (void *__restrict userdata, const int row,
+                                    const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	ImageBase *image = static_cast<ImageBase *>(userdata);
+	const std::vector<FilterBase *>& filters = image->m_rowFilters;
+	const unsigned int width = image->m_size[0];
+	unsigned int *pixels = image->m_image + width * row;
+	// filters are stored from last to first, all are applied while the row is in cache
+	for (std::vector<FilterBase *>::const_reverse_iterator it = filters.rbegin(); it != filters.rend(); ++it)
+		(*it)->filterRow(pixels, width);
+}
+
+// apply row filters on image
+void ImageBase::applyRowFilters (void)
+{
+	ParallelRangeSettings settings;
+	initRowSettings(&settings);
+	BLI_task_parallel_range(0, m_size[1], this, applyRowFiltersRow, &settings);
 }
 
 void ImageBase::swapImageBR()
@@ -40,6 +40,8 @@
 
 #include "FilterBase.h"
 
+#include "BLI_task.h"
+
 // forward declarations
 struct PyImage;
 class ImageSource;
@@ -80,6 +82,9 @@ public:
 	/// refresh image - invalidate its current content
 	virtual void refresh(void);
 
+	/// use row filters and source mixing in one pass when possible, disabled to compare with the per pixel filters
+	static bool m_useRowFilters;
+
 	/// get scale
 	bool getScale(void) { return m_scale; }
 	/// set scale
@@ -150,6 +155,8 @@ protected:
 
 	/// pixel filter
 	PyFilter * m_pyfilter;
+	/// pixel filters of the chain from last to first, empty if a filter isn't a row filter
+	std::vector<FilterBase *> m_rowFilters;
 
 	/// initialize image data
 	void init(short width, short height);
@@ -169,6 +176,51 @@ protected:
 	/// perform loop detection
 	bool loopDetect(ImageBase * img);
 
+	/// check that the row filters match the current filter chain, compile them again if not
+	bool checkRowFilters(void);
+	/// compile pixel filter chain in row filters
+	void compileRowFilters(void);
+	/// apply row filters on the image rows in parallel
+	void applyRowFilters(void);
+	/// apply row filters on one image row
+	static void applyRowFiltersRow(void *__restrict userdata, const int row,
+		const ParallelRangeTLS *__restrict tls);
+
+	/// settings for parallel processing of image rows
+	void initRowSettings(ParallelRangeSettings *settings)
+	{
+		BLI_parallel_range_settings_defaults(settings);
+		// avoid threading overhead on small images
+		settings->use_threading = (m_size[0] * m_size[1] >= 128 * 128);
+		settings->min_iter_per_thread = 16;
+	}
+
+	/// data of parallel image conversion
+	template<class FLT, class SRC> struct ConvImageData
+	{
+		FLT *filter;
+		SRC srcBuff;
+		short *srcSize;
+		unsigned int *dstBuff;
+		unsigned int pixSize;
+		bool flip;
+	};
+
+	/// convert one image row without scaling
+	template<class FLT, class SRC> static void convImageRow(void *__restrict userdata, const int row,
+		const ParallelRangeTLS *__restrict UNUSED(tls))
+	{
+		ConvImageData<FLT, SRC> *data = static_cast<ConvImageData<FLT, SRC> *>(userdata);
+		short * srcSize = data->srcSize;
+		// source row, bottom to top if flipping is required
+		short y = data->flip ? srcSize[1] - 1 - row : row;
+		SRC srcBuff = data->srcBuff + srcSize[0] * y * data->pixSize;
+		unsigned int * dstBuff = data->dstBuff + srcSize[0] * row;
+		for (short x = 0; x < srcSize[0]; ++x, ++dstBuff, srcBuff += data->pixSize)
+			// copy pixel
+			*dstBuff = data->filter->convert(srcBuff, x, y, srcSize, data->pixSize);
+	}
+
 	/// template for image conversion
 	template<class FLT, class SRC> void convImage(FLT & filter, SRC srcBuff,
 		short * srcSize)
@@ -177,27 +229,15 @@ protected:
 		unsigned int * dstBuff = m_image;
 		// pixel size from filter
 		unsigned int pixSize = filter.firstPixelSize();
-		// if no scaling is needed
+		// if no scaling is needed, rows are converted in parallel
 		if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
-			// if flipping isn't required
-			if (!m_flip)
-				// copy bitmap
-				for (short y = 0; y < m_size[1]; ++y)
-					for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-						// copy pixel
-						*dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-		// otherwise flip image top to bottom
-			else
-			{
-				// go to last row of image
-				srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
-				// copy bitmap
-				for (short y = m_size[1] - 1; y >= 0; --y, srcBuff -= 2 * srcSize[0] * pixSize)
-					for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
-						// copy pixel
-						*dstBuff = filter.convert(srcBuff, x, y, srcSize, pixSize);
-			}
-			// else scale picture (nearest neighbor)
+		{
+			ConvImageData<FLT, SRC> data = {&filter, srcBuff, srcSize, dstBuff, pixSize, m_flip};
+			ParallelRangeSettings settings;
+			initRowSettings(&settings);
+			BLI_task_parallel_range(0, m_size[1], &data, convImageRow<FLT, SRC>, &settings);
+		}
+		// else scale picture (nearest neighbor)
 		else
 		{
 			// interpolation accumulator
@@ -256,8 +296,15 @@ protected:
 		// find first filter in chain
 		FilterBase * firstFilter = nullptr;
 		if (m_pyfilter != nullptr) firstFilter = m_pyfilter->m_filter->findFirst();
-		// if first filter is available
-		if (firstFilter != nullptr)
+		// if all filters only depend on the pixel value, convert the source
+		// and then apply the filters row by row
+		if (firstFilter != nullptr && checkRowFilters())
+		{
+			convImage(filt, srcBuff, srcSize);
+			applyRowFilters();
+		}
+		// otherwise if first filter is available, convert through the filter chain
+		else if (firstFilter != nullptr)
 		{
 			// python wrapper for filter
 			PyFilter pyFilt;
@@ -40,6 +40,12 @@
 
 #include "Exception.h"
 
+#include <vector>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 
 // cast ImageSource pointer to ImageSourceMix
 inline ImageSourceMix *getImageSourceMix(ImageSource *src)
@@ -94,7 +100,7 @@ void ImageMix::calcImage(unsigned int texId, double ts)
 		filterImage(mixFilt, m_sources[0]->getImageBuf(), m_sources[0]->getSize());
 	}
 	// otherwise use mix filter to merge source images
-	else
+	else if (!mixSources())
 	{
 		FilterImageMix mixFilt (m_sources);
 		// fiter and convert image
@@ -103,6 +109,124 @@ void ImageMix::calcImage(unsigned int texId, double ts)
 }
 
 
+/// data of parallel source mixing
+struct MixSourcesData
+{
+	/// buffers and weights of the sources with a non zero weight
+	std::vector<unsigned int *> buffers;
+	std::vector<short> weights;
+	/// destination buffer
+	unsigned int *dstBuff;
+	/// image size
+	short width;
+	short height;
+	/// flip image vertically
+	bool flip;
+};
+
+// blend one row of the sources, same result as FilterImageMix::filter
+static void mixSourcesRow(void *__restrict userdata, const int row, const ParallelRangeTLS *__restrict UNUSED(tls))
+{
+	MixSourcesData *data = static_cast<MixSourcesData *>(userdata);
+	const unsigned int numSources = data->buffers.size();
+	const unsigned int width = data->width;
+	// source row, bottom to top if flipping is required
+	const unsigned int srcOffset = (data->flip ? data->height - 1 - row : row) * width;
+	unsigned int *dstBuff = data->dstBuff + row * width;
+	unsigned int x = 0;
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	// blend 4 pixels at once, two sources at a time
+	for (; x + 4 <= width; x += 4)
+	{
+		// color components of the 4 pixels
+		__m128i color[4] = {zero, zero, zero, zero};
+		for (unsigned int i = 0; i < numSources; i += 2)
+		{
+			const __m128i pixA = _mm_loadu_si128((const __m128i *)(data->buffers[i] + srcOffset + x));
+			__m128i pixB = zero;
+			unsigned short weightB = 0;
+			if (i + 1 < numSources)
+			{
+				pixB = _mm_loadu_si128((const __m128i *)(data->buffers[i + 1] + srcOffset + x));
+				weightB = data->weights[i + 1];
+			}
+			// weights of both sources interleaved
+			const __m128i weight = _mm_set1_epi32((int)((unsigned short)data->weights[i] | ((unsigned int)weightB << 16)));
+			// 16 bits components
+			const __m128i lowA = _mm_unpacklo_epi8(pixA, zero);
+			const __m128i highA = _mm_unpackhi_epi8(pixA, zero);
+			const __m128i lowB = _mm_unpacklo_epi8(pixB, zero);
+			const __m128i highB = _mm_unpackhi_epi8(pixB, zero);
+			// components of both sources interleaved per pixel, weighted and added
+			color[0] = _mm_add_epi32(color[0], _mm_madd_epi16(_mm_unpacklo_epi16(lowA, lowB), weight));
+			color[1] = _mm_add_epi32(color[1], _mm_madd_epi16(_mm_unpackhi_epi16(lowA, lowB), weight));
+			color[2] = _mm_add_epi32(color[2], _mm_madd_epi16(_mm_unpacklo_epi16(highA, highB), weight));
+			color[3] = _mm_add_epi32(color[3], _mm_madd_epi16(_mm_unpackhi_epi16(highA, highB), weight));
+		}
+		for (int i = 0; i < 4; ++i)
+			color[i] = _mm_and_si128(_mm_srai_epi32(color[i], 8), mask);
+		const __m128i res = _mm_packus_epi16(_mm_packs_epi32(color[0], color[1]), _mm_packs_epi32(color[2], color[3]));
+		_mm_storeu_si128((__m128i *)(dstBuff + x), res);
+	}
+#endif
+	for (; x < width; ++x)
+	{
+		int color[] = {0, 0, 0, 0};
+		for (unsigned int i = 0; i < numSources; ++i)
+		{
+			const unsigned int pix = data->buffers[i][srcOffset + x];
+			const int weight = data->weights[i];
+			color[0] += weight * (pix & 0xFF);
+			color[1] += weight * ((pix >> 8) & 0xFF);
+			color[2] += weight * ((pix >> 16) & 0xFF);
+			color[3] += weight * ((pix >> 24) & 0xFF);
+		}
+		dstBuff[x] = ((color[0] >> 8) & 0xFF) | (color[1] & 0xFF00)
+			| ((color[2] << 8) & 0xFF0000) | ((color[3] << 16) & 0xFF000000);
+	}
+}
+
+// blend sources
+bool ImageMix::mixSources(void)
+{
+	short *srcSize = m_sources[0]->getSize();
+	// scaling and pixel filters needing the source are done by the generic filter,
+	// as well as everything when the row filters are disabled
+	if (!m_useRowFilters || m_image == nullptr || srcSize[0] != m_size[0] || srcSize[1] != m_size[1] ||
+		(m_pyfilter != nullptr && !checkRowFilters()))
+	{
+		return false;
+	}
+
+	MixSourcesData data;
+	for (ImageSourceList::iterator it = m_sources.begin(); it != m_sources.end(); ++it)
+	{
+		ImageSourceMix *mixSrc = getImageSourceMix(*it);
+		// sources without weight don't change the result
+		if (mixSrc->getWeight() != 0)
+		{
+			data.buffers.push_back(mixSrc->getImageBuf());
+			data.weights.push_back(mixSrc->getWeight());
+		}
+	}
+	data.dstBuff = m_image;
+	data.width = m_size[0];
+	data.height = m_size[1];
+	data.flip = m_flip;
+
+	ParallelRangeSettings settings;
+	initRowSettings(&settings);
+	BLI_task_parallel_range(0, m_size[1], &data, mixSourcesRow, &settings);
+
+	if (m_pyfilter != nullptr)
+		applyRowFilters();
+	// image was processed
+	m_avail = true;
+	return true;
+}
+
 
 // cast Image pointer to ImageMix
 inline ImageMix * getImageMix(PyImage *self)
@@ -87,6 +87,9 @@ protected:
 
 	/// calculate image from sources and set its availability
 	virtual void calcImage (unsigned int texId, double ts);
+
+	/// blend the sources row by row in parallel, return false if the generic filter is needed
+	bool mixSources (void);
 };
 
 
@@ -45,6 +45,7 @@
 #include "PIL_time.h"
 
 #include <string>
+#include <algorithm>
 
 #include "VideoFFmpeg.h"
 #include "Exception.h"
@@ -66,10 +67,11 @@ m_frame(nullptr), m_frameDeinterlaced(nullptr), m_frameRGB(nullptr), m_imgConver
 m_deinterlace(false), m_preseek(0),	m_videoStream(-1), m_baseFrameRate(25.0),
 m_lastFrame(-1),  m_eof(false), m_externTime(false), m_curPosition(-1), m_startTime(0), 
 m_captWidth(0), m_captHeight(0), m_captRate(0.f), m_isImage(false),
-m_isThreaded(false), m_isStreaming(false), m_stopThread(false), m_cacheStarted(false)
+m_isThreaded(false), m_isStreaming(false), m_cacheSize(CACHE_FRAME_SIZE), m_decodedFrames(0),
+m_droppedFrames(0), m_stopThread(false), m_cacheStarted(false)
 {
-	// set video format
-	m_format = RGB24;
+	// set video format, frames are always converted to RGBA
+	m_format = RGBA32;
 	// force flip because ffmpeg always return the image in the wrong orientation for texture
 	setFlip(true);
 	// construction is OK
@@ -142,23 +144,13 @@ AVFrame	*VideoFFmpeg::allocFrameRGB()
 {
 	AVFrame *frame;
 	frame = av_frame_alloc();
-	if (m_format == RGBA32)
-	{
-		avpicture_fill((AVPicture*)frame, 
-			(uint8_t*)MEM_callocN(avpicture_get_size(
-				AV_PIX_FMT_RGBA,
-				m_codecCtx->width, m_codecCtx->height),
-				"ffmpeg rgba"),
-			AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height);
-	} else 
-	{
-		avpicture_fill((AVPicture*)frame, 
-			(uint8_t*)MEM_callocN(avpicture_get_size(
-				AV_PIX_FMT_RGB24,
-				m_codecCtx->width, m_codecCtx->height),
-				"ffmpeg rgb"),
-			AV_PIX_FMT_RGB24, m_codecCtx->width, m_codecCtx->height);
-	}
+	// same size and allocator as the image buffer, see swapImage
+	avpicture_fill((AVPicture*)frame, 
+		(uint8_t*)MEM_callocN(avpicture_get_size(
+			AV_PIX_FMT_RGBA,
+			m_codecCtx->width, m_codecCtx->height),
+			"ffmpeg rgba"),
+		AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height);
 	return frame;
 }
 
@@ -172,6 +164,18 @@ void VideoFFmpeg::initParams (short width, short height, float rate, bool image)
 }
 
 
+// check if an opened file is in fact a streaming source
+static bool isStreamingSource(const char *filename, AVFormatContext *formatCtx)
+{
+	// ffmpeg reports that http source are actually non stream
+	// but it is really not desirable to seek on http file, so force streaming.
+	// It would be good to find this information from the context but there are no simple indication
+	return (!strncmp(filename, "http://", 7) ||
+	        !strncmp(filename, "rtsp://", 7) ||
+	        (formatCtx->pb && !formatCtx->pb->seekable));
+}
+
+
 int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AVDictionary **formatParams)
 {
 	AVFormatContext *formatCtx = nullptr;
@@ -217,6 +221,18 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 		return -1;
 	}
 	codecCtx->workaround_bugs = 1;
+	// a single image doesn't benefit from threading
+	if (m_isImage)
+		codecCtx->thread_count = 1;
+	else
+	{
+		codecCtx->thread_count = std::min(BLI_system_thread_count(), DECODE_THREAD_MAX);
+		// frame threading delays the frames by the number of threads, this is only hidden
+		// when the cache thread reads a file ahead, keep capture and network latency low
+		bool cached = (inputFormat == nullptr && !isStreamingSource(filename, formatCtx) &&
+		               BLI_system_thread_count() > 1);
+		codecCtx->thread_type = (cached) ? FF_THREAD_FRAME | FF_THREAD_SLICE : FF_THREAD_SLICE;
+	}
 	if (avcodec_open2(codecCtx, codec, nullptr) < 0)
 	{
 		avformat_close_input(&formatCtx);
@@ -248,39 +264,19 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 		"ffmpeg deinterlace"), 
 		m_codecCtx->pix_fmt, m_codecCtx->width, m_codecCtx->height);
 
-	// check if the pixel format supports Alpha
-	if (m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 ||
-		m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) 
-	{
-		// allocate buffer to store final decoded frame
-		m_format = RGBA32;
-		// allocate sws context
-		m_imgConvertCtx = sws_getContext(
-			m_codecCtx->width,
-			m_codecCtx->height,
-			m_codecCtx->pix_fmt,
-			m_codecCtx->width,
-			m_codecCtx->height,
-			AV_PIX_FMT_RGBA,
-			SWS_FAST_BILINEAR,
-			nullptr, nullptr, nullptr);
-	} else
-	{
-		// allocate buffer to store final decoded frame
-		m_format = RGB24;
-		// allocate sws context
-		m_imgConvertCtx = sws_getContext(
-			m_codecCtx->width,
-			m_codecCtx->height,
-			m_codecCtx->pix_fmt,
-			m_codecCtx->width,
-			m_codecCtx->height,
-			AV_PIX_FMT_RGB24,
-			SWS_FAST_BILINEAR,
-			nullptr, nullptr, nullptr);
-	}
+	// convert to RGBA even without alpha in source, the frame has then the image format
+	m_format = RGBA32;
+	// allocate sws context
+	m_imgConvertCtx = sws_getContext(
+		m_codecCtx->width,
+		m_codecCtx->height,
+		m_codecCtx->pix_fmt,
+		m_codecCtx->width,
+		m_codecCtx->height,
+		AV_PIX_FMT_RGBA,
+		SWS_FAST_BILINEAR,
+		nullptr, nullptr, nullptr);
+	// allocate buffer to store final decoded frame
 	m_frameRGB = allocFrameRGB();
 
 	if (!m_imgConvertCtx) {
@@ -301,13 +297,79 @@ int VideoFFmpeg::openStream(const char *filename, AVInputFormat *inputFormat, AV
 	return 0;
 }
 
+// deinterlace and convert decoded frame
+void VideoFFmpeg::convertFrame(AVFrame *output)
+{
+	AVFrame *input = m_frame;
+	if (m_deinterlace)
+	{
+		if (avpicture_deinterlace(
+			(AVPicture*) m_frameDeinterlaced,
+			(const AVPicture*) m_frame,
+			m_codecCtx->pix_fmt,
+			m_codecCtx->width,
+			m_codecCtx->height) >= 0)
+		{
+			input = m_frameDeinterlaced;
+		}
+	}
+	// write rows from bottom to top, the frame is then already flipped for the texture
+	uint8_t *data[4] = {output->data[0] + (m_codecCtx->height - 1) * output->linesize[0], nullptr, nullptr, nullptr};
+	int linesize[4] = {-output->linesize[0], 0, 0, 0};
+	// convert to RGBA
+	sws_scale(m_imgConvertCtx,
+		input->data,
+		input->linesize,
+		0,
+		m_codecCtx->height,
+		data,
+		linesize);
+}
+
+// exchange image and frame buffers
+bool VideoFFmpeg::swapImage(AVFrame *frame)
+{
+	// the frame can be used as image only without filtering, scaling or flip change
+	// and if no python buffer points to the image
+	if (m_image == nullptr || m_avail || !m_flip || m_scaleChange || m_pyfilter != nullptr || m_exports > 0 ||
+		m_size[0] != m_orgSize[0] || m_size[1] != m_orgSize[1] ||
+		m_imgSize != (unsigned int)(m_size[0] * m_size[1]))
+	{
+		return false;
+	}
+	// both buffers have the same size, the frame gets the previous image buffer
+	unsigned int *image = m_image;
+	m_image = (unsigned int *)frame->data[0];
+	frame->data[0] = (uint8_t *)image;
+	m_avail = true;
+	return true;
+}
+
+// set number of decoded frames in cache
+void VideoFFmpeg::setCacheSize(int size)
+{
+	m_cacheSize = std::max(1, std::min(size, CACHE_FRAME_MAX));
+	// the cache is allocated again with the new size at next frame
+	stopCache();
+}
+
+// get number of decoded frames in cache
+int VideoFFmpeg::getCacheFill(void)
+{
+	pthread_mutex_lock(&m_cacheMutex);
+	int fill = BLI_listbase_count(&m_frameCacheBase);
+	pthread_mutex_unlock(&m_cacheMutex);
+	return fill;
+}
+
 /*
  * This thread is used to load video frame asynchronously.
  * It provides a frame caching service. 
  * The main thread is responsible for positioning the frame pointer in the
  * file correctly before calling startCache() which starts this thread.
- * The cache is organized in two layers: 1) a cache of 20-30 undecoded packets to keep
- * memory and CPU low 2) a cache of 5 decoded frames. 
+ * The cache is organized in two layers: 1) a cache of undecoded packets to keep
+ * memory and CPU low 2) a cache of decoded frames (see setCacheSize), converted
+ * to RGBA in the image format so that they can replace the image buffer.
  * If the main thread does not find the frame in the cache (because the video has restarted
  * or because the GE is lagging), it stops the cache with StopCache() (this is a synchronous
  * function: it sends a signal to stop the cache thread and wait for confirmation), then
@@ -319,7 +381,10 @@ void *VideoFFmpeg::cacheThread(void *data)
 	// holds the frame that is being decoded
 	CacheFrame *currentFrame = nullptr;
 	CachePacket *cachePacket;
+	// empty packet to get the frames delayed by the decoder threads at end of file
+	AVPacket flushPacket;
 	bool endOfFile = false;
+	bool decoderFlushed = false;
 	int frameFinished = 0;
 	double timeBase = av_q2d(video->m_formatCtx->streams[video->m_videoStream]->time_base);
 	int64_t startTs = video->m_formatCtx->streams[video->m_videoStream]->start_time;
@@ -375,14 +440,30 @@ void *VideoFFmpeg::cacheThread(void *data)
 		{
 			// this frame is out of free and busy queue, we can manipulate it without locking
 			frameFinished = 0;
-			while (!frameFinished && (cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr)
+			while (!frameFinished &&
+			       ((cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr ||
+			        (endOfFile && !decoderFlushed)))
 			{
-				BLI_remlink(&video->m_packetCacheBase, cachePacket);
+				AVPacket *packet = &flushPacket;
+				if (cachePacket)
+				{
+					BLI_remlink(&video->m_packetCacheBase, cachePacket);
+					packet = &cachePacket->packet;
+				}
+				else
+				{
+					av_init_packet(&flushPacket);
+					flushPacket.data = nullptr;
+					flushPacket.size = 0;
+				}
 				// use m_frame because when caching, it is not used in main thread
 				// we can't use currentFrame directly because we need to convert to RGB first
 				avcodec_decode_video2(video->m_codecCtx, 
 					video->m_frame, &frameFinished, 
-					&cachePacket->packet);
+					packet);
+				// all delayed frames are returned
+				if (!cachePacket && !frameFinished)
+					decoderFlushed = true;
 				if (frameFinished) 
 				{
 					AVFrame * input = video->m_frame;
@@ -391,39 +472,26 @@ void *VideoFFmpeg::cacheThread(void *data)
 					if (   input->data[0]!=0 || input->data[1]!=0 
 						|| input->data[2]!=0 || input->data[3]!=0)
 					{
-						if (video->m_deinterlace) 
-						{
-							if (avpicture_deinterlace(
-								(AVPicture*) video->m_frameDeinterlaced,
-								(const AVPicture*) video->m_frame,
-								video->m_codecCtx->pix_fmt,
-								video->m_codecCtx->width,
-								video->m_codecCtx->height) >= 0)
-							{
-								input = video->m_frameDeinterlaced;
-							}
-						}
-						// convert to RGB24
-						sws_scale(video->m_imgConvertCtx,
-							input->data,
-							input->linesize,
-							0,
-							video->m_codecCtx->height,
-							currentFrame->frame->data,
-							currentFrame->frame->linesize);
-						// move frame to queue, this frame is necessarily the next one
-						video->m_curPosition = (long)((cachePacket->packet.dts-startTs) * (video->m_baseFrameRate*timeBase) + 0.5);
+						video->convertFrame(currentFrame->frame);
+						// move frame to queue, use the frame timestamp as the packet can belong
+						// to a later frame with threaded decoding
+						int64_t pts = av_get_pts_from_frame(video->m_formatCtx, input);
+						video->m_curPosition = (long)((pts-startTs) * (video->m_baseFrameRate*timeBase) + 0.5);
 						currentFrame->framePosition = video->m_curPosition;
 						pthread_mutex_lock(&video->m_cacheMutex);
 						BLI_addtail(&video->m_frameCacheBase, currentFrame);
+						++video->m_decodedFrames;
 						pthread_mutex_unlock(&video->m_cacheMutex);
 						currentFrame = nullptr;
 					}
 				}
-				av_free_packet(&cachePacket->packet);
-				BLI_addtail(&video->m_packetCacheFree, cachePacket);
+				if (cachePacket)
+				{
+					av_free_packet(&cachePacket->packet);
+					BLI_addtail(&video->m_packetCacheFree, cachePacket);
+				}
 			} 
-			if (currentFrame && endOfFile) 
+			if (currentFrame && endOfFile && decoderFlushed) 
 			{
 				// no more packet and end of file => put a special frame that indicates that
 				currentFrame->framePosition = -1;
@@ -456,13 +524,15 @@ bool VideoFFmpeg::startCache()
 	if (!m_cacheStarted && m_isThreaded)
 	{
 		m_stopThread = false;
-		for (int i=0; i<CACHE_FRAME_SIZE; i++)
+		for (int i=0; i<m_cacheSize; i++)
 		{
 			CacheFrame *frame = new CacheFrame();
 			frame->frame = allocFrameRGB();
 			BLI_addtail(&m_frameCacheFree, frame);
 		}
-		for (int i=0; i<CACHE_PACKET_SIZE; i++) 
+		// keep the default packets per frame ratio
+		const int packetCacheSize = std::max(CACHE_PACKET_SIZE, m_cacheSize * CACHE_PACKET_SIZE / CACHE_FRAME_SIZE);
+		for (int i=0; i<packetCacheSize; i++) 
 		{
 			CachePacket *packet = new CachePacket();
 			BLI_addtail(&m_packetCacheFree, packet);
@@ -548,14 +618,7 @@ void VideoFFmpeg::openFile (char *filename)
 	// open base class
 	VideoBase::openFile(filename);
 
-	if (
-		// ffmpeg reports that http source are actually non stream
-		// but it is really not desirable to seek on http file, so force streaming.
-		// It would be good to find this information from the context but there are no simple indication
-		!strncmp(filename, "http://", 7) ||
-		!strncmp(filename, "rtsp://", 7) ||
-		(m_formatCtx->pb && !m_formatCtx->pb->seekable)
-		)
+	if (isStreamingSource(filename, m_formatCtx))
 	{
 		// the file is in fact a streaming source, treat as cam to prevent seeking
 		m_isFile = false;
@@ -833,8 +896,14 @@ void VideoFFmpeg::calcImage (unsigned int texId, double ts)
 				m_lastFrame = actFrame;
 				// init image, if needed
 				init(short(m_codecCtx->width), short(m_codecCtx->height));
-				// process image
-				process((BYTE*)(frame->data[0]));
+				// use the frame as image if possible, otherwise process it
+				if (!swapImage(frame))
+				{
+					// the frame rows are already flipped
+					m_flip = !m_flip;
+					process((BYTE*)(frame->data[0]));
+					m_flip = !m_flip;
+				}
 				// finished with the frame, release it so that cache can reuse it
 				releaseFrame(frame);
 				// in case it is an image, automatically stop reading it
@@ -881,7 +950,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 	bool frameLoaded = false;
 	int64_t targetTs = 0;
 	CacheFrame *frame;
-	int64_t dts = 0;
+	int64_t pts = 0;
 
 	if (m_cacheStarted)
 	{
@@ -928,6 +997,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 			BLI_remlink(&m_frameCacheBase, frame);
 			BLI_addtail(&m_frameCacheFree, frame);
 			pthread_mutex_unlock(&m_cacheMutex);
+			++m_droppedFrames;
 		} while (true);
 	}
 	double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
@@ -955,7 +1025,8 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 						&packet);
 					if (frameFinished)
 					{
-						m_curPosition = (long)((packet.dts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
+						pts = av_get_pts_from_frame(m_formatCtx, m_frame);
+						m_curPosition = (long)((pts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
 					}
 				}
 				av_free_packet(&packet);
@@ -1020,8 +1091,21 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 
 	// find the correct frame, in case of streaming and no cache, it means just
 	// return the next frame. This is not quite correct, may need more work
-	while (av_read_frame(m_formatCtx, &packet) >= 0)
+	bool endOfFile = false;
+	for (;;)
 	{
+		if (av_read_frame(m_formatCtx, &packet) < 0)
+		{
+			// at the end of a file, get the frames delayed by the decoder threads
+			// with empty packets, until the decoder has no more frame to return
+			if (!m_isFile)
+				break;
+			av_init_packet(&packet);
+			packet.data = nullptr;
+			packet.size = 0;
+			packet.stream_index = m_videoStream;
+			endOfFile = true;
+		}
 		if (packet.stream_index == m_videoStream) 
 		{
 			AVFrame *input = m_frame;
@@ -1033,11 +1117,17 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 				counter++;
 			} while ((input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 && input->data[3] == 0) && counter < 10 && m_isImage);
 
-			// remember dts to compute exact frame number
-			dts = packet.dts;
+			// all delayed frames are returned
+			if (endOfFile && !frameFinished)
+				break;
+
+			// remember frame timestamp to compute exact frame number, the packet
+			// doesn't always belong to the decoded frame with threaded decoding
+			if (frameFinished)
+				pts = av_get_pts_from_frame(m_formatCtx, m_frame);
 			if (frameFinished && !posFound) 
 			{
-				if (dts >= targetTs)
+				if (pts >= targetTs)
 				{
 					posFound = 1;
 				}
@@ -1056,28 +1146,10 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 					break;
 				}
 
-				if (m_deinterlace) 
-				{
-					if (avpicture_deinterlace(
-						(AVPicture*) m_frameDeinterlaced,
-						(const AVPicture*) m_frame,
-						m_codecCtx->pix_fmt,
-						m_codecCtx->width,
-						m_codecCtx->height) >= 0)
-					{
-						input = m_frameDeinterlaced;
-					}
-				}
-				// convert to RGB24
-				sws_scale(m_imgConvertCtx,
-					input->data,
-					input->linesize,
-					0,
-					m_codecCtx->height,
-					m_frameRGB->data,
-					m_frameRGB->linesize);
+				convertFrame(m_frameRGB);
 				av_free_packet(&packet);
 				frameLoaded = true;
+				++m_decodedFrames;
 				break;
 			}
 		}
@@ -1086,7 +1158,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
 	m_eof = m_isFile && !frameLoaded;
 	if (frameLoaded)
 	{
-		m_curPosition = (long)((dts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
+		m_curPosition = (long)((pts-startTs) * (m_baseFrameRate*timeBase) + 0.5);
 		if (m_isThreaded)
 		{
 			// normal case for file: first locate, then start cache
@@ -1197,6 +1269,43 @@ static int VideoFFmpeg_setDeinterlace(PyImage *self, PyObject *value, void *clos
 	return 0;
 }
 
+// get number of cached frames
+static PyObject *VideoFFmpeg_getCacheSize(PyImage *self, void *closure)
+{
+	return Py_BuildValue("i", getFFmpeg(self)->getCacheSize());
+}
+
+// set number of cached frames
+static int VideoFFmpeg_setCacheSize(PyImage *self, PyObject *value, void *closure)
+{
+	// check validity of parameter
+	if (value == nullptr || !PyLong_Check(value))
+	{
+		PyErr_SetString(PyExc_TypeError, "The value must be an integer");
+		return -1;
+	}
+	// set cache size
+	getFFmpeg(self)->setCacheSize(PyLong_AsLong(value));
+	// success
+	return 0;
+}
+
+// get decoding statistics
+static PyObject *VideoFFmpeg_getDecodedFrames(PyImage *self, void *closure)
+{
+	return PyLong_FromLong(getFFmpeg(self)->getDecodedFrames());
+}
+
+static PyObject *VideoFFmpeg_getDroppedFrames(PyImage *self, void *closure)
+{
+	return PyLong_FromLong(getFFmpeg(self)->getDroppedFrames());
+}
+
+static PyObject *VideoFFmpeg_getCacheFill(PyImage *self, void *closure)
+{
+	return PyLong_FromLong(getFFmpeg(self)->getCacheFill());
+}
+
 // methods structure
 static PyMethodDef videoMethods[] =
 { // methods from VideoBase class
@@ -1222,6 +1331,10 @@ static PyGetSetDef videoGetSets[] =
 	{(char*)"filter", (getter)Image_getFilter, (setter)Image_setFilter, (char*)"pixel filter", nullptr},
 	{(char*)"preseek", (getter)VideoFFmpeg_getPreseek, (setter)VideoFFmpeg_setPreseek, (char*)"nb of frames of preseek", nullptr},
 	{(char*)"deinterlace", (getter)VideoFFmpeg_getDeinterlace, (setter)VideoFFmpeg_setDeinterlace, (char*)"deinterlace image", nullptr},
+	{(char*)"cacheSize", (getter)VideoFFmpeg_getCacheSize, (setter)VideoFFmpeg_setCacheSize, (char*)"nb of decoded frames in cache", nullptr},
+	{(char*)"decodedFrames", (getter)VideoFFmpeg_getDecodedFrames, nullptr, (char*)"nb of decoded frames", nullptr},
+	{(char*)"droppedFrames", (getter)VideoFFmpeg_getDroppedFrames, nullptr, (char*)"nb of decoded frames skipped", nullptr},
+	{(char*)"cacheFill", (getter)VideoFFmpeg_getCacheFill, nullptr, (char*)"nb of decoded frames waiting in cache", nullptr},
 	{nullptr}
 };
 
@@ -66,6 +66,9 @@ static inline AVCodecContext *get_codec_from_stream(AVStream* stream)
 
 #define CACHE_FRAME_SIZE	10
 #define CACHE_PACKET_SIZE	30
+#define CACHE_FRAME_MAX	100
+/// maximum number of decoding threads, ffmpeg warns above this value
+#define DECODE_THREAD_MAX	16
 
 // type VideoFFmpeg declaration
 class VideoFFmpeg : public VideoBase
@@ -103,6 +106,14 @@ public:
 	bool getDeinterlace(void) { return m_deinterlace; }
 	void setDeinterlace(bool deinterlace) { m_deinterlace = deinterlace; }
 	char *getImageName(void) { return (m_isImage) ? (char *)m_imageName.c_str() : nullptr; }
+	int getCacheSize(void) { return m_cacheSize; }
+	void setCacheSize(int size);
+	/// number of frames decoded since the video was opened
+	long getDecodedFrames(void) { return m_decodedFrames; }
+	/// number of decoded frames skipped because the game was late
+	long getDroppedFrames(void) { return m_droppedFrames; }
+	/// number of decoded frames waiting in cache
+	int getCacheFill(void);
 
 protected:
 	// format and codec information
@@ -113,7 +124,7 @@ protected:
 	AVFrame	*m_frame;
 	// deinterlaced frame if codec requires it
 	AVFrame	*m_frameDeinterlaced;
-	// decoded RGB24 frame if codec requires it
+	// decoded RGBA frame, rows are stored bottom to top like the image
 	AVFrame	*m_frameRGB;
 	// conversion from raw to RGB is done with sws_scale
 	struct SwsContext *m_imgConvertCtx;
@@ -163,6 +174,13 @@ protected:
 	/// keep last image name
 	std::string m_imageName;
 
+	/// number of decoded frames in cache
+	int m_cacheSize;
+	/// number of decoded frames
+	long m_decodedFrames;
+	/// number of decoded frames not displayed
+	long m_droppedFrames;
+
 	/// image calculation
 	virtual void calcImage (unsigned int texId, double ts);
 
@@ -181,6 +199,11 @@ protected:
 	/// in case of caching, put the frame back in free queue
 	void releaseFrame(AVFrame* frame);
 
+	/// deinterlace if required and convert decoded frame to RGBA
+	void convertFrame(AVFrame *output);
+	/// exchange the image buffer with the frame buffer if no conversion is needed, return true on success
+	bool swapImage(AVFrame *frame);
+
 	/// start thread to load the video file/capture/stream 
 	bool startCache();
 	void stopCache();
@@ -95,6 +95,15 @@ static PyObject *setLogFile (PyObject *self, PyObject *args)
 	return Py_BuildValue("i", 0);
 }
 
+// enable row filters
+static PyObject *setRowFilters (PyObject *self, PyObject *args)
+{
+	int enable;
+	if (!PyArg_ParseTuple(args, "i:setRowFilters", &enable))
+		return nullptr;
+	ImageBase::m_useRowFilters = (enable != 0);
+	Py_RETURN_NONE;
+}
 
 // image to numpy array
 static PyObject *imageToArray(PyObject *self, PyObject *args)
@@ -120,6 +129,7 @@ static PyMethodDef moduleMethods[] =
 	{"materialID", getMaterialID, METH_VARARGS, "Gets object's Blender Material ID"},
 	{"getLastError", getLastError, METH_NOARGS, "Gets last error description"},
 	{"setLogFile", setLogFile, METH_VARARGS, "Sets log file name"},
+	{"setRowFilters", setRowFilters, METH_VARARGS, "Enable filtering images row by row"},
 	{"imageToArray", imageToArray, METH_VARARGS, "get buffer from image source, color channels are selectable"},
 	{nullptr}  /* Sentinel */
 };
@@ -0,0 +1,246 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_kdopbvh.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_geom.h"
+#include "BLI_rand.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include "stubs/bf_intern_eigen_stubs.h"
+
+/* Compare the single queries with the batched ones, on a grid of triangles.
+ *
+ * The batched queries are threaded when given many queries at once,
+ * they are also given chunks too small to be threaded, to time the packet traversal alone. */
+
+/* Number of quads along the grid sides. */
+#define GRID_RES 300
+
+#define RAYS_NUM 1000000
+
+/* Batch size below the threading threshold. */
+#define CHUNK_SIZE 128
+
+static void ray_cast_tri_cb(void *userdata, int index, const BVHTreeRay *ray, BVHTreeRayHit *hit)
+{
+	const float (*tris)[3][3] = (const float (*)[3][3])userdata;
+	float dist;
+
+	if (isect_ray_tri_watertight_v3(ray->origin, ray->isect_precalc, UNPACK3(tris[index]), &dist, NULL) &&
+	    dist < hit->dist)
+	{
+		hit->index = index;
+		hit->dist = dist;
+		madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist);
+	}
+}
+
+/* A wavy grid, like a terrain. */
+static BVHTree *grid_tree_create(float (**r_tris)[3][3])
+{
+	const int tris_num = GRID_RES * GRID_RES * 2;
+	float (*tris)[3][3] = (float (*)[3][3])MEM_mallocN(sizeof(float[3][3]) * tris_num, __func__);
+	BVHTree *tree = BLI_bvhtree_new(tris_num, 0.0f, 4, 6);
+	int tri = 0;
+
+	for (int y = 0; y < GRID_RES; y++) {
+		for (int x = 0; x < GRID_RES; x++) {
+			float quad[4][3];
+			for (int i = 0; i < 4; i++) {
+				const int qx = x + (i == 1 || i == 2), qy = y + (i >= 2);
+				quad[i][0] = (float)qx / GRID_RES;
+				quad[i][1] = (float)qy / GRID_RES;
+				quad[i][2] = 0.1f * sinf((float)qx * 0.1f) * cosf((float)qy * 0.13f);
+			}
+			copy_v3_v3(tris[tri][0], quad[0]); copy_v3_v3(tris[tri][1], quad[1]); copy_v3_v3(tris[tri][2], quad[2]);
+			BLI_bvhtree_insert(tree, tri, &tris[tri][0][0], 3);
+			tri++;
+			copy_v3_v3(tris[tri][0], quad[0]); copy_v3_v3(tris[tri][1], quad[2]); copy_v3_v3(tris[tri][2], quad[3]);
+			BLI_bvhtree_insert(tree, tri, &tris[tri][0][0], 3);
+			tri++;
+		}
+	}
+	BLI_bvhtree_balance(tree);
+
+	*r_tris = tris;
+	return tree;
+}
+
+static void hits_init(BVHTreeRayHit *hits, int num)
+{
+	for (int i = 0; i < num; i++) {
+		hits[i].index = -1;
+		hits[i].dist = BVH_RAYCAST_DIST_MAX;
+	}
+}
+
+static void ray_cast_test(bool coherent)
+{
+	float (*tris)[3][3];
+	BVHTree *tree = grid_tree_create(&tris);
+	struct RNG *rng = BLI_rng_new(0);
+
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * RAYS_NUM, __func__);
+	float (*dir)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * RAYS_NUM, __func__);
+	BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * RAYS_NUM, __func__);
+
+	printf("\n========== STARTING %s ==========\n", coherent ? "coherent rays" : "incoherent rays");
+
+	for (int i = 0; i < RAYS_NUM; i++) {
+		if (coherent) {
+			/* Rays from a camera above the grid, in scan-line order. */
+			const int res = 1000;
+			const float cam[3] = {0.5f, 0.5f, 1.0f};
+			copy_v3_v3(co[i], cam);
+			dir[i][0] = ((float)(i % res) / res) - 0.5f;
+			dir[i][1] = ((float)(i / res) / res) - 0.5f;
+			dir[i][2] = -1.0f;
+			normalize_v3(dir[i]);
+		}
+		else {
+			co[i][0] = BLI_rng_get_float(rng);
+			co[i][1] = BLI_rng_get_float(rng);
+			co[i][2] = 0.5f;
+			BLI_rng_get_float_unit_v3(rng, dir[i]);
+		}
+	}
+
+	int hits_num_single = 0, hits_num_batch = 0;
+
+	{
+		TIMEIT_START(ray_cast_single);
+
+		for (int i = 0; i < RAYS_NUM; i++) {
+			BVHTreeRayHit hit;
+			hits_init(&hit, 1);
+			if (BLI_bvhtree_ray_cast(tree, co[i], dir[i], 0.0f, &hit, ray_cast_tri_cb, tris) != -1) {
+				hits_num_single++;
+			}
+		}
+
+		TIMEIT_END(ray_cast_single);
+	}
+
+	{
+		hits_init(hits, RAYS_NUM);
+
+		TIMEIT_START(ray_cast_batch_chunks);
+
+		for (int i = 0; i < RAYS_NUM; i += CHUNK_SIZE) {
+			BLI_bvhtree_ray_cast_batch(
+			        tree, &co[i], &dir[i], min_ii(CHUNK_SIZE, RAYS_NUM - i), 0.0f, &hits[i],
+			        ray_cast_tri_cb, tris, BVH_RAYCAST_DEFAULT);
+		}
+
+		TIMEIT_END(ray_cast_batch_chunks);
+	}
+
+	{
+		hits_init(hits, RAYS_NUM);
+
+		TIMEIT_START(ray_cast_batch_threaded);
+
+		BLI_bvhtree_ray_cast_batch(
+		        tree, co, dir, RAYS_NUM, 0.0f, hits,
+		        ray_cast_tri_cb, tris, BVH_RAYCAST_DEFAULT);
+
+		TIMEIT_END(ray_cast_batch_threaded);
+	}
+
+	for (int i = 0; i < RAYS_NUM; i++) {
+		if (hits[i].index != -1) {
+			hits_num_batch++;
+		}
+	}
+	EXPECT_EQ(hits_num_single, hits_num_batch);
+
+	printf("%d rays, %d hits\n", RAYS_NUM, hits_num_batch);
+	printf("========== ENDED %s ==========\n\n", coherent ? "coherent rays" : "incoherent rays");
+
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(tris);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hits);
+}
+
+TEST(kdopbvh, RayCastCoherent)
+{
+	ray_cast_test(true);
+}
+
+TEST(kdopbvh, RayCastIncoherent)
+{
+	ray_cast_test(false);
+}
+
+TEST(kdopbvh, FindNearest)
+{
+	float (*tris)[3][3];
+	BVHTree *tree = grid_tree_create(&tris);
+
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * RAYS_NUM, __func__);
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * RAYS_NUM, __func__);
+
+	printf("\n========== STARTING %s ==========\n", __func__);
+
+	/* Points above the grid, in scan-line order. */
+	for (int i = 0; i < RAYS_NUM; i++) {
+		const int res = 1000;
+		co[i][0] = (float)(i % res) / res;
+		co[i][1] = (float)(i / res) / res;
+		co[i][2] = 0.2f;
+	}
+
+	{
+		TIMEIT_START(find_nearest_single);
+
+		for (int i = 0; i < RAYS_NUM; i++) {
+			BVHTreeNearest nearest_single;
+			nearest_single.index = -1;
+			nearest_single.dist_sq = FLT_MAX;
+			BLI_bvhtree_find_nearest(tree, co[i], &nearest_single, NULL, NULL);
+		}
+
+		TIMEIT_END(find_nearest_single);
+	}
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < RAYS_NUM; i++) {
+			nearest[i].index = -1;
+			nearest[i].dist_sq = FLT_MAX;
+		}
+
+		if (pass == 0) {
+			TIMEIT_START(find_nearest_batch_chunks);
+
+			for (int i = 0; i < RAYS_NUM; i += CHUNK_SIZE) {
+				BLI_bvhtree_find_nearest_batch(
+				        tree, &co[i], min_ii(CHUNK_SIZE, RAYS_NUM - i), &nearest[i], NULL, NULL);
+			}
+
+			TIMEIT_END(find_nearest_batch_chunks);
+		}
+		else {
+			TIMEIT_START(find_nearest_batch_threaded);
+
+			BLI_bvhtree_find_nearest_batch(tree, co, RAYS_NUM, nearest, NULL, NULL);
+
+			TIMEIT_END(find_nearest_batch_threaded);
+		}
+	}
+
+	printf("========== ENDED %s ==========\n\n", __func__);
+
+	BLI_bvhtree_free(tree);
+	MEM_freeN(tris);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+}
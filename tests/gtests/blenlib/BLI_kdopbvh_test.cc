@@ -6,9 +6,11 @@
 
 extern "C" {
 #include "BLI_compiler_attrs.h"
+#include "BLI_utildefines.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_rand.h"
 #include "BLI_math_vector.h"
+#include "BLI_math_geom.h"
 #include "MEM_guardedalloc.h"
 }
 
@@ -95,3 +97,155 @@ static void find_nearest_points_test(int points_len, float scale, int round, int
 TEST(kdopbvh, FindNearest_1)		{ find_nearest_points_test(1, 1.0, 1000, 1234); }
 TEST(kdopbvh, FindNearest_2)		{ find_nearest_points_test(2, 1.0, 1000, 123); }
 TEST(kdopbvh, FindNearest_500)		{ find_nearest_points_test(500, 1.0, 1000, 12); }
+
+/* -------------------------------------------------------------------- */
+/* Batched Queries
+ *
+ * Compare with the results of the single queries. */
+
+static void find_nearest_point_cb(void *userdata, int index, const float co[3], BVHTreeNearest *nearest)
+{
+	const float (*points)[3] = (const float (*)[3])userdata;
+	const float dist_sq = len_squared_v3v3(co, points[index]);
+
+	if (dist_sq < nearest->dist_sq) {
+		nearest->index = index;
+		nearest->dist_sq = dist_sq;
+		copy_v3_v3(nearest->co, points[index]);
+	}
+}
+
+static void find_nearest_batch_test(int points_len, int co_len, bool use_callback, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * co_len, __func__);
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * co_len, __func__);
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	for (int i = 0; i < co_len; i++) {
+		BLI_rng_get_float_unit_v3(rng, co[i]);
+		mul_v3_fl(co[i], BLI_rng_get_float(rng) * 2.0f);
+		nearest[i].index = -1;
+		nearest[i].dist_sq = FLT_MAX;
+	}
+
+	BLI_bvhtree_find_nearest_batch(
+	        tree, co, co_len, nearest,
+	        use_callback ? find_nearest_point_cb : NULL, points);
+
+	for (int i = 0; i < co_len; i++) {
+		BVHTreeNearest nearest_single;
+		nearest_single.index = -1;
+		nearest_single.dist_sq = FLT_MAX;
+		BLI_bvhtree_find_nearest(
+		        tree, co[i], &nearest_single,
+		        use_callback ? find_nearest_point_cb : NULL, points);
+
+		EXPECT_EQ(nearest[i].index, nearest_single.index);
+		EXPECT_EQ(nearest[i].dist_sq, nearest_single.dist_sq);
+		EXPECT_EQ_ARRAY(nearest[i].co, nearest_single.co, 3);
+	}
+
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+}
+
+static void ray_cast_tri_cb(void *userdata, int index, const BVHTreeRay *ray, BVHTreeRayHit *hit)
+{
+	const float (*tris)[3][3] = (const float (*)[3][3])userdata;
+	float dist;
+
+	if (isect_ray_tri_watertight_v3(ray->origin, ray->isect_precalc, UNPACK3(tris[index]), &dist, NULL) &&
+	    dist < hit->dist)
+	{
+		hit->index = index;
+		hit->dist = dist;
+		madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist);
+	}
+}
+
+static void ray_cast_batch_test(int tris_len, int rays_len, float radius, bool use_callback, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(tris_len, 0.0, 4, 8);
+
+	float (*tris)[3][3] = (float (*)[3][3])MEM_mallocN(sizeof(float[3][3]) * tris_len, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+	float (*dir)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+	BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * rays_len, __func__);
+
+	for (int i = 0; i < tris_len; i++) {
+		float center[3];
+		rng_v3_round(center, 3, rng, 1000, 1.0f);
+		for (int j = 0; j < 3; j++) {
+			rng_v3_round(tris[i][j], 3, rng, 1000, 0.1f);
+			add_v3_v3(tris[i][j], center);
+		}
+		BLI_bvhtree_insert(tree, i, &tris[i][0][0], 3);
+	}
+	BLI_bvhtree_balance(tree);
+
+	for (int i = 0; i < rays_len; i++) {
+		/* Rays from outside and inside the tree bounds, including axis aligned directions. */
+		BLI_rng_get_float_unit_v3(rng, co[i]);
+		mul_v3_fl(co[i], BLI_rng_get_float(rng) * 2.0f);
+		if (i % 10 == 0) {
+			zero_v3(dir[i]);
+			dir[i][i % 3] = (i % 20) ? 1.0f : -1.0f;
+		}
+		else {
+			BLI_rng_get_float_unit_v3(rng, dir[i]);
+		}
+		hits[i].index = -1;
+		hits[i].dist = BVH_RAYCAST_DIST_MAX;
+	}
+
+	BLI_bvhtree_ray_cast_batch(
+	        tree, co, dir, rays_len, radius, hits,
+	        use_callback ? ray_cast_tri_cb : NULL, tris, BVH_RAYCAST_DEFAULT);
+
+	int hits_num = 0;
+	for (int i = 0; i < rays_len; i++) {
+		BVHTreeRayHit hit_single;
+		hit_single.index = -1;
+		hit_single.dist = BVH_RAYCAST_DIST_MAX;
+		BLI_bvhtree_ray_cast_ex(
+		        tree, co[i], dir[i], radius, &hit_single,
+		        use_callback ? ray_cast_tri_cb : NULL, tris, BVH_RAYCAST_DEFAULT);
+
+		EXPECT_EQ(hits[i].index, hit_single.index);
+		EXPECT_EQ(hits[i].dist, hit_single.dist);
+		if (hit_single.index != -1) {
+			EXPECT_EQ_ARRAY(hits[i].co, hit_single.co, 3);
+			hits_num++;
+		}
+	}
+	/* Check the test isn't trivial. */
+	EXPECT_GT(hits_num, 0);
+	EXPECT_LT(hits_num, rays_len);
+
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(tris);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hits);
+}
+
+TEST(kdopbvh, FindNearestBatch_1)		{ find_nearest_batch_test(1, 10, false, 1234); }
+TEST(kdopbvh, FindNearestBatch_500)		{ find_nearest_batch_test(500, 2001, false, 12); }
+TEST(kdopbvh, FindNearestBatch_Callback)	{ find_nearest_batch_test(500, 2001, true, 123); }
+TEST(kdopbvh, RayCastBatch)				{ ray_cast_batch_test(500, 2001, 0.0f, false, 12); }
+TEST(kdopbvh, RayCastBatch_Callback)	{ ray_cast_batch_test(500, 2001, 0.0f, true, 123); }
+TEST(kdopbvh, RayCastBatch_Radius)		{ ray_cast_batch_test(500, 2001, 0.05f, true, 1234); }
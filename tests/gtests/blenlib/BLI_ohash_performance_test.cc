@@ -0,0 +1,219 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+#include "BLI_ressource_strings.h"
+
+#define GHASH_INTERNAL_API
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_ghash.h"
+#include "BLI_ohash.h"
+#include "BLI_rand.h"
+#include "BLI_string.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Compare GHash and OHash, with the same keys and the same hash callbacks.
+ * Both use the default number of buckets, so resizing is part of the insertion timings. */
+
+/* Run the longest tests! */
+//#define OHASH_RUN_BIG
+
+/* Thin wrappers so the same test code runs on both hash types. */
+struct GHashOps {
+	typedef GHash Hash;
+	typedef GHashIterator Iterator;
+	static const char *name() { return "GHash"; }
+	static Hash *create(GHashHashFP hashfp, GHashCmpFP cmpfp) { return BLI_ghash_new(hashfp, cmpfp, __func__); }
+	static void free(Hash *h) { BLI_ghash_free(h, NULL, NULL); }
+	static bool reinsert(Hash *h, void *key, void *val) { return BLI_ghash_reinsert(h, key, val, NULL, NULL); }
+	static void *lookup(Hash *h, const void *key) { return BLI_ghash_lookup(h, key); }
+	static unsigned int size(Hash *h) { return BLI_ghash_size(h); }
+	static void iter_init(Iterator *it, Hash *h) { BLI_ghashIterator_init(it, h); }
+	static void iter_step(Iterator *it) { BLI_ghashIterator_step(it); }
+	static bool iter_done(Iterator *it) { return BLI_ghashIterator_done(it); }
+	static void *iter_value(Iterator *it) { return BLI_ghashIterator_getValue(it); }
+};
+
+struct OHashOps {
+	typedef OHash Hash;
+	typedef OHashIterator Iterator;
+	static const char *name() { return "OHash"; }
+	static Hash *create(GHashHashFP hashfp, GHashCmpFP cmpfp) { return BLI_ohash_new(hashfp, cmpfp, __func__); }
+	static void free(Hash *h) { BLI_ohash_free(h, NULL, NULL); }
+	static bool reinsert(Hash *h, void *key, void *val) { return BLI_ohash_reinsert(h, key, val, NULL, NULL); }
+	static void *lookup(Hash *h, const void *key) { return BLI_ohash_lookup(h, key); }
+	static unsigned int size(Hash *h) { return BLI_ohash_size(h); }
+	static void iter_init(Iterator *it, Hash *h) { BLI_ohashIterator_init(it, h); }
+	static void iter_step(Iterator *it) { BLI_ohashIterator_step(it); }
+	static bool iter_done(Iterator *it) { return BLI_ohashIterator_done(it); }
+	static void *iter_value(Iterator *it) { return BLI_ohashIterator_getValue(it); }
+};
+
+/* Insert all keys, look them up, then iterate over all entries. */
+template<typename Ops>
+static void keys_hash_tests(
+        void **keys, const unsigned int nbr, GHashHashFP hashfp, GHashCmpFP cmpfp, const char *id)
+{
+	typename Ops::Hash *hash = Ops::create(hashfp, cmpfp);
+	unsigned int i;
+
+	printf("\n========== STARTING %s - %s - %u ==========\n", id, Ops::name(), nbr);
+
+	{
+		TIMEIT_START(insert);
+
+		for (i = 0; i < nbr; i++) {
+			Ops::reinsert(hash, keys[i], keys[i]);
+		}
+
+		TIMEIT_END(insert);
+	}
+
+	{
+		/* Lookup in a different order than insertion, otherwise GHash entries are read
+		 * sequentially from its memory pool, which is not what happens in real use. */
+		void **keys_lookup = (void **)MEM_dupallocN(keys);
+		BLI_array_randomize(keys_lookup, sizeof(*keys_lookup), nbr, 1);
+
+		TIMEIT_START(lookup);
+
+		for (i = 0; i < nbr; i++) {
+			/* Values are the keys, duplicated keys have the value of their last insertion. */
+			void *v = Ops::lookup(hash, keys_lookup[i]);
+			EXPECT_FALSE(cmpfp(v, keys_lookup[i]));
+		}
+
+		TIMEIT_END(lookup);
+
+		MEM_freeN(keys_lookup);
+	}
+
+	{
+		typename Ops::Iterator it;
+		unsigned int count = 0;
+
+		TIMEIT_START(iterate);
+
+		for (Ops::iter_init(&it, hash); !Ops::iter_done(&it); Ops::iter_step(&it)) {
+			if (Ops::iter_value(&it)) {
+				count++;
+			}
+		}
+
+		TIMEIT_END(iterate);
+
+		EXPECT_EQ(count, Ops::size(hash));
+	}
+
+	Ops::free(hash);
+
+	printf("========== ENDED %s - %s - %u ==========\n\n", id, Ops::name(), nbr);
+}
+
+/* Ptr: addresses of the elements of an array, like most pointer maps in Blender. */
+
+static void ptr_hash_tests(const unsigned int nbr)
+{
+	char *data = (char *)MEM_mallocN(sizeof(*data) * 64 * (size_t)nbr, __func__);
+	void **keys = (void **)MEM_mallocN(sizeof(*keys) * (size_t)nbr, __func__);
+	unsigned int i;
+
+	for (i = 0; i < nbr; i++) {
+		keys[i] = &data[64 * (size_t)i];
+	}
+	BLI_array_randomize(keys, sizeof(*keys), nbr, 0);
+
+	keys_hash_tests<GHashOps>(keys, nbr, BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, "PtrHash");
+	keys_hash_tests<OHashOps>(keys, nbr, BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, "PtrHash");
+
+	MEM_freeN(keys);
+	MEM_freeN(data);
+}
+
+TEST(ohash, PtrHash1000)
+{
+	ptr_hash_tests(1000);
+}
+
+TEST(ohash, PtrHash100000)
+{
+	ptr_hash_tests(100000);
+}
+
+TEST(ohash, PtrHash1000000)
+{
+	ptr_hash_tests(1000000);
+}
+
+#ifdef OHASH_RUN_BIG
+TEST(ohash, PtrHash10000000)
+{
+	ptr_hash_tests(10000000);
+}
+#endif
+
+/* Str: the words of a text, with duplicates. */
+
+static void str_hash_tests(const unsigned int nbr)
+{
+	/* Each word is prefixed by the number of the copy of the text it comes from (up to 11 chars). */
+	const size_t words_len = strlen(words10k);
+	const size_t data_len = (words_len + 1) * ((nbr / 1000) + 1) + (size_t)nbr * 12;
+	char *data = (char *)MEM_mallocN(sizeof(*data) * data_len, __func__);
+	void **keys = (void **)MEM_mallocN(sizeof(*keys) * (size_t)nbr, __func__);
+	unsigned int i = 0, copy = 0;
+	char *c = data;
+
+	/* Repeat the text until there are enough words. */
+	while (i < nbr) {
+		const char *w = words10k;
+
+		while (i < nbr) {
+			while (ELEM(*w, ' ', '.')) {
+				w++;
+			}
+			if (*w == '\0') {
+				break;
+			}
+
+			keys[i++] = c;
+			c += sprintf(c, "%u_", copy);
+			while (*w && !ELEM(*w, ' ', '.')) {
+				*c++ = *w++;
+			}
+			*c++ = '\0';
+		}
+		copy++;
+	}
+
+	keys_hash_tests<GHashOps>(keys, nbr, BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, "StrHash");
+	keys_hash_tests<OHashOps>(keys, nbr, BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, "StrHash");
+
+	MEM_freeN(keys);
+	MEM_freeN(data);
+}
+
+TEST(ohash, StrHash1000)
+{
+	str_hash_tests(1000);
+}
+
+TEST(ohash, StrHash100000)
+{
+	str_hash_tests(100000);
+}
+
+TEST(ohash, StrHash1000000)
+{
+	str_hash_tests(1000000);
+}
+
+#ifdef OHASH_RUN_BIG
+TEST(ohash, StrHash10000000)
+{
+	str_hash_tests(10000000);
+}
+#endif
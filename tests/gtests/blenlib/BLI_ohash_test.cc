@@ -0,0 +1,200 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#define GHASH_INTERNAL_API
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_ohash.h"
+#include "BLI_rand.h"
+}
+
+#define TESTCASE_SIZE 10000
+
+/* Note: as for GHash tests, nature of the keys and data have no importance here,
+ *       we just use random integers stored in pointers. */
+
+static void init_keys(unsigned int keys[TESTCASE_SIZE], const int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	unsigned int *k;
+	int i;
+
+	for (i = 0, k = keys; i < TESTCASE_SIZE; ) {
+		/* Risks of collision are low, but they do exist. */
+		int j, t = BLI_rng_get_uint(rng);
+		for (j = i; j--; ) {
+			if (keys[j] == t) {
+				continue;
+			}
+		}
+		*k = t;
+		i++;
+		k++;
+	}
+	BLI_rng_free(rng);
+}
+
+/* All keys hash to a few values, to test long probe sequences. */
+static unsigned int ohash_tests_badhash_p(const void *p)
+{
+	return GET_UINT_FROM_POINTER(p) % 7;
+}
+
+/* Here we simply insert and then lookup all keys, ensuring we do get back the expected stored 'data'. */
+TEST(ohash, InsertLookup)
+{
+	OHash *ohash = BLI_ohash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_ohash_size(ohash), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Insert and then remove all keys, ensuring we do get an empty ohash. */
+TEST(ohash, InsertRemove)
+{
+	OHash *ohash = BLI_ohash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 10);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_ohash_size(ohash), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		/* Check removing keys doesn't break the probe sequence of the remaining ones. */
+		if (i % 2) {
+			void *v = BLI_ohash_popkey(ohash, SET_UINT_IN_POINTER(*k), NULL);
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+		}
+	}
+
+	EXPECT_EQ(BLI_ohash_size(ohash), TESTCASE_SIZE / 2);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		if ((i % 2) == 0) {
+			EXPECT_TRUE(BLI_ohash_remove(ohash, SET_UINT_IN_POINTER(*k), NULL, NULL));
+		}
+		else {
+			EXPECT_FALSE(BLI_ohash_haskey(ohash, SET_UINT_IN_POINTER(*k)));
+		}
+	}
+
+	EXPECT_EQ(BLI_ohash_size(ohash), 0);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Same as above with a bad hash function, all keys end up in a few long probe sequences. */
+TEST(ohash, InsertRemoveBadHash)
+{
+	OHash *ohash = BLI_ohash_new(ohash_tests_badhash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 20);
+
+	for (i = TESTCASE_SIZE / 10, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	for (i = TESTCASE_SIZE / 10, k = keys; i--; k++) {
+		if (i % 3) {
+			EXPECT_TRUE(BLI_ohash_remove(ohash, SET_UINT_IN_POINTER(*k), NULL, NULL));
+		}
+	}
+
+	for (i = TESTCASE_SIZE / 10, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), (i % 3) ? 0 : *k);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Check ensure_p and reinsert. */
+TEST(ohash, EnsureReinsert)
+{
+	OHash *ohash = BLI_ohash_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 30);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void **val_p;
+		EXPECT_FALSE(BLI_ohash_ensure_p(ohash, SET_UINT_IN_POINTER(*k), &val_p));
+		*val_p = SET_UINT_IN_POINTER(*k);
+	}
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void **val_p;
+		EXPECT_TRUE(BLI_ohash_ensure_p(ohash, SET_UINT_IN_POINTER(*k), &val_p));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(*val_p), *k);
+		EXPECT_FALSE(BLI_ohash_reinsert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k + 1), NULL, NULL));
+	}
+
+	EXPECT_EQ(BLI_ohash_size(ohash), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k + 1);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Check iteration visits every entry once, and clear. */
+TEST(ohash, IterClear)
+{
+	OHash *ohash = BLI_ohash_int_new(__func__);
+	OHashIterator ohi;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i, bkt_size;
+
+	init_keys(keys, 40);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	i = 0;
+	OHASH_ITER (ohi, ohash) {
+		EXPECT_EQ(BLI_ohashIterator_getKey(&ohi), BLI_ohashIterator_getValue(&ohi));
+		i++;
+	}
+	EXPECT_EQ(i, TESTCASE_SIZE);
+
+	bkt_size = BLI_ohash_buckets_size(ohash);
+	BLI_ohash_clear_ex(ohash, NULL, NULL, TESTCASE_SIZE);
+	EXPECT_EQ(BLI_ohash_size(ohash), 0);
+	EXPECT_EQ(BLI_ohash_buckets_size(ohash), bkt_size);
+
+	BLI_ohash_clear(ohash, NULL, NULL);
+	EXPECT_LT(BLI_ohash_buckets_size(ohash), bkt_size);
+
+	OHASH_ITER (ohi, ohash) {
+		ADD_FAILURE();
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
@@ -0,0 +1,84 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "atomic_ops.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Number of tiny tasks pushed to the pool for every measurement. */
+#define NUM_TASKS 10000
+
+/* Number of measurements per thread count. */
+#define NUM_RUNS 50
+
+static void task_tiny_func(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	uint32_t *count = (uint32_t *)BLI_task_pool_userdata(pool);
+	atomic_add_and_fetch_uint32(count, 1);
+}
+
+static void task_push_wait_test(int num_threads, bool background)
+{
+	TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads);
+	uint32_t count = 0;
+
+	printf("\n========== STARTING %s ==========\n", __func__);
+	printf("%d threads, %s pool\n", BLI_task_scheduler_num_threads(scheduler), background ? "background" : "regular");
+
+	TIMEIT_START_AVERAGED(push_wait);
+	for (int run = 0; run < NUM_RUNS; run++) {
+		TaskPool *pool = background ? BLI_task_pool_create_background(scheduler, &count) :
+		                              BLI_task_pool_create(scheduler, &count);
+
+		for (int i = 0; i < NUM_TASKS; i++) {
+			BLI_task_pool_push(pool, task_tiny_func, NULL, false,
+			                   (i % 2) ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW);
+		}
+		BLI_task_pool_work_and_wait(pool);
+
+		BLI_task_pool_free(pool);
+	}
+	TIMEIT_END_AVERAGED(push_wait);
+
+	EXPECT_EQ(count, NUM_TASKS * NUM_RUNS);
+
+	BLI_task_scheduler_free(scheduler);
+
+	printf("========== ENDED %s ==========\n\n", __func__);
+}
+
+TEST(task, PushWait1Thread)
+{
+	task_push_wait_test(1, false);
+}
+
+TEST(task, PushWait2Threads)
+{
+	task_push_wait_test(2, false);
+}
+
+TEST(task, PushWait4Threads)
+{
+	task_push_wait_test(4, false);
+}
+
+TEST(task, PushWait8Threads)
+{
+	task_push_wait_test(8, false);
+}
+
+TEST(task, PushWaitAllThreads)
+{
+	task_push_wait_test(0, false);
+}
+
+TEST(task, PushWaitBackgroundAllThreads)
+{
+	task_push_wait_test(0, true);
+}
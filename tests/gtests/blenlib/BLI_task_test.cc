@@ -74,3 +74,64 @@ TEST(task, MempoolIter)
 
 	BLI_mempool_destroy(mempool);
 }
+
+static void task_pool_nested_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	uint32_t *count = (uint32_t *)BLI_task_pool_userdata(pool);
+	intptr_t depth = (intptr_t)taskdata;
+
+	atomic_add_and_fetch_uint32(count, 1);
+
+	if (depth > 0) {
+		for (int i = 0; i < 4; i++) {
+			BLI_task_pool_push_from_thread(pool, task_pool_nested_func, (void *)(depth - 1), false,
+			                               TASK_PRIORITY_HIGH, threadid);
+		}
+	}
+}
+
+TEST(task, PoolPushWait)
+{
+	/* One thread uses the background only worker, others steal tasks between their queues. */
+	for (int num_threads = 1; num_threads <= 4; num_threads++) {
+		TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads);
+		uint32_t count = 0;
+
+		TaskPool *pool = BLI_task_pool_create(scheduler, &count);
+		for (int i = 0; i < NUM_ITEMS; i++) {
+			BLI_task_pool_push(pool, task_pool_nested_func, NULL, false,
+			                   (i % 2) ? TASK_PRIORITY_HIGH : TASK_PRIORITY_LOW);
+		}
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+		EXPECT_EQ(count, NUM_ITEMS);
+
+		/* 1 + 4 + 16 + 64 + 256 + 1024 tasks pushed from within tasks. */
+		count = 0;
+		pool = BLI_task_pool_create(scheduler, &count);
+		BLI_task_pool_push(pool, task_pool_nested_func, (void *)5, false, TASK_PRIORITY_LOW);
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+		EXPECT_EQ(count, 1365);
+
+		count = 0;
+		pool = BLI_task_pool_create_background(scheduler, &count);
+		for (int i = 0; i < NUM_ITEMS; i++) {
+			BLI_task_pool_push(pool, task_pool_nested_func, NULL, false, TASK_PRIORITY_LOW);
+		}
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+		EXPECT_EQ(count, NUM_ITEMS);
+
+		count = 0;
+		pool = BLI_task_pool_create_suspended(scheduler, &count);
+		for (int i = 0; i < NUM_ITEMS; i++) {
+			BLI_task_pool_push(pool, task_pool_nested_func, NULL, false, TASK_PRIORITY_LOW);
+		}
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+		EXPECT_EQ(count, NUM_ITEMS);
+
+		BLI_task_scheduler_free(scheduler);
+	}
+}
@@ -0,0 +1,162 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "COM_MixOperation.h"
+#include "COM_ColorBalanceLGGOperation.h"
+#include "COM_ColorBalanceASCCDLOperation.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_rand.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Compare the per pixel path of the compositor operations with the row path,
+ * used by the write buffer operations, on a 4K frame. */
+
+#define WIDTH 3840
+#define HEIGHT 2160
+
+/* Input reading a buffer in memory, like ReadBufferOperation. */
+class BufferInputOperation : public NodeOperation {
+private:
+	const float *m_buffer;
+
+public:
+	BufferInputOperation(const float *buffer) : NodeOperation(), m_buffer(buffer)
+	{
+		this->addOutputSocket(COM_DT_COLOR);
+		this->setWidth(WIDTH);
+		this->setHeight(HEIGHT);
+	}
+
+	void executePixelSampled(float output[4], float x, float y, PixelSampler /*sampler*/)
+	{
+		copy_v4_v4(output, &this->m_buffer[((int)y * WIDTH + (int)x) * 4]);
+	}
+
+	void executeRow(float *output, int x, int y, int width)
+	{
+		memcpy(output, &this->m_buffer[(y * WIDTH + x) * 4], sizeof(float) * 4 * width);
+	}
+};
+
+static float *buffer_create(RNG *rng, float min, float max)
+{
+	float *buffer = (float *)MEM_mallocN(sizeof(float) * 4 * WIDTH * HEIGHT, __func__);
+	for (int i = 0; i < WIDTH * HEIGHT * 4; i++) {
+		buffer[i] = min + (max - min) * BLI_rng_get_float(rng);
+	}
+	return buffer;
+}
+
+static void operation_test(const char *name, NodeOperation *operation, int inputs_num)
+{
+	RNG *rng = BLI_rng_new(0);
+	float *inputs[3];
+	BufferInputOperation *input_operations[3];
+
+	for (int i = 0; i < inputs_num; i++) {
+		/* Factors between 0 and 1, colors out of the display range too. */
+		inputs[i] = (i == 0) ? buffer_create(rng, 0.0f, 1.0f) : buffer_create(rng, -0.2f, 1.5f);
+		input_operations[i] = new BufferInputOperation(inputs[i]);
+		operation->getInputSocket(i)->setLink(input_operations[i]->getOutputSocket());
+	}
+
+	float *output_pixel = (float *)MEM_mallocN(sizeof(float) * 4 * WIDTH * HEIGHT, __func__);
+	float *output_row = (float *)MEM_mallocN(sizeof(float) * 4 * WIDTH * HEIGHT, __func__);
+	/* Not timing the first writes to the pages. */
+	memset(output_pixel, 0, sizeof(float) * 4 * WIDTH * HEIGHT);
+	memset(output_row, 0, sizeof(float) * 4 * WIDTH * HEIGHT);
+
+	printf("\n========== STARTING %s ==========\n", name);
+
+	operation->initExecution();
+
+	{
+		TIMEIT_START(pixel);
+
+		for (int y = 0; y < HEIGHT; y++) {
+			for (int x = 0; x < WIDTH; x++) {
+				operation->readSampled(&output_pixel[(y * WIDTH + x) * 4], x, y, COM_PS_NEAREST);
+			}
+		}
+
+		TIMEIT_END(pixel);
+	}
+
+	{
+		TIMEIT_START(row);
+
+		for (int y = 0; y < HEIGHT; y++) {
+			for (int x = 0; x < WIDTH; x += COM_ROW_SIZE) {
+				operation->readRow(&output_row[(y * WIDTH + x) * 4], x, y, min_ii(COM_ROW_SIZE, WIDTH - x));
+			}
+		}
+
+		TIMEIT_END(row);
+	}
+
+	operation->deinitExecution();
+
+	float max_diff = 0.0f;
+	for (int i = 0; i < WIDTH * HEIGHT * 4; i++) {
+		max_diff = max_ff(max_diff, fabsf(output_pixel[i] - output_row[i]));
+	}
+	EXPECT_LT(max_diff, 1e-6f);
+
+	printf("========== ENDED %s ==========\n\n", name);
+
+	for (int i = 0; i < inputs_num; i++) {
+		delete input_operations[i];
+		MEM_freeN(inputs[i]);
+	}
+	delete operation;
+	MEM_freeN(output_pixel);
+	MEM_freeN(output_row);
+	BLI_rng_free(rng);
+}
+
+TEST(compositor, MixBlend)
+{
+	MixBlendOperation *operation = new MixBlendOperation();
+	operation->setUseValueAlphaMultiply(true);
+	operation_test("mix blend", operation, 3);
+}
+
+TEST(compositor, MixMultiply)
+{
+	MixMultiplyOperation *operation = new MixMultiplyOperation();
+	operation->setUseClamp(true);
+	operation_test("mix multiply clamped", operation, 3);
+}
+
+TEST(compositor, MixScreen)
+{
+	operation_test("mix screen", new MixScreenOperation(), 3);
+}
+
+TEST(compositor, ColorBalanceLGG)
+{
+	const float lift[3] = {0.9f, 1.0f, 1.1f};
+	const float gamma_inv[3] = {1.0f / 1.2f, 1.0f, 1.0f / 0.8f};
+	const float gain[3] = {1.1f, 0.9f, 1.0f};
+	ColorBalanceLGGOperation *operation = new ColorBalanceLGGOperation();
+	operation->setLift(lift);
+	operation->setGammaInv(gamma_inv);
+	operation->setGain(gain);
+	operation_test("color balance lift gamma gain", operation, 2);
+}
+
+TEST(compositor, ColorBalanceASCCDL)
+{
+	float offset[3] = {0.05f, 0.0f, -0.05f};
+	float power[3] = {1.2f, 1.0f, 0.8f};
+	float slope[3] = {1.1f, 0.9f, 1.0f};
+	ColorBalanceASCCDLOperation *operation = new ColorBalanceASCCDLOperation();
+	operation->setOffset(offset);
+	operation->setPower(power);
+	operation->setSlope(slope);
+	operation_test("color balance ASC CDL", operation, 2);
+}
@@ -0,0 +1,178 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "DEV_InputRecorder.h"
+
+#include <sstream>
+#include <cstring>
+
+/* CM_Message.cpp needs the logic bricks, only the prefixes used by the recorder are defined. */
+std::ostream& _CM_PrefixWarning(std::ostream& stream)
+{
+	return stream << "Warning: ";
+}
+
+std::ostream& _CM_PrefixError(std::ostream& stream)
+{
+	return stream << "Error: ";
+}
+
+#define FRAMES_NUM 20
+
+static DEV_InputRecorder::JoystickState joystick_state(bool connected, int axis, unsigned int buttons)
+{
+	DEV_InputRecorder::JoystickState state;
+	memset(&state, 0, sizeof(state));
+	state.m_connected = connected;
+	for (int i = 0; i < JOYAXIS_MAX; ++i) {
+		state.m_axes[i] = axis * (i + 1);
+	}
+	state.m_buttons = buttons;
+	return state;
+}
+
+static void expect_joystick_eq(const DEV_InputRecorder::JoystickState& a, DEV_InputRecorder::JoystickState b)
+{
+	EXPECT_EQ(a.m_connected, b.m_connected);
+	EXPECT_EQ_ARRAY(a.m_axes, b.m_axes, JOYAXIS_MAX);
+	EXPECT_EQ(a.m_buttons, b.m_buttons);
+}
+
+/* The state of the joysticks at each frame of the record. */
+static DEV_InputRecorder::JoystickState frame_joystick(int frame, int index)
+{
+	if (index == 0) {
+		/* Connected from the third frame to the disconnection, moving every 4 frames. */
+		if (frame < 2 || frame >= 15) {
+			return joystick_state(false, 0, 0);
+		}
+		return joystick_state(true, (frame / 4) * 1000 - 2000, (frame % 3 == 0) ? (1u << 11) | 1u : 0);
+	}
+	if (index == 3) {
+		/* Connected all along, only the buttons and the hat (D-pad buttons) change. */
+		return joystick_state(true, -32768, 1u << (frame % JOYBUT_MAX));
+	}
+	return joystick_state(false, 0, 0);
+}
+
+static void record_frame(DEV_InputRecorder& recorder, int frame)
+{
+	for (int i = 0; i < JOYINDEX_MAX; ++i) {
+		recorder.RecordJoystick(i, frame_joystick(frame, i));
+	}
+
+	if (frame % 2 == 0) {
+		recorder.AddEvent(DEV_InputRecorder::EVENT_INPUT, 10 + frame, 1, 'a' + frame);
+	}
+	if (frame % 5 == 0) {
+		recorder.AddEvent(DEV_InputRecorder::EVENT_MOVE, 0, frame * 3, frame * 7);
+		recorder.AddEvent(DEV_InputRecorder::EVENT_WHEEL, 0, -frame, 0);
+	}
+}
+
+TEST(input_recorder, RoundTrip)
+{
+	DEV_InputRecorder recorder;
+	recorder.StartRecording();
+	EXPECT_EQ(recorder.GetMode(), DEV_InputRecorder::MODE_RECORD);
+
+	for (int frame = 0; frame < FRAMES_NUM; ++frame) {
+		record_frame(recorder, frame);
+		recorder.NextFrame();
+	}
+
+	std::stringstream stream;
+	EXPECT_TRUE(recorder.WriteRecord(stream));
+
+	DEV_InputRecorder replay;
+	EXPECT_TRUE(replay.StartReplay(stream));
+	EXPECT_EQ(replay.GetMode(), DEV_InputRecorder::MODE_REPLAY);
+
+	/* The recording of each frame is done again to compare the events. */
+	DEV_InputRecorder expected;
+	expected.StartRecording();
+
+	for (int frame = 0; frame < FRAMES_NUM; ++frame) {
+		EXPECT_FALSE(replay.IsReplayFinished());
+
+		replay.ReplayJoysticks();
+		for (int i = 0; i < JOYINDEX_MAX; ++i) {
+			expect_joystick_eq(replay.GetJoystickState(i), frame_joystick(frame, i));
+		}
+
+		std::stringstream expectedFrame;
+		expected.StartRecording();
+		record_frame(expected, frame);
+		expected.WriteRecord(expectedFrame);
+
+		DEV_InputRecorder frameEvents;
+		EXPECT_TRUE(frameEvents.StartReplay(expectedFrame));
+
+		DEV_InputRecorder::Event event, expectedEvent;
+		while (replay.NextReplayEvent(event)) {
+			EXPECT_TRUE(frameEvents.NextReplayEvent(expectedEvent));
+			EXPECT_EQ(event.m_frame, frame);
+			EXPECT_EQ(event.m_type, expectedEvent.m_type);
+			EXPECT_EQ(event.m_input, expectedEvent.m_input);
+			EXPECT_EQ(event.m_value, expectedEvent.m_value);
+			EXPECT_EQ(event.m_data, expectedEvent.m_data);
+		}
+		EXPECT_FALSE(frameEvents.NextReplayEvent(expectedEvent));
+
+		replay.NextFrame();
+	}
+
+	EXPECT_TRUE(replay.IsReplayFinished());
+}
+
+TEST(input_recorder, JoystickChangesOnly)
+{
+	/* A joystick keeping the same state is only recorded at its connection. */
+	const DEV_InputRecorder::JoystickState state = joystick_state(true, 1234, 5);
+	std::stringstream records[2];
+
+	for (int i = 0; i < 2; ++i) {
+		DEV_InputRecorder recorder;
+		recorder.StartRecording();
+		for (int frame = 0; frame < ((i == 0) ? 1 : 100); ++frame) {
+			recorder.RecordJoystick(2, state);
+			recorder.NextFrame();
+		}
+		recorder.WriteRecord(records[i]);
+	}
+
+	/* Only the number of frames differs. */
+	EXPECT_EQ(records[0].str().size(), records[1].str().size());
+
+	DEV_InputRecorder replay;
+	EXPECT_TRUE(replay.StartReplay(records[1]));
+	for (int frame = 0; frame < 100; ++frame) {
+		replay.ReplayJoysticks();
+		expect_joystick_eq(replay.GetJoystickState(2), state);
+		replay.NextFrame();
+	}
+	EXPECT_TRUE(replay.IsReplayFinished());
+}
+
+TEST(input_recorder, InvalidRecord)
+{
+	DEV_InputRecorder replay;
+
+	std::stringstream garbage("not an input record, not an input record");
+	EXPECT_FALSE(replay.StartReplay(garbage));
+	EXPECT_EQ(replay.GetMode(), DEV_InputRecorder::MODE_NONE);
+
+	DEV_InputRecorder recorder;
+	recorder.StartRecording();
+	record_frame(recorder, 0);
+	recorder.NextFrame();
+
+	std::stringstream stream;
+	recorder.WriteRecord(stream);
+	const std::string record = stream.str();
+
+	std::stringstream truncated(record.substr(0, record.size() - 1));
+	EXPECT_FALSE(replay.StartReplay(truncated));
+	EXPECT_EQ(replay.GetMode(), DEV_InputRecorder::MODE_NONE);
+}
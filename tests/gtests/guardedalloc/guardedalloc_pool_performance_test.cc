@@ -0,0 +1,302 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+/* Compare the lock-free allocator with the pool allocator, by replaying the same
+ * allocation traces with both.
+ *
+ * By default a trace modeled on a game engine frame is generated: many small
+ * blocks freed by the end of the frame, and longer lived objects replaced every
+ * now and then. A trace captured from a real session can be replayed instead,
+ * as a text file with one "m <id> <len>" or "f <id>" line per allocation and free,
+ * where the id is the hexadecimal address of the block. Blender writes such a trace
+ * when started with the MEM_POOL_TRACE environment variable set to the file path. */
+
+/* Replay a captured trace. */
+//#define TRACE_PATH "/path/to/trace.txt"
+
+#define TRACE_FRAMES 2000
+#define TRACE_FRAME_BLOCKS 500
+#define TRACE_LIVE_BLOCKS 5000
+#define TRACE_THREADS 4
+
+/* A free when len is zero. */
+struct TraceOp {
+	unsigned int slot;
+	unsigned int len;
+};
+
+struct Trace {
+	std::vector<TraceOp> ops;
+	unsigned int num_slots;
+};
+
+/* Small deterministic generator, so traces don't depend on the allocator being tested. */
+static unsigned int trace_rand(unsigned int *seed)
+{
+	*seed = *seed * 1103515245u + 12345u;
+	return *seed >> 8;
+}
+
+static unsigned int trace_rand_len(unsigned int *seed)
+{
+	const unsigned int r = trace_rand(seed) % 100;
+	if (r < 70) {
+		return 8 + trace_rand(seed) % 56;
+	}
+	else if (r < 95) {
+		return 64 + trace_rand(seed) % 192;
+	}
+	return 256 + trace_rand(seed) % 4096;
+}
+
+static void trace_generate(Trace *trace, unsigned int seed)
+{
+	std::vector<unsigned int> frame_slots;
+	unsigned int frame, i;
+
+	trace->ops.clear();
+	trace->num_slots = TRACE_LIVE_BLOCKS + TRACE_FRAME_BLOCKS;
+
+	/* Objects living for the whole session. */
+	for (i = 0; i < TRACE_LIVE_BLOCKS; i++) {
+		trace->ops.push_back({i, trace_rand_len(&seed)});
+	}
+
+	for (frame = 0; frame < TRACE_FRAMES; frame++) {
+		/* Temporary blocks, freed in a different order than allocated. */
+		frame_slots.clear();
+		for (i = 0; i < TRACE_FRAME_BLOCKS; i++) {
+			const unsigned int slot = TRACE_LIVE_BLOCKS + i;
+			trace->ops.push_back({slot, trace_rand_len(&seed)});
+			frame_slots.push_back(slot);
+
+			/* Some blocks don't even last until the end of the frame. */
+			if (trace_rand(&seed) % 4 == 0) {
+				const unsigned int index = trace_rand(&seed) % (unsigned int)frame_slots.size();
+				trace->ops.push_back({frame_slots[index], 0});
+				frame_slots[index] = frame_slots.back();
+				frame_slots.pop_back();
+			}
+		}
+
+		/* Objects added and removed. */
+		for (i = 0; i < TRACE_FRAME_BLOCKS / 20; i++) {
+			const unsigned int slot = trace_rand(&seed) % TRACE_LIVE_BLOCKS;
+			trace->ops.push_back({slot, 0});
+			trace->ops.push_back({slot, trace_rand_len(&seed)});
+		}
+
+		while (!frame_slots.empty()) {
+			const unsigned int index = trace_rand(&seed) % (unsigned int)frame_slots.size();
+			trace->ops.push_back({frame_slots[index], 0});
+			frame_slots[index] = frame_slots.back();
+			frame_slots.pop_back();
+		}
+	}
+
+	for (i = 0; i < TRACE_LIVE_BLOCKS; i++) {
+		trace->ops.push_back({i, 0});
+	}
+}
+
+#ifdef TRACE_PATH
+static bool trace_read(Trace *trace, const char *filepath)
+{
+	FILE *file = fopen(filepath, "r");
+	std::map<unsigned long long, unsigned int> id_slots;
+	std::vector<unsigned int> free_slots;
+	char type;
+	unsigned long long id;
+	unsigned long len;
+
+	if (file == NULL) {
+		return false;
+	}
+
+	trace->ops.clear();
+	trace->num_slots = 0;
+
+	/* Map the ids to slots, which are reused once freed. */
+	while (fscanf(file, " %c %llx", &type, &id) == 2) {
+		if (type == 'm' && fscanf(file, " %lu", &len) == 1) {
+			unsigned int slot;
+			if (free_slots.empty()) {
+				slot = trace->num_slots++;
+			}
+			else {
+				slot = free_slots.back();
+				free_slots.pop_back();
+			}
+			id_slots[id] = slot;
+			trace->ops.push_back({slot, len ? (unsigned int)len : 1u});
+		}
+		else if (type == 'f' && id_slots.count(id)) {
+			const unsigned int slot = id_slots[id];
+			id_slots.erase(id);
+			free_slots.push_back(slot);
+			trace->ops.push_back({slot, 0});
+		}
+	}
+	fclose(file);
+
+	/* Blocks still in use at the end of the capture. */
+	for (std::map<unsigned long long, unsigned int>::iterator it = id_slots.begin(); it != id_slots.end(); ++it) {
+		trace->ops.push_back({it->second, 0});
+	}
+
+	return !trace->ops.empty();
+}
+#endif
+
+static void trace_replay(const Trace *trace)
+{
+	std::vector<void *> slots(trace->num_slots, NULL);
+
+	for (size_t i = 0; i < trace->ops.size(); i++) {
+		const TraceOp &op = trace->ops[i];
+		if (op.len) {
+			char *mem = (char *)MEM_mallocN(op.len, __func__);
+			/* Touch the memory like the caller would. */
+			mem[0] = 1;
+			slots[op.slot] = mem;
+		}
+		else {
+			MEM_freeN(slots[op.slot]);
+		}
+	}
+}
+
+/* Blocks allocated by one thread and freed by another, like task pool results. */
+static void producer_consumer(const Trace *trace)
+{
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::vector<void *> > batches;
+	bool done = false;
+
+	std::thread consumer([&]() {
+		for (;;) {
+			std::vector<void *> batch;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]() { return done || !batches.empty(); });
+				if (batches.empty()) {
+					break;
+				}
+				batch.swap(batches.front());
+				batches.pop_front();
+			}
+			for (size_t i = 0; i < batch.size(); i++) {
+				MEM_freeN(batch[i]);
+			}
+		}
+	});
+
+	std::vector<void *> batch;
+	for (size_t i = 0; i < trace->ops.size(); i++) {
+		const TraceOp &op = trace->ops[i];
+		if (op.len) {
+			char *mem = (char *)MEM_mallocN(op.len, __func__);
+			mem[0] = 1;
+			batch.push_back(mem);
+		}
+		if (batch.size() == TRACE_FRAME_BLOCKS) {
+			std::unique_lock<std::mutex> lock(mutex);
+			batches.push_back(std::vector<void *>());
+			batches.back().swap(batch);
+			condition.notify_one();
+		}
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		batches.push_back(std::vector<void *>());
+		batches.back().swap(batch);
+		done = true;
+		condition.notify_one();
+	}
+	consumer.join();
+}
+
+static void trace_tests(const std::vector<Trace> &traces, const char *id)
+{
+	const size_t mem_in_use = MEM_get_memory_in_use();
+
+	printf("\n========== STARTING %s ==========\n", id);
+
+	{
+		TIMEIT_START(replay);
+
+		trace_replay(&traces[0]);
+
+		TIMEIT_END(replay);
+	}
+
+	{
+		std::vector<std::thread> threads;
+
+		TIMEIT_START(replay_threaded);
+
+		for (size_t i = 0; i < traces.size(); i++) {
+			threads.push_back(std::thread(trace_replay, &traces[i]));
+		}
+		for (size_t i = 0; i < threads.size(); i++) {
+			threads[i].join();
+		}
+
+		TIMEIT_END(replay_threaded);
+	}
+
+	{
+		TIMEIT_START(producer_consumer);
+
+		producer_consumer(&traces[0]);
+
+		TIMEIT_END(producer_consumer);
+	}
+
+	MEM_printmemlist_stats();
+
+	EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(guardedalloc, PoolTraceReplay)
+{
+	std::vector<Trace> traces(TRACE_THREADS);
+
+#ifdef TRACE_PATH
+	ASSERT_TRUE(trace_read(&traces[0], TRACE_PATH));
+	for (size_t i = 1; i < traces.size(); i++) {
+		traces[i] = traces[0];
+	}
+#else
+	for (size_t i = 0; i < traces.size(); i++) {
+		trace_generate(&traces[i], (unsigned int)i + 1);
+	}
+#endif
+
+	/* The allocator can't be switched back, so compare within a single test. */
+	trace_tests(traces, "Lock-free allocator");
+
+	MEM_use_pool_allocator();
+	trace_tests(traces, "Pool allocator");
+}
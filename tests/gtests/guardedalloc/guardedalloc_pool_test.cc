@@ -0,0 +1,180 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "BLI_utildefines.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#define CHECK_ALIGNMENT(ptr, align) EXPECT_EQ((size_t)ptr % align, 0)
+
+/* Lengths below and above the largest block kept in the thread caches. */
+static const size_t test_lengths[] = {0, 1, 4, 15, 16, 17, 100, 511, 512, 513, 4096};
+
+namespace {
+
+void AllocBlocks(std::vector<void *> &blocks, size_t num)
+{
+	for (size_t i = 0; i < num; i++) {
+		const size_t len = test_lengths[i % ARRAY_SIZE(test_lengths)];
+		char *mem = (char *)MEM_mallocN(len, "AllocBlocks");
+		memset(mem, (int)i, len);
+		blocks.push_back(mem);
+	}
+}
+
+void FreeBlocks(std::vector<void *> &blocks)
+{
+	for (size_t i = 0; i < blocks.size(); i++) {
+		MEM_freeN(blocks[i]);
+	}
+	blocks.clear();
+}
+
+}  // namespace
+
+TEST(guardedalloc, PoolAccounting)
+{
+	MEM_use_pool_allocator();
+
+	const size_t mem_in_use = MEM_get_memory_in_use();
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	size_t total_len = 0;
+	std::vector<void *> blocks;
+
+	for (size_t i = 0; i < ARRAY_SIZE(test_lengths); i++) {
+		const size_t len = test_lengths[i];
+		void *mem = MEM_callocN(len, "PoolAccounting");
+		EXPECT_EQ(MEM_allocN_len(mem), (len + 3) & ~(size_t)3);
+		for (size_t j = 0; j < len; j++) {
+			EXPECT_EQ(((char *)mem)[j], 0);
+		}
+		total_len += MEM_allocN_len(mem);
+		blocks.push_back(mem);
+	}
+
+	EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use + total_len);
+	EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use + blocks.size());
+	EXPECT_GE(MEM_get_peak_memory(), mem_in_use + total_len);
+
+	FreeBlocks(blocks);
+
+	/* Blocks kept in the thread cache are not counted. */
+	EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+	EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST(guardedalloc, PoolReuse)
+{
+	MEM_use_pool_allocator();
+
+	void *mem = MEM_mallocN(24, "PoolReuse");
+	MEM_freeN(mem);
+
+	/* Same size class, taken from the thread cache. */
+	void *mem_reused = MEM_callocN(32, "PoolReuse");
+	EXPECT_EQ(mem_reused, mem);
+	EXPECT_EQ(MEM_allocN_len(mem_reused), 32);
+	EXPECT_EQ(((int *)mem_reused)[0], 0);
+	MEM_freeN(mem_reused);
+}
+
+TEST(guardedalloc, PoolRealloc)
+{
+	MEM_use_pool_allocator();
+
+	const size_t mem_in_use = MEM_get_memory_in_use();
+	char *mem = (char *)MEM_mallocN(100, "PoolRealloc");
+	memset(mem, 1, 100);
+
+	/* Grow out of the thread cache sizes and back. */
+	mem = (char *)MEM_recallocN(mem, 1000);
+	EXPECT_EQ(MEM_allocN_len(mem), 1000);
+	EXPECT_EQ(mem[99], 1);
+	EXPECT_EQ(mem[100], 0);
+	EXPECT_EQ(mem[999], 0);
+
+	char *mem_dup = (char *)MEM_dupallocN(mem);
+	EXPECT_EQ(memcmp(mem, mem_dup, 1000), 0);
+	MEM_freeN(mem_dup);
+
+	mem = (char *)MEM_reallocN(mem, 40);
+	EXPECT_EQ(MEM_allocN_len(mem), 40);
+	EXPECT_EQ(mem[39], 1);
+
+	mem_dup = (char *)MEM_dupallocN(mem);
+	EXPECT_EQ(memcmp(mem, mem_dup, 40), 0);
+	MEM_freeN(mem_dup);
+
+	MEM_freeN(mem);
+	EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+}
+
+TEST(guardedalloc, PoolAlignedAlloc16)
+{
+	MEM_use_pool_allocator();
+
+	int *foo = (int *)MEM_mallocN_aligned(sizeof(int) * 10, 16, "test");
+	CHECK_ALIGNMENT(foo, 16);
+
+	int *bar = (int *)MEM_dupallocN(foo);
+	CHECK_ALIGNMENT(bar, 16);
+	MEM_freeN(bar);
+
+	foo = (int *)MEM_reallocN(foo, sizeof(int) * 5);
+	CHECK_ALIGNMENT(foo, 16);
+
+	foo = (int *)MEM_recallocN(foo, sizeof(int) * 5);
+	CHECK_ALIGNMENT(foo, 16);
+
+	MEM_freeN(foo);
+}
+
+TEST(guardedalloc, PoolCrossThreadFree)
+{
+	MEM_use_pool_allocator();
+
+	const size_t mem_in_use = MEM_get_memory_in_use();
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	std::vector<void *> blocks;
+
+	for (int iter = 0; iter < 10; iter++) {
+		/* Allocated and freed by different threads, the caches of finished
+		 * threads are adopted by the next ones. */
+		std::thread alloc_thread(AllocBlocks, std::ref(blocks), (size_t)1000);
+		alloc_thread.join();
+
+		EXPECT_GT(MEM_get_memory_in_use(), mem_in_use);
+
+		std::thread free_thread(FreeBlocks, std::ref(blocks));
+		free_thread.join();
+	}
+
+	/* Blocks allocated by this thread, freed by many threads at once. */
+	AllocBlocks(blocks, 10000);
+	std::vector<std::thread> threads;
+	std::vector<std::vector<void *> > thread_blocks(4);
+	for (size_t i = 0; i < blocks.size(); i++) {
+		thread_blocks[i % thread_blocks.size()].push_back(blocks[i]);
+	}
+	blocks.clear();
+	for (size_t i = 0; i < thread_blocks.size(); i++) {
+		threads.push_back(std::thread(FreeBlocks, std::ref(thread_blocks[i])));
+	}
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+
+	/* Take back the blocks freed by the other threads. */
+	AllocBlocks(blocks, 10000);
+	FreeBlocks(blocks);
+
+	EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+	EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
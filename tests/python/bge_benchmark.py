@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# Apache License, Version 2.0
+
+# Game engine frame time benchmark.
+#
+# Builds the stress scenes of bge_benchmark_scenes.py with Blender, runs each of them
+# in the headless player for a fixed number of frames with a fixed time step and
+# gathers the time spent per profile category in one JSON report.
+#
+# ./bge_benchmark.py -blender ./bin/blender -player ./bin/blenderplayer -outdir /tmp/bge_benchmark
+#
+# The headless player doesn't draw, but the scene conversion needs an OpenGL context
+# that it creates in a hidden window, a display is then needed.
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+
+def build_scenes(blender, outdir, scale, scenes):
+    command = [
+        blender,
+        "--background",
+        "-noaudio",
+        "--factory-startup",
+        "--python", os.path.join(os.path.dirname(os.path.abspath(__file__)), "bge_benchmark_scenes.py"),
+        "--",
+        "--outdir", outdir,
+        "--scale", str(scale),
+    ]
+    if scenes:
+        command += ["--scenes"] + scenes
+
+    subprocess.check_call(command)
+
+
+def run_scene(player, filepath, frames, profile_filepath):
+    if os.path.exists(profile_filepath):
+        os.remove(profile_filepath)
+
+    command = [
+        player,
+        "-b",
+        "-g", "max_frames", "=", str(frames),
+        "-g", "noaudio",
+        "-r", profile_filepath,
+        filepath,
+    ]
+
+    start = time.time()
+    returncode = subprocess.call(command)
+    wall_time = time.time() - start
+
+    if returncode != 0 or not os.path.exists(profile_filepath):
+        print("FAILED: %s (exit code %d)" % (filepath, returncode))
+        return None
+
+    with open(profile_filepath) as f:
+        profile = json.load(f)
+    profile["wall_time"] = wall_time
+    return profile
+
+
+def create_argparse():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-blender", nargs=1, required=True)
+    parser.add_argument("-player", nargs=1, required=True)
+    parser.add_argument("-outdir", nargs=1, required=True)
+    parser.add_argument("-frames", nargs=1, type=int, default=[500])
+    parser.add_argument("-scale", nargs=1, type=float, default=[1.0])
+    parser.add_argument("-scenes", nargs="*", default=[])
+    parser.add_argument("-report", nargs=1, help="Report file, outdir/report.json by default")
+    return parser
+
+
+def main():
+    parser = create_argparse()
+    args = parser.parse_args()
+
+    outdir = os.path.abspath(args.outdir[0])
+    frames = args.frames[0]
+    os.makedirs(outdir, exist_ok=True)
+
+    build_scenes(args.blender[0], outdir, args.scale[0], args.scenes)
+
+    report = {
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "machine": platform.node(),
+        "platform": platform.platform(),
+        "frames": frames,
+        "scale": args.scale[0],
+        "scenes": {},
+    }
+
+    ok = True
+    blend_files = sorted(f for f in os.listdir(outdir) if f.endswith(".blend"))
+    for blend_file in blend_files:
+        name = os.path.splitext(blend_file)[0]
+        if args.scenes and name not in args.scenes:
+            continue
+
+        print("RUN %s" % name)
+        profile = run_scene(args.player[0], os.path.join(outdir, blend_file), frames,
+                            os.path.join(outdir, name + "_profile.json"))
+        if profile is None:
+            ok = False
+            continue
+
+        report["scenes"][name] = profile
+        print("    %d frames, %.3f ms per frame" % (profile["frames"], profile["frame"]["average"] * 1000.0))
+
+    report_filepath = args.report[0] if args.report else os.path.join(outdir, "report.json")
+    with open(report_filepath, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print("Report written in %s" % report_filepath)
+
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
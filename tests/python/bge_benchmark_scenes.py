@@ -0,0 +1,301 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+# Builds the stress scenes of the game engine benchmark, see bge_benchmark.py.
+# Each scene is saved in its own .blend file in the output directory.
+#
+# ./blender.bin --background --factory-startup --python tests/python/bge_benchmark_scenes.py -- \
+#     --outdir /tmp/bge_benchmark --scale 1.0
+
+import math
+import os
+import sys
+
+import bpy
+
+
+# Number of objects of each stress scene for a scale of 1.0.
+SCENES = {
+    "static_meshes": 10000,
+    "rigid_bodies": 1000,
+    "skinned_armatures": 200,
+    "logic_bricks": 5000,
+    "messages": 1000,
+    "steering_agents": 2000,
+}
+
+
+def reset_file():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.game_settings.fps = 60
+    scene.game_settings.logic_step_max = 1
+    scene.game_settings.physics_step_max = 1
+    return scene
+
+
+def link_object(scene, ob):
+    scene.master_collection.objects.link(ob)
+    return ob
+
+
+def set_active(ob):
+    bpy.context.view_layer.objects.active = ob
+
+
+def add_camera(scene, distance):
+    cam_data = bpy.data.cameras.new("Camera")
+    cam_data.clip_end = distance * 4.0
+    cam = link_object(scene, bpy.data.objects.new("Camera", cam_data))
+    cam.location = (0.0, -distance, distance)
+    cam.rotation_euler = (math.radians(45.0), 0.0, 0.0)
+    scene.camera = cam
+
+
+def cube_mesh(name, size=0.5):
+    s = size
+    verts = [(-s, -s, -s), (s, -s, -s), (s, s, -s), (-s, s, -s),
+             (-s, -s, s), (s, -s, s), (s, s, s), (-s, s, s)]
+    faces = [(0, 1, 2, 3), (4, 7, 6, 5), (0, 4, 5, 1),
+             (1, 5, 6, 2), (2, 6, 7, 3), (3, 7, 4, 0)]
+    mesh = bpy.data.meshes.new(name)
+    mesh.from_pydata(verts, [], faces)
+    mesh.update()
+    return mesh
+
+
+def grid_location(index, count, spacing):
+    side = max(1, int(math.ceil(math.sqrt(count))))
+    x = (index % side - side * 0.5) * spacing
+    y = (index // side - side * 0.5) * spacing
+    return x, y
+
+
+def add_copies(scene, template, count, spacing, z=0.0):
+    """Copy a template object with its logic bricks and game settings on a grid."""
+    obs = [template]
+    template.location = grid_location(0, count, spacing) + (z,)
+    for i in range(1, count):
+        ob = link_object(scene, template.copy())
+        ob.location = grid_location(i, count, spacing) + (z,)
+        obs.append(ob)
+    return obs
+
+
+def add_logic(ob, sensor_type, actuator_type, pulse=True):
+    set_active(ob)
+    bpy.ops.logic.sensor_add(type=sensor_type, object=ob.name)
+    bpy.ops.logic.controller_add(type='LOGIC_AND', object=ob.name)
+    bpy.ops.logic.actuator_add(type=actuator_type, object=ob.name)
+    sens = ob.game.sensors[-1]
+    cont = ob.game.controllers[-1]
+    act = ob.game.actuators[-1]
+    sens.use_pulse_true_level = pulse
+    sens.link(cont)
+    act.link(cont)
+    return sens, act
+
+
+def add_property(ob, name, type='INT'):
+    set_active(ob)
+    bpy.ops.object.game_property_new(type=type, name=name)
+
+
+def build_static_meshes(scene, count):
+    add_camera(scene, math.sqrt(count) * 2.0)
+    mesh = cube_mesh("Cube")
+    template = link_object(scene, bpy.data.objects.new("Static", mesh))
+    template.game.physics_type = 'STATIC'
+    add_copies(scene, template, count, 2.0)
+
+
+def build_rigid_bodies(scene, count):
+    add_camera(scene, math.sqrt(count) * 3.0)
+    ground = link_object(scene, bpy.data.objects.new("Ground", cube_mesh("Ground", math.sqrt(count) * 2.0)))
+    ground.location = (0.0, 0.0, -math.sqrt(count) * 2.0)
+    ground.game.physics_type = 'STATIC'
+
+    template = link_object(scene, bpy.data.objects.new("Body", cube_mesh("Body")))
+    template.game.physics_type = 'RIGID_BODY'
+    template.game.use_sleep = False
+    obs = add_copies(scene, template, count, 1.5, z=2.0)
+    # Stack half of the bodies to keep contacts all along the run.
+    for i, ob in enumerate(obs[::2]):
+        ob.location.z += 1.1
+
+
+def build_skinned_armatures(scene, count):
+    add_camera(scene, math.sqrt(count) * 4.0)
+
+    # A column of rings skinned to two bones.
+    rings, segments, height = 16, 16, 2.0
+    verts = []
+    faces = []
+    for r in range(rings):
+        z = r * height / (rings - 1)
+        for s in range(segments):
+            a = 2.0 * math.pi * s / segments
+            verts.append((math.cos(a) * 0.3, math.sin(a) * 0.3, z))
+    for r in range(rings - 1):
+        for s in range(segments):
+            n = (s + 1) % segments
+            faces.append((r * segments + s, r * segments + n, (r + 1) * segments + n, (r + 1) * segments + s))
+    mesh = bpy.data.meshes.new("Skin")
+    mesh.from_pydata(verts, [], faces)
+    mesh.update()
+
+    arm_data = bpy.data.armatures.new("Armature")
+    arm = link_object(scene, bpy.data.objects.new("Armature", arm_data))
+    set_active(arm)
+    bpy.ops.object.mode_set(mode='EDIT')
+    lower = arm_data.edit_bones.new("Lower")
+    lower.head = (0.0, 0.0, 0.0)
+    lower.tail = (0.0, 0.0, height * 0.5)
+    upper = arm_data.edit_bones.new("Upper")
+    upper.head = lower.tail
+    upper.tail = (0.0, 0.0, height)
+    upper.parent = lower
+    upper.use_connect = True
+    bpy.ops.object.mode_set(mode='OBJECT')
+
+    skin = link_object(scene, bpy.data.objects.new("Skin", mesh))
+    skin.parent = arm
+    lower_group = skin.vertex_groups.new(name="Lower")
+    upper_group = skin.vertex_groups.new(name="Upper")
+    for i, v in enumerate(verts):
+        w = v[2] / height
+        lower_group.add([i], 1.0 - w, 'REPLACE')
+        upper_group.add([i], w, 'REPLACE')
+    modifier = skin.modifiers.new("Armature", 'ARMATURE')
+    modifier.object = arm
+
+    action = bpy.data.actions.new("Bend")
+    for bone in ("Lower", "Upper"):
+        arm.pose.bones[bone].rotation_mode = 'XYZ'
+        fcurve = action.fcurves.new('pose.bones["%s"].rotation_euler' % bone, index=0)
+        for frame, angle in ((1.0, 0.0), (30.0, 0.8), (60.0, 0.0)):
+            fcurve.keyframe_points.insert(frame, angle)
+
+    sens, act = add_logic(arm, 'ALWAYS', 'ACTION', pulse=False)
+    act.action = action
+    act.play_mode = 'LOOPEND'
+    act.frame_start = 1.0
+    act.frame_end = 60.0
+
+    arms = add_copies(scene, arm, count, 2.0)
+    for copy in arms[1:]:
+        skin_copy = link_object(scene, skin.copy())
+        skin_copy.parent = copy
+        skin_copy.modifiers["Armature"].object = copy
+
+
+def build_logic_bricks(scene, count):
+    add_camera(scene, math.sqrt(count) * 2.0)
+    template = link_object(scene, bpy.data.objects.new("Logic", cube_mesh("Logic")))
+    template.game.physics_type = 'NO_COLLISION'
+    add_property(template, "counter")
+    add_property(template, "toggle", type='BOOL')
+
+    sens, act = add_logic(template, 'ALWAYS', 'PROPERTY')
+    act.mode = 'ADD'
+    act.property = "counter"
+    act.value = "1"
+
+    sens, act = add_logic(template, 'PROPERTY', 'PROPERTY')
+    sens.evaluation_type = 'PROPCHANGED'
+    sens.property = "counter"
+    act.mode = 'TOGGLE'
+    act.property = "toggle"
+
+    add_copies(scene, template, count, 2.0)
+
+
+def build_messages(scene, count):
+    add_camera(scene, math.sqrt(count) * 2.0)
+    template = link_object(scene, bpy.data.objects.new("Messenger", cube_mesh("Messenger")))
+    template.game.physics_type = 'NO_COLLISION'
+    add_property(template, "received")
+    add_property(template, "text", type='STRING')
+
+    sens, act = add_logic(template, 'ALWAYS', 'MESSAGE')
+    act.subject = "ping"
+    act.body_type = 'TEXT'
+    act.body_message = "payload"
+
+    sens, act = add_logic(template, 'MESSAGE', 'PROPERTY')
+    sens.subject = "ping"
+    act.mode = 'ADD'
+    act.property = "received"
+    act.value = "1"
+
+    add_copies(scene, template, count, 2.0)
+
+
+def build_steering_agents(scene, count):
+    add_camera(scene, math.sqrt(count) * 3.0)
+    target = link_object(scene, bpy.data.objects.new("Target", cube_mesh("Target")))
+    target.game.physics_type = 'NO_COLLISION'
+
+    template = link_object(scene, bpy.data.objects.new("Agent", cube_mesh("Agent", 0.25)))
+    template.game.physics_type = 'DYNAMIC'
+    template.game.use_obstacle_create = True
+    sens, act = add_logic(template, 'ALWAYS', 'STEERING', pulse=False)
+    act.mode = 'SEEK'
+    act.target = target
+    act.velocity = 2.0
+    act.distance = 0.5
+
+    scene.game_settings.obstacle_simulation = 'RVO_CELLS'
+    add_copies(scene, template, count, 2.0)
+
+
+BUILDERS = {
+    "static_meshes": build_static_meshes,
+    "rigid_bodies": build_rigid_bodies,
+    "skinned_armatures": build_skinned_armatures,
+    "logic_bricks": build_logic_bricks,
+    "messages": build_messages,
+    "steering_agents": build_steering_agents,
+}
+
+
+def main():
+    import argparse
+
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+    parser = argparse.ArgumentParser(description="Build the game engine benchmark scenes")
+    parser.add_argument("--outdir", required=True)
+    parser.add_argument("--scale", type=float, default=1.0, help="Factor applied to the number of objects")
+    parser.add_argument("--scenes", nargs="*", default=sorted(SCENES.keys()))
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.outdir, exist_ok=True)
+
+    for name in args.scenes:
+        count = max(1, int(SCENES[name] * args.scale))
+        scene = reset_file()
+        BUILDERS[name](scene, count)
+        filepath = os.path.join(args.outdir, name + ".blend")
+        bpy.ops.wm.save_as_mainfile(filepath=filepath)
+        print("Saved %s with %d objects" % (filepath, count))
+
+
+if __name__ == "__main__":
+    main()
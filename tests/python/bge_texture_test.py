@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# Apache License, Version 2.0
+
+# VideoTexture filters test and benchmark.
+#
+# Compares the images computed by the row filters of bge.texture with the per pixel
+# filters and reports the throughput of both paths for each filter type.
+# The checks run in the headless player, see bge_texture_test_game.py.
+#
+# ./bge_texture_test.py -blender ./bin/blender -player ./bin/blenderplayer -outdir /tmp/bge_texture_test
+#
+# The same script builds the .blend file when run by Blender:
+#
+# ./blender.bin --background --factory-startup --python tests/python/bge_texture_test.py -- \
+#     --output /tmp/bge_texture_test/texture_test.blend
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+
+GAME_SCRIPT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "bge_texture_test_game.py")
+
+
+def build_file(filepath):
+    import bpy
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    cam = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    scene.master_collection.objects.link(cam)
+    scene.camera = cam
+
+    text = bpy.data.texts.new("texture_test.py")
+    with open(GAME_SCRIPT) as f:
+        text.from_string(f.read())
+
+    # The script runs once on the first logic frame.
+    ob = bpy.data.objects.new("Test", None)
+    scene.master_collection.objects.link(ob)
+    bpy.context.view_layer.objects.active = ob
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=ob.name)
+    cont = ob.game.controllers[-1]
+    cont.mode = 'SCRIPT'
+    cont.text = text
+    ob.game.sensors[-1].link(cont)
+
+    bpy.ops.wm.save_as_mainfile(filepath=filepath)
+
+
+def run_test(blender, player, outdir):
+    filepath = os.path.join(outdir, "texture_test.blend")
+    report_filepath = os.path.join(outdir, "texture_test.json")
+
+    subprocess.check_call([
+        blender,
+        "--background",
+        "-noaudio",
+        "--factory-startup",
+        "--python", os.path.abspath(__file__),
+        "--",
+        "--output", filepath,
+    ])
+
+    if os.path.exists(report_filepath):
+        os.remove(report_filepath)
+
+    env = dict(os.environ, BGE_TEXTURE_TEST_REPORT=report_filepath)
+    returncode = subprocess.call([player, "-b", "-g", "noaudio", filepath], env=env)
+
+    if returncode != 0 or not os.path.exists(report_filepath):
+        print("FAILED: player exit code %d" % returncode)
+        return False
+
+    with open(report_filepath) as f:
+        report = json.load(f)
+
+    for error in report["errors"]:
+        print("FAILED: %s" % error)
+    if not report["done"]:
+        print("FAILED: test script did not complete")
+
+    print("Report written in %s" % report_filepath)
+    return report["done"] and not report["errors"]
+
+
+def main():
+    if "--" in sys.argv:
+        # Run by Blender to build the file.
+        parser = argparse.ArgumentParser()
+        parser.add_argument("--output", required=True)
+        args = parser.parse_args(sys.argv[sys.argv.index("--") + 1:])
+        build_file(args.output)
+        return
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-blender", nargs=1, required=True)
+    parser.add_argument("-player", nargs=1, required=True)
+    parser.add_argument("-outdir", nargs=1, required=True)
+    args = parser.parse_args()
+
+    outdir = os.path.abspath(args.outdir[0])
+    os.makedirs(outdir, exist_ok=True)
+
+    sys.exit(0 if run_test(args.blender[0], args.player[0], outdir) else 1)
+
+
+if __name__ == "__main__":
+    main()
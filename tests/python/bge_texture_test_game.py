@@ -0,0 +1,204 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+# Game script of bge_texture_test.py, run once by the player.
+#
+# Every image is computed with the row filters (bge.texture.setRowFilters(True)) and
+# with the per pixel filters, the results must be the same bytes. The time of both
+# paths is reported for each filter type and for the mix of several sources.
+#
+# The report is written in the JSON file given by the BGE_TEXTURE_TEST_REPORT
+# environment variable.
+
+import json
+import os
+import random
+import time
+
+from bge import logic, texture
+
+
+WIDTH = 1024
+HEIGHT = 512
+RUNS = 20
+
+
+def random_bytes(rng, size):
+    return rng.getrandbits(8 * size).to_bytes(size, "little")
+
+
+def image_buff(rng, width, height):
+    buff = texture.ImageBuff()
+    # RGB source converted by the default filter of ImageBuff.
+    buff.load(random_bytes(rng, width * height * 3), width, height)
+    return buff
+
+
+def filter_gray(rng):
+    return texture.FilterGray()
+
+
+def filter_color(rng):
+    filt = texture.FilterColor()
+    filt.matrix = [[rng.randint(-512, 512) for c in range(5)] for r in range(4)]
+    return filt
+
+
+def filter_level(rng):
+    filt = texture.FilterLevel()
+    levels = []
+    for r in range(4):
+        low = rng.randint(0, 254)
+        levels.append([low, rng.randint(low + 1, 255)])
+    filt.levels = levels
+    return filt
+
+
+def filter_blue_screen(rng):
+    filt = texture.FilterBlueScreen()
+    filt.color = [rng.randint(0, 255) for c in range(3)]
+    low = rng.randint(0, 200)
+    filt.limits = [low, rng.randint(low + 1, 255)]
+    return filt
+
+
+def filter_chain(rng):
+    filt = filter_blue_screen(rng)
+    filt.previous = filter_level(rng)
+    filt.previous.previous = filter_color(rng)
+    filt.previous.previous.previous = filter_gray(rng)
+    return filt
+
+
+FILTERS = {
+    "gray": filter_gray,
+    "color": filter_color,
+    "level": filter_level,
+    "blue_screen": filter_blue_screen,
+    "chain": filter_chain,
+}
+
+
+def compute(image, row_filters):
+    texture.setRowFilters(row_filters)
+    image.refresh()
+    return texture.imageToArray(image).to_list()
+
+
+def time_image(image, row_filters, runs):
+    texture.setRowFilters(row_filters)
+    # The copy of the result is part of each run, it's timed alone and removed.
+    image.refresh()
+    texture.imageToArray(image)
+    start = time.perf_counter()
+    for i in range(runs):
+        texture.imageToArray(image)
+    copy_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    for i in range(runs):
+        image.refresh()
+        texture.imageToArray(image)
+    return (time.perf_counter() - start - copy_time) / runs
+
+
+def test_filters(rng, report):
+    """Filters on a single source image."""
+    source = image_buff(rng, WIDTH, HEIGHT)
+    pixels = WIDTH * HEIGHT
+
+    for name, create in sorted(FILTERS.items()):
+        for seed in range(4):
+            image = texture.ImageMix()
+            image.setSource("source", source)
+            image.filter = create(rng)
+            image.flip = (seed % 2 == 1)
+            if compute(image, True) != compute(image, False):
+                report["errors"].append("filter %s differs (seed %d)" % (name, seed))
+
+        row_time = time_image(image, True, RUNS)
+        pixel_time = time_image(image, False, RUNS)
+        report["filters"][name] = {
+            "row_mpixels_per_second": pixels / row_time / 1e6,
+            "pixel_mpixels_per_second": pixels / pixel_time / 1e6,
+        }
+        print("%-12s row %8.1f Mpixels/s, pixel %8.1f Mpixels/s" %
+              (name, pixels / row_time / 1e6, pixels / pixel_time / 1e6))
+
+
+def test_mix(rng, report):
+    """ImageMix blending its sources in one pass, compared with FilterImageMix."""
+    for seed in range(20):
+        # Widths not multiple of the SIMD width too.
+        width = rng.randint(1, 67)
+        height = rng.randint(1, 33)
+        image = texture.ImageMix()
+        for i in range(rng.randint(2, 5)):
+            name = "source%d" % i
+            image.setSource(name, image_buff(rng, width, height))
+            # Zero weights are skipped by the row path.
+            image.setWeight(name, rng.choice((0, rng.randint(1, 255), 255)))
+        image.flip = rng.random() < 0.5
+        if seed % 4 == 3:
+            image.filter = filter_chain(rng)
+        if compute(image, True) != compute(image, False):
+            report["errors"].append("mix differs (seed %d, %dx%d)" % (seed, width, height))
+
+    # Weights adding up to 256, like a cross fade.
+    image = texture.ImageMix()
+    for i, weight in enumerate((128, 96, 32)):
+        name = "source%d" % i
+        image.setSource(name, image_buff(rng, WIDTH, HEIGHT))
+        image.setWeight(name, weight)
+    if compute(image, True) != compute(image, False):
+        report["errors"].append("mix differs (%dx%d)" % (WIDTH, HEIGHT))
+
+    pixels = WIDTH * HEIGHT
+    row_time = time_image(image, True, RUNS)
+    pixel_time = time_image(image, False, RUNS)
+    report["filters"]["mix"] = {
+        "row_mpixels_per_second": pixels / row_time / 1e6,
+        "pixel_mpixels_per_second": pixels / pixel_time / 1e6,
+    }
+    print("%-12s row %8.1f Mpixels/s, pixel %8.1f Mpixels/s" %
+          ("mix", pixels / row_time / 1e6, pixels / pixel_time / 1e6))
+
+
+def main():
+    report = {"done": False, "errors": [], "filters": {}}
+    rng = random.Random(0)
+
+    try:
+        test_filters(rng, report)
+        test_mix(rng, report)
+        report["done"] = True
+    finally:
+        texture.setRowFilters(True)
+
+        for error in report["errors"]:
+            print("FAILED: %s" % error)
+
+        with open(os.environ["BGE_TEXTURE_TEST_REPORT"], "w") as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+
+        logic.endGame()
+
+
+main()
@@ -0,0 +1,156 @@
+# Apache License, Version 2.0
+
+# Compositor buffer cache test.
+#
+# The compositor keeps the buffers of unchanged parts of the tree between executions,
+# the results must be the same as when the tree is executed without the cache
+# after changing node settings, curves or the pixels of an image.
+#
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_compositor_buffer_cache.py -- --verbose
+
+import bpy
+import unittest
+
+
+WIDTH = 64
+HEIGHT = 48
+
+
+class TestBufferCache(unittest.TestCase):
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        scene = bpy.context.scene
+        self.scene = scene
+
+        # No render layers node, the frame is not rendered but the compositor runs.
+        cam = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+        scene.master_collection.objects.link(cam)
+        scene.camera = cam
+
+        scene.render.resolution_x = WIDTH
+        scene.render.resolution_y = HEIGHT
+        scene.render.resolution_percentage = 100
+        scene.render.use_compositing = True
+        scene.use_nodes = True
+
+        self.image = bpy.data.images.new("Source", WIDTH, HEIGHT, alpha=True, float_buffer=True)
+        self.set_pixels(0.0)
+
+        tree = scene.node_tree
+        self.tree = tree
+        for node in list(tree.nodes):
+            tree.nodes.remove(node)
+
+        image = tree.nodes.new("CompositorNodeImage")
+        image.image = self.image
+        self.image_node = image
+
+        # The blur is the expensive, cached part of the tree.
+        blur = tree.nodes.new("CompositorNodeBlur")
+        blur.size_x = 4
+        blur.size_y = 4
+        self.blur = blur
+
+        mix = tree.nodes.new("CompositorNodeMixRGB")
+        mix.blend_type = 'MULTIPLY'
+        mix.inputs[0].default_value = 0.5
+        mix.inputs[2].default_value = (0.2, 0.6, 1.0, 1.0)
+        self.mix = mix
+
+        viewer = tree.nodes.new("CompositorNodeViewer")
+        composite = tree.nodes.new("CompositorNodeComposite")
+
+        tree.links.new(image.outputs["Image"], blur.inputs["Image"])
+        tree.links.new(blur.outputs["Image"], mix.inputs[1])
+        tree.links.new(mix.outputs["Image"], viewer.inputs["Image"])
+        tree.links.new(mix.outputs["Image"], composite.inputs["Image"])
+
+    def set_pixels(self, offset):
+        pixels = []
+        for y in range(HEIGHT):
+            for x in range(WIDTH):
+                pixels += [
+                    ((x * 7 + y * 3) % 17) / 16.0 + offset,
+                    ((x + y * 5) % 11) / 10.0,
+                    (y % 5) / 4.0,
+                    1.0,
+                ]
+        self.image.pixels = pixels
+
+    def execute(self, use_buffer_cache=True):
+        self.tree.use_buffer_cache = use_buffer_cache
+        bpy.ops.render.render()
+        return list(bpy.data.images["Viewer Node"].pixels)
+
+    def assertSamePixels(self, pixels1, pixels2):
+        self.assertEqual(len(pixels1), len(pixels2))
+        self.assertEqual(len(pixels1), WIDTH * HEIGHT * 4)
+        diff = max(abs(v1 - v2) for v1, v2 in zip(pixels1, pixels2))
+        self.assertLess(diff, 1e-6)
+
+    def test_same_tree(self):
+        result_uncached = self.execute(use_buffer_cache=False)
+        self.execute()
+        # Second execution uses the cached blur.
+        self.assertSamePixels(self.execute(), result_uncached)
+
+    def test_change_mix_setting(self):
+        self.execute()
+        self.mix.inputs[0].default_value = 0.9
+        result_cached = self.execute()
+        self.assertSamePixels(result_cached, self.execute(use_buffer_cache=False))
+
+    def test_change_blur_setting(self):
+        result_before = self.execute()
+        self.blur.size_x = 9
+        result_cached = self.execute()
+        self.assertNotEqual(result_before, result_cached)
+        self.assertSamePixels(result_cached, self.execute(use_buffer_cache=False))
+
+        # Back to the first settings.
+        self.blur.size_x = 4
+        self.assertSamePixels(self.execute(), result_before)
+
+    def test_change_image_pixels(self):
+        # The image buffer is modified in place, like when painting.
+        result_before = self.execute()
+        self.set_pixels(0.25)
+        result_cached = self.execute()
+        self.assertNotEqual(result_before, result_cached)
+        self.assertSamePixels(result_cached, self.execute(use_buffer_cache=False))
+
+    def test_change_curve(self):
+        # The curves are before the blur, their result is a cached buffer.
+        curves = self.tree.nodes.new("CompositorNodeCurveRGB")
+        self.tree.links.new(self.image_node.outputs["Image"], curves.inputs["Image"])
+        self.tree.links.new(curves.outputs["Image"], self.blur.inputs["Image"])
+
+        result_before = self.execute()
+        point = curves.mapping.curves[3].points[0]
+        point.location = (0.0, 0.3)
+        curves.mapping.update()
+        result_cached = self.execute()
+        self.assertNotEqual(result_before, result_cached)
+        self.assertSamePixels(result_cached, self.execute(use_buffer_cache=False))
+
+        # Back to the first curve, with newly allocated points.
+        point.location = (0.0, 0.0)
+        curves.mapping.update()
+        self.assertSamePixels(self.execute(), result_before)
+
+    def test_reload_image(self):
+        self.execute()
+        self.set_pixels(0.5)
+        result_changed = self.execute()
+        # Generated images are reset on reload, without a new address for the buffer.
+        self.image.reload()
+        result_cached = self.execute()
+        self.assertNotEqual(result_changed, result_cached)
+        self.assertSamePixels(result_cached, self.execute(use_buffer_cache=False))
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()